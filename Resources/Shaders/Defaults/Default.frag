@@ -8,6 +8,13 @@
 //layout(constant_id = 4) const bool MATERIAL_MAPPING = false;
 //layout(constant_id = 5) const bool NORMAL_MAPPING = false;
 
+#if INDIRECT
+#include "Object.glsl"
+
+layout(binding = 6) readonly buffer BufferObjects {
+	Object objects[];
+};
+#else
 layout(binding = 1) uniform UniformObject {
 	mat4 transform;
 
@@ -17,6 +24,7 @@ layout(binding = 1) uniform UniformObject {
 	float ignoreFog;
 	float ignoreLighting;
 } object;
+#endif
 
 #if DIFFUSE_MAPPING
 layout(binding = 3) uniform sampler2D samplerDiffuse;
@@ -31,6 +39,9 @@ layout(binding = 5) uniform sampler2D samplerNormal;
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
+#if INDIRECT
+layout(location = 3) flat in uint inInstance;
+#endif
 
 layout(location = 0) out vec4 outPosition;
 layout(location = 1) out vec4 outDiffuse;
@@ -38,9 +49,17 @@ layout(location = 2) out vec4 outNormal;
 layout(location = 3) out vec4 outMaterial;
 
 void main() {
-	vec4 diffuse = object.baseDiffuse;
+#if INDIRECT
+	vec4 baseDiffuse = objects[inInstance].values[0];
+	vec4 parameters = objects[inInstance].values[1];
+#else
+	vec4 baseDiffuse = object.baseDiffuse;
+	vec4 parameters = vec4(object.metallic, object.roughness, object.ignoreFog, object.ignoreLighting);
+#endif
+
+	vec4 diffuse = baseDiffuse;
 	vec3 normal = normalize(inNormal);
-	vec3 material = vec3(object.metallic, object.roughness, 0.0f);
+	vec3 material = vec3(parameters.x, parameters.y, 0.0f);
 	float glowing = 0.0f;
 
 #if DIFFUSE_MAPPING
@@ -58,7 +77,10 @@ void main() {
 #endif
 
 #if NORMAL_MAPPING
-	vec3 tangentNormal = texture(samplerNormal, inUV).rgb * 2.0f - 1.0f;
+	// Z is rebuilt from x and y, so two channel normal maps cooked to BC5 sample the same as RGB normal maps.
+	vec3 tangentNormal;
+	tangentNormal.xy = texture(samplerNormal, inUV).rg * 2.0f - 1.0f;
+	tangentNormal.z = sqrt(max(1.0f - dot(tangentNormal.xy, tangentNormal.xy), 0.0f));
 	
 	vec3 q1 = dFdx(inPosition);
 	vec3 q2 = dFdy(inPosition);
@@ -73,7 +95,7 @@ void main() {
 	normal = TBN * tangentNormal;
 #endif
 
-	material.z = (1.0f / 3.0f) * (object.ignoreFog + (2.0f * min(object.ignoreLighting + glowing, 1.0f)));
+	material.z = (1.0f / 3.0f) * (parameters.z + (2.0f * min(parameters.w + glowing, 1.0f)));
 
 	outPosition = vec4(inPosition, 1.0f);
 	outDiffuse = diffuse;
@@ -12,6 +12,13 @@ layout(binding = 0) uniform UniformScene {
 	vec3 cameraPos;
 } scene;
 
+#if INDIRECT
+#include "Object.glsl"
+
+layout(binding = 6) readonly buffer BufferObjects {
+	Object objects[];
+};
+#else
 layout(binding = 1) uniform UniformObject {
 	mat4 transform;
 
@@ -21,6 +28,7 @@ layout(binding = 1) uniform UniformObject {
 	float ignoreFog;
 	float ignoreLighting;
 } object;
+#endif
 #if ANIMATED
 layout(binding = 2) buffer BufferAnimation {
 	mat4 jointTransforms[];
@@ -38,6 +46,9 @@ layout(location = 4) in vec3 inWeights;
 layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec2 outUV;
 layout(location = 2) out vec3 outNormal;
+#if INDIRECT
+layout(location = 3) flat out uint outInstance;
+#endif
 
 out gl_PerVertex {
 	vec4 gl_Position;
@@ -61,8 +72,16 @@ void main() {
 	vec4 normal = vec4(inNormal, 0.0f);
 #endif
 
-	vec4 worldPosition = object.transform * position;
-    mat3 normalMatrix = transpose(inverse(mat3(object.transform)));
+#if INDIRECT
+	// Each draw command starts its instances at the index of its object.
+	mat4 transform = objects[gl_InstanceIndex].transform;
+	outInstance = gl_InstanceIndex;
+#else
+	mat4 transform = object.transform;
+#endif
+
+	vec4 worldPosition = transform * position;
+    mat3 normalMatrix = transpose(inverse(mat3(transform)));
 
 	gl_Position = scene.projection * scene.view * worldPosition;
 
@@ -0,0 +1,9 @@
+// The values of a mesh drawn in a GPU culled batch, laid out the same as MeshesSubrender::Object.
+struct Object {
+	mat4 transform;
+	vec3 min;
+	uint batch;
+	vec3 max;
+	uint padding;
+	vec4 values[2];
+};
@@ -16,11 +16,14 @@
 #include "Audio/Flac/FlacSoundBuffer.hpp"
 #include "Audio/Mp3/Mp3SoundBuffer.hpp"
 #include "Audio/Ogg/OggSoundBuffer.hpp"
-#include "Audio/Opus/OpusSoundBuffer.hpp"
 #include "Audio/Sound.hpp"
 #include "Audio/SoundBuffer.hpp"
+#include "Audio/SoundBufferCache.hpp"
 #include "Audio/Wave/WaveSoundBuffer.hpp"
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/Compressed/BlockCompression.hpp"
+#include "Bitmaps/Compressed/CompressedBitmap.hpp"
+#include "Bitmaps/Compressed/TextureManifest.hpp"
 #include "Bitmaps/Dng/DngBitmap.hpp"
 #include "Bitmaps/Exr/ExrBitmap.hpp"
 #include "Bitmaps/Jpg/JpgBitmap.hpp"
@@ -41,11 +44,16 @@
 #include "Files/File.hpp"
 #include "Files/FileObserver.hpp"
 #include "Files/Files.hpp"
+#include "Files/Binary/Binary.hpp"
 #include "Files/Json/Json.hpp"
 #include "Files/Node.hpp"
+#include "Files/NodeArena.hpp"
 #include "Files/NodeConstView.hpp"
 #include "Files/NodeView.hpp"
+#include "Files/Pack/AssetPack.hpp"
+#include "Files/Pack/AssetPackWriter.hpp"
 #include "Files/Xml/Xml.hpp"
+#include "Files/Xml/XmlReader.hpp"
 #include "Files/Zip/ZipArchive.hpp"
 #include "Files/Zip/ZipEntry.hpp"
 #include "Files/Zip/ZipException.hpp"
@@ -74,6 +82,7 @@
 #include "Graphics/Images/Image2dArray.hpp"
 #include "Graphics/Images/ImageCube.hpp"
 #include "Graphics/Images/ImageDepth.hpp"
+#include "Graphics/Images/TextureStreamer.hpp"
 #include "Graphics/Pipelines/Pipeline.hpp"
 #include "Graphics/Pipelines/PipelineCompute.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
@@ -107,6 +116,7 @@
 #include "Materials/DefaultMaterial.hpp"
 #include "Materials/Material.hpp"
 #include "Materials/MaterialPipeline.hpp"
+#include "Maths/Batch.hpp"
 #include "Maths/Colour.hpp"
 #include "Maths/ElapsedTime.hpp"
 #include "Maths/Maths.hpp"
@@ -114,10 +124,12 @@
 #include "Maths/Matrix3.hpp"
 #include "Maths/Matrix4.hpp"
 #include "Maths/Quaternion.hpp"
+#include "Maths/Random.hpp"
 #include "Maths/Time.hpp"
 #include "Maths/Transform.hpp"
 #include "Maths/Vector2.hpp"
 #include "Maths/Vector3.hpp"
+#include "Maths/Vector3Soa.hpp"
 #include "Maths/Vector4.hpp"
 #include "Meshes/Mesh.hpp"
 #include "Meshes/MeshesSubrender.hpp"
@@ -143,11 +155,14 @@
 #include "Network/Http/HttpResponse.hpp"
 #include "Network/IpAddress.hpp"
 #include "Network/Packet.hpp"
+#include "Network/PacketBufferPool.hpp"
 #include "Network/Socket.hpp"
+#include "Network/SocketPoller.hpp"
 #include "Network/SocketSelector.hpp"
 #include "Network/Tcp/TcpListener.hpp"
 #include "Network/Tcp/TcpSocket.hpp"
 #include "Network/Udp/UdpSocket.hpp"
+#include "Network/Udp/UdpTransport.hpp"
 #include "Particles/Emitters/CircleEmitter.hpp"
 #include "Particles/Emitters/Emitter.hpp"
 #include "Particles/Emitters/LineEmitter.hpp"
@@ -195,6 +210,7 @@
 #include "Post/Pipelines/BlurPipeline.hpp"
 #include "Post/PostFilter.hpp"
 #include "Post/PostPipeline.hpp"
+#include "Resources/HotReloader.hpp"
 #include "Resources/Resource.hpp"
 #include "Resources/Resources.hpp"
 #include "Scenes/Camera.hpp"
@@ -205,6 +221,7 @@
 #include "Scenes/ScenePhysics.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Scenes/SceneStructure.hpp"
+#include "Scenes/SpatialTree.hpp"
 #include "Shadows/ShadowBox.hpp"
 #include "Shadows/ShadowRender.hpp"
 #include "Shadows/Shadows.hpp"
@@ -1,7 +1,10 @@
 #include "AnimatedMesh.hpp"
 
 #include "Maths/Maths.hpp"
-#include "Files/File.hpp"
+#include "Files/Files.hpp"
+#include "Files/NodeArena.hpp"
+#include "Files/Xml/Xml.hpp"
+#include "Engine/Log.hpp"
 #include "Maths/Matrix4.hpp"
 #include "Scenes/Entity.hpp"
 #include "Animation/AnimationLoader.hpp"
@@ -23,16 +26,26 @@ void AnimatedMesh::Start() {
 	if (filename.empty())
 		return;
 
-	File file(filename, File::Type::Xml);
-	file.Load();
-	auto fileNode = file.GetNode()["COLLADA"];
+	auto fileLoaded = Files::Read(filename);
+
+	if (!fileLoaded) {
+		Log::Error("Animated mesh could not be loaded: ", filename, '\n');
+		return;
+	}
+
+	// The document is only read by the loaders below, so it is parsed into an arena that is freed at once when this returns.
+	// Views in the tree point into the loaded string, which outlives the arena.
+	NodeArena arena;
+	auto &document = arena.CreateNode();
+	document.ParseString<Xml>(*fileLoaded);
+	auto fileNode = document["COLLADA"];
 
 	// Because in Blender z is up, but Acid is y up. A correction must be applied to positions and normals.
 	static const auto Correction = Matrix4().Rotate(Maths::Radians(-90.0f), Vector3f::Right);
 
 	SkinLoader skinLoader(fileNode["library_controllers"], MaxWeights);
 	SkeletonLoader skeletonLoader(fileNode["library_visual_scenes"], skinLoader.GetJointOrder(), Correction);
-	GeometryLoader geometryLoader(fileNode["library_geometries"], skinLoader.GetVertexWeights(), Correction);
+	GeometryLoader geometryLoader(*fileLoaded, skinLoader.GetVertexWeights(), Correction);
 
 	model = std::make_shared<Model>(geometryLoader.GetVertices(), geometryLoader.GetIndices());
 	headJoint = skeletonLoader.GetHeadJoint();
@@ -1,6 +1,7 @@
 #include "Animator.hpp"
 
 #include "Engine/Engine.hpp"
+#include "Maths/Batch.hpp"
 #include "Utils/Enumerate.hpp"
 
 namespace acid {
@@ -9,7 +10,11 @@ void Animator::Update(const Joint &rootJoint, std::vector<Matrix4> &jointMatrice
 
 	IncreaseAnimationTime();
 	auto currentPose = CalculateCurrentAnimationPose();
-	CalculateJointPose(currentPose, rootJoint, {}, jointMatrices);
+
+	// Joints that are not in the hierarchy keep their matrix.
+	inverseBindTransforms.assign(jointMatrices.size(), Matrix4());
+	CalculateJointPose(currentPose, rootJoint, {}, jointMatrices, inverseBindTransforms);
+	Batch::Multiply(jointMatrices.data(), inverseBindTransforms.data(), jointMatrices.data(), jointMatrices.size());
 }
 
 void Animator::IncreaseAnimationTime() {
@@ -60,17 +65,18 @@ std::map<std::string, Matrix4> Animator::InterpolatePoses(const Keyframe &previo
 	return currentPose;
 }
 
-void Animator::CalculateJointPose(const std::map<std::string, Matrix4> &currentPose, const Joint &joint, const Matrix4 &parentTransform, std::vector<Matrix4> &jointMatrices) {
+void Animator::CalculateJointPose(const std::map<std::string, Matrix4> &currentPose, const Joint &joint, const Matrix4 &parentTransform,
+	std::vector<Matrix4> &modelTransforms, std::vector<Matrix4> &inverseBindTransforms) {
 	auto currentLocalTransform = currentPose.find(joint.GetName())->second;
 	auto currentTransform = parentTransform * currentLocalTransform;
 
 	for (const auto &childJoint : joint.GetChildren())
-		CalculateJointPose(currentPose, childJoint, currentTransform, jointMatrices);
-
-	currentTransform = currentTransform * joint.GetInverseBindTransform();
+		CalculateJointPose(currentPose, childJoint, currentTransform, modelTransforms, inverseBindTransforms);
 
-	if (joint.GetIndex() < jointMatrices.size())
-		jointMatrices[joint.GetIndex()] = currentTransform;
+	if (joint.GetIndex() < modelTransforms.size()) {
+		modelTransforms[joint.GetIndex()] = currentTransform;
+		inverseBindTransforms[joint.GetIndex()] = joint.GetInverseBindTransform();
+	}
 }
 
 void Animator::DoAnimation(Animation *animation) {
@@ -93,7 +93,8 @@ public:
 	 * The same thing is then done to all the child joints.
 	 *
 	 * Finally the inverse of the joint's bind transform is multiplied with the
-	 * model-space transform of the joint. This basically "subtracts" the
+	 * model-space transform of the joint, this is done for every joint at once
+	 * by {@link Animator#Update}. This basically "subtracts" the
 	 * joint's original bind (no animation applied) transform from the desired
 	 * pose transform. The result of this is then the transform required to move
 	 * the joint from its original model-space transform to it's desired
@@ -103,9 +104,11 @@ public:
 	 * @param currentPose A map of the local-space transforms for all the joints for the desired pose. The map is indexed by the name of the joint which the transform corresponds to.
 	 * @param joint The current joint which the pose should be applied to.
 	 * @param parentTransform The desired model-space transform of the parent joint for the pose.
-	 * @param jointMatrices The transforms that get loaded up to the shader and is used to deform the vertices of the "skin".
+	 * @param modelTransforms The model-space transforms of the joints, indexed by joint.
+	 * @param inverseBindTransforms The inverse bind transforms of the joints, indexed by joint.
 	 */
-	static void CalculateJointPose(const std::map<std::string, Matrix4> &currentPose, const Joint &joint, const Matrix4 &parentTransform, std::vector<Matrix4> &jointMatrices);
+	static void CalculateJointPose(const std::map<std::string, Matrix4> &currentPose, const Joint &joint, const Matrix4 &parentTransform,
+		std::vector<Matrix4> &modelTransforms, std::vector<Matrix4> &inverseBindTransforms);
 
 	const Animation *GetCurrentAnimation() const { return currentAnimation; }
 
@@ -118,5 +121,6 @@ public:
 private:
 	Time animationTime;
 	Animation *currentAnimation = nullptr;
+	std::vector<Matrix4> inverseBindTransforms;
 };
 }
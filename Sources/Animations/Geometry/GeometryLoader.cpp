@@ -1,25 +1,65 @@
 #include "GeometryLoader.hpp"
 
+#include <iomanip>
+
 #include "Animations/AnimatedMesh.hpp"
+#include "Engine/Log.hpp"
+#include "Files/Xml/XmlReader.hpp"
 
 namespace acid {
-GeometryLoader::GeometryLoader(NodeConstView &&libraryGeometries, std::vector<VertexWeights> vertexWeights, const Matrix4 &correction) :
-	meshData(libraryGeometries["geometry"]["mesh"]),
+static bool FindChild(XmlReader &reader, std::string_view name) {
+	auto depth = reader.GetDepth();
+	while (reader.NextChild(depth)) {
+		if (reader.GetName() == name)
+			return true;
+	}
+	return false;
+}
+
+GeometryLoader::GeometryLoader(std::string_view document, std::vector<VertexWeights> vertexWeights, const Matrix4 &correction) :
 	vertexWeights(std::move(vertexWeights)),
 	correction(correction) {
+	XmlReader reader(document);
+
+	if (!FindChild(reader, "COLLADA") || !FindChild(reader, "library_geometries") || !FindChild(reader, "geometry") || !FindChild(reader, "mesh")) {
+		Log::Error("Collada document has no mesh\n");
+		return;
+	}
+
+	auto depth = reader.GetDepth();
+	while (reader.NextChild(depth)) {
+		if (reader.GetName() == "source")
+			ReadSource(reader);
+		else if (reader.GetName() == "vertices")
+			ReadVertices(reader);
+		else if ((reader.GetName() == "polylist" || reader.GetName() == "triangles") && primitives.empty())
+			ReadPrimitives(reader);
+	}
+
+	if (reader.GetEvent() == XmlReader::Event::Error) {
+		Log::Error("Collada document could not be read: ", reader.GetError(), '\n');
+		return;
+	}
+
+	auto vertexInput = inputs.find("VERTEX");
+	auto normalInput = inputs.find("NORMAL");
+	auto uvInput = inputs.find("TEXCOORD");
+
+	if (vertexInput == inputs.end() || normalInput == inputs.end() || uvInput == inputs.end() || vertexInput->second.source != verticesId) {
+		Log::Error("Collada mesh requires vertex, normal and texture coordinate inputs\n");
+		return;
+	}
+
 	auto positions = GetPositions();
 	auto uvs = GetUvs();
 	auto normals = GetNormals();
 
-	auto indexCount = static_cast<int32_t>(meshData.GetPropertyWithBackup("polylist", "triangles")["input"].GetProperties().size());
-	auto indexRawData = String::Split(meshData.GetPropertyWithBackup("polylist", "triangles")["p"].Get<std::string>(), ' ');
-
 	std::unordered_map<VertexAnimated, size_t> uniqueVertices;
 
-	for (uint32_t i = 0; i < indexRawData.size() / indexCount; i++) {
-		auto positionIndex = String::From<uint32_t>(indexRawData[indexCount * i]);
-		auto normalIndex = String::From<uint32_t>(indexRawData[indexCount * i + 1]);
-		auto uvIndex = String::From<uint32_t>(indexRawData[indexCount * i + 2]);
+	for (uint32_t i = 0; i < primitives.size() / stride; i++) {
+		auto positionIndex = primitives[stride * i + vertexInput->second.offset];
+		auto normalIndex = primitives[stride * i + normalInput->second.offset];
+		auto uvIndex = primitives[stride * i + uvInput->second.offset];
 
 		auto vertexWeight = this->vertexWeights[positionIndex];
 		Vector3ui jointIds(vertexWeight.GetJointIds()[0], vertexWeight.GetJointIds()[1], vertexWeight.GetJointIds()[2]);
@@ -36,17 +76,66 @@ GeometryLoader::GeometryLoader(NodeConstView &&libraryGeometries, std::vector<Ve
 	}
 }
 
+void GeometryLoader::ReadSource(XmlReader &reader) {
+	auto id = reader.GetAttribute("id");
+	auto depth = reader.GetDepth();
+
+	while (reader.NextChild(depth)) {
+		if (reader.GetName() != "float_array")
+			continue;
+
+		auto &data = sources[id];
+		data.reserve(String::From<uint32_t>(std::string(reader.GetAttribute("count"))));
+
+		if (!String::ParseNumbers(reader.ReadText(), data))
+			Log::Error("Collada source ", std::quoted(id), " has a value that is not a number\n");
+	}
+}
+
+void GeometryLoader::ReadVertices(XmlReader &reader) {
+	verticesId = reader.GetAttribute("id");
+	auto depth = reader.GetDepth();
+
+	while (reader.NextChild(depth)) {
+		if (reader.GetName() == "input" && reader.GetAttribute("semantic") == "POSITION")
+			positionsSource = reader.GetAttribute("source").substr(1);
+	}
+}
+
+void GeometryLoader::ReadPrimitives(XmlReader &reader) {
+	auto depth = reader.GetDepth();
+
+	while (reader.NextChild(depth)) {
+		if (reader.GetName() == "input") {
+			auto semantic = reader.GetAttribute("semantic");
+			auto &input = inputs[semantic];
+			input.source = reader.GetAttribute("source").substr(1);
+			input.offset = String::From<uint32_t>(std::string(reader.GetAttribute("offset")));
+			stride = std::max(stride, input.offset + 1);
+		} else if (reader.GetName() == "p") {
+			if (!String::ParseNumbers(reader.ReadText(), primitives))
+				Log::Error("Collada primitive indices have a value that is not a number\n");
+		}
+	}
+}
+
+const std::vector<float> &GeometryLoader::GetSource(std::string_view id) const {
+	static const std::vector<float> Empty;
+
+	if (auto it = sources.find(id); it != sources.end())
+		return it->second;
+	Log::Error("Collada source ", std::quoted(id), " was not found\n");
+	return Empty;
+}
+
 std::vector<Vector3f> GeometryLoader::GetPositions() const {
-	auto positionsSource = meshData["vertices"]["input"]["-source"].Get<std::string>().substr(1);
-	auto positionsData = meshData["source"].GetPropertyWithValue("-id", positionsSource)["float_array"];
-	auto positionsCount = positionsData["-count"].Get<uint32_t>();
-	auto positionsRawData = String::Split(positionsData.Get<std::string>(), ' ');
+	const auto &positionsData = GetSource(positionsSource);
 
 	std::vector<Vector3f> positions;
+	positions.reserve(positionsData.size() / 3);
 
-	for (uint32_t i = 0; i < positionsCount / 3; i++) {
-		Vector4f position(String::From<float>(positionsRawData[3 * i]), String::From<float>(positionsRawData[i * 3 + 1]),
-			String::From<float>(positionsRawData[3 * i + 2]));
+	for (uint32_t i = 0; i < positionsData.size() / 3; i++) {
+		Vector4f position(positionsData[3 * i], positionsData[3 * i + 1], positionsData[3 * i + 2]);
 		positions.emplace_back(correction.Transform(position));
 	}
 
@@ -54,15 +143,13 @@ std::vector<Vector3f> GeometryLoader::GetPositions() const {
 }
 
 std::vector<Vector2f> GeometryLoader::GetUvs() const {
-	auto uvsSource = meshData.GetPropertyWithBackup("polylist", "triangles")["input"].GetPropertyWithValue("-semantic", "TEXCOORD")["-source"].Get<std::string>().substr(1);
-	auto uvsData = meshData["source"].GetPropertyWithValue("-id", uvsSource)["float_array"];
-	auto uvsCount = uvsData["-count"].Get<uint32_t>();
-	auto uvsRawData = String::Split(uvsData.Get<std::string>(), ' ');
+	const auto &uvsData = GetSource(inputs.at("TEXCOORD").source);
 
 	std::vector<Vector2f> uvs;
+	uvs.reserve(uvsData.size() / 2);
 
-	for (uint32_t i = 0; i < uvsCount / 2; i++) {
-		Vector2f uv(String::From<float>(uvsRawData[2 * i]), 1.0f - String::From<float>(uvsRawData[2 * i + 1]));
+	for (uint32_t i = 0; i < uvsData.size() / 2; i++) {
+		Vector2f uv(uvsData[2 * i], 1.0f - uvsData[2 * i + 1]);
 		uvs.emplace_back(uv);
 	}
 
@@ -70,15 +157,13 @@ std::vector<Vector2f> GeometryLoader::GetUvs() const {
 }
 
 std::vector<Vector3f> GeometryLoader::GetNormals() const {
-	auto normalsSource = meshData.GetPropertyWithBackup("polylist", "triangles")["input"].GetPropertyWithValue("-semantic", "NORMAL")["-source"].Get<std::string>().substr(1);
-	auto normalsData = meshData["source"].GetPropertyWithValue("-id", normalsSource)["float_array"];
-	auto normalsCount = normalsData["-count"].Get<uint32_t>();
-	auto normalsRawData = String::Split(normalsData.Get<std::string>(), ' ');
+	const auto &normalsData = GetSource(inputs.at("NORMAL").source);
 
 	std::vector<Vector3f> normals;
+	normals.reserve(normalsData.size() / 3);
 
-	for (uint32_t i = 0; i < normalsCount / 3; i++) {
-		Vector4f normal(String::From<float>(normalsRawData[3 * i]), String::From<float>(normalsRawData[3 * i + 1]), String::From<float>(normalsRawData[3 * i + 2]));
+	for (uint32_t i = 0; i < normalsData.size() / 3; i++) {
+		Vector4f normal(normalsData[3 * i], normalsData[3 * i + 1], normalsData[3 * i + 2]);
 		normals.emplace_back(correction.Transform(normal));
 	}
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "Maths/Matrix4.hpp"
 #include "Maths/Vector3.hpp"
 #include "Utils/NonCopyable.hpp"
@@ -7,23 +9,59 @@
 #include "VertexAnimated.hpp"
 
 namespace acid {
+class XmlReader;
+
+/**
+ * @brief Class that loads the mesh of a COLLADA document.
+ *
+ * The geometry library is streamed with a acid::XmlReader, number arrays are parsed from the document straight into buffers
+ * without building a node tree.
+ */
 class ACID_EXPORT GeometryLoader : NonCopyable {
 public:
-	GeometryLoader(NodeConstView &&libraryGeometries, std::vector<VertexWeights> vertexWeights, const Matrix4 &correction);
+	/**
+	 * Loads the first mesh in the geometry library of a COLLADA document.
+	 * @param document The COLLADA document.
+	 * @param vertexWeights The joint weights of each position.
+	 * @param correction The correction applied to positions and normals.
+	 */
+	GeometryLoader(std::string_view document, std::vector<VertexWeights> vertexWeights, const Matrix4 &correction);
 
 	const std::vector<VertexAnimated> &GetVertices() const { return vertices; }
 	const std::vector<uint32_t> &GetIndices() const { return indices; }
 
 private:
+	/**
+	 * @brief A input of a polylist, that reads a source with a offset into each index group.
+	 */
+	class Input {
+	public:
+		std::string_view source;
+		uint32_t offset = 0;
+	};
+
+	void ReadSource(XmlReader &reader);
+	void ReadVertices(XmlReader &reader);
+	void ReadPrimitives(XmlReader &reader);
+	const std::vector<float> &GetSource(std::string_view id) const;
+
 	std::vector<Vector3f> GetPositions() const;
 	std::vector<Vector2f> GetUvs() const;
 	std::vector<Vector3f> GetNormals() const;
 
-	NodeConstView meshData;
-
 	std::vector<VertexWeights> vertexWeights;
 	Matrix4 correction;
 
+	/// Float arrays in the mesh by source id.
+	std::unordered_map<std::string_view, std::vector<float>> sources;
+	/// The vertices element id, and the source of its positions.
+	std::string_view verticesId;
+	std::string_view positionsSource;
+	/// Inputs of the polylist by semantic.
+	std::unordered_map<std::string_view, Input> inputs;
+	uint32_t stride = 0;
+	std::vector<uint32_t> primitives;
+
 	std::vector<VertexAnimated> vertices;
 	std::vector<uint32_t> indices;
 };
@@ -1,6 +1,6 @@
 #include "SkinLoader.hpp"
 
-#include "Utils/Enumerate.hpp"
+#include "Utils/String.hpp"
 
 namespace acid {
 SkinLoader::SkinLoader(NodeConstView &&libraryControllers, uint32_t maxWeights) :
@@ -26,35 +26,30 @@ std::vector<float> SkinLoader::LoadWeights() const {
 	auto weightsDataId = inputNode["input"].GetPropertyWithValue("-semantic", "WEIGHT")["-source"].Get<std::string>().substr(1);
 	auto weightsNode = skinData["source"].GetPropertyWithValue("-id", weightsDataId)["float_array"];
 
-	auto rawDatas = String::Split(weightsNode.Get<std::string>(), ' ');
-	std::vector<float> weights(rawDatas.size());
-
-	for (auto &&[i, weight] : Enumerate(weights))
-		weight = String::From<float>(rawDatas[i]);
-
+	std::vector<float> weights;
+	weights.reserve(weightsNode["-count"].Get<uint32_t>());
+	String::ParseNumbers(weightsNode.Get<std::string>(), weights);
 	return weights;
 }
 
 std::vector<uint32_t> SkinLoader::GetEffectiveJointsCounts(const Node &weightsDataNode) const {
-	auto rawData = String::Split(weightsDataNode["vcount"].Get<std::string>(), ' ');
-	std::vector<uint32_t> counts(rawData.size());
-
-	for (auto &&[i, count] : Enumerate(counts))
-		count = String::From<uint32_t>(rawData[i]);
-
+	std::vector<uint32_t> counts;
+	counts.reserve(weightsDataNode["-count"].Get<uint32_t>());
+	String::ParseNumbers(weightsDataNode["vcount"].Get<std::string>(), counts);
 	return counts;
 }
 
 void SkinLoader::GetSkinWeights(const Node &weightsDataNode, const std::vector<uint32_t> &counts, const std::vector<float> &weights) {
-	auto rawData = String::Split(weightsDataNode["v"].Get<std::string>(), ' ');
+	std::vector<uint32_t> rawData;
+	String::ParseNumbers(weightsDataNode["v"].Get<std::string>(), rawData);
 	uint32_t pointer = 0;
 
 	for (auto count : counts) {
 		VertexWeights skinData;
 
 		for (uint32_t i = 0; i < count; i++) {
-			auto jointId = String::From<uint32_t>(rawData[pointer++]);
-			auto weightId = String::From<uint32_t>(rawData[pointer++]);
+			auto jointId = rawData[pointer++];
+			auto weightId = rawData[pointer++];
 			skinData.AddJointEffect(jointId, weights[weightId]);
 		}
 
@@ -10,6 +10,7 @@
 #endif
 
 #include "Scenes/Scenes.hpp"
+#include "SoundBufferCache.hpp"
 
 namespace acid {
 struct Audio::_intern {
@@ -18,7 +19,8 @@ struct Audio::_intern {
 };
 
 Audio::Audio() :
-	impl(std::make_unique<_intern>()) {
+	impl(std::make_unique<_intern>()),
+	soundBufferCache(std::make_unique<SoundBufferCache>()) {
 	impl->device = alcOpenDevice(nullptr);
 	impl->context = alcCreateContext(impl->device, nullptr);
 	alcMakeContextCurrent(impl->context);
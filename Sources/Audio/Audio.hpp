@@ -4,6 +4,8 @@
 #include "Utils/Delegate.hpp"
 
 namespace acid {
+class SoundBufferCache;
+
 /**
  * @brief Module used for loading, managing and playing a variety of different sound types.
  */
@@ -31,10 +33,17 @@ public:
 	 */
 	Delegate<void(Type, float)> &OnGain() { return onGain; }
 
+	/**
+	 * Gets the cache of decoded sound samples shared between sound buffers.
+	 * @return The sound buffer cache.
+	 */
+	SoundBufferCache &GetSoundBufferCache() { return *soundBufferCache; }
+
 private:
 	// TODO: Only using p-impl because of signature differences from OpenAL and OpenALSoft.
 	struct _intern;
 	std::unique_ptr<_intern> impl;
+	std::unique_ptr<SoundBufferCache> soundBufferCache;
 
 	std::map<Type, float> gains;
 
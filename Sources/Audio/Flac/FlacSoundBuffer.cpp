@@ -1,34 +1,26 @@
 #include "FlacSoundBuffer.hpp"
 
-#if defined(ACID_BUILD_MACOS)
-#include <OpenAL/al.h>
-#else
-#include <al.h>
-#endif
-
 #include <dr_libs/dr_flac.h>
 
-#include "Files/Files.hpp"
+#include "Engine/Log.hpp"
 #include "Maths/Time.hpp"
 
 namespace acid {
-void FlacSoundBuffer::Load(SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
-
-	auto fileLoaded = Files::Read(filename);
-
-	if (!fileLoaded) {
-		Log::Error("SoundBuffer could not be loaded: ", filename, '\n');
-		return;
+bool FlacSoundBuffer::Load(SoundSamples &samples, std::string_view data) {
+	uint32_t channels;
+	uint32_t sampleRate;
+	drflac_uint64 totalPCMFrameCount;
+	auto sampleData = drflac_open_memory_and_read_pcm_frames_s16(data.data(), data.size(), &channels, &sampleRate, &totalPCMFrameCount, nullptr);
+	if (!sampleData) {
+		Log::Error("Error reading FLAC, could not load samples\n");
+		return false;
 	}
 
-	//soundBuffer->SetBuffer(buffer);
-
-#if defined(ACID_DEBUG)
-	Log::Out("SoundBuffer ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif
+	samples.channels = channels;
+	samples.sampleRate = sampleRate;
+	samples.data.assign(sampleData, sampleData + totalPCMFrameCount * channels);
+	drflac_free(sampleData, nullptr);
+	return true;
 }
 
 void FlacSoundBuffer::Write(const SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
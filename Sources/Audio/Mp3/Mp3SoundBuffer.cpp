@@ -1,50 +1,25 @@
 #include "Mp3SoundBuffer.hpp"
 
-#if defined(ACID_BUILD_MACOS)
-#include <OpenAL/al.h>
-#else
-#include <al.h>
-#endif
-
 #include <dr_libs/dr_mp3.h>
 
-#include "Files/Files.hpp"
+#include "Engine/Log.hpp"
 #include "Maths/Time.hpp"
 
 namespace acid {
-void Mp3SoundBuffer::Load(SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
-
-	auto fileLoaded = Files::Read(filename);
-
-	if (!fileLoaded) {
-		Log::Error("SoundBuffer could not be loaded: ", filename, '\n');
-		return;
-	}
-
+bool Mp3SoundBuffer::Load(SoundSamples &samples, std::string_view data) {
 	drmp3_config config;
 	drmp3_uint64 totalPCMFrameCount;
-	auto sampleData = drmp3_open_memory_and_read_pcm_frames_s16(fileLoaded->data(), fileLoaded->size(), &config, &totalPCMFrameCount, nullptr);
+	auto sampleData = drmp3_open_memory_and_read_pcm_frames_s16(data.data(), data.size(), &config, &totalPCMFrameCount, nullptr);
 	if (!sampleData) {
-		Log::Error("Error reading OGG ", filename, ", could not load samples\n");
-		return;
+		Log::Error("Error reading MP3, could not load samples\n");
+		return false;
 	}
 
-	uint32_t buffer;
-	alGenBuffers(1, &buffer);
-	alBufferData(buffer, (config.channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, sampleData, totalPCMFrameCount, config.sampleRate);
-
-	Audio::CheckAl(alGetError());
-
-	soundBuffer->SetBuffer(buffer);
-
+	samples.channels = config.channels;
+	samples.sampleRate = config.sampleRate;
+	samples.data.assign(sampleData, sampleData + totalPCMFrameCount * config.channels);
 	drmp3_free(sampleData, nullptr);
-
-#if defined(ACID_DEBUG)
-	Log::Out("SoundBuffer ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif
+	return true;
 }
 
 void Mp3SoundBuffer::Write(const SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
@@ -6,7 +6,7 @@ namespace acid {
 class ACID_EXPORT Mp3SoundBuffer : public SoundBuffer::Registrar<Mp3SoundBuffer> {
 	inline static const bool Registered = Register(".mp3");
 public:
-	static void Load(SoundBuffer *soundBuffer, const std::filesystem::path &filename);
+	static bool Load(SoundSamples &samples, std::string_view data);
 	static void Write(const SoundBuffer *soundBuffer, const std::filesystem::path &filename);
 };
 }
@@ -1,51 +1,27 @@
 #include "OggSoundBuffer.hpp"
 
-#if defined(ACID_BUILD_MACOS)
-#include <OpenAL/al.h>
-#else
-#include <al.h>
-#endif
-
 #include <stb/stb_vorbis.h>
 
-#include "Files/Files.hpp"
+#include "Engine/Log.hpp"
 #include "Maths/Time.hpp"
 
 namespace acid {
-void OggSoundBuffer::Load(SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
-
-	auto fileLoaded = Files::Read(filename);
-
-	if (!fileLoaded) {
-		Log::Error("SoundBuffer could not be loaded: ", filename, '\n');
-		return;
-	}
-
+bool OggSoundBuffer::Load(SoundSamples &samples, std::string_view data) {
 	int32_t channels;
 	int32_t samplesPerSec;
-	int16_t *data;
-	auto size = stb_vorbis_decode_memory(reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size()), &channels, &samplesPerSec, &data);
+	int16_t *decoded;
+	auto frames = stb_vorbis_decode_memory(reinterpret_cast<const uint8_t *>(data.data()), static_cast<int32_t>(data.size()), &channels, &samplesPerSec, &decoded);
 
-	if (size == -1) {
-		Log::Error("Error reading OGG ", filename, ", could not find size\n");
-		return;
+	if (frames == -1) {
+		Log::Error("Error reading OGG, could not find size\n");
+		return false;
 	}
 
-	uint32_t buffer;
-	alGenBuffers(1, &buffer);
-	alBufferData(buffer, (channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, data, size, samplesPerSec);
-
-	Audio::CheckAl(alGetError());
-
-	free(data);
-	soundBuffer->SetBuffer(buffer);
-	
-#if defined(ACID_DEBUG)
-	Log::Out("SoundBuffer ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif
+	samples.channels = static_cast<uint32_t>(channels);
+	samples.sampleRate = static_cast<uint32_t>(samplesPerSec);
+	samples.data.assign(decoded, decoded + static_cast<std::size_t>(frames) * channels);
+	free(decoded);
+	return true;
 }
 
 void OggSoundBuffer::Write(const SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
@@ -7,6 +7,7 @@
 #endif
 #include "Files/Files.hpp"
 #include "Resources/Resources.hpp"
+#include "SoundBufferCache.hpp"
 
 namespace acid {
 std::shared_ptr<SoundBuffer> SoundBuffer::Create(const Node &node) {
@@ -37,6 +38,20 @@ SoundBuffer::~SoundBuffer() {
 	alDeleteBuffers(1, &buffer);
 }
 
+bool SoundBuffer::IsLoaded() const {
+	return !samples.valid() || samples.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+uint32_t SoundBuffer::GetBuffer() {
+	if (samples.valid()) {
+		if (auto decoded = samples.get())
+			Upload(*decoded);
+		samples = {};
+	}
+
+	return buffer;
+}
+
 void SoundBuffer::SetBuffer(uint32_t buffer) {
 	if (this->buffer)
 		alDeleteBuffers(1, &this->buffer);
@@ -57,6 +72,18 @@ void SoundBuffer::Load() {
 	if (filename.empty())
 		return;
 
-	Registry()[filename.extension().string()].first(this, filename);
+	// Decoding is shared through the audio cache and runs on the resource thread pool, the buffer is uploaded on first use.
+	samples = Audio::Get()->GetSoundBufferCache().Decode(filename);
+}
+
+void SoundBuffer::Upload(const SoundSamples &samples) {
+	uint32_t buffer;
+	alGenBuffers(1, &buffer);
+	alBufferData(buffer, (samples.channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, samples.data.data(),
+		static_cast<int32_t>(samples.GetSize()), static_cast<int32_t>(samples.sampleRate));
+
+	Audio::CheckAl(alGetError());
+
+	SetBuffer(buffer);
 }
 }
@@ -1,16 +1,33 @@
 #pragma once
 
 #include <unordered_map>
+#include <future>
 
 #include "Maths/Vector3.hpp"
 #include "Resources/Resource.hpp"
 #include "Audio.hpp"
 
 namespace acid {
+/**
+ * @brief Decoded 16-bit PCM samples, interleaved by channel.
+ */
+class ACID_EXPORT SoundSamples {
+public:
+	/**
+	 * Gets the size of the decoded samples in bytes.
+	 * @return The size in bytes.
+	 */
+	std::size_t GetSize() const { return data.size() * sizeof(int16_t); }
+
+	uint32_t channels = 0;
+	uint32_t sampleRate = 0;
+	std::vector<int16_t> data;
+};
+
 template<typename Base>
 class SoundBufferFactory {
 public:
-	using TLoadMethod = std::function<void(Base *, const std::filesystem::path &)>;
+	using TLoadMethod = std::function<bool(SoundSamples &, std::string_view)>;
 	using TWriteMethod = std::function<void(const Base *, const std::filesystem::path &)>;
 	using TRegistryMap = std::unordered_map<std::string, std::pair<TLoadMethod, TWriteMethod>>;
 
@@ -61,8 +78,18 @@ public:
 
 	std::type_index GetTypeIndex() const override { return typeid(SoundBuffer); }
 
+	/**
+	 * Gets if the samples have finished decoding, a buffer can be retrieved without blocking.
+	 * @return If the buffer is ready.
+	 */
+	bool IsLoaded() const;
+
 	const std::filesystem::path &GetFilename() const { return filename; };
-	uint32_t GetBuffer() const { return buffer; }
+	/**
+	 * Gets the OpenAL buffer, if decoding is still running on the resource thread pool this will wait for it.
+	 * @return The OpenAL buffer.
+	 */
+	uint32_t GetBuffer();
 	void SetBuffer(uint32_t buffer);
 
 	friend const Node &operator>>(const Node &node, SoundBuffer &soundBuffer);
@@ -70,8 +97,10 @@ public:
 
 private:
 	void Load();
+	void Upload(const SoundSamples &samples);
 
 	std::filesystem::path filename;
+	std::shared_future<std::shared_ptr<const SoundSamples>> samples;
 	uint32_t buffer = 0;
 };
 }
@@ -0,0 +1,194 @@
+#include "SoundBufferCache.hpp"
+
+#include "Files/Files.hpp"
+#include "Resources/Resources.hpp"
+
+namespace acid {
+SoundBufferCache::SoundBufferCache(std::size_t budget) :
+	budget(budget) {
+}
+
+std::shared_future<SoundBufferCache::TSamples> SoundBufferCache::Decode(const std::filesystem::path &filename) {
+	auto key = filename.string();
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (auto samples = Find(key)) {
+		std::promise<TSamples> promise;
+		promise.set_value(samples);
+		return promise.get_future().share();
+	}
+
+	if (auto it = pending.find(key); it != pending.end())
+		return it->second;
+
+	if (!Resources::Get()) {
+		lock.unlock();
+		std::promise<TSamples> promise;
+		promise.set_value(DecodeNow(filename));
+		return promise.get_future().share();
+	}
+
+	// The task removes itself from pending under the same lock, so it cannot finish before it is added.
+	auto future = Resources::Get()->GetThreadPool().Enqueue([this, filename, key]() {
+		auto samples = Load(filename);
+		std::unique_lock<std::mutex> lock(mutex);
+		if (samples)
+			Insert(key, samples);
+		pending.erase(key);
+		return samples;
+	}).share();
+	pending.emplace(key, future);
+	return future;
+}
+
+SoundBufferCache::TSamples SoundBufferCache::DecodeNow(const std::filesystem::path &filename) {
+	auto key = filename.string();
+	std::shared_future<TSamples> inFlight;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (auto samples = Find(key))
+			return samples;
+		if (auto it = pending.find(key); it != pending.end())
+			inFlight = it->second;
+	}
+
+	if (inFlight.valid())
+		return inFlight.get();
+
+	auto samples = Load(filename);
+	if (samples) {
+		std::unique_lock<std::mutex> lock(mutex);
+		Insert(key, samples);
+	}
+	return samples;
+}
+
+void SoundBufferCache::SetResident(const std::filesystem::path &filename, bool resident) {
+	auto key = filename.string();
+
+	if (!resident) {
+		std::unique_lock<std::mutex> lock(mutex);
+		this->resident.erase(key);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (this->resident.find(key) != this->resident.end())
+			return;
+	}
+
+	auto fileLoaded = Files::Read(filename);
+
+	if (!fileLoaded) {
+		Log::Error("SoundBuffer could not be loaded: ", filename, '\n');
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	this->resident.emplace(key, std::make_shared<const std::string>(std::move(*fileLoaded)));
+}
+
+void SoundBufferCache::Clear() {
+	std::unique_lock<std::mutex> lock(mutex);
+	entries.clear();
+	resident.clear();
+	lru.clear();
+	size = 0;
+}
+
+void SoundBufferCache::SetBudget(std::size_t budget) {
+	std::unique_lock<std::mutex> lock(mutex);
+	this->budget = budget;
+	Evict();
+}
+
+std::size_t SoundBufferCache::GetSize() const {
+	std::unique_lock<std::mutex> lock(mutex);
+	return size;
+}
+
+SoundBufferCache::TSamples SoundBufferCache::Find(const std::string &key) {
+	auto it = entries.find(key);
+	if (it == entries.end())
+		return nullptr;
+
+	lru.splice(lru.begin(), lru, it->second.lru);
+	return it->second.samples;
+}
+
+SoundBufferCache::TSamples SoundBufferCache::Load(const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	auto &registry = SoundBuffer::Registry();
+	auto loader = registry.find(filename.extension().string());
+
+	if (loader == registry.end()) {
+		Log::Error("SoundBuffer has no decoder for extension: ", filename, '\n');
+		return nullptr;
+	}
+
+	std::shared_ptr<const std::string> fileResident;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (auto it = resident.find(filename.string()); it != resident.end())
+			fileResident = it->second;
+	}
+
+	// Files that are not resident are decoded straight from a mapping of the file.
+	std::optional<MappedFile> fileMapped;
+	std::string_view fileLoaded;
+
+	if (fileResident) {
+		fileLoaded = *fileResident;
+	} else {
+		fileMapped = Files::Map(filename);
+
+		if (!fileMapped) {
+			Log::Error("SoundBuffer could not be loaded: ", filename, '\n');
+			return nullptr;
+		}
+
+		fileLoaded = fileMapped->GetString();
+	}
+
+	auto samples = std::make_shared<SoundSamples>();
+
+	if (!loader->second.first(*samples, fileLoaded)) {
+		Log::Error("SoundBuffer could not be decoded: ", filename, '\n');
+		return nullptr;
+	}
+
+#if defined(ACID_DEBUG)
+	Log::Out("SoundBuffer ", filename, " decoded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+	return samples;
+}
+
+void SoundBufferCache::Insert(const std::string &key, const TSamples &samples) {
+	if (auto it = entries.find(key); it != entries.end()) {
+		size -= it->second.samples->GetSize();
+		lru.erase(it->second.lru);
+		entries.erase(it);
+	}
+
+	lru.emplace_front(key);
+	entries.emplace(key, Entry{samples, lru.begin()});
+	size += samples->GetSize();
+	Evict();
+}
+
+void SoundBufferCache::Evict() {
+	// The most recently used entry is always kept, even if it alone is over budget.
+	while (size > budget && lru.size() > 1) {
+		auto it = entries.find(lru.back());
+		size -= it->second.samples->GetSize();
+		entries.erase(it);
+		lru.pop_back();
+	}
+}
+}
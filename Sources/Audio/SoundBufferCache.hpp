@@ -0,0 +1,83 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <future>
+#include <unordered_map>
+
+#include "Utils/NonCopyable.hpp"
+#include "SoundBuffer.hpp"
+
+namespace acid {
+/**
+ * @brief Shared cache of decoded sound samples keyed by filename, bounded by a memory budget with least recently used eviction.
+ * Files can be marked as resident, these keep their compressed data in memory and are decoded again on demand after eviction.
+ */
+class ACID_EXPORT SoundBufferCache : NonCopyable {
+public:
+	using TSamples = std::shared_ptr<const SoundSamples>;
+
+	explicit SoundBufferCache(std::size_t budget = 64 * 1024 * 1024);
+
+	/**
+	 * Gets the decoded samples for a file, decoding on the resource thread pool if they are not cached.
+	 * Requests for a file that is already being decoded will share the same decode.
+	 * @param filename The file to decode.
+	 * @return A future that holds the samples, or nullptr if the file could not be decoded.
+	 */
+	std::shared_future<TSamples> Decode(const std::filesystem::path &filename);
+
+	/**
+	 * Gets the decoded samples for a file, decoding on the calling thread if they are not cached.
+	 * @param filename The file to decode.
+	 * @return The samples, or nullptr if the file could not be decoded.
+	 */
+	TSamples DecodeNow(const std::filesystem::path &filename);
+
+	/**
+	 * Sets if the compressed data of a file is kept in memory, when resident the file will not be read from disk again.
+	 * @param filename The file to keep resident.
+	 * @param resident If the file is resident.
+	 */
+	void SetResident(const std::filesystem::path &filename, bool resident);
+
+	/**
+	 * Removes all decoded samples and resident files.
+	 */
+	void Clear();
+
+	std::size_t GetBudget() const { return budget; }
+	/**
+	 * Sets the maximum amount of decoded sample bytes held in the cache, least recently used samples are evicted first.
+	 * @param budget The budget in bytes.
+	 */
+	void SetBudget(std::size_t budget);
+
+	/**
+	 * Gets the amount of decoded sample bytes held in the cache.
+	 * @return The size in bytes.
+	 */
+	std::size_t GetSize() const;
+
+private:
+	class Entry {
+	public:
+		TSamples samples;
+		std::list<std::string>::iterator lru;
+	};
+
+	TSamples Find(const std::string &key);
+	TSamples Load(const std::filesystem::path &filename);
+	void Insert(const std::string &key, const TSamples &samples);
+	void Evict();
+
+	mutable std::mutex mutex;
+	std::unordered_map<std::string, Entry> entries;
+	std::unordered_map<std::string, std::shared_future<TSamples>> pending;
+	std::unordered_map<std::string, std::shared_ptr<const std::string>> resident;
+	/// Keys ordered from most to least recently used.
+	std::list<std::string> lru;
+	std::size_t budget;
+	std::size_t size = 0;
+};
+}
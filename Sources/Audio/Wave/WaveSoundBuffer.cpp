@@ -1,51 +1,26 @@
 #include "WaveSoundBuffer.hpp"
 
-#if defined(ACID_BUILD_MACOS)
-#include <OpenAL/al.h>
-#else
-#include <al.h>
-#endif
-
 #include <dr_libs/dr_wav.h>
 
-#include "Files/Files.hpp"
+#include "Engine/Log.hpp"
 #include "Maths/Time.hpp"
 
 namespace acid {
-void WaveSoundBuffer::Load(SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
-
-	auto fileLoaded = Files::Read(filename);
-
-	if (!fileLoaded) {
-		Log::Error("SoundBuffer could not be loaded: ", filename, '\n');
-		return;
-	}
-
+bool WaveSoundBuffer::Load(SoundSamples &samples, std::string_view data) {
 	uint32_t channels;
 	uint32_t sampleRate;
 	drwav_uint64 totalPCMFrameCount;
-	auto sampleData = drwav_open_memory_and_read_pcm_frames_s16(fileLoaded->data(), fileLoaded->size(), &channels, &sampleRate, &totalPCMFrameCount, nullptr);
+	auto sampleData = drwav_open_memory_and_read_pcm_frames_s16(data.data(), data.size(), &channels, &sampleRate, &totalPCMFrameCount, nullptr);
 	if (!sampleData) {
-		Log::Error("Error reading OGG ", filename, ", could not load samples\n");
-		return;
+		Log::Error("Error reading WAV, could not load samples\n");
+		return false;
 	}
 
-	uint32_t buffer;
-	alGenBuffers(1, &buffer);
-	alBufferData(buffer, (channels == 2) ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, sampleData, totalPCMFrameCount, sampleRate);
-
-	Audio::CheckAl(alGetError());
-
-	soundBuffer->SetBuffer(buffer);
-	
+	samples.channels = channels;
+	samples.sampleRate = sampleRate;
+	samples.data.assign(sampleData, sampleData + totalPCMFrameCount * channels);
 	drwav_free(sampleData, nullptr);
-
-#if defined(ACID_DEBUG)
-	Log::Out("SoundBuffer ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif
+	return true;
 }
 
 void WaveSoundBuffer::Write(const SoundBuffer *soundBuffer, const std::filesystem::path &filename) {
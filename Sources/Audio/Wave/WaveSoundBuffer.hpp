@@ -6,7 +6,7 @@ namespace acid {
 class ACID_EXPORT WaveSoundBuffer : public SoundBuffer::Registrar<WaveSoundBuffer> {
 	inline static const bool Registered = Register(".wav", ".wave");
 public:
-	static void Load(SoundBuffer *soundBuffer, const std::filesystem::path &filename);
+	static bool Load(SoundSamples &samples, std::string_view data);
 	static void Write(const SoundBuffer *soundBuffer, const std::filesystem::path &filename);
 };
 }
@@ -1,15 +1,23 @@
 #include "Bitmap.hpp"
 
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
 #include <stb/stb_image.h>
 #include <stb/stb_image_write.h>
 
 #include "Engine/Log.hpp"
 #include "Files/Files.hpp"
+#include "Jpg/JpgBitmap.hpp"
+#include "Maths/Time.hpp"
+#include "Png/PngBitmap.hpp"
+#include "Utils/String.hpp"
 
 namespace acid {
-Bitmap::Bitmap(std::filesystem::path filename) :
+Bitmap::Bitmap(std::filesystem::path filename, uint32_t bytesPerPixel) :
 	filename(std::move(filename)) {
-	Load(this->filename);
+	Load(this->filename, bytesPerPixel);
 }
 
 Bitmap::Bitmap(const Vector2ui &size, uint32_t bytesPerPixel) :
@@ -24,33 +32,93 @@ Bitmap::Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, uint32_
 	bytesPerPixel(bytesPerPixel) {
 }
 
-void Bitmap::Load(const std::filesystem::path &filename) {
-	//Registry()[filename.extension().string()].first(this, filename);
+void Bitmap::Load(const std::filesystem::path &filename, uint32_t bytesPerPixel) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
 
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::Map(filename);
 
 	if (!fileLoaded) {
 		Log::Error("Bitmap could not be loaded: ", filename, '\n');
 		return;
 	}
 
-	data = std::unique_ptr<uint8_t[]>(stbi_load_from_memory(reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size()),
-		reinterpret_cast<int32_t *>(&size.x), reinterpret_cast<int32_t *>(&size.y), reinterpret_cast<int32_t *>(&bytesPerPixel), STBI_rgb_alpha));
-	bytesPerPixel = 4;
+	// The header gives the length, the pixels are then decoded straight into the bitmap.
+	this->bytesPerPixel = bytesPerPixel;
+	if (!Decode(this, filename, fileLoaded->GetData(), fileLoaded->GetSize(), nullptr)) {
+		Log::Error("Bitmap could not be decoded: ", filename, '\n');
+		return;
+	}
+
+	// A header can claim more pixels than the 32 bit length holds, allocating the wrapped length would be overrun by the decoder.
+	if (std::size_t(size.x) * size.y * this->bytesPerPixel > std::numeric_limits<uint32_t>::max()) {
+		Log::Error("Bitmap is too large to be decoded: ", filename, '\n');
+		return;
+	}
+
+	data = std::make_unique<uint8_t[]>(GetLength());
+	if (!Decode(this, filename, fileLoaded->GetData(), fileLoaded->GetSize(), data.get())) {
+		Log::Error("Bitmap could not be decoded: ", filename, '\n');
+		data = nullptr;
+		return;
+	}
+
+#if defined(ACID_DEBUG)
+	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
 }
 
 void Bitmap::Write(const std::filesystem::path &filename) const {
 	if (auto parentPath = filename.parent_path(); !parentPath.empty())
 		std::filesystem::create_directories(parentPath);
 
-	//Registry()[filename.extension().string()].second(this, filename);
+	if (auto it = Registry().find(String::Lowercase(filename.extension().string())); it != Registry().end() && it->second.second) {
+		it->second.second(this, filename);
+		return;
+	}
 
+	// Every other extension is written as a PNG.
 	std::ofstream os(filename, std::ios::binary | std::ios::out);
 	int32_t len;
-	std::unique_ptr<uint8_t[]> png(stbi_write_png_to_mem(data.get(), size.x * bytesPerPixel, size.x, size.y, bytesPerPixel, &len));
+	std::unique_ptr<uint8_t, decltype(&std::free)> png(stbi_write_png_to_mem(data.get(), size.x * bytesPerPixel, size.x, size.y, bytesPerPixel, &len), std::free);
+	if (!png)
+		return;
 	os.write(reinterpret_cast<char *>(png.get()), len);
 }
 
+std::optional<Vector2ui> Bitmap::LoadSize(const std::filesystem::path &filename) {
+	auto fileLoaded = Files::Map(filename);
+
+	Bitmap bitmap;
+	bitmap.bytesPerPixel = 4;
+	if (!fileLoaded || !Decode(&bitmap, filename, fileLoaded->GetData(), fileLoaded->GetSize(), nullptr)) {
+		Log::Error("Bitmap could not be loaded: ", filename, '\n');
+		return std::nullopt;
+	}
+
+	return bitmap.size;
+}
+
+bool Bitmap::LoadPixels(const std::filesystem::path &filename, uint8_t *pixels, const Vector2ui &size) {
+	auto fileLoaded = Files::Map(filename);
+
+	if (!fileLoaded) {
+		Log::Error("Bitmap could not be loaded: ", filename, '\n');
+		return false;
+	}
+
+	Bitmap bitmap;
+	bitmap.bytesPerPixel = 4;
+	if (!Decode(&bitmap, filename, fileLoaded->GetData(), fileLoaded->GetSize(), nullptr) || bitmap.size != size ||
+		!Decode(&bitmap, filename, fileLoaded->GetData(), fileLoaded->GetSize(), pixels)) {
+		Log::Error("Bitmap ", filename, " could not be decoded with the size ", size, '\n');
+		return false;
+	}
+
+	return true;
+}
+
 uint32_t Bitmap::GetLength() const {
 	return size.x * size.y * bytesPerPixel;
 }
@@ -58,4 +126,36 @@ uint32_t Bitmap::GetLength() const {
 uint32_t Bitmap::CalculateLength(const Vector2ui &size, uint32_t bytesPerPixel) {
 	return size.x * size.y * bytesPerPixel;
 }
+
+bool Bitmap::Decode(Bitmap *bitmap, const std::filesystem::path &filename, const uint8_t *file, std::size_t length, uint8_t *pixels) {
+	auto requestedBytesPerPixel = bitmap->bytesPerPixel;
+
+	if (auto it = Registry().find(String::Lowercase(filename.extension().string())); it != Registry().end() && it->second.first) {
+		if (it->second.first(bitmap, file, length, pixels))
+			return true;
+		bitmap->bytesPerPixel = requestedBytesPerPixel;
+	}
+
+	// stb_image decodes every other format, and the files a registered decoder does not support.
+	Vector2i loadedSize;
+	int32_t channels;
+	if (!stbi_info_from_memory(file, static_cast<int32_t>(length), &loadedSize.x, &loadedSize.y, &channels))
+		return false;
+
+	bitmap->size = Vector2ui(loadedSize);
+	bitmap->bytesPerPixel = requestedBytesPerPixel == 0 ? static_cast<uint32_t>(channels) : requestedBytesPerPixel;
+
+	if (!pixels)
+		return true;
+
+	// stb_image allocates the pixels it decodes, they are copied out once.
+	std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> data(stbi_load_from_memory(file, static_cast<int32_t>(length),
+		&loadedSize.x, &loadedSize.y, &channels, static_cast<int32_t>(bitmap->bytesPerPixel)), stbi_image_free);
+
+	if (!data || Vector2ui(loadedSize) != bitmap->size)
+		return false;
+
+	std::memcpy(pixels, data.get(), bitmap->GetLength());
+	return true;
+}
 }
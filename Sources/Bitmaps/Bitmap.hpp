@@ -2,14 +2,23 @@
 
 #include <unordered_map>
 #include <functional>
+#include <optional>
 
 #include "Maths/Vector2.hpp"
 
 namespace acid {
+/**
+ * @brief Registry of the bitmap decoders and encoders, found by file extension.
+ *
+ * A load method is given the bitmap, with the bytes per pixel it is asked for or 0 to keep the channels of the file, and the
+ * file in memory. It sets the size and bytes per pixel from the header, and if given pixels decodes into them with rows tightly
+ * packed. It returns false if the file cannot be decoded, those files are decoded by stb_image instead.
+ * @tparam Base The bitmap type.
+ */
 template<typename Base>
 class BitmapFactory {
 public:
-	using TLoadMethod = std::function<void(Base *, const std::filesystem::path &)>;
+	using TLoadMethod = std::function<bool(Base *, const uint8_t *, std::size_t, uint8_t *)>;
 	using TWriteMethod = std::function<void(const Base *, const std::filesystem::path &)>;
 	using TRegistryMap = std::unordered_map<std::string, std::pair<TLoadMethod, TWriteMethod>>;
 
@@ -35,15 +44,40 @@ public:
 class ACID_EXPORT Bitmap : public BitmapFactory<Bitmap> {
 public:
 	Bitmap() = default;
-	explicit Bitmap(std::filesystem::path filename);
+	/**
+	 * Creates a new bitmap decoded from a file.
+	 * @param filename The file to decode.
+	 * @param bytesPerPixel The bytes per pixel to decode to, 4 for RGBA8 or 0 to keep 1, 2 or 3 channels when the file has them.
+	 */
+	explicit Bitmap(std::filesystem::path filename, uint32_t bytesPerPixel = 4);
 	explicit Bitmap(const Vector2ui &size, uint32_t bytesPerPixel = 4);
 	Bitmap(std::unique_ptr<uint8_t[]> &&data, const Vector2ui &size, uint32_t bytesPerPixel = 4);
 	~Bitmap() = default;
 
-	void Load(const std::filesystem::path &filename);
+	/**
+	 * Decodes a file with the decoder registered for its extension, or stb_image if there is none or it fails.
+	 * @param filename The file to decode.
+	 * @param bytesPerPixel The bytes per pixel to decode to, 4 for RGBA8 or 0 to keep 1, 2 or 3 channels when the file has them.
+	 */
+	void Load(const std::filesystem::path &filename, uint32_t bytesPerPixel = 4);
 	void Write(const std::filesystem::path &filename) const;
 
-	explicit operator bool() const noexcept { return !data; }
+	/**
+	 * Reads the size of an image from its header, without decoding the pixels.
+	 * @param filename The file to read.
+	 * @return The size in pixels, or std::nullopt if the file could not be read.
+	 */
+	static std::optional<Vector2ui> LoadSize(const std::filesystem::path &filename);
+	/**
+	 * Decodes an image as RGBA8 into memory owned by the caller, such as a mapped staging buffer.
+	 * @param filename The file to decode.
+	 * @param pixels The pixels to write, with room for the size of the image.
+	 * @param size The size the image is expected to have.
+	 * @return If the image was decoded with the expected size.
+	 */
+	static bool LoadPixels(const std::filesystem::path &filename, uint8_t *pixels, const Vector2ui &size);
+
+	explicit operator bool() const noexcept { return data != nullptr; }
 
 	uint32_t GetLength() const;
 
@@ -62,6 +96,16 @@ public:
 
 private:
 	static uint32_t CalculateLength(const Vector2ui &size, uint32_t bytesPerPixel);
+	/**
+	 * Decodes a file in memory with the decoder registered for its extension, or stb_image.
+	 * @param bitmap The bitmap to set the size and bytes per pixel of, holding the bytes per pixel asked for.
+	 * @param filename The file, used to find the decoder.
+	 * @param file The file in memory.
+	 * @param length The length of the file.
+	 * @param pixels The pixels to write, or nullptr to only read the header.
+	 * @return If the file was decoded.
+	 */
+	static bool Decode(Bitmap *bitmap, const std::filesystem::path &filename, const uint8_t *file, std::size_t length, uint8_t *pixels);
 	
 	std::filesystem::path filename;
 	std::unique_ptr<uint8_t[]> data;
@@ -0,0 +1,825 @@
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace acid {
+/**
+ * @brief The layout of a BC7 mode.
+ */
+class Bc7Mode {
+public:
+	uint32_t subsets;
+	uint32_t partitionBits;
+	uint32_t rotationBits;
+	uint32_t indexSelectionBits;
+	uint32_t colourBits;
+	uint32_t alphaBits;
+	uint32_t endpointPBits;
+	uint32_t sharedPBits;
+	uint32_t indexBits;
+	uint32_t secondaryIndexBits;
+};
+
+static constexpr std::array<Bc7Mode, 8> Bc7Modes = {{
+	{3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+	{2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+	{3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+	{2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+	{1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+	{1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+	{1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+	{2, 6, 0, 0, 5, 5, 1, 0, 2, 0}
+}};
+
+/// Two subset partitions, bit i is the subset of pixel i.
+static constexpr std::array<uint16_t, 64> Bc7Partitions2 = {
+	0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+	0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+	0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+	0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22
+};
+
+/// Three subset partitions, 2 bits per pixel with pixel i at bit 2i.
+static constexpr std::array<uint32_t, 64> Bc7Partitions3 = {
+	0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+	0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+	0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+	0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+	0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+	0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+	0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+	0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254
+};
+
+/// The pixel of the second subset, in two subset partitions, that stores its index with one less bit.
+static constexpr std::array<uint8_t, 64> Bc7Anchors2 = {
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+	15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+	6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+};
+
+/// The anchor pixels of the second and third subsets in three subset partitions.
+static constexpr std::array<uint8_t, 64> Bc7Anchors3Second = {
+	3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+	3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+	8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+	3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3
+};
+
+static constexpr std::array<uint8_t, 64> Bc7Anchors3Third = {
+	15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+	15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+	15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+	15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8
+};
+
+static constexpr std::array<uint8_t, 4> Bc7Weights2 = {0, 21, 43, 64};
+static constexpr std::array<uint8_t, 8> Bc7Weights3 = {0, 9, 18, 27, 37, 46, 55, 64};
+static constexpr std::array<uint8_t, 16> Bc7Weights4 = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/**
+ * @brief Reads bits from a 128 bit block, starting at the lowest bit of the first byte.
+ */
+class BlockBitReader {
+public:
+	explicit BlockBitReader(const uint8_t *block) {
+		for (uint32_t i = 0; i < 8; i++) {
+			low |= static_cast<uint64_t>(block[i]) << (8 * i);
+			high |= static_cast<uint64_t>(block[8 + i]) << (8 * i);
+		}
+	}
+
+	uint32_t Read(uint32_t count) {
+		uint32_t value = 0;
+
+		for (uint32_t i = 0; i < count; i++, position++) {
+			auto bit = position < 64 ? (low >> position) & 1 : (high >> (position - 64)) & 1;
+			value |= static_cast<uint32_t>(bit) << i;
+		}
+
+		return value;
+	}
+
+private:
+	uint64_t low = 0;
+	uint64_t high = 0;
+	uint32_t position = 0;
+};
+
+/**
+ * @brief Writes bits to a 128 bit block, starting at the lowest bit of the first byte.
+ */
+class BlockBitWriter {
+public:
+	explicit BlockBitWriter(uint8_t *block) :
+		block(block) {
+		std::memset(block, 0, 16);
+	}
+
+	void Write(uint32_t value, uint32_t count) {
+		for (uint32_t i = 0; i < count; i++, position++) {
+			if ((value >> i) & 1)
+				block[position / 8] |= static_cast<uint8_t>(1 << (position % 8));
+		}
+	}
+
+private:
+	uint8_t *block;
+	uint32_t position = 0;
+};
+
+static uint8_t Bc7Interpolate(uint32_t e0, uint32_t e1, uint32_t indexBits, uint32_t index) {
+	auto weight = indexBits == 2 ? Bc7Weights2[index] : indexBits == 3 ? Bc7Weights3[index] : Bc7Weights4[index];
+	return static_cast<uint8_t>(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+}
+
+/**
+ * Finds the endpoints of a line through the pixels, along the axis they vary the most, from the pixels furthest along it.
+ * The axis is found by power iteration on the covariance of the pixels.
+ * @tparam Channels The number of channels of each pixel to fit.
+ * @param pixels The 16 RGBA8 pixels to fit.
+ * @param endpoints The endpoints to write, the first has the lowest projection on the axis.
+ */
+template<uint32_t Channels>
+static void FitEndpoints(const uint8_t *pixels, float (&endpoints)[2][4]) {
+	float mean[Channels] = {};
+	for (uint32_t i = 0; i < 16; i++) {
+		for (uint32_t channel = 0; channel < Channels; channel++)
+			mean[channel] += pixels[4 * i + channel] / 16.0f;
+	}
+
+	float covariance[Channels][Channels] = {};
+	for (uint32_t i = 0; i < 16; i++) {
+		for (uint32_t a = 0; a < Channels; a++) {
+			for (uint32_t b = 0; b < Channels; b++)
+				covariance[a][b] += (pixels[4 * i + a] - mean[a]) * (pixels[4 * i + b] - mean[b]);
+		}
+	}
+
+	// Starting from the row with the largest variance avoids starting orthogonal to the axis.
+	uint32_t largest = 0;
+	for (uint32_t channel = 1; channel < Channels; channel++) {
+		if (covariance[channel][channel] > covariance[largest][largest])
+			largest = channel;
+	}
+
+	float axis[Channels];
+	std::copy(std::begin(covariance[largest]), std::end(covariance[largest]), axis);
+
+	for (uint32_t iteration = 0; iteration < 8; iteration++) {
+		float next[Channels] = {};
+		auto length = 0.0f;
+
+		for (uint32_t a = 0; a < Channels; a++) {
+			for (uint32_t b = 0; b < Channels; b++)
+				next[a] += covariance[a][b] * axis[b];
+			length = std::max(length, std::abs(next[a]));
+		}
+
+		if (length == 0.0f)
+			break;
+
+		for (uint32_t channel = 0; channel < Channels; channel++)
+			axis[channel] = next[channel] / length;
+	}
+
+	auto minimum = std::numeric_limits<float>::max(), maximum = std::numeric_limits<float>::lowest();
+	uint32_t minimumPixel = 0, maximumPixel = 0;
+	for (uint32_t i = 0; i < 16; i++) {
+		auto projection = 0.0f;
+		for (uint32_t channel = 0; channel < Channels; channel++)
+			projection += pixels[4 * i + channel] * axis[channel];
+
+		if (projection < minimum) {
+			minimum = projection;
+			minimumPixel = i;
+		}
+		if (projection > maximum) {
+			maximum = projection;
+			maximumPixel = i;
+		}
+	}
+
+	for (uint32_t channel = 0; channel < Channels; channel++) {
+		endpoints[0][channel] = pixels[4 * minimumPixel + channel];
+		endpoints[1][channel] = pixels[4 * maximumPixel + channel];
+	}
+}
+
+/**
+ * Refits endpoints to the pixels by least squares, keeping the weight each pixel has of the second endpoint.
+ * @tparam Channels The number of channels of each pixel to fit.
+ * @param pixels The 16 RGBA8 pixels to fit.
+ * @param weights The weight of the second endpoint for each pixel.
+ * @param endpoints The endpoints to write.
+ * @return If the endpoints could be refit, false when every pixel has the same weight.
+ */
+template<uint32_t Channels>
+static bool RefineEndpoints(const uint8_t *pixels, const float *weights, float (&endpoints)[2][4]) {
+	auto a = 0.0f, b = 0.0f, c = 0.0f;
+	float x[Channels] = {}, y[Channels] = {};
+
+	for (uint32_t i = 0; i < 16; i++) {
+		auto w = weights[i], v = 1.0f - w;
+		a += v * v;
+		b += v * w;
+		c += w * w;
+
+		for (uint32_t channel = 0; channel < Channels; channel++) {
+			x[channel] += v * pixels[4 * i + channel];
+			y[channel] += w * pixels[4 * i + channel];
+		}
+	}
+
+	auto determinant = a * c - b * b;
+	if (std::abs(determinant) < 1e-6f)
+		return false;
+
+	for (uint32_t channel = 0; channel < Channels; channel++) {
+		endpoints[0][channel] = std::clamp((c * x[channel] - b * y[channel]) / determinant, 0.0f, 255.0f);
+		endpoints[1][channel] = std::clamp((a * y[channel] - b * x[channel]) / determinant, 0.0f, 255.0f);
+	}
+
+	return true;
+}
+
+static uint16_t PackRgb565(const float *colour) {
+	auto r = static_cast<uint32_t>(std::lround(colour[0] * 31.0f / 255.0f));
+	auto g = static_cast<uint32_t>(std::lround(colour[1] * 63.0f / 255.0f));
+	auto b = static_cast<uint32_t>(std::lround(colour[2] * 31.0f / 255.0f));
+	return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+static void UnpackRgb565(uint32_t colour, uint8_t *rgb) {
+	auto r = (colour >> 11) & 0x1f, g = (colour >> 5) & 0x3f, b = colour & 0x1f;
+	rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+	rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+	rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+}
+
+/**
+ * Selects the four colour palette entry closest to each pixel.
+ * @param pixels The 16 RGBA8 pixels.
+ * @param colours The RGB565 endpoints, the first greater than the second unless they are equal.
+ * @param indices The 2 bit indices to write.
+ * @return The squared error of the block.
+ */
+static uint32_t FitColourIndices(const uint8_t *pixels, const uint16_t (&colours)[2], uint32_t &indices) {
+	uint8_t palette[4][3];
+	UnpackRgb565(colours[0], palette[0]);
+	UnpackRgb565(colours[1], palette[1]);
+	for (uint32_t channel = 0; channel < 3; channel++) {
+		palette[2][channel] = static_cast<uint8_t>((2 * palette[0][channel] + palette[1][channel]) / 3);
+		palette[3][channel] = static_cast<uint8_t>((palette[0][channel] + 2 * palette[1][channel]) / 3);
+	}
+
+	// Equal endpoints decode BC1 as three colours and black, only the first colour is used.
+	auto paletteSize = colours[0] == colours[1] ? 1u : 4u;
+	uint32_t error = 0;
+	indices = 0;
+
+	for (uint32_t i = 0; i < 16; i++) {
+		uint32_t bestIndex = 0, bestError = std::numeric_limits<uint32_t>::max();
+
+		for (uint32_t index = 0; index < paletteSize; index++) {
+			uint32_t indexError = 0;
+			for (uint32_t channel = 0; channel < 3; channel++) {
+				auto difference = static_cast<int32_t>(pixels[4 * i + channel]) - palette[index][channel];
+				indexError += difference * difference;
+			}
+
+			if (indexError < bestError) {
+				bestError = indexError;
+				bestIndex = index;
+			}
+		}
+
+		indices |= bestIndex << (2 * i);
+		error += bestError;
+	}
+
+	return error;
+}
+
+/**
+ * Quantizes a BC7 mode 6 endpoint to 7 bits per channel and a p-bit, choosing the p-bit with the least error.
+ * @param endpoint The RGBA endpoint to quantize.
+ * @param quantized The 7 bit channels to write.
+ * @return The p-bit.
+ */
+static uint32_t QuantizeBc7Endpoint(const float *endpoint, uint32_t (&quantized)[4]) {
+	uint32_t bestPBit = 0;
+	auto bestError = std::numeric_limits<float>::max();
+
+	for (uint32_t pBit = 0; pBit < 2; pBit++) {
+		auto error = 0.0f;
+		for (uint32_t channel = 0; channel < 4; channel++) {
+			auto value = std::clamp(std::lround((endpoint[channel] - pBit) / 2.0f), 0l, 127l);
+			auto difference = static_cast<float>(2 * value + pBit) - endpoint[channel];
+			error += difference * difference;
+		}
+
+		if (error < bestError) {
+			bestError = error;
+			bestPBit = pBit;
+		}
+	}
+
+	for (uint32_t channel = 0; channel < 4; channel++)
+		quantized[channel] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[channel] - bestPBit) / 2.0f), 0l, 127l));
+	return bestPBit;
+}
+
+/**
+ * Selects the BC7 index closest to each pixel, from the projection of the pixel on the endpoints and its neighbours.
+ * @tparam Channels The number of channels of each pixel to fit.
+ * @param pixels The 16 RGBA8 pixels.
+ * @param endpoints The expanded endpoints.
+ * @param indexBits The number of bits of each index.
+ * @param indices The 16 indices to write.
+ * @return The squared error of the block.
+ */
+template<uint32_t Channels>
+static uint32_t FitBc7Indices(const uint8_t *pixels, const uint32_t (&endpoints)[2][4], uint32_t indexBits, uint32_t (&indices)[16]) {
+	auto maxIndex = static_cast<int32_t>((1 << indexBits) - 1);
+	int32_t direction[Channels];
+	auto lengthSquared = 0;
+	for (uint32_t channel = 0; channel < Channels; channel++) {
+		direction[channel] = static_cast<int32_t>(endpoints[1][channel]) - static_cast<int32_t>(endpoints[0][channel]);
+		lengthSquared += direction[channel] * direction[channel];
+	}
+
+	uint32_t error = 0;
+
+	for (uint32_t i = 0; i < 16; i++) {
+		auto projection = 0;
+		for (uint32_t channel = 0; channel < Channels; channel++)
+			projection += (pixels[4 * i + channel] - static_cast<int32_t>(endpoints[0][channel])) * direction[channel];
+
+		auto guess = lengthSquared ? std::clamp(static_cast<int32_t>(std::lround(static_cast<float>(maxIndex) * projection / lengthSquared)), 0, maxIndex) : 0;
+		uint32_t bestIndex = 0, bestError = std::numeric_limits<uint32_t>::max();
+
+		for (auto index = std::max(guess - 1, 0); index <= std::min(guess + 1, maxIndex); index++) {
+			uint32_t indexError = 0;
+			for (uint32_t channel = 0; channel < Channels; channel++) {
+				auto difference = static_cast<int32_t>(pixels[4 * i + channel]) - Bc7Interpolate(endpoints[0][channel], endpoints[1][channel], indexBits, index);
+				indexError += difference * difference;
+			}
+
+			if (indexError < bestError) {
+				bestError = indexError;
+				bestIndex = static_cast<uint32_t>(index);
+			}
+		}
+
+		indices[i] = bestIndex;
+		error += bestError;
+	}
+
+	return error;
+}
+
+static float Bc7Weight(uint32_t indexBits, uint32_t index) {
+	return (indexBits == 2 ? Bc7Weights2[index] : Bc7Weights4[index]) / 64.0f;
+}
+
+/**
+ * Fits endpoints and indices of a BC7 endpoint pair to the pixels, refining the endpoints by least squares.
+ * @tparam Channels The number of channels of each pixel to fit.
+ * @param pixels The 16 RGBA8 pixels.
+ * @param bits The number of bits of each endpoint channel, not counting the p-bit.
+ * @param pBit If the endpoints have a p-bit.
+ * @param indexBits The number of bits of each index.
+ * @param quantized The endpoint channels to write.
+ * @param pBits The p-bits to write.
+ * @param indices The indices to write, with the highest bit of the first index zero.
+ */
+template<uint32_t Channels>
+static void FitBc7Endpoints(const uint8_t *pixels, uint32_t bits, bool pBit, uint32_t indexBits, uint32_t (&quantized)[2][4], uint32_t (&pBits)[2],
+	uint32_t (&indices)[16]) {
+	float endpoints[2][4];
+	FitEndpoints<Channels>(pixels, endpoints);
+	auto bestError = std::numeric_limits<uint32_t>::max();
+
+	for (uint32_t iteration = 0; iteration < 3; iteration++) {
+		uint32_t iterationQuantized[2][4] = {}, iterationPBits[2] = {}, expanded[2][4] = {};
+		for (uint32_t endpoint = 0; endpoint < 2; endpoint++) {
+			if (pBit) {
+				iterationPBits[endpoint] = QuantizeBc7Endpoint(endpoints[endpoint], iterationQuantized[endpoint]);
+				for (uint32_t channel = 0; channel < Channels; channel++)
+					expanded[endpoint][channel] = 2 * iterationQuantized[endpoint][channel] + iterationPBits[endpoint];
+				continue;
+			}
+
+			for (uint32_t channel = 0; channel < Channels; channel++) {
+				auto maximum = static_cast<float>((1 << bits) - 1);
+				auto value = static_cast<uint32_t>(std::lround(endpoints[endpoint][channel] * maximum / 255.0f));
+				iterationQuantized[endpoint][channel] = value;
+				expanded[endpoint][channel] = ((value << (8 - bits)) | (value >> (2 * bits - 8))) & 0xff;
+			}
+		}
+
+		uint32_t iterationIndices[16];
+		auto error = FitBc7Indices<Channels>(pixels, expanded, indexBits, iterationIndices);
+		if (error < bestError) {
+			bestError = error;
+			std::memcpy(quantized, iterationQuantized, sizeof(quantized));
+			std::memcpy(pBits, iterationPBits, sizeof(pBits));
+			std::memcpy(indices, iterationIndices, sizeof(indices));
+		}
+
+		if (error == 0)
+			break;
+
+		float weights[16];
+		for (uint32_t i = 0; i < 16; i++)
+			weights[i] = Bc7Weight(indexBits, iterationIndices[i]);
+		if (!RefineEndpoints<Channels>(pixels, weights, endpoints))
+			break;
+	}
+
+	// The index of the first pixel is stored without its highest bit, the weights are symmetric so the endpoints can be swapped.
+	auto maxIndex = (1u << indexBits) - 1;
+	if (indices[0] > maxIndex / 2) {
+		std::swap(quantized[0], quantized[1]);
+		std::swap(pBits[0], pBits[1]);
+		for (auto &index : indices)
+			index = maxIndex - index;
+	}
+}
+
+static uint32_t BlockError(const uint8_t *pixels, const uint8_t *block) {
+	uint8_t decoded[64];
+	BlockCompression::DecodeBc7(block, decoded);
+	uint32_t error = 0;
+	for (uint32_t i = 0; i < 64; i++) {
+		auto difference = static_cast<int32_t>(pixels[i]) - decoded[i];
+		error += difference * difference;
+	}
+	return error;
+}
+
+void BlockCompression::DecodeBc1(const uint8_t *block, uint8_t *pixels, bool alpha) {
+	DecodeColour(block, pixels, true, alpha);
+}
+
+void BlockCompression::DecodeBc2(const uint8_t *block, uint8_t *pixels) {
+	DecodeColour(block + 8, pixels, false, false);
+
+	for (uint32_t i = 0; i < 16; i++) {
+		auto value = (block[i / 2] >> (4 * (i % 2))) & 0xf;
+		pixels[4 * i + 3] = static_cast<uint8_t>(value * 17);
+	}
+}
+
+void BlockCompression::DecodeBc3(const uint8_t *block, uint8_t *pixels) {
+	DecodeColour(block + 8, pixels, false, false);
+	DecodeChannel(block, pixels + 3);
+}
+
+void BlockCompression::DecodeBc4(const uint8_t *block, uint8_t *pixels) {
+	DecodeChannel(block, pixels);
+
+	for (uint32_t i = 0; i < 16; i++) {
+		pixels[4 * i + 1] = 0;
+		pixels[4 * i + 2] = 0;
+		pixels[4 * i + 3] = 255;
+	}
+}
+
+void BlockCompression::DecodeBc5(const uint8_t *block, uint8_t *pixels) {
+	DecodeChannel(block, pixels);
+	DecodeChannel(block + 8, pixels + 1);
+
+	for (uint32_t i = 0; i < 16; i++) {
+		pixels[4 * i + 2] = 0;
+		pixels[4 * i + 3] = 255;
+	}
+}
+
+void BlockCompression::DecodeBc7(const uint8_t *block, uint8_t *pixels) {
+	// The mode is the number of zero bits before the first set bit.
+	uint32_t mode = 0;
+	while (mode < 8 && !(block[0] & (1 << mode)))
+		mode++;
+
+	if (mode == 8) {
+		std::memset(pixels, 0, 64);
+		return;
+	}
+
+	const auto &info = Bc7Modes[mode];
+	BlockBitReader reader(block);
+	reader.Read(mode + 1);
+	auto partition = reader.Read(info.partitionBits);
+	auto rotation = reader.Read(info.rotationBits);
+	auto indexSelection = reader.Read(info.indexSelectionBits);
+
+	// Endpoints are stored channel by channel, each channel with the endpoints of every subset in order.
+	uint32_t endpoints[3][2][4] = {};
+	for (uint32_t channel = 0; channel < 3; channel++) {
+		for (uint32_t subset = 0; subset < info.subsets; subset++) {
+			endpoints[subset][0][channel] = reader.Read(info.colourBits);
+			endpoints[subset][1][channel] = reader.Read(info.colourBits);
+		}
+	}
+
+	if (info.alphaBits) {
+		for (uint32_t subset = 0; subset < info.subsets; subset++) {
+			endpoints[subset][0][3] = reader.Read(info.alphaBits);
+			endpoints[subset][1][3] = reader.Read(info.alphaBits);
+		}
+	}
+
+	uint32_t pBits[3][2] = {};
+	for (uint32_t subset = 0; subset < info.subsets; subset++) {
+		if (info.endpointPBits) {
+			pBits[subset][0] = reader.Read(1);
+			pBits[subset][1] = reader.Read(1);
+		} else if (info.sharedPBits) {
+			pBits[subset][0] = pBits[subset][1] = reader.Read(1);
+		}
+	}
+
+	// Endpoints are expanded to 8 bits, with the p-bit as their lowest bit, by repeating their highest bits.
+	auto hasPBits = info.endpointPBits || info.sharedPBits;
+	for (uint32_t subset = 0; subset < info.subsets; subset++) {
+		for (uint32_t endpoint = 0; endpoint < 2; endpoint++) {
+			for (uint32_t channel = 0; channel < 4; channel++) {
+				auto bits = channel < 3 ? info.colourBits : info.alphaBits;
+				auto &value = endpoints[subset][endpoint][channel];
+
+				if (bits == 0) {
+					value = 255;
+					continue;
+				}
+
+				if (hasPBits) {
+					value = (value << 1) | pBits[subset][endpoint];
+					bits++;
+				}
+
+				value <<= 8 - bits;
+				value |= value >> bits;
+			}
+		}
+	}
+
+	auto subsetOf = [&](uint32_t pixel) -> uint32_t {
+		if (info.subsets == 2)
+			return (Bc7Partitions2[partition] >> pixel) & 1;
+		if (info.subsets == 3)
+			return (Bc7Partitions3[partition] >> (2 * pixel)) & 3;
+		return 0;
+	};
+
+	// The anchor pixel of each subset stores its index with one less bit, the highest bit is zero.
+	auto isAnchor = [&](uint32_t pixel) {
+		if (pixel == 0)
+			return true;
+		if (info.subsets == 2)
+			return pixel == Bc7Anchors2[partition];
+		if (info.subsets == 3)
+			return pixel == Bc7Anchors3Second[partition] || pixel == Bc7Anchors3Third[partition];
+		return false;
+	};
+
+	uint32_t indices[16];
+	uint32_t secondaryIndices[16] = {};
+	for (uint32_t i = 0; i < 16; i++)
+		indices[i] = reader.Read(isAnchor(i) ? info.indexBits - 1 : info.indexBits);
+	if (info.secondaryIndexBits) {
+		for (uint32_t i = 0; i < 16; i++)
+			secondaryIndices[i] = reader.Read(i == 0 ? info.secondaryIndexBits - 1 : info.secondaryIndexBits);
+	}
+
+	for (uint32_t i = 0; i < 16; i++) {
+		const auto &e = endpoints[subsetOf(i)];
+		auto colourBits = info.indexBits, colourIndex = indices[i];
+		auto alphaBits = info.indexBits, alphaIndex = indices[i];
+
+		// Modes with two sets of indices use the secondary indices for alpha, unless the index selection swaps them.
+		if (info.secondaryIndexBits) {
+			if (indexSelection) {
+				colourBits = info.secondaryIndexBits;
+				colourIndex = secondaryIndices[i];
+			} else {
+				alphaBits = info.secondaryIndexBits;
+				alphaIndex = secondaryIndices[i];
+			}
+		}
+
+		auto pixel = pixels + 4 * i;
+		for (uint32_t channel = 0; channel < 3; channel++)
+			pixel[channel] = Bc7Interpolate(e[0][channel], e[1][channel], colourBits, colourIndex);
+		pixel[3] = Bc7Interpolate(e[0][3], e[1][3], alphaBits, alphaIndex);
+
+		if (rotation)
+			std::swap(pixel[3], pixel[rotation - 1]);
+	}
+}
+
+void BlockCompression::DecodeColour(const uint8_t *block, uint8_t *pixels, bool threeColour, bool alpha) {
+	uint32_t colours[2] = {
+		static_cast<uint32_t>(block[0] | block[1] << 8),
+		static_cast<uint32_t>(block[2] | block[3] << 8)
+	};
+
+	uint8_t palette[4][4];
+	for (uint32_t i = 0; i < 2; i++) {
+		UnpackRgb565(colours[i], palette[i]);
+		palette[i][3] = 255;
+	}
+
+	// A first colour not greater than the second selects three colours and black.
+	if (colours[0] > colours[1] || !threeColour) {
+		for (uint32_t channel = 0; channel < 3; channel++) {
+			palette[2][channel] = static_cast<uint8_t>((2 * palette[0][channel] + palette[1][channel]) / 3);
+			palette[3][channel] = static_cast<uint8_t>((palette[0][channel] + 2 * palette[1][channel]) / 3);
+		}
+		palette[2][3] = palette[3][3] = 255;
+	} else {
+		for (uint32_t channel = 0; channel < 3; channel++) {
+			palette[2][channel] = static_cast<uint8_t>((palette[0][channel] + palette[1][channel]) / 2);
+			palette[3][channel] = 0;
+		}
+		palette[2][3] = 255;
+		palette[3][3] = alpha ? 0 : 255;
+	}
+
+	auto indices = static_cast<uint32_t>(block[4] | block[5] << 8 | block[6] << 16 | block[7] << 24);
+	for (uint32_t i = 0; i < 16; i++)
+		std::memcpy(pixels + 4 * i, palette[(indices >> (2 * i)) & 3], 4);
+}
+
+void BlockCompression::DecodeChannel(const uint8_t *block, uint8_t *pixels) {
+	uint32_t values[8] = {block[0], block[1]};
+
+	// A first value not greater than the second selects six values, zero and 255.
+	if (values[0] > values[1]) {
+		for (uint32_t i = 1; i < 7; i++)
+			values[i + 1] = ((7 - i) * values[0] + i * values[1]) / 7;
+	} else {
+		for (uint32_t i = 1; i < 5; i++)
+			values[i + 1] = ((5 - i) * values[0] + i * values[1]) / 5;
+		values[6] = 0;
+		values[7] = 255;
+	}
+
+	uint64_t indices = 0;
+	for (uint32_t i = 0; i < 6; i++)
+		indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+
+	for (uint32_t i = 0; i < 16; i++)
+		pixels[4 * i] = static_cast<uint8_t>(values[(indices >> (3 * i)) & 7]);
+}
+
+void BlockCompression::EncodeBc1(const uint8_t *pixels, uint8_t *block) {
+	EncodeColour(pixels, block);
+}
+
+void BlockCompression::EncodeBc3(const uint8_t *pixels, uint8_t *block) {
+	EncodeChannel(pixels + 3, block);
+	EncodeColour(pixels, block + 8);
+}
+
+void BlockCompression::EncodeBc4(const uint8_t *pixels, uint8_t *block) {
+	EncodeChannel(pixels, block);
+}
+
+void BlockCompression::EncodeBc5(const uint8_t *pixels, uint8_t *block) {
+	EncodeChannel(pixels, block);
+	EncodeChannel(pixels + 1, block + 8);
+}
+
+void BlockCompression::EncodeBc7(const uint8_t *pixels, uint8_t *block) {
+	// Mode 6 fits colour and alpha along one line, mode 5 fits alpha on its own, the mode that decodes closer is kept.
+	{
+		uint32_t quantized[2][4], pBits[2], indices[16];
+		FitBc7Endpoints<4>(pixels, 7, true, 4, quantized, pBits, indices);
+
+		BlockBitWriter writer(block);
+		writer.Write(1 << 6, 7);
+		for (uint32_t channel = 0; channel < 4; channel++) {
+			writer.Write(quantized[0][channel], 7);
+			writer.Write(quantized[1][channel], 7);
+		}
+		writer.Write(pBits[0], 1);
+		writer.Write(pBits[1], 1);
+		for (uint32_t i = 0; i < 16; i++)
+			writer.Write(indices[i], i == 0 ? 3 : 4);
+	}
+
+	auto error = BlockError(pixels, block);
+	if (error == 0)
+		return;
+
+	uint32_t colour[2][4], alpha[2][4], pBits[2], colourIndices[16], alphaIndices[16];
+	FitBc7Endpoints<3>(pixels, 7, false, 2, colour, pBits, colourIndices);
+	FitBc7Endpoints<1>(pixels + 3, 8, false, 2, alpha, pBits, alphaIndices);
+
+	uint8_t candidate[16];
+	BlockBitWriter writer(candidate);
+	writer.Write(1 << 5, 6);
+	writer.Write(0, 2);
+	for (uint32_t channel = 0; channel < 3; channel++) {
+		writer.Write(colour[0][channel], 7);
+		writer.Write(colour[1][channel], 7);
+	}
+	writer.Write(alpha[0][0], 8);
+	writer.Write(alpha[1][0], 8);
+	for (uint32_t i = 0; i < 16; i++)
+		writer.Write(colourIndices[i], i == 0 ? 1 : 2);
+	for (uint32_t i = 0; i < 16; i++)
+		writer.Write(alphaIndices[i], i == 0 ? 1 : 2);
+
+	if (BlockError(pixels, candidate) < error)
+		std::memcpy(block, candidate, sizeof(candidate));
+}
+
+void BlockCompression::EncodeColour(const uint8_t *pixels, uint8_t *block) {
+	float endpoints[2][4];
+	FitEndpoints<3>(pixels, endpoints);
+
+	uint16_t bestColours[2] = {};
+	uint32_t bestIndices = 0;
+	auto bestError = std::numeric_limits<uint32_t>::max();
+
+	for (uint32_t iteration = 0; iteration < 3; iteration++) {
+		// The first colour is the greater, selecting four colours.
+		uint16_t colours[2] = {PackRgb565(endpoints[0]), PackRgb565(endpoints[1])};
+		if (colours[0] < colours[1]) {
+			std::swap(colours[0], colours[1]);
+			std::swap(endpoints[0], endpoints[1]);
+		}
+
+		uint32_t indices;
+		auto error = FitColourIndices(pixels, colours, indices);
+		if (error < bestError) {
+			bestError = error;
+			bestColours[0] = colours[0];
+			bestColours[1] = colours[1];
+			bestIndices = indices;
+		}
+
+		if (error == 0 || colours[0] == colours[1])
+			break;
+
+		static constexpr std::array<float, 4> ColourWeights = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+		float weights[16];
+		for (uint32_t i = 0; i < 16; i++)
+			weights[i] = ColourWeights[(indices >> (2 * i)) & 3];
+		if (!RefineEndpoints<3>(pixels, weights, endpoints))
+			break;
+	}
+
+	block[0] = static_cast<uint8_t>(bestColours[0]);
+	block[1] = static_cast<uint8_t>(bestColours[0] >> 8);
+	block[2] = static_cast<uint8_t>(bestColours[1]);
+	block[3] = static_cast<uint8_t>(bestColours[1] >> 8);
+	for (uint32_t i = 0; i < 4; i++)
+		block[4 + i] = static_cast<uint8_t>(bestIndices >> (8 * i));
+}
+
+void BlockCompression::EncodeChannel(const uint8_t *pixels, uint8_t *block) {
+	uint32_t minimum = 255, maximum = 0;
+	for (uint32_t i = 0; i < 16; i++) {
+		minimum = std::min<uint32_t>(minimum, pixels[4 * i]);
+		maximum = std::max<uint32_t>(maximum, pixels[4 * i]);
+	}
+
+	// The first value is the greater, selecting eight values. Equal values decode every index 0 to the first value.
+	block[0] = static_cast<uint8_t>(maximum);
+	block[1] = static_cast<uint8_t>(minimum);
+
+	uint32_t values[8] = {maximum, minimum};
+	for (uint32_t i = 1; i < 7; i++)
+		values[i + 1] = ((7 - i) * maximum + i * minimum) / 7;
+
+	uint64_t indices = 0;
+	if (maximum > minimum) {
+		for (uint32_t i = 0; i < 16; i++) {
+			uint32_t bestIndex = 0, bestError = std::numeric_limits<uint32_t>::max();
+
+			for (uint32_t index = 0; index < 8; index++) {
+				auto difference = static_cast<int32_t>(pixels[4 * i]) - static_cast<int32_t>(values[index]);
+				if (static_cast<uint32_t>(difference * difference) < bestError) {
+					bestError = static_cast<uint32_t>(difference * difference);
+					bestIndex = index;
+				}
+			}
+
+			indices |= static_cast<uint64_t>(bestIndex) << (3 * i);
+		}
+	}
+
+	for (uint32_t i = 0; i < 6; i++)
+		block[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief Class that encodes and decodes blocks of the BCn texture compression formats.
+ *
+ * Every block holds 4x4 pixels, decoded to 16 RGBA8 pixels in rows from the top left. Decoding is used when the device
+ * cannot sample a block compressed format, the result matches what the device would sample to within rounding. Encoding
+ * is used to cook textures offline, endpoints are fitted along the principal axis of the pixels and refined by least squares.
+ */
+class ACID_EXPORT BlockCompression {
+public:
+	/**
+	 * Decodes a BC1 block of 8 bytes.
+	 * @param block The block to decode.
+	 * @param pixels The 16 RGBA8 pixels to write.
+	 * @param alpha If three colour blocks have a transparent black, otherwise it is opaque.
+	 */
+	static void DecodeBc1(const uint8_t *block, uint8_t *pixels, bool alpha = true);
+
+	/**
+	 * Decodes a BC2 block of 16 bytes, with explicit 4 bit alpha.
+	 * @param block The block to decode.
+	 * @param pixels The 16 RGBA8 pixels to write.
+	 */
+	static void DecodeBc2(const uint8_t *block, uint8_t *pixels);
+
+	/**
+	 * Decodes a BC3 block of 16 bytes, with interpolated alpha.
+	 * @param block The block to decode.
+	 * @param pixels The 16 RGBA8 pixels to write.
+	 */
+	static void DecodeBc3(const uint8_t *block, uint8_t *pixels);
+
+	/**
+	 * Decodes a BC4 block of 8 bytes into the red channel, green and blue are zero and alpha is opaque.
+	 * @param block The block to decode.
+	 * @param pixels The 16 RGBA8 pixels to write.
+	 */
+	static void DecodeBc4(const uint8_t *block, uint8_t *pixels);
+
+	/**
+	 * Decodes a BC5 block of 16 bytes into the red and green channels, blue is zero and alpha is opaque.
+	 * @param block The block to decode.
+	 * @param pixels The 16 RGBA8 pixels to write.
+	 */
+	static void DecodeBc5(const uint8_t *block, uint8_t *pixels);
+
+	/**
+	 * Decodes a BC7 block of 16 bytes, reserved modes decode to transparent black.
+	 * @param block The block to decode.
+	 * @param pixels The 16 RGBA8 pixels to write.
+	 */
+	static void DecodeBc7(const uint8_t *block, uint8_t *pixels);
+
+	/**
+	 * Encodes an opaque BC1 block of 8 bytes, alpha is ignored.
+	 * @param pixels The 16 RGBA8 pixels to read.
+	 * @param block The block to write.
+	 */
+	static void EncodeBc1(const uint8_t *pixels, uint8_t *block);
+
+	/**
+	 * Encodes a BC3 block of 16 bytes, with interpolated alpha.
+	 * @param pixels The 16 RGBA8 pixels to read.
+	 * @param block The block to write.
+	 */
+	static void EncodeBc3(const uint8_t *pixels, uint8_t *block);
+
+	/**
+	 * Encodes a BC4 block of 8 bytes from the red channel.
+	 * @param pixels The 16 RGBA8 pixels to read.
+	 * @param block The block to write.
+	 */
+	static void EncodeBc4(const uint8_t *pixels, uint8_t *block);
+
+	/**
+	 * Encodes a BC5 block of 16 bytes from the red and green channels.
+	 * @param pixels The 16 RGBA8 pixels to read.
+	 * @param block The block to write.
+	 */
+	static void EncodeBc5(const uint8_t *pixels, uint8_t *block);
+
+	/**
+	 * Encodes a BC7 block of 16 bytes with mode 6, a single subset with 7 bit RGBA endpoints and 4 bit indices, or mode 5
+	 * with separate colour and alpha endpoints when it has less error.
+	 * @param pixels The 16 RGBA8 pixels to read.
+	 * @param block The block to write.
+	 */
+	static void EncodeBc7(const uint8_t *pixels, uint8_t *block);
+
+private:
+	static void DecodeColour(const uint8_t *block, uint8_t *pixels, bool threeColour, bool alpha);
+	/**
+	 * Decodes a BC4 style channel block.
+	 * @param block The 8 byte block to decode.
+	 * @param pixels The first channel of 16 RGBA8 pixels to write, written every 4 bytes.
+	 */
+	static void DecodeChannel(const uint8_t *block, uint8_t *pixels);
+	static void EncodeColour(const uint8_t *pixels, uint8_t *block);
+	/**
+	 * Encodes a BC4 style channel block.
+	 * @param pixels The first channel of 16 RGBA8 pixels to read, read every 4 bytes.
+	 * @param block The 8 byte block to write.
+	 */
+	static void EncodeChannel(const uint8_t *pixels, uint8_t *block);
+};
+}
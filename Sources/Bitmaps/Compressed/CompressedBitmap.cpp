@@ -0,0 +1,730 @@
+#include "CompressedBitmap.hpp"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "Bitmaps/Bitmap.hpp"
+#include "Files/Files.hpp"
+#include "Maths/Time.hpp"
+#include "Utils/String.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "BlockCompression.hpp"
+
+namespace acid {
+static constexpr std::array<uint8_t, 12> Ktx2Identifier = {0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n'};
+static constexpr std::size_t Ktx2HeaderSize = 80;
+static constexpr std::size_t Ktx2LevelIndexSize = 24;
+/// Containers with a larger width or height are refused, it is the largest 2D image dimension desktop devices commonly support.
+static constexpr uint32_t MaxImageDimension = 16384;
+
+static constexpr std::size_t DdsHeaderSize = 128;
+static constexpr std::size_t DdsDx10HeaderSize = 20;
+static constexpr uint32_t DdsPixelFormatFourCC = 0x4;
+static constexpr uint32_t DdsPixelFormatRgb = 0x40;
+static constexpr uint32_t DdsCaps2Cubemap = 0x200;
+static constexpr uint32_t DdsCaps2CubemapAllFaces = 0xfc00;
+static constexpr uint32_t DdsCaps2Volume = 0x200000;
+static constexpr uint32_t DdsMiscTextureCube = 0x4;
+static constexpr uint32_t DdsDimensionTexture2d = 3;
+
+/**
+ * @brief The rows of blocks of a bitmap being compressed, shared by the compressing thread and the pool workers helping it.
+ *
+ * Rows are claimed from a counter, the compressing thread compresses rows too and only waits for rows that a worker already
+ * claimed. Workers that start after every row is claimed return without touching the bitmap.
+ */
+class BlockRowJob {
+public:
+	BlockRowJob(std::size_t count, std::function<void(std::size_t)> &&compress) :
+		count(count),
+		compress(std::move(compress)) {
+	}
+
+	void Run() {
+		for (std::size_t i; (i = next++) < count;) {
+			compress(i);
+			finished++;
+		}
+	}
+
+	void Wait() const {
+		while (finished < count)
+			std::this_thread::yield();
+	}
+
+private:
+	std::size_t count;
+	std::function<void(std::size_t)> compress;
+	std::atomic<std::size_t> next = 0;
+	std::atomic<std::size_t> finished = 0;
+};
+
+static uint32_t ReadUint32(const uint8_t *data) {
+	return static_cast<uint32_t>(data[0] | data[1] << 8 | data[2] << 16 | data[3] << 24);
+}
+
+static uint64_t ReadUint64(const uint8_t *data) {
+	return ReadUint32(data) | static_cast<uint64_t>(ReadUint32(data + 4)) << 32;
+}
+
+static void WriteUint32(uint8_t *data, uint32_t value) {
+	for (uint32_t i = 0; i < 4; i++)
+		data[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static void WriteUint64(uint8_t *data, uint64_t value) {
+	WriteUint32(data, static_cast<uint32_t>(value));
+	WriteUint32(data + 4, static_cast<uint32_t>(value >> 32));
+}
+
+/**
+ * Checks the size and mip chain read from a container before anything is allocated for them.
+ * @param size The size of the largest level in pixels.
+ * @param levelCount The number of mip levels.
+ * @return If the size is within MaxImageDimension and the levels do not go past 1x1.
+ */
+static bool IsValidMipChain(const Vector2ui &size, uint32_t levelCount) {
+	if (size.x == 0 || size.y == 0 || size.x > MaxImageDimension || size.y > MaxImageDimension)
+		return false;
+	// floor(log2(max)) + 1 levels.
+	uint32_t maxLevelCount = 0;
+	for (auto extent = std::max(size.x, size.y); extent > 0; extent >>= 1)
+		maxLevelCount++;
+	return levelCount <= maxLevelCount;
+}
+
+/**
+ * Gets the length of every level and layer of a mip chain.
+ * @param format The format of the layers.
+ * @param size The size of the largest level in pixels.
+ * @param levelCount The number of mip levels.
+ * @param layerCount The number of layers in each level.
+ * @return The length in bytes.
+ */
+static std::size_t GetMipChainLength(VkFormat format, const Vector2ui &size, uint32_t levelCount, uint32_t layerCount) {
+	std::size_t length = 0;
+	for (uint32_t i = 0; i < levelCount; i++)
+		length += CompressedBitmap::GetLayerLength(format, {std::max(size.x >> i, 1u), std::max(size.y >> i, 1u)}) * layerCount;
+	return length;
+}
+
+static float SrgbToLinear(uint8_t value) {
+	static const auto Table = []() {
+		std::array<float, 256> table;
+		for (uint32_t i = 0; i < table.size(); i++) {
+			auto v = i / 255.0f;
+			table[i] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+		}
+		return table;
+	}();
+	return Table[value];
+}
+
+static uint8_t LinearToSrgb(float value) {
+	value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	return static_cast<uint8_t>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+/**
+ * Creates the KTX2 data format descriptor of a format, describing the colour model and the channels of a block or pixel.
+ * @param format The format to describe.
+ * @return The descriptor, starting with its total size.
+ */
+static std::vector<uint8_t> CreateKtx2DataFormatDescriptor(VkFormat format) {
+	// Each sample is a channel id, with its bit offset and bit length.
+	static constexpr uint32_t ChannelAlpha = 15;
+	static constexpr uint32_t SampleLinear = 0x10;
+	uint32_t colourModel;
+	std::vector<std::array<uint32_t, 3>> samples;
+
+	switch (format) {
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		colourModel = 128;
+		samples = {{0, 0, 64}};
+		break;
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		colourModel = 128;
+		samples = {{1, 0, 64}};
+		break;
+	case VK_FORMAT_BC2_UNORM_BLOCK:
+	case VK_FORMAT_BC2_SRGB_BLOCK:
+		colourModel = 129;
+		samples = {{ChannelAlpha, 0, 64}, {0, 64, 64}};
+		break;
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+		colourModel = 130;
+		samples = {{ChannelAlpha, 0, 64}, {0, 64, 64}};
+		break;
+	case VK_FORMAT_BC4_UNORM_BLOCK:
+		colourModel = 131;
+		samples = {{0, 0, 64}};
+		break;
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+		colourModel = 132;
+		samples = {{0, 0, 64}, {1, 64, 64}};
+		break;
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		colourModel = 134;
+		samples = {{0, 0, 128}};
+		break;
+	default:
+		colourModel = 1;
+		samples = {{0, 0, 8}, {1, 8, 8}, {2, 16, 8}, {ChannelAlpha, 24, 8}};
+		break;
+	}
+
+	auto blockCompressed = CompressedBitmap::IsBlockCompressed(format);
+	auto srgb = CompressedBitmap::IsSrgb(format);
+	auto blockSize = static_cast<uint32_t>(24 + 16 * samples.size());
+	std::vector<uint8_t> descriptor(4 + blockSize);
+	auto data = descriptor.data();
+	WriteUint32(data, static_cast<uint32_t>(descriptor.size()));
+	WriteUint32(data + 8, 2 | blockSize << 16);
+	// BT.709 primaries, with a sRGB or linear transfer function.
+	WriteUint32(data + 12, colourModel | 1 << 8 | (srgb ? 2 : 1) << 16);
+	WriteUint32(data + 16, blockCompressed ? 0x0303 : 0);
+	WriteUint32(data + 20, static_cast<uint32_t>(CompressedBitmap::GetLayerLength(format, {1, 1})));
+
+	for (std::size_t i = 0; i < samples.size(); i++) {
+		auto sample = data + 28 + 16 * i;
+		auto [channel, bitOffset, bitLength] = samples[i];
+		// Alpha is never sRGB encoded.
+		if (srgb && channel == ChannelAlpha)
+			channel |= SampleLinear;
+		WriteUint32(sample, bitOffset | (bitLength - 1) << 16 | channel << 24);
+		WriteUint32(sample + 12, blockCompressed ? 0xffffffff : 255);
+	}
+
+	return descriptor;
+}
+
+static constexpr uint32_t MakeFourCC(const char (&code)[5]) {
+	return static_cast<uint32_t>(code[0] | code[1] << 8 | code[2] << 16 | code[3] << 24);
+}
+
+static VkFormat FromDxgiFormat(uint32_t dxgiFormat) {
+	switch (dxgiFormat) {
+	case 28:
+		return VK_FORMAT_R8G8B8A8_UNORM;
+	case 29:
+		return VK_FORMAT_R8G8B8A8_SRGB;
+	case 71:
+		return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+	case 72:
+		return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+	case 74:
+		return VK_FORMAT_BC2_UNORM_BLOCK;
+	case 75:
+		return VK_FORMAT_BC2_SRGB_BLOCK;
+	case 77:
+		return VK_FORMAT_BC3_UNORM_BLOCK;
+	case 78:
+		return VK_FORMAT_BC3_SRGB_BLOCK;
+	case 80:
+		return VK_FORMAT_BC4_UNORM_BLOCK;
+	case 83:
+		return VK_FORMAT_BC5_UNORM_BLOCK;
+	case 98:
+		return VK_FORMAT_BC7_UNORM_BLOCK;
+	case 99:
+		return VK_FORMAT_BC7_SRGB_BLOCK;
+	default:
+		return VK_FORMAT_UNDEFINED;
+	}
+}
+
+static VkFormat FromFourCC(uint32_t fourCC) {
+	switch (fourCC) {
+	case MakeFourCC("DXT1"):
+		return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+	case MakeFourCC("DXT2"):
+	case MakeFourCC("DXT3"):
+		return VK_FORMAT_BC2_UNORM_BLOCK;
+	case MakeFourCC("DXT4"):
+	case MakeFourCC("DXT5"):
+		return VK_FORMAT_BC3_UNORM_BLOCK;
+	case MakeFourCC("ATI1"):
+	case MakeFourCC("BC4U"):
+		return VK_FORMAT_BC4_UNORM_BLOCK;
+	case MakeFourCC("ATI2"):
+	case MakeFourCC("BC5U"):
+		return VK_FORMAT_BC5_UNORM_BLOCK;
+	default:
+		return VK_FORMAT_UNDEFINED;
+	}
+}
+
+CompressedBitmap::CompressedBitmap(std::filesystem::path filename) :
+	filename(std::move(filename)) {
+	Load(this->filename);
+}
+
+CompressedBitmap::CompressedBitmap(VkFormat format, const Vector2ui &size, uint32_t levelCount, uint32_t layerCount) {
+	Allocate(format, size, levelCount, layerCount);
+}
+
+CompressedBitmap::CompressedBitmap(const Bitmap &bitmap, bool srgb) :
+	filename(bitmap.GetFilename()) {
+	if (bitmap.GetBytesPerPixel() != 4 || !bitmap.GetData()) {
+		Log::Error("Bitmap ", bitmap.GetFilename(), " does not have 4 bytes per pixel\n");
+		return;
+	}
+
+	Allocate(srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM, bitmap.GetSize(), 1, 1);
+	std::memcpy(data.get(), bitmap.GetData().get(), length);
+}
+
+void CompressedBitmap::Load(const std::filesystem::path &filename) {
+#if defined(ACID_DEBUG)
+	auto debugStart = Time::Now();
+#endif
+
+	auto fileLoaded = Files::Map(filename);
+
+	if (!fileLoaded) {
+		Log::Error("Bitmap could not be loaded: ", filename, '\n');
+		return;
+	}
+
+	auto extension = String::Lowercase(filename.extension().string());
+	auto loaded = false;
+	if (extension == ".ktx2")
+		loaded = LoadKtx2(fileLoaded->GetData(), fileLoaded->GetSize());
+	else if (extension == ".dds")
+		loaded = LoadDds(fileLoaded->GetData(), fileLoaded->GetSize());
+
+	if (!loaded) {
+		Log::Error("Bitmap ", filename, " is not a supported KTX2 or DDS texture\n");
+		levels.clear();
+		data = nullptr;
+		length = 0;
+		return;
+	}
+
+	this->filename = filename;
+
+#if defined(ACID_DEBUG)
+	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
+#endif
+}
+
+void CompressedBitmap::Write(const std::filesystem::path &filename) const {
+	if (layerCount != 1 && layerCount != 6) {
+		Log::Error("Bitmap ", filename, " can only be written with 1 or 6 layers\n");
+		return;
+	}
+
+	auto levelCount = GetLevelCount();
+	auto descriptor = CreateKtx2DataFormatDescriptor(format);
+	std::vector<uint8_t> header(Ktx2HeaderSize + levelCount * Ktx2LevelIndexSize);
+	std::memcpy(header.data(), Ktx2Identifier.data(), Ktx2Identifier.size());
+	WriteUint32(&header[12], format);
+	WriteUint32(&header[16], 1);
+	WriteUint32(&header[20], size.x);
+	WriteUint32(&header[24], size.y);
+	WriteUint32(&header[36], layerCount);
+	WriteUint32(&header[40], levelCount);
+	WriteUint32(&header[48], static_cast<uint32_t>(header.size()));
+	WriteUint32(&header[52], static_cast<uint32_t>(descriptor.size()));
+
+	// Levels are stored from the smallest, each aligned to a block or pixel.
+	auto alignment = GetLayerLength(format, {1, 1});
+	auto offset = header.size() + descriptor.size();
+	std::vector<std::size_t> offsets(levelCount);
+	for (auto i = levelCount; i-- > 0;) {
+		offset = (offset + alignment - 1) / alignment * alignment;
+		offsets[i] = offset;
+		auto levelLength = levels[i].layerLength * layerCount;
+		WriteUint64(&header[Ktx2HeaderSize + i * Ktx2LevelIndexSize], offset);
+		WriteUint64(&header[Ktx2HeaderSize + i * Ktx2LevelIndexSize + 8], levelLength);
+		WriteUint64(&header[Ktx2HeaderSize + i * Ktx2LevelIndexSize + 16], levelLength);
+		offset += levelLength;
+	}
+
+	if (auto parentPath = filename.parent_path(); !parentPath.empty())
+		std::filesystem::create_directories(parentPath);
+
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	os.write(reinterpret_cast<const char *>(header.data()), header.size());
+	os.write(reinterpret_cast<const char *>(descriptor.data()), descriptor.size());
+	offset = header.size() + descriptor.size();
+
+	for (auto i = levelCount; i-- > 0;) {
+		static constexpr char Padding[16] = {};
+		os.write(Padding, offsets[i] - offset);
+		os.write(reinterpret_cast<const char *>(GetData(i)), levels[i].layerLength * layerCount);
+		offset = offsets[i] + levels[i].layerLength * layerCount;
+	}
+
+	if (!os)
+		Log::Error("Bitmap could not be written: ", filename, '\n');
+}
+
+CompressedBitmap CompressedBitmap::GenerateMipmaps(bool gammaCorrect) const {
+	if (format != VK_FORMAT_R8G8B8A8_UNORM && format != VK_FORMAT_R8G8B8A8_SRGB) {
+		Log::Error("Bitmap ", filename, " must be RGBA8 to generate mipmaps\n");
+		return {};
+	}
+
+	gammaCorrect |= IsSrgb(format);
+	uint32_t levelCount = 1;
+	while ((size.x >> levelCount) || (size.y >> levelCount))
+		levelCount++;
+
+	CompressedBitmap result(format, size, levelCount, layerCount);
+	result.filename = filename;
+
+	auto decode = [gammaCorrect](uint8_t value, uint32_t channel) {
+		return gammaCorrect && channel < 3 ? SrgbToLinear(value) : value / 255.0f;
+	};
+	auto encode = [gammaCorrect](float value, uint32_t channel) {
+		return gammaCorrect && channel < 3 ? LinearToSrgb(value) : static_cast<uint8_t>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+	};
+
+	for (uint32_t layer = 0; layer < layerCount; layer++) {
+		std::memcpy(result.GetData(0, layer), GetData(0, layer), levels[0].layerLength);
+
+		auto source = GetData(0, layer);
+		std::vector<float> current(static_cast<std::size_t>(size.x) * size.y * 4);
+		for (std::size_t i = 0; i < current.size(); i++)
+			current[i] = decode(source[i], i % 4);
+
+		for (uint32_t level = 1; level < levelCount; level++) {
+			auto currentSize = result.levels[level - 1].size;
+			auto nextSize = result.levels[level].size;
+			std::vector<float> next(static_cast<std::size_t>(nextSize.x) * nextSize.y * 4);
+
+			// Odd sizes repeat their last row or column. The channels of a pixel are filtered together, which compilers vectorize.
+			for (uint32_t y = 0; y < nextSize.y; y++) {
+				auto row0 = current.data() + 4 * static_cast<std::size_t>(std::min(2 * y, currentSize.y - 1)) * currentSize.x;
+				auto row1 = current.data() + 4 * static_cast<std::size_t>(std::min(2 * y + 1, currentSize.y - 1)) * currentSize.x;
+				auto destination = next.data() + 4 * static_cast<std::size_t>(y) * nextSize.x;
+
+				for (uint32_t x = 0; x < nextSize.x; x++) {
+					auto x0 = 4 * std::min(2 * x, currentSize.x - 1);
+					auto x1 = 4 * std::min(2 * x + 1, currentSize.x - 1);
+					for (uint32_t channel = 0; channel < 4; channel++)
+						destination[4 * x + channel] = 0.25f * (row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel]);
+				}
+			}
+
+			auto levelData = result.GetData(level, layer);
+			for (std::size_t i = 0; i < next.size(); i++)
+				levelData[i] = encode(next[i], i % 4);
+			current = std::move(next);
+		}
+	}
+
+	return result;
+}
+
+CompressedBitmap CompressedBitmap::Compress(VkFormat format, ThreadPool *threadPool) const {
+	void (*encode)(const uint8_t *, uint8_t *) = nullptr;
+	switch (format) {
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		encode = &BlockCompression::EncodeBc1;
+		break;
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+		encode = &BlockCompression::EncodeBc3;
+		break;
+	case VK_FORMAT_BC4_UNORM_BLOCK:
+		encode = &BlockCompression::EncodeBc4;
+		break;
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+		encode = &BlockCompression::EncodeBc5;
+		break;
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		encode = &BlockCompression::EncodeBc7;
+		break;
+	default:
+		break;
+	}
+
+	if (!encode || (this->format != VK_FORMAT_R8G8B8A8_UNORM && this->format != VK_FORMAT_R8G8B8A8_SRGB)) {
+		Log::Error("Bitmap ", filename, " cannot be compressed to format ", format, '\n');
+		return {};
+	}
+
+	CompressedBitmap result(format, size, GetLevelCount(), layerCount);
+	result.filename = filename;
+
+	// Every row of blocks, of every level and layer, is compressed on its own.
+	std::vector<std::array<uint32_t, 3>> rows;
+	for (uint32_t level = 0; level < GetLevelCount(); level++) {
+		for (uint32_t layer = 0; layer < layerCount; layer++) {
+			for (uint32_t blockY = 0; blockY < levels[level].size.y; blockY += 4)
+				rows.push_back({level, layer, blockY});
+		}
+	}
+
+	auto blockLength = GetBlockLength(format);
+	auto compress = [&](std::size_t i) {
+		auto [level, layer, blockY] = rows[i];
+		auto levelSize = levels[level].size;
+		auto source = GetData(level, layer);
+		auto block = result.GetData(level, layer) + static_cast<std::size_t>(blockY / 4) * ((levelSize.x + 3) / 4) * blockLength;
+		uint8_t pixels[64];
+
+		for (uint32_t blockX = 0; blockX < levelSize.x; blockX += 4, block += blockLength) {
+			// Blocks on the right and bottom edges repeat the last column or row of the level.
+			for (uint32_t y = 0; y < 4; y++) {
+				auto row = source + 4 * static_cast<std::size_t>(std::min(blockY + y, levelSize.y - 1)) * levelSize.x;
+				for (uint32_t x = 0; x < 4; x++)
+					std::memcpy(pixels + 4 * (4 * y + x), row + 4 * std::min(blockX + x, levelSize.x - 1), 4);
+			}
+
+			encode(pixels, block);
+		}
+	};
+
+	if (!threadPool || rows.size() == 1) {
+		for (std::size_t i = 0; i < rows.size(); i++)
+			compress(i);
+		return result;
+	}
+
+	auto job = std::make_shared<BlockRowJob>(rows.size(), compress);
+	auto helpers = std::min(threadPool->GetWorkers().size(), rows.size() - 1);
+	for (std::size_t i = 0; i < helpers; i++)
+		threadPool->Enqueue([job]() { job->Run(); });
+
+	job->Run();
+	job->Wait();
+	return result;
+}
+
+CompressedBitmap CompressedBitmap::Decompress() const {
+	auto blockLength = GetBlockLength(format);
+	if (!blockLength)
+		return {};
+
+	CompressedBitmap result(IsSrgb(format) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM, size, GetLevelCount(), layerCount);
+	result.filename = filename;
+	uint8_t pixels[64];
+
+	for (uint32_t level = 0; level < GetLevelCount(); level++) {
+		auto levelSize = levels[level].size;
+
+		for (uint32_t layer = 0; layer < layerCount; layer++) {
+			auto block = GetData(level, layer);
+			auto destination = result.GetData(level, layer);
+
+			for (uint32_t blockY = 0; blockY < levelSize.y; blockY += 4) {
+				for (uint32_t blockX = 0; blockX < levelSize.x; blockX += 4, block += blockLength) {
+					switch (format) {
+					case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+					case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+						BlockCompression::DecodeBc1(block, pixels, false);
+						break;
+					case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+					case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+						BlockCompression::DecodeBc1(block, pixels);
+						break;
+					case VK_FORMAT_BC2_UNORM_BLOCK:
+					case VK_FORMAT_BC2_SRGB_BLOCK:
+						BlockCompression::DecodeBc2(block, pixels);
+						break;
+					case VK_FORMAT_BC3_UNORM_BLOCK:
+					case VK_FORMAT_BC3_SRGB_BLOCK:
+						BlockCompression::DecodeBc3(block, pixels);
+						break;
+					case VK_FORMAT_BC4_UNORM_BLOCK:
+						BlockCompression::DecodeBc4(block, pixels);
+						break;
+					case VK_FORMAT_BC5_UNORM_BLOCK:
+						BlockCompression::DecodeBc5(block, pixels);
+						break;
+					default:
+						BlockCompression::DecodeBc7(block, pixels);
+						break;
+					}
+
+					// Blocks on the right and bottom edges can be partly outside the level.
+					auto width = std::min(levelSize.x - blockX, 4u);
+					auto height = std::min(levelSize.y - blockY, 4u);
+					for (uint32_t y = 0; y < height; y++)
+						std::memcpy(destination + 4 * ((blockY + y) * levelSize.x + blockX), pixels + 16 * y, 4 * width);
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+bool CompressedBitmap::IsContainer(const std::filesystem::path &filename) {
+	auto extension = String::Lowercase(filename.extension().string());
+	return extension == ".ktx2" || extension == ".dds";
+}
+
+bool CompressedBitmap::IsSrgb(VkFormat format) {
+	switch (format) {
+	case VK_FORMAT_R8G8B8A8_SRGB:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+	case VK_FORMAT_BC2_SRGB_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return true;
+	default:
+		return false;
+	}
+}
+
+uint32_t CompressedBitmap::GetBlockLength(VkFormat format) {
+	switch (format) {
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+	case VK_FORMAT_BC4_UNORM_BLOCK:
+		return 8;
+	case VK_FORMAT_BC2_UNORM_BLOCK:
+	case VK_FORMAT_BC2_SRGB_BLOCK:
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+std::size_t CompressedBitmap::GetLayerLength(VkFormat format, const Vector2ui &size) {
+	if (auto blockLength = GetBlockLength(format))
+		return (static_cast<std::size_t>(size.x) + 3) / 4 * ((static_cast<std::size_t>(size.y) + 3) / 4) * blockLength;
+	if (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB)
+		return static_cast<std::size_t>(size.x) * size.y * 4;
+	return 0;
+}
+
+void CompressedBitmap::Allocate(VkFormat format, const Vector2ui &size, uint32_t levelCount, uint32_t layerCount) {
+	this->format = format;
+	this->size = size;
+	this->layerCount = layerCount;
+	levels.clear();
+	levels.reserve(levelCount);
+	length = 0;
+
+	for (uint32_t i = 0; i < levelCount; i++) {
+		Level level;
+		level.size = {std::max(size.x >> i, 1u), std::max(size.y >> i, 1u)};
+		level.offset = length;
+		level.layerLength = GetLayerLength(format, level.size);
+		length += level.layerLength * layerCount;
+		levels.emplace_back(level);
+	}
+
+	data = std::unique_ptr<uint8_t[]>(new uint8_t[length]);
+}
+
+bool CompressedBitmap::LoadKtx2(const uint8_t *file, std::size_t fileLength) {
+	if (fileLength < Ktx2HeaderSize || std::memcmp(file, Ktx2Identifier.data(), Ktx2Identifier.size()) != 0)
+		return false;
+
+	auto vkFormat = static_cast<VkFormat>(ReadUint32(file + 12));
+	Vector2ui pixelSize(ReadUint32(file + 20), ReadUint32(file + 24));
+	auto pixelDepth = ReadUint32(file + 28);
+	auto arrayLayerCount = ReadUint32(file + 32);
+	auto faceCount = ReadUint32(file + 36);
+	auto levelCount = std::max(ReadUint32(file + 40), 1u);
+	auto supercompressionScheme = ReadUint32(file + 44);
+
+	// Supercompressed, volume and array textures are not loaded.
+	if (!IsSupported(vkFormat) || supercompressionScheme != 0 || pixelDepth > 1 || arrayLayerCount > 1 || (faceCount != 1 && faceCount != 6) ||
+		!IsValidMipChain(pixelSize, levelCount) || Ktx2HeaderSize + levelCount * Ktx2LevelIndexSize > fileLength) {
+		return false;
+	}
+
+	// The levels are stored in the file, so they can never be longer than it.
+	if (GetMipChainLength(vkFormat, pixelSize, levelCount, faceCount) > fileLength - Ktx2HeaderSize - levelCount * Ktx2LevelIndexSize)
+		return false;
+
+	Allocate(vkFormat, pixelSize, levelCount, faceCount);
+
+	// Each level holds its faces one after another, the same as this bitmap.
+	for (uint32_t i = 0; i < levelCount; i++) {
+		auto index = file + Ktx2HeaderSize + i * Ktx2LevelIndexSize;
+		auto byteOffset = ReadUint64(index);
+		auto byteLength = ReadUint64(index + 8);
+
+		if (byteLength != levels[i].layerLength * layerCount || byteOffset > fileLength || byteLength > fileLength - byteOffset)
+			return false;
+
+		std::memcpy(GetData(i), file + byteOffset, static_cast<std::size_t>(byteLength));
+	}
+
+	return true;
+}
+
+bool CompressedBitmap::LoadDds(const uint8_t *file, std::size_t fileLength) {
+	if (fileLength < DdsHeaderSize || std::memcmp(file, "DDS ", 4) != 0 || ReadUint32(file + 4) != 124)
+		return false;
+
+	Vector2ui pixelSize(ReadUint32(file + 16), ReadUint32(file + 12));
+	auto levelCount = std::max(ReadUint32(file + 28), 1u);
+	auto pixelFormatFlags = ReadUint32(file + 80);
+	auto fourCC = ReadUint32(file + 84);
+	auto caps2 = ReadUint32(file + 112);
+
+	auto dataOffset = DdsHeaderSize;
+	auto ddsFormat = VK_FORMAT_UNDEFINED;
+	uint32_t faceCount = 1;
+
+	if ((pixelFormatFlags & DdsPixelFormatFourCC) && fourCC == MakeFourCC("DX10")) {
+		if (fileLength < DdsHeaderSize + DdsDx10HeaderSize)
+			return false;
+
+		auto dimension = ReadUint32(file + 132);
+		auto miscFlag = ReadUint32(file + 136);
+		auto arraySize = ReadUint32(file + 140);
+		if (dimension != DdsDimensionTexture2d || arraySize > 1)
+			return false;
+
+		ddsFormat = FromDxgiFormat(ReadUint32(file + 128));
+		faceCount = (miscFlag & DdsMiscTextureCube) ? 6 : 1;
+		dataOffset += DdsDx10HeaderSize;
+	} else if (pixelFormatFlags & DdsPixelFormatFourCC) {
+		ddsFormat = FromFourCC(fourCC);
+	} else if ((pixelFormatFlags & DdsPixelFormatRgb) && ReadUint32(file + 88) == 32 && ReadUint32(file + 92) == 0x000000ff &&
+		ReadUint32(file + 96) == 0x0000ff00 && ReadUint32(file + 100) == 0x00ff0000) {
+		ddsFormat = VK_FORMAT_R8G8B8A8_UNORM;
+	}
+
+	if (caps2 & DdsCaps2Cubemap) {
+		if ((caps2 & DdsCaps2CubemapAllFaces) != DdsCaps2CubemapAllFaces)
+			return false;
+		faceCount = 6;
+	}
+
+	if (!IsSupported(ddsFormat) || (caps2 & DdsCaps2Volume) || !IsValidMipChain(pixelSize, levelCount) ||
+		GetMipChainLength(ddsFormat, pixelSize, levelCount, faceCount) > fileLength - dataOffset) {
+		return false;
+	}
+
+	Allocate(ddsFormat, pixelSize, levelCount, faceCount);
+
+	// DDS stores the mip chain of each face one after another, faces are moved into their levels.
+	auto source = file + dataOffset;
+	for (uint32_t face = 0; face < faceCount; face++) {
+		for (uint32_t i = 0; i < levelCount; i++) {
+			std::memcpy(GetData(i, face), source, levels[i].layerLength);
+			source += levels[i].layerLength;
+		}
+	}
+
+	return true;
+}
+}
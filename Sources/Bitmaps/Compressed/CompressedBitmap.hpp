@@ -0,0 +1,140 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <volk.h>
+
+#include "Maths/Vector2.hpp"
+
+namespace acid {
+class Bitmap;
+class ThreadPool;
+
+/**
+ * @brief Class that holds a texture with a stored mip chain, loaded from a KTX2 or DDS container.
+ *
+ * Levels are stored from the largest, each level holds every layer one after another. Block compressed formats (BC1, BC2,
+ * BC3, BC4, BC5, BC7) are kept compressed so they can be uploaded as they are, and can be decompressed to RGBA8 for devices
+ * that cannot sample them. RGBA8 bitmaps can be given a mip chain and compressed on the CPU, then written as KTX2.
+ */
+class ACID_EXPORT CompressedBitmap {
+public:
+	/**
+	 * @brief A mip level of the bitmap.
+	 */
+	class Level {
+	public:
+		Vector2ui size;
+		/// The offset of the first layer in the bitmap data.
+		std::size_t offset = 0;
+		std::size_t layerLength = 0;
+	};
+
+	CompressedBitmap() = default;
+	explicit CompressedBitmap(std::filesystem::path filename);
+	/**
+	 * Creates a new bitmap with uninitialized data.
+	 * @param format The format of the bitmap, one of the formats given by IsSupported.
+	 * @param size The size of the largest level in pixels.
+	 * @param levelCount The number of mip levels.
+	 * @param layerCount The number of layers in each level, 6 for a cubemap.
+	 */
+	CompressedBitmap(VkFormat format, const Vector2ui &size, uint32_t levelCount = 1, uint32_t layerCount = 1);
+	/**
+	 * Creates a new RGBA8 bitmap with a single level from the pixels of a bitmap.
+	 * @param bitmap The bitmap to copy, with 4 bytes per pixel.
+	 * @param srgb If the bitmap holds sRGB encoded colour.
+	 */
+	explicit CompressedBitmap(const Bitmap &bitmap, bool srgb = false);
+
+	void Load(const std::filesystem::path &filename);
+	/**
+	 * Writes the bitmap as a KTX2 container.
+	 * @param filename The file to write.
+	 */
+	void Write(const std::filesystem::path &filename) const;
+
+	/**
+	 * Generates the mip chain of a RGBA8 bitmap from its first level, replacing any other levels.
+	 * Each level is box filtered from the level above it, kept in floating point between levels.
+	 * @param gammaCorrect If colour is filtered in linear space, for sRGB encoded colour stored in a UNORM format. sRGB formats
+	 * are always filtered in linear space, alpha never is.
+	 * @return The bitmap with every level down to 1x1.
+	 */
+	CompressedBitmap GenerateMipmaps(bool gammaCorrect) const;
+
+	/**
+	 * Compresses a RGBA8 bitmap, keeping every level and layer.
+	 * @param format The block compressed format, BC1 RGB, BC3, BC4, BC5 or BC7.
+	 * @param threadPool The pool that rows of blocks are compressed on together with the calling thread, or nullptr.
+	 * @return The compressed bitmap, or an empty bitmap if the format cannot be encoded.
+	 */
+	CompressedBitmap Compress(VkFormat format, ThreadPool *threadPool = nullptr) const;
+
+	/**
+	 * Decompresses a block compressed bitmap to RGBA8, keeping every level and layer.
+	 * @return The decompressed bitmap, sRGB if this bitmap is sRGB.
+	 */
+	CompressedBitmap Decompress() const;
+
+	explicit operator bool() const noexcept { return !levels.empty(); }
+
+	/**
+	 * Gets if a file is a texture container this bitmap loads, by its extension.
+	 * @param filename The file to check.
+	 * @return If the file is a KTX2 or DDS container.
+	 */
+	static bool IsContainer(const std::filesystem::path &filename);
+
+	/**
+	 * Gets if a format can be held by this bitmap.
+	 * @param format The format to check.
+	 * @return If the format is a supported block compressed format, or RGBA8.
+	 */
+	static bool IsSupported(VkFormat format) { return GetLayerLength(format, {1, 1}) != 0; }
+	static bool IsBlockCompressed(VkFormat format) { return GetBlockLength(format) != 0; }
+	static bool IsSrgb(VkFormat format);
+	/**
+	 * Gets the length of a 4x4 block.
+	 * @param format The format of the block.
+	 * @return The length in bytes, or 0 if the format is not a supported block compressed format.
+	 */
+	static uint32_t GetBlockLength(VkFormat format);
+	/**
+	 * Gets the length of a layer.
+	 * @param format The format of the layer.
+	 * @param size The size of the layer in pixels.
+	 * @return The length in bytes, or 0 if the format is not supported.
+	 */
+	static std::size_t GetLayerLength(VkFormat format, const Vector2ui &size);
+
+	const std::filesystem::path &GetFilename() const { return filename; }
+	VkFormat GetFormat() const { return format; }
+	const Vector2ui &GetSize() const { return size; }
+	uint32_t GetLevelCount() const { return static_cast<uint32_t>(levels.size()); }
+	uint32_t GetLayerCount() const { return layerCount; }
+	const std::vector<Level> &GetLevels() const { return levels; }
+
+	const uint8_t *GetData(uint32_t level = 0, uint32_t layer = 0) const { return data.get() + levels[level].offset + layer * levels[level].layerLength; }
+	uint8_t *GetData(uint32_t level = 0, uint32_t layer = 0) { return data.get() + levels[level].offset + layer * levels[level].layerLength; }
+	/**
+	 * Gets the length of every level and layer.
+	 * @return The length in bytes.
+	 */
+	std::size_t GetLength() const { return length; }
+
+private:
+	void Allocate(VkFormat format, const Vector2ui &size, uint32_t levelCount, uint32_t layerCount);
+	bool LoadKtx2(const uint8_t *file, std::size_t fileLength);
+	bool LoadDds(const uint8_t *file, std::size_t fileLength);
+
+	std::filesystem::path filename;
+	VkFormat format = VK_FORMAT_UNDEFINED;
+	Vector2ui size;
+	uint32_t layerCount = 0;
+	std::vector<Level> levels;
+	std::unique_ptr<uint8_t[]> data;
+	std::size_t length = 0;
+};
+}
@@ -0,0 +1,49 @@
+#include "TextureManifest.hpp"
+
+#include "Files/File.hpp"
+#include "Files/Files.hpp"
+
+namespace acid {
+const std::filesystem::path TextureManifest::Path = "Cooked/Textures.json";
+
+TextureManifest::TextureManifest(const std::filesystem::path &filename) {
+	Load(filename);
+}
+
+void TextureManifest::Load(const std::filesystem::path &filename) {
+	File file(File::Type::Json);
+	file.Load(filename);
+	textures.clear();
+
+	const auto &node = file.GetNode();
+	if (auto texturesNode = node["textures"]) {
+		for (const auto &texture : texturesNode->GetProperties())
+			textures.emplace(texture.GetName<std::string>(), texture.Get<std::string>());
+	}
+}
+
+void TextureManifest::Write(const std::filesystem::path &filename) const {
+	File file(File::Type::Json);
+	auto &texturesNode = file.GetNode().AddProperty("textures");
+	for (const auto &[source, cooked] : textures)
+		texturesNode.AddProperty(source).Set(cooked);
+	file.Write(filename, Node::Format::Beautified);
+}
+
+void TextureManifest::Add(const std::filesystem::path &source, const std::filesystem::path &cooked) {
+	textures[source.lexically_normal().generic_string()] = cooked.lexically_normal().generic_string();
+}
+
+std::optional<std::filesystem::path> TextureManifest::Find(const std::filesystem::path &source) const {
+	if (auto it = textures.find(source.lexically_normal().generic_string()); it != textures.end())
+		return it->second;
+	return std::nullopt;
+}
+
+std::optional<std::filesystem::path> TextureManifest::FindCooked(const std::filesystem::path &source) {
+	static const auto Manifest = []() {
+		return Files::ExistsInPath(Path) ? TextureManifest(Path) : TextureManifest();
+	}();
+	return Manifest.Find(source);
+}
+}
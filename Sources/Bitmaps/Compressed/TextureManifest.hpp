@@ -0,0 +1,54 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief Class that maps source textures to the KTX2 textures cooked from them.
+ *
+ * The texture cooker writes a manifest to Path in the resources folder, with cooked textures beside it. Images created from a
+ * source texture that the manifest in the search paths lists load the cooked texture instead, with its stored mip chain.
+ */
+class ACID_EXPORT TextureManifest {
+public:
+	/// The path of the manifest in the search paths.
+	static const std::filesystem::path Path;
+
+	TextureManifest() = default;
+	explicit TextureManifest(const std::filesystem::path &filename);
+
+	void Load(const std::filesystem::path &filename);
+	void Write(const std::filesystem::path &filename) const;
+
+	/**
+	 * Adds a cooked texture to the manifest.
+	 * @param source The path of the source texture, relative to the search paths.
+	 * @param cooked The path of the cooked texture, relative to the search paths.
+	 */
+	void Add(const std::filesystem::path &source, const std::filesystem::path &cooked);
+
+	/**
+	 * Finds the cooked texture of a source texture.
+	 * @param source The path of the source texture, relative to the search paths.
+	 * @return The path of the cooked texture, or std::nullopt if it is not in the manifest.
+	 */
+	std::optional<std::filesystem::path> Find(const std::filesystem::path &source) const;
+
+	/**
+	 * Finds the cooked texture of a source texture in the manifest found in the search paths, the manifest is loaded the first
+	 * time this is called.
+	 * @param source The path of the source texture, relative to the search paths.
+	 * @return The path of the cooked texture, or std::nullopt if it is not in the manifest.
+	 */
+	static std::optional<std::filesystem::path> FindCooked(const std::filesystem::path &source);
+
+	const std::map<std::string, std::string> &GetTextures() const { return textures; }
+
+private:
+	std::map<std::string, std::string> textures;
+};
+}
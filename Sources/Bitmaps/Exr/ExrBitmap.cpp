@@ -8,23 +8,9 @@
 #include "Maths/Time.hpp"
 
 namespace acid {
-void ExrBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
-
-	auto fileLoaded = Files::Read(filename);
-
-	if (!fileLoaded) {
-		Log::Error("Bitmap could not be loaded: ", filename, '\n');
-		return;
-	}
-
+bool ExrBitmap::Load(Bitmap *bitmap, const uint8_t *file, std::size_t length, uint8_t *pixels) {
 	// TODO
-
-#if defined(ACID_DEBUG)
-	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif
+	return false;
 }
 
 void ExrBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filename) {
@@ -33,6 +19,7 @@ void ExrBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filenam
 #endif
 
 	// TODO
+	Log::Error("Bitmap cannot be written as EXR: ", filename, '\n');
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
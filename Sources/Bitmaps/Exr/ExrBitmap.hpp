@@ -6,7 +6,7 @@ namespace acid {
 class ACID_EXPORT ExrBitmap : public Bitmap::Registrar<ExrBitmap> {
 	inline static const bool Registered = Register(".exr");
 public:
-	static void Load(Bitmap *bitmap, const std::filesystem::path &filename);
+	static bool Load(Bitmap *bitmap, const uint8_t *file, std::size_t length, uint8_t *pixels);
 	static void Write(const Bitmap *bitmap, const std::filesystem::path &filename);
 };
 }
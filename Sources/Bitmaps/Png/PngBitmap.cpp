@@ -1,41 +1,81 @@
 #include "PngBitmap.hpp"
 
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <limits>
 
 #include <libspng/spng.h>
+#include <stb/stb_image_write.h>
 
 #include "Files/Files.hpp"
 #include "Maths/Time.hpp"
 
 namespace acid {
-void PngBitmap::Load(Bitmap *bitmap, const std::filesystem::path &filename) {
-#if defined(ACID_DEBUG)
-	auto debugStart = Time::Now();
-#endif
+/// The largest width and height decoded, no GPU samples images larger.
+static constexpr uint32_t MaxSize = 32768;
 
-	auto fileLoaded = Files::Read(filename);
+bool PngBitmap::Load(Bitmap *bitmap, const uint8_t *file, std::size_t length, uint8_t *pixels) {
+	std::unique_ptr<spng_ctx, decltype(&spng_ctx_free)> ctx(spng_ctx_new(0), spng_ctx_free);
+	if (!ctx || spng_set_png_buffer(ctx.get(), file, length))
+		return false;
 
-	if (!fileLoaded) {
-		Log::Error("Bitmap could not be loaded: ", filename, '\n');
-		return;
+	// Headers are untrusted, images larger than Vulkan could sample are refused before their size is used.
+	if (spng_set_image_limits(ctx.get(), MaxSize, MaxSize))
+		return false;
+
+	spng_ihdr ihdr;
+	if (spng_get_ihdr(ctx.get(), &ihdr))
+		return false;
+
+	// Grey and colour images are kept without expanding to RGBA8 when asked to, transparency keys need an alpha channel.
+	spng_trns trns;
+	auto hasTrns = spng_get_trns(ctx.get(), &trns) == 0;
+	auto bytesPerPixel = bitmap->GetBytesPerPixel();
+
+	if (bytesPerPixel == 0) {
+		if (ihdr.color_type == SPNG_COLOR_TYPE_GRAYSCALE && ihdr.bit_depth <= 8)
+			bytesPerPixel = hasTrns ? 2 : 1;
+		else if ((ihdr.color_type == SPNG_COLOR_TYPE_TRUECOLOR || ihdr.color_type == SPNG_COLOR_TYPE_INDEXED) && !hasTrns)
+			bytesPerPixel = 3;
+		else
+			bytesPerPixel = 4;
 	}
-	
-	/*uint8_t *buffer;
-	uint32_t width = 0, height = 0;
-	auto error = lodepng_decode_memory(&buffer, &width, &height, reinterpret_cast<const uint8_t *>(fileLoaded->data()), fileLoaded->length(), LCT_RGBA, 8);
-	if (buffer && !error) {
-		LodePNGColorMode color = {LCT_RGBA, 8};
-		auto buffersize = lodepng_get_raw_size(width, height, &color);
-		bitmap->SetData(std::make_unique<uint8_t[]>(buffersize));
-		std::memcpy(bitmap->GetData().get(), buffer, buffersize);
-		bitmap->SetSize({ width, height });
-		bitmap->SetBytesPerPixel(buffersize / (width * height));
-		free(buffer); // lodepng_free
-	}*/
 
-#if defined(ACID_DEBUG)
-	Log::Out("Bitmap ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
-#endif
+	int format;
+	switch (bytesPerPixel) {
+	case 1:
+		format = SPNG_FMT_G8;
+		break;
+	case 2:
+		format = SPNG_FMT_GA8;
+		break;
+	case 3:
+		format = SPNG_FMT_RGB8;
+		break;
+	case 4:
+		format = SPNG_FMT_RGBA8;
+		break;
+	default:
+		return false;
+	}
+
+	// spng only gives grey formats for grey images, any other pairing is left to stb_image.
+	std::size_t decodedLength;
+	if (spng_decoded_image_size(ctx.get(), format, &decodedLength) || decodedLength != std::size_t(ihdr.width) * ihdr.height * bytesPerPixel)
+		return false;
+
+	// The bitmaps length is 32 bit, it must hold every decoded byte.
+	if (decodedLength > std::numeric_limits<uint32_t>::max())
+		return false;
+
+	bitmap->SetSize({ihdr.width, ihdr.height});
+	bitmap->SetBytesPerPixel(bytesPerPixel);
+
+	if (!pixels)
+		return true;
+
+	return spng_decode_image(ctx.get(), pixels, decodedLength, format, SPNG_DECODE_TRNS) == 0;
 }
 
 void PngBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filename) {
@@ -43,15 +83,16 @@ void PngBitmap::Write(const Bitmap *bitmap, const std::filesystem::path &filenam
 	auto debugStart = Time::Now();
 #endif
 
-	/*LodePNGColorType colorType = LCT_GREY;
-	if (bitmap->GetBytesPerPixel() == 4)
-		colorType = LCT_RGBA;
-	else if (bitmap->GetBytesPerPixel() == 3)
-		colorType = LCT_RGB;
-	else
-		Log::Error("Cannot write PNG with ", bitmap->GetBytesPerPixel(), " bytes per pixel\n");
+	// spng does not encode, stb_image_write writes the PNG.
+	std::ofstream os(filename, std::ios::binary | std::ios::out);
+	int32_t len;
+	// stb_image_write allocates with malloc, so it is freed with free and not delete[].
+	std::unique_ptr<uint8_t, decltype(&std::free)> png(stbi_write_png_to_mem(bitmap->GetData().get(), bitmap->GetSize().x * bitmap->GetBytesPerPixel(),
+		bitmap->GetSize().x, bitmap->GetSize().y, bitmap->GetBytesPerPixel(), &len), std::free);
+	if (!png)
+		return;
 
-	lodepng::encode(filename.string(), bitmap->GetData().get(), bitmap->GetSize().x, bitmap->GetSize().y, colorType);*/
+	os.write(reinterpret_cast<char *>(png.get()), len);
 
 #if defined(ACID_DEBUG)
 	Log::Out("Bitmap ", filename, " written in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
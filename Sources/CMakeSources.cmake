@@ -16,11 +16,14 @@ set(_temp_acid_headers
 		Audio/Flac/FlacSoundBuffer.hpp
 		Audio/Mp3/Mp3SoundBuffer.hpp
 		Audio/Ogg/OggSoundBuffer.hpp
-		Audio/Opus/OpusSoundBuffer.hpp
 		Audio/Sound.hpp
 		Audio/SoundBuffer.hpp
+		Audio/SoundBufferCache.hpp
 		Audio/Wave/WaveSoundBuffer.hpp
 		Bitmaps/Bitmap.hpp
+		Bitmaps/Compressed/BlockCompression.hpp
+		Bitmaps/Compressed/CompressedBitmap.hpp
+		Bitmaps/Compressed/TextureManifest.hpp
 		Bitmaps/Dng/DngBitmap.hpp
 		Bitmaps/Exr/ExrBitmap.hpp
 		Bitmaps/Jpg/JpgBitmap.hpp
@@ -41,14 +44,19 @@ set(_temp_acid_headers
 		Files/File.hpp
 		Files/FileObserver.hpp
 		Files/Files.hpp
+		Files/Binary/Binary.hpp
 		Files/Json/Json.hpp
 		Files/Node.hpp
 		Files/Node.inl
+		Files/NodeArena.hpp
 		Files/NodeConstView.hpp
 		Files/NodeConstView.inl
 		Files/NodeView.hpp
 		Files/NodeView.inl
+		Files/Pack/AssetPack.hpp
+		Files/Pack/AssetPackWriter.hpp
 		Files/Xml/Xml.hpp
+		Files/Xml/XmlReader.hpp
 		Files/Zip/ZipArchive.hpp
 		Files/Zip/ZipEntry.hpp
 		Files/Zip/ZipException.hpp
@@ -77,6 +85,7 @@ set(_temp_acid_headers
 		Graphics/Images/Image2dArray.hpp
 		Graphics/Images/ImageCube.hpp
 		Graphics/Images/ImageDepth.hpp
+		Graphics/Images/TextureStreamer.hpp
 		Graphics/Pipelines/Pipeline.hpp
 		Graphics/Pipelines/PipelineCompute.hpp
 		Graphics/Pipelines/PipelineGraphics.hpp
@@ -110,6 +119,7 @@ set(_temp_acid_headers
 		Materials/DefaultMaterial.hpp
 		Materials/Material.hpp
 		Materials/MaterialPipeline.hpp
+		Maths/Batch.hpp
 		Maths/Colour.hpp
 		Maths/Colour.inl
 		Maths/ElapsedTime.hpp
@@ -118,6 +128,8 @@ set(_temp_acid_headers
 		Maths/Matrix3.hpp
 		Maths/Matrix4.hpp
 		Maths/Quaternion.hpp
+		Maths/Random.hpp
+		Maths/Simd.hpp
 		Maths/Time.hpp
 		Maths/Time.inl
 		Maths/Transform.hpp
@@ -125,6 +137,7 @@ set(_temp_acid_headers
 		Maths/Vector2.inl
 		Maths/Vector3.hpp
 		Maths/Vector3.inl
+		Maths/Vector3Soa.hpp
 		Maths/Vector4.hpp
 		Maths/Vector4.inl
 		Meshes/Mesh.hpp
@@ -151,11 +164,14 @@ set(_temp_acid_headers
 		Network/Http/HttpResponse.hpp
 		Network/IpAddress.hpp
 		Network/Packet.hpp
+		Network/PacketBufferPool.hpp
 		Network/Socket.hpp
+		Network/SocketPoller.hpp
 		Network/SocketSelector.hpp
 		Network/Tcp/TcpListener.hpp
 		Network/Tcp/TcpSocket.hpp
 		Network/Udp/UdpSocket.hpp
+		Network/Udp/UdpTransport.hpp
 		Particles/Emitters/CircleEmitter.hpp
 		Particles/Emitters/Emitter.hpp
 		Particles/Emitters/LineEmitter.hpp
@@ -203,6 +219,7 @@ set(_temp_acid_headers
 		Post/Pipelines/BlurPipeline.hpp
 		Post/PostFilter.hpp
 		Post/PostPipeline.hpp
+		Resources/HotReloader.hpp
 		Resources/Resource.hpp
 		Resources/Resources.hpp
 		Scenes/Camera.hpp
@@ -213,6 +230,7 @@ set(_temp_acid_headers
 		Scenes/ScenePhysics.hpp
 		Scenes/Scenes.hpp
 		Scenes/SceneStructure.hpp
+		Scenes/SpatialTree.hpp
 		Shadows/ShadowBox.hpp
 		Shadows/ShadowRender.hpp
 		Shadows/Shadows.hpp
@@ -297,11 +315,14 @@ set(_temp_acid_sources
 		Audio/Flac/FlacSoundBuffer.cpp
 		Audio/Mp3/Mp3SoundBuffer.cpp
 		Audio/Ogg/OggSoundBuffer.cpp
-		Audio/Opus/OpusSoundBuffer.cpp
 		Audio/Sound.cpp
 		Audio/SoundBuffer.cpp
+		Audio/SoundBufferCache.cpp
 		Audio/Wave/WaveSoundBuffer.cpp
 		Bitmaps/Bitmap.cpp
+		Bitmaps/Compressed/BlockCompression.cpp
+		Bitmaps/Compressed/CompressedBitmap.cpp
+		Bitmaps/Compressed/TextureManifest.cpp
 		Bitmaps/Dng/DngBitmap.cpp
 		Bitmaps/Exr/ExrBitmap.cpp
 		Bitmaps/Jpg/JpgBitmap.cpp
@@ -320,11 +341,16 @@ set(_temp_acid_sources
 		Files/File.cpp
 		Files/FileObserver.cpp
 		Files/Files.cpp
+		Files/Binary/Binary.cpp
 		Files/Json/Json.cpp
 		Files/Node.cpp
+		Files/NodeArena.cpp
 		Files/NodeConstView.cpp
 		Files/NodeView.cpp
+		Files/Pack/AssetPack.cpp
+		Files/Pack/AssetPackWriter.cpp
 		Files/Xml/Xml.cpp
+		Files/Xml/XmlReader.cpp
 		Files/Zip/ZipArchive.cpp
 		Files/Zip/ZipEntry.cpp
 		Fonts/FontsSubrender.cpp
@@ -351,6 +377,7 @@ set(_temp_acid_sources
 		Graphics/Images/Image2dArray.cpp
 		Graphics/Images/ImageCube.cpp
 		Graphics/Images/ImageDepth.cpp
+		Graphics/Images/TextureStreamer.cpp
 		Graphics/Pipelines/PipelineCompute.cpp
 		Graphics/Pipelines/PipelineGraphics.cpp
 		Graphics/Pipelines/Shader.cpp
@@ -378,6 +405,7 @@ set(_temp_acid_sources
 		Lights/Light.cpp
 		Materials/DefaultMaterial.cpp
 		Materials/MaterialPipeline.cpp
+		Maths/Batch.cpp
 		Maths/Colour.cpp
 		Maths/ElapsedTime.cpp
 		Maths/Maths.cpp
@@ -385,6 +413,7 @@ set(_temp_acid_sources
 		Maths/Matrix3.cpp
 		Maths/Matrix4.cpp
 		Maths/Quaternion.cpp
+		Maths/Random.cpp
 		Maths/Transform.cpp
 		Maths/Vector2.cpp
 		Maths/Vector3.cpp
@@ -411,11 +440,14 @@ set(_temp_acid_sources
 		Network/Http/HttpResponse.cpp
 		Network/IpAddress.cpp
 		Network/Packet.cpp
+		Network/PacketBufferPool.cpp
 		Network/Socket.cpp
+		Network/SocketPoller.cpp
 		Network/SocketSelector.cpp
 		Network/Tcp/TcpListener.cpp
 		Network/Tcp/TcpSocket.cpp
 		Network/Udp/UdpSocket.cpp
+		Network/Udp/UdpTransport.cpp
 		Particles/Emitters/CircleEmitter.cpp
 		Particles/Emitters/LineEmitter.cpp
 		Particles/Emitters/PointEmitter.cpp
@@ -461,12 +493,14 @@ set(_temp_acid_sources
 		Post/Filters/WobbleFilter.cpp
 		Post/Pipelines/BlurPipeline.cpp
 		Post/PostFilter.cpp
+		Resources/HotReloader.cpp
 		Resources/Resources.cpp
 		Scenes/Entity.cpp
 		Scenes/EntityPrefab.cpp
 		Scenes/ScenePhysics.cpp
 		Scenes/Scenes.cpp
 		Scenes/SceneStructure.cpp
+		Scenes/SpatialTree.cpp
 		Shadows/ShadowBox.cpp
 		Shadows/ShadowRender.cpp
 		Shadows/Shadows.cpp
@@ -76,6 +76,13 @@ void Instance::FvkCmdPushDescriptorSetKHR(VkDevice device, VkCommandBuffer comma
 		func(commandBuffer, pipelineBindPoint, layout, set, descriptorWriteCount, pDescriptorWrites);
 }
 
+void Instance::FvkCmdDrawIndexedIndirectCountKHR(VkDevice device, VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer,
+	VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride) {
+	auto func = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR"));
+	if (func)
+		func(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
+}
+
 uint32_t Instance::FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties *deviceMemoryProperties, const VkMemoryRequirements *memoryRequirements,
 	VkMemoryPropertyFlags requiredProperties) {
 	for (uint32_t i = 0; i < deviceMemoryProperties->memoryTypeCount; ++i) {
@@ -38,6 +38,8 @@ public:
 
 	static void FvkCmdPushDescriptorSetKHR(VkDevice device, VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t set,
 		uint32_t descriptorWriteCount, const VkWriteDescriptorSet *pDescriptorWrites);
+	static void FvkCmdDrawIndexedIndirectCountKHR(VkDevice device, VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer,
+		VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride);
 
 	static uint32_t FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties *deviceMemoryProperties, const VkMemoryRequirements *memoryRequirements,
 		VkMemoryPropertyFlags requiredProperties);
@@ -1,5 +1,7 @@
 #include "LogicalDevice.hpp"
 
+#include <cstring>
+
 #include "Graphics/Graphics.hpp"
 #include "Instance.hpp"
 #include "PhysicalDevice.hpp"
@@ -109,8 +111,6 @@ void LogicalDevice::CreateLogicalDevice() {
 		transferFamily = graphicsFamily;
 	}
 
-	VkPhysicalDeviceFeatures enabledFeatures = {};
-
 	// Enable sample rate shading filtering if supported.
 	if (physicalDeviceFeatures.sampleRateShading)
 		enabledFeatures.sampleRateShading = VK_TRUE;
@@ -176,6 +176,31 @@ void LogicalDevice::CreateLogicalDevice() {
 	else
 		Log::Warning("Selected GPU does not support multi viewports!\n");
 
+	if (physicalDeviceFeatures.multiDrawIndirect)
+		enabledFeatures.multiDrawIndirect = VK_TRUE;
+	else
+		Log::Warning("Selected GPU does not support multi draw indirect!\n");
+
+	if (physicalDeviceFeatures.drawIndirectFirstInstance)
+		enabledFeatures.drawIndirectFirstInstance = VK_TRUE;
+	else
+		Log::Warning("Selected GPU does not support draw indirect first instance!\n");
+
+	auto deviceExtensions = DeviceExtensions;
+
+	// Draw indirect count lets the GPU choose how many indirect draws run, it is not required.
+	uint32_t extensionPropertyCount;
+	vkEnumerateDeviceExtensionProperties(*physicalDevice, nullptr, &extensionPropertyCount, nullptr);
+	std::vector<VkExtensionProperties> extensionProperties(extensionPropertyCount);
+	vkEnumerateDeviceExtensionProperties(*physicalDevice, nullptr, &extensionPropertyCount, extensionProperties.data());
+
+	for (const auto &extension : extensionProperties) {
+		if (std::strcmp(extension.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0) {
+			deviceExtensions.emplace_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+			drawIndirectCount = true;
+		}
+	}
+
 	VkDeviceCreateInfo deviceCreateInfo = {};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
@@ -184,8 +209,8 @@ void LogicalDevice::CreateLogicalDevice() {
 		deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(Instance::ValidationLayers.size());
 		deviceCreateInfo.ppEnabledLayerNames = Instance::ValidationLayers.data();
 	}
-	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(DeviceExtensions.size());
-	deviceCreateInfo.ppEnabledExtensionNames = DeviceExtensions.data();
+	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+	deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 	deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 	Graphics::CheckVk(vkCreateDevice(*physicalDevice, &deviceCreateInfo, nullptr, &logicalDevice));
 
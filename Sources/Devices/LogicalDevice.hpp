@@ -28,6 +28,7 @@ public:
 	uint32_t GetPresentFamily() const { return presentFamily; }
 	uint32_t GetComputeFamily() const { return computeFamily; }
 	uint32_t GetTransferFamily() const { return transferFamily; }
+	bool IsDrawIndirectCount() const { return drawIndirectCount; }
 
 	static const std::vector<const char *> DeviceExtensions;
 	
@@ -52,5 +53,7 @@ private:
 	VkQueue presentQueue = VK_NULL_HANDLE;
 	VkQueue computeQueue = VK_NULL_HANDLE;
 	VkQueue transferQueue = VK_NULL_HANDLE;
+
+	bool drawIndirectCount = false;
 };
 }
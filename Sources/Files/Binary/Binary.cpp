@@ -0,0 +1,633 @@
+#include "Binary.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <miniz/miniz.h>
+
+#include "Utils/String.hpp"
+
+namespace acid {
+static constexpr char Magic[4] = {'\x89', 'A', 'N', 'B'};
+static constexpr uint8_t Version = 1;
+static constexpr uint8_t DeflatedFlag = 1;
+/// Payloads smaller than this are never compressed automatically.
+static constexpr std::size_t CompressionThreshold = 4096;
+/// Arrays shorter than this are written element by element, packing would not save anything.
+static constexpr std::size_t MinPackedCount = 4;
+
+enum class Tag : uint8_t {
+	Null, False, True, Integer, Float32, Float64, String, Object, Array, PackedInteger, PackedFloat32, PackedFloat64,
+	/// A value kept as text with its node type, for values that do not round trip through a typed encoding.
+	Text
+};
+
+/// The node has a name, followed by its index in the string table.
+static constexpr uint8_t NamedFlag = 0x80;
+/// A container that also has a value (Xml elements with text), followed by the value string.
+static constexpr uint8_t ValueFlag = 0x40;
+/// A container whose type is not Object or Array, followed by the type.
+static constexpr uint8_t TypedFlag = 0x20;
+static constexpr uint8_t TagMask = 0x1F;
+
+static void WriteVarint(std::string &out, uint64_t value) {
+	while (value >= 0x80) {
+		out += static_cast<char>(value | 0x80);
+		value >>= 7;
+	}
+	out += static_cast<char>(value);
+}
+
+static uint64_t ZigZag(int64_t value) {
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value) {
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+template<typename T>
+static void WriteRaw(std::string &out, T value) {
+	char bytes[sizeof(T)];
+	std::memcpy(bytes, &value, sizeof(T));
+	out.append(bytes, sizeof(T));
+}
+
+// Integers are only encoded as integers if they can be written back exactly as they were.
+static bool ParseInteger(const std::string &value, int64_t &result) {
+	if (value.empty() || value.size() > 20)
+		return false;
+
+	char *end;
+	errno = 0;
+	result = std::strtoll(value.c_str(), &end, 10);
+	return errno == 0 && *end == '\0' && std::to_string(result) == value;
+}
+
+static std::size_t SignificantDigits(const std::string &value) {
+	std::size_t digits = 0, zeros = 0;
+	bool leading = true;
+
+	for (auto c : value) {
+		if (c == 'e' || c == 'E')
+			break;
+		if (c < '0' || c > '9')
+			continue;
+		if (c == '0') {
+			// Leading zeros never count, trailing zeros only count if followed by another digit.
+			if (!leading)
+				zeros++;
+			continue;
+		}
+		leading = false;
+		digits += zeros + 1;
+		zeros = 0;
+	}
+
+	return digits;
+}
+
+// Decimals are stored as floats if they have no more significant digits than a float can hold,
+// or if they are exactly how a float is written by String::To.
+static bool ParseDecimal(const std::string &value, double &result, bool &single) {
+	if (value.empty())
+		return false;
+
+	char *end;
+	result = std::strtod(value.c_str(), &end);
+	if (*end != '\0')
+		return false;
+
+	single = std::abs(result) <= FLT_MAX && (result == 0.0 || std::abs(result) >= FLT_MIN) &&
+		(SignificantDigits(value) <= FLT_DIG || String::To(static_cast<float>(result)) == value);
+	return true;
+}
+
+// Finds the shortest text that reads back as the same value.
+template<typename T>
+static std::string FormatDecimal(T value) {
+	char buffer[32];
+#if defined(__cpp_lib_to_chars)
+	auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	return std::string(buffer, result.ptr);
+#else
+	for (int precision = std::is_same_v<T, float> ? 6 : 15; ; precision++) {
+		std::snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+		if (precision >= (std::is_same_v<T, float> ? 9 : 17) || static_cast<T>(std::strtod(buffer, nullptr)) == value)
+			return buffer;
+	}
+#endif
+}
+
+// Typed decimals are stored as floats under the same rule, applied to their shortest text.
+static bool IsSingle(double value) {
+	if (std::abs(value) > FLT_MAX || (value != 0.0 && std::abs(value) < FLT_MIN))
+		return false;
+	return static_cast<double>(static_cast<float>(value)) == value || SignificantDigits(FormatDecimal(value)) <= FLT_DIG;
+}
+
+// Reads a value as an integer or decimal from either its typed or text representation.
+static bool GetNumber(const Node &node, int64_t &integer, double &decimal, bool &single) {
+	return std::visit([&](const auto &value) {
+		using T = std::decay_t<decltype(value)>;
+		if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+			if (node.GetType() == Node::Type::Integer)
+				return ParseInteger(std::string(value), integer);
+			return node.GetType() == Node::Type::Decimal && ParseDecimal(std::string(value), decimal, single);
+		} else if constexpr (std::is_same_v<T, int64_t>) {
+			integer = value;
+			return node.GetType() == Node::Type::Integer;
+		} else if constexpr (std::is_same_v<T, float>) {
+			decimal = value;
+			single = true;
+			return node.GetType() == Node::Type::Decimal;
+		} else if constexpr (std::is_same_v<T, double>) {
+			decimal = value;
+			single = IsSingle(value);
+			return node.GetType() == Node::Type::Decimal;
+		} else {
+			return false;
+		}
+	}, node.GetTypedValue());
+}
+
+class BinaryWriter {
+public:
+	explicit BinaryWriter(std::string &out) :
+		out(out) {
+	}
+
+	void CollectNames(const Node &node) {
+		if (!node.GetName().empty())
+			names.emplace(std::string(node.GetName()), static_cast<uint32_t>(names.size()));
+
+		// Packed elements have no names, and must not be expanded.
+		if (node.GetPacked())
+			return;
+
+		for (const auto &property : node.GetProperties())
+			CollectNames(property);
+	}
+
+	void WriteNames() {
+		std::vector<const std::string *> table(names.size());
+		for (const auto &[name, index] : names)
+			table[index] = &name;
+
+		WriteVarint(out, table.size());
+		for (auto name : table) {
+			WriteVarint(out, name->size());
+			out += *name;
+		}
+	}
+
+	void WriteNode(const Node &node) {
+		auto tagPosition = out.size();
+		out += '\0';
+		uint8_t flags = 0;
+
+		if (!node.GetName().empty()) {
+			flags |= NamedFlag;
+			WriteVarint(out, names[std::string(node.GetName())] + 1);
+		}
+
+		out[tagPosition] = static_cast<char>(WriteValue(node, flags) | flags);
+	}
+
+private:
+	uint8_t WriteValue(const Node &node, uint8_t &flags) {
+		if (auto packed = node.GetPacked()) {
+			if (node.GetType() == Node::Type::Array) {
+				if (auto tag = WritePacked(*packed); tag != Tag::Null)
+					return static_cast<uint8_t>(tag);
+			}
+
+			// Elements that do not fit an encoding are written from an expanded copy, the node being written is not changed.
+			Node expanded(node);
+			expanded.Unpack();
+			return WriteValue(expanded, flags);
+		}
+
+		const auto &properties = node.GetProperties();
+		auto value = node.GetValue();
+
+		if (!properties.empty() || node.GetType() == Node::Type::Object || node.GetType() == Node::Type::Array) {
+			if (auto packed = WritePacked(node); packed != Tag::Null)
+				return static_cast<uint8_t>(packed);
+
+			if (node.GetType() != Node::Type::Object && node.GetType() != Node::Type::Array) {
+				flags |= TypedFlag;
+				out += static_cast<char>(node.GetType());
+			}
+
+			if (!value.empty()) {
+				flags |= ValueFlag;
+				WriteString(value);
+			}
+
+			WriteVarint(out, properties.size());
+			for (const auto &property : properties)
+				WriteNode(property);
+			return static_cast<uint8_t>(node.GetType() == Node::Type::Array ? Tag::Array : Tag::Object);
+		}
+
+		int64_t integer;
+		double decimal;
+		bool single;
+
+		switch (node.GetType()) {
+		case Node::Type::Null:
+			if (value.empty())
+				return static_cast<uint8_t>(Tag::Null);
+			break;
+		case Node::Type::Boolean:
+			if (value == "true" || value == "false")
+				return static_cast<uint8_t>(value == "true" ? Tag::True : Tag::False);
+			break;
+		case Node::Type::Integer:
+			if (GetNumber(node, integer, decimal, single)) {
+				WriteVarint(out, ZigZag(integer));
+				return static_cast<uint8_t>(Tag::Integer);
+			}
+			break;
+		case Node::Type::Decimal:
+			if (GetNumber(node, integer, decimal, single)) {
+				if (single)
+					WriteRaw(out, static_cast<float>(decimal));
+				else
+					WriteRaw(out, decimal);
+				return static_cast<uint8_t>(single ? Tag::Float32 : Tag::Float64);
+			}
+			break;
+		case Node::Type::String:
+			WriteString(value);
+			return static_cast<uint8_t>(Tag::String);
+		default:
+			break;
+		}
+
+		out += static_cast<char>(node.GetType());
+		WriteString(value);
+		return static_cast<uint8_t>(Tag::Text);
+	}
+
+	// Packed arrays are written as they are stored, the tag is Null if the elements do not fit an encoding.
+	Tag WritePacked(const Node::Packed &packed) {
+		auto size = packed.GetSize();
+
+		if (packed.IsInteger()) {
+			if (packed.GetElement() == Node::Packed::Element::UInt64) {
+				for (std::size_t i = 0; i < size; i++) {
+					if (packed.Get<uint64_t>(i) > static_cast<uint64_t>(INT64_MAX))
+						return Tag::Null;
+				}
+			}
+
+			WriteVarint(out, size);
+			for (std::size_t i = 0; i < size; i++)
+				WriteVarint(out, ZigZag(packed.Get<int64_t>(i)));
+			return Tag::PackedInteger;
+		}
+
+		auto single = packed.GetElement() == Node::Packed::Element::Float;
+		for (std::size_t i = 0; !single && i < size; i++) {
+			if (!IsSingle(packed.Get<double>(i)))
+				break;
+			single = i == size - 1;
+		}
+
+		WriteVarint(out, size);
+		for (std::size_t i = 0; i < size; i++) {
+			if (single)
+				WriteRaw(out, packed.Get<float>(i));
+			else
+				WriteRaw(out, packed.Get<double>(i));
+		}
+		return single ? Tag::PackedFloat32 : Tag::PackedFloat64;
+	}
+
+	// Arrays of unnamed integers or decimals are written as one block, the tag is Null if the node can't be packed.
+	Tag WritePacked(const Node &node) {
+		const auto &properties = node.GetProperties();
+
+		if (node.GetType() != Node::Type::Array || properties.size() < MinPackedCount || !node.GetValue().empty())
+			return Tag::Null;
+
+		auto type = properties.front().GetType();
+		if (type != Node::Type::Integer && type != Node::Type::Decimal)
+			return Tag::Null;
+
+		std::vector<int64_t> integers;
+		std::vector<double> decimals;
+		bool allSingle = true;
+
+		for (const auto &property : properties) {
+			if (property.GetType() != type || !property.GetName().empty() || !property.GetProperties().empty())
+				return Tag::Null;
+
+			int64_t integer;
+			double decimal;
+			bool single;
+			if (!GetNumber(property, integer, decimal, single))
+				return Tag::Null;
+
+			if (type == Node::Type::Integer) {
+				integers.emplace_back(integer);
+			} else {
+				decimals.emplace_back(decimal);
+				allSingle &= single;
+			}
+		}
+
+		WriteVarint(out, properties.size());
+
+		if (type == Node::Type::Integer) {
+			for (auto integer : integers)
+				WriteVarint(out, ZigZag(integer));
+			return Tag::PackedInteger;
+		}
+
+		if (allSingle) {
+			for (auto decimal : decimals)
+				WriteRaw(out, static_cast<float>(decimal));
+			return Tag::PackedFloat32;
+		}
+
+		for (auto decimal : decimals)
+			WriteRaw(out, decimal);
+		return Tag::PackedFloat64;
+	}
+
+	void WriteString(const std::string &value) {
+		WriteVarint(out, value.size());
+		out += value;
+	}
+
+	std::string &out;
+	std::unordered_map<std::string, uint32_t> names;
+};
+
+class BinaryReader {
+public:
+	BinaryReader(const char *it, const char *end) :
+		it(it),
+		end(end) {
+	}
+
+	void ReadNames() {
+		auto count = ReadVarint();
+		// Every name takes at least one byte, a larger count is a corrupt file.
+		if (count > static_cast<uint64_t>(end - it))
+			throw std::runtime_error("Binary node string table is corrupt");
+
+		names.reserve(count);
+		for (uint64_t i = 0; i < count; i++)
+			names.emplace_back(ReadString());
+	}
+
+	void ReadNode(Node &node) {
+		auto tag = ReadByte();
+
+		if (tag & NamedFlag) {
+			auto index = ReadVarint();
+			if (index == 0 || index > names.size())
+				throw std::runtime_error("Binary node name index out of range");
+			node.SetName(names[index - 1]);
+		}
+
+		switch (static_cast<Tag>(tag & TagMask)) {
+		case Tag::Null:
+			node.SetType(Node::Type::Null);
+			break;
+		case Tag::False:
+		case Tag::True:
+			node << (static_cast<Tag>(tag & TagMask) == Tag::True);
+			break;
+		case Tag::Integer:
+			node << UnZigZag(ReadVarint());
+			break;
+		case Tag::Float32:
+			node << ReadRaw<float>();
+			break;
+		case Tag::Float64:
+			node << ReadRaw<double>();
+			break;
+		case Tag::String:
+			node.SetValue(ReadString());
+			node.SetType(Node::Type::String);
+			break;
+		case Tag::Text: {
+			auto type = ReadType();
+			node.SetValue(ReadString());
+			node.SetType(type);
+			break;
+		}
+		case Tag::Object:
+		case Tag::Array: {
+			auto type = static_cast<Tag>(tag & TagMask) == Tag::Array ? Node::Type::Array : Node::Type::Object;
+			if (tag & TypedFlag)
+				type = ReadType();
+			if (tag & ValueFlag)
+				node.SetValue(ReadString());
+
+			auto count = ReadCount(1);
+			node.GetProperties().reserve(count);
+			for (uint64_t i = 0; i < count; i++)
+				ReadNode(node.AddProperty());
+			node.SetType(type);
+			break;
+		}
+		case Tag::PackedInteger: {
+			std::vector<int64_t> integers(ReadCount(1));
+			for (auto &integer : integers)
+				integer = UnZigZag(ReadVarint());
+			node.SetTypedValue(Node::Packed(integers.data(), integers.size()));
+			node.SetType(Node::Type::Array);
+			break;
+		}
+		case Tag::PackedFloat32:
+			ReadPacked<float>(node);
+			break;
+		case Tag::PackedFloat64:
+			ReadPacked<double>(node);
+			break;
+		default:
+			throw std::runtime_error("Binary node has an unknown tag");
+		}
+	}
+
+private:
+	uint8_t ReadByte() {
+		if (it == end)
+			throw std::runtime_error("Binary node data ended early");
+		return static_cast<uint8_t>(*it++);
+	}
+
+	Node::Type ReadType() {
+		auto type = ReadByte();
+		if (type > static_cast<uint8_t>(Node::Type::Unknown))
+			throw std::runtime_error("Binary node has an unknown type");
+		return static_cast<Node::Type>(type);
+	}
+
+	uint64_t ReadVarint() {
+		uint64_t value = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7) {
+			auto byte = ReadByte();
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		throw std::runtime_error("Binary node varint is too long");
+	}
+
+	// Reads an element count, checked against the remaining data so a corrupt count can't allocate gigabytes.
+	uint64_t ReadCount(std::size_t minElementSize) {
+		auto count = ReadVarint();
+		if (count > static_cast<uint64_t>(end - it) / minElementSize)
+			throw std::runtime_error("Binary node count is larger than the data");
+		return count;
+	}
+
+	template<typename T>
+	T ReadRaw() {
+		if (static_cast<std::size_t>(end - it) < sizeof(T))
+			throw std::runtime_error("Binary node data ended early");
+		T value;
+		std::memcpy(&value, it, sizeof(T));
+		it += sizeof(T);
+		return value;
+	}
+
+	template<typename T>
+	void ReadPacked(Node &node) {
+		std::vector<T> decimals(ReadCount(sizeof(T)));
+		if (!decimals.empty()) {
+			std::memcpy(decimals.data(), it, decimals.size() * sizeof(T));
+			it += decimals.size() * sizeof(T);
+		}
+		node.SetTypedValue(Node::Packed(decimals.data(), decimals.size()));
+		node.SetType(Node::Type::Array);
+	}
+
+	std::string ReadString() {
+		auto size = ReadCount(1);
+		std::string value(it, size);
+		it += size;
+		return value;
+	}
+
+	const char *it;
+	const char *end;
+	std::vector<std::string> names;
+};
+
+bool Binary::IsBinary(std::string_view string) {
+	return string.size() >= sizeof(Magic) && std::memcmp(string.data(), Magic, sizeof(Magic)) == 0;
+}
+
+void Binary::ParseString(Node &node, std::string_view string) {
+	if (!IsBinary(string) || string.size() < sizeof(Magic) + 2)
+		throw std::runtime_error("Data is not a binary node");
+
+	auto version = static_cast<uint8_t>(string[sizeof(Magic)]);
+	auto flags = static_cast<uint8_t>(string[sizeof(Magic) + 1]);
+	if (version > Version)
+		throw std::runtime_error("Binary node version is newer than supported");
+
+	auto payload = string.substr(sizeof(Magic) + 2);
+	std::string inflated;
+
+	if (flags & DeflatedFlag) {
+		if (payload.size() < sizeof(uint64_t))
+			throw std::runtime_error("Binary node data ended early");
+
+		uint64_t size;
+		std::memcpy(&size, payload.data(), sizeof(uint64_t));
+		auto deflated = payload.substr(sizeof(uint64_t));
+
+		// Deflate expands data at most 1032 times, a larger size can only come from a corrupt header.
+		if (size > static_cast<uint64_t>(deflated.size()) * 1032)
+			throw std::runtime_error("Binary node inflated size is larger than the data");
+
+		// The size is still untrusted, so the output grows as data is inflated and never past the size.
+		mz_stream stream = {};
+		if (mz_inflateInit(&stream) != MZ_OK)
+			throw std::runtime_error("Binary node data could not be inflated");
+
+		stream.next_in = reinterpret_cast<const unsigned char *>(deflated.data());
+		stream.avail_in = static_cast<unsigned int>(deflated.size());
+		inflated.resize(static_cast<std::size_t>(std::min<uint64_t>(size, 4 * static_cast<uint64_t>(deflated.size()) + 64)));
+		int status = MZ_OK;
+
+		while (status == MZ_OK) {
+			if (stream.total_out == inflated.size()) {
+				if (inflated.size() == size)
+					break;
+				inflated.resize(static_cast<std::size_t>(std::min<uint64_t>(size, 2 * static_cast<uint64_t>(inflated.size()))));
+			}
+
+			stream.next_out = reinterpret_cast<unsigned char *>(inflated.data()) + stream.total_out;
+			stream.avail_out = static_cast<unsigned int>(inflated.size() - stream.total_out);
+			status = mz_inflate(&stream, MZ_NO_FLUSH);
+		}
+
+		auto inflatedSize = stream.total_out;
+		mz_inflateEnd(&stream);
+
+		if (status != MZ_STREAM_END || inflatedSize != size)
+			throw std::runtime_error("Binary node data could not be inflated");
+		payload = inflated;
+	}
+
+	BinaryReader reader(payload.data(), payload.data() + payload.size());
+	reader.ReadNames();
+	reader.ReadNode(node);
+}
+
+void Binary::WriteStream(const Node &node, std::ostream &stream, Node::Format /*format*/) {
+	WriteStream(node, stream, Compression::Auto);
+}
+
+void Binary::WriteStream(const Node &node, std::ostream &stream, Compression compression) {
+	std::string payload;
+	BinaryWriter writer(payload);
+	writer.CollectNames(node);
+	writer.WriteNames();
+	writer.WriteNode(node);
+
+	std::string deflated;
+
+	if (compression == Compression::Deflate || (compression == Compression::Auto && payload.size() >= CompressionThreshold)) {
+		auto size = mz_compressBound(static_cast<mz_ulong>(payload.size()));
+		deflated.resize(sizeof(uint64_t) + size);
+
+		uint64_t payloadSize = payload.size();
+		std::memcpy(deflated.data(), &payloadSize, sizeof(uint64_t));
+
+		if (mz_compress2(reinterpret_cast<unsigned char *>(deflated.data() + sizeof(uint64_t)), &size,
+			reinterpret_cast<const unsigned char *>(payload.data()), static_cast<mz_ulong>(payload.size()), MZ_DEFAULT_LEVEL) == MZ_OK) {
+			deflated.resize(sizeof(uint64_t) + size);
+		} else {
+			deflated.clear();
+		}
+
+		// Only worth the inflate when loading if it saves a good part of the size.
+		if (compression == Compression::Auto && deflated.size() > payload.size() - payload.size() / 8)
+			deflated.clear();
+	}
+
+	stream.write(Magic, sizeof(Magic));
+	stream.put(static_cast<char>(Version));
+	stream.put(static_cast<char>(deflated.empty() ? 0 : DeflatedFlag));
+
+	if (!deflated.empty())
+		stream.write(deflated.data(), deflated.size());
+	else
+		stream.write(payload.data(), payload.size());
+}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Files/Node.hpp"
+
+namespace acid {
+/**
+ * @brief Compact binary format for Node trees, an alternative to Json and Xml for large serialized data.
+ *
+ * Node names are written once into a string table and referenced by index, integers are written as variable length
+ * integers and decimals as 32 or 64 bit floats. Arrays of plain integers or decimals are packed into one contiguous
+ * block without per element headers. The payload can be deflated with miniz, this is recorded in the header and
+ * handled when parsing.
+ */
+class ACID_EXPORT Binary {
+public:
+	enum class Compression {
+		/// Never compress.
+		None,
+		/// Always deflate the payload.
+		Deflate,
+		/// Deflate payloads larger than a few kilobytes if it makes them smaller.
+		Auto
+	};
+
+	Binary() = delete;
+
+	/**
+	 * Gets if data starts with the binary node header.
+	 * @param string The data to check.
+	 * @return If the data is in the binary format.
+	 */
+	static bool IsBinary(std::string_view string);
+
+	static void ParseString(Node &node, std::string_view string);
+	static void WriteStream(const Node &node, std::ostream &stream, Node::Format format = Node::Format::Minified);
+	static void WriteStream(const Node &node, std::ostream &stream, Compression compression);
+};
+}
@@ -1,6 +1,7 @@
 #include "File.hpp"
 
 #include "Engine/Engine.hpp"
+#include "Binary/Binary.hpp"
 #include "Json/Json.hpp"
 #include "Xml/Xml.hpp"
 #include "Files.hpp"
@@ -33,21 +34,25 @@ void File::Load(const std::filesystem::path &filename) {
 	auto debugStart = Time::Now();
 #endif
 
+	std::string data;
+
 	if (Files::ExistsInPath(filename)) {
 		IFStream inStream(filename);
-		if (type == Type::Json)
-			node.ParseStream<Json>(inStream);
-		else if (type == Type::Xml)
-			node.ParseStream<Xml>(inStream);
+		data.assign(std::istreambuf_iterator<char>(inStream), {});
 	} else if (std::filesystem::exists(filename)) {
-		std::ifstream inStream(filename);
-		if (type == Type::Json)
-			node.ParseStream<Json>(inStream);
-		else if (type == Type::Xml)
-			node.ParseStream<Xml>(inStream);
+		std::ifstream inStream(filename, std::ios::binary);
+		data.assign(std::istreambuf_iterator<char>(inStream), {});
 		inStream.close();
 	}
 
+	// Binary files are detected from their header, so a Json or Xml file can be replaced by its binary form.
+	if (Binary::IsBinary(data))
+		node.ParseString<Binary>(data);
+	else if (type == Type::Json)
+		node.ParseString<Json>(data);
+	else if (type == Type::Xml)
+		node.ParseString<Xml>(data);
+
 #if defined(ACID_DEBUG)
 	Log::Out("File ", filename, " loaded in ", (Time::Now() - debugStart).AsMilliseconds<float>(), "ms\n");
 #endif
@@ -69,11 +74,13 @@ void File::Write(const std::filesystem::path &filename, Node::Format format) con
 		if (auto parentPath = filename.parent_path(); !parentPath.empty())
 			std::filesystem::create_directories(parentPath);
 
-		std::ofstream os(filename);
+		std::ofstream os(filename, type == Type::Binary ? std::ios::out | std::ios::binary : std::ios::out);
 		if (type == Type::Json)
 			node.WriteStream<Json>(os, format);
 		else if (type == Type::Xml)
 			node.WriteStream<Xml>(os, format);
+		else if (type == Type::Binary)
+			node.WriteStream<Binary>(os, format);
 		os.close();
 	//}
 
@@ -10,7 +10,7 @@ class ACID_EXPORT File {
 public:
 	// TODO: Implement a more dynamic, less hard-coded, file parse/write.
 	enum class Type {
-		Json, Xml
+		Json, Xml, Binary
 	};
 	
 	File() = default;
@@ -1,21 +1,40 @@
 #include "FileObserver.hpp"
 
+#include <array>
+#if defined(ACID_BUILD_LINUX)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include "Engine/Log.hpp"
+#include "Utils/String.hpp"
+
 namespace acid {
-FileObserver::FileObserver(std::filesystem::path path, const Time &delay) :
+/// The longest the observer thread waits before checking if it was stopped.
+static constexpr auto StopCheckInterval = 100ms;
+
+FileObserver::FileObserver(std::filesystem::path path, const Time &delay, Delivery delivery) :
 	path(std::move(path)),
 	delay(delay),
-	running(true),
-	thread(&FileObserver::QueueLoop, this) {
-	DoWithFilesInPath([this](const std::filesystem::path &file) {
-		paths[file.string()] = std::filesystem::last_write_time(file);
-	});
+	delivery(delivery) {
+	Start();
 }
 
 FileObserver::~FileObserver() {
-	if (thread.joinable()) {
-		running = false;
-		thread.join();
+	Stop();
+}
+
+void FileObserver::Update() {
+	std::vector<std::pair<std::filesystem::path, Status>> changes;
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+		changes.swap(queue);
 	}
+
+	for (const auto &[file, status] : changes)
+		onChange(file, status);
 }
 
 void FileObserver::DoWithFilesInPath(const std::function<void(std::filesystem::path)> &f) const {
@@ -23,49 +42,268 @@ void FileObserver::DoWithFilesInPath(const std::function<void(std::filesystem::p
 		f(path);
 		return;
 	}
-	for (auto &file : std::filesystem::recursive_directory_iterator(path)) {
-		f(file.path());
+
+	// Files can be removed while iterating, errors end the iteration instead of throwing.
+	std::error_code error;
+	for (auto it = std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, error);
+		!error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+		f(it->path());
 	}
 }
 
+void FileObserver::SetPath(const std::filesystem::path &path) {
+	Stop();
+	this->path = path;
+	Start();
+}
+
+void FileObserver::Start() {
+	running = true;
+	thread = std::thread(&FileObserver::QueueLoop, this);
+}
+
+void FileObserver::Stop() {
+	running = false;
+	if (thread.joinable())
+		thread.join();
+	paths.clear();
+	pending.clear();
+}
+
 void FileObserver::QueueLoop() {
+#if defined(ACID_BUILD_LINUX)
+	if (NotifyLoop())
+		return;
+#endif
+	native = false;
+	PollLoop();
+}
+
+void FileObserver::PollLoop() {
+	DoWithFilesInPath([this](const std::filesystem::path &file) {
+		std::error_code error;
+		auto lastWriteTime = std::filesystem::last_write_time(file, error);
+		if (!error)
+			paths[file.string()] = lastWriteTime;
+	});
+
+	auto nextPoll = Time::Now() + delay;
+
 	while (running) {
-		// Wait for "delay" milliseconds
-		std::this_thread::sleep_for(std::chrono::microseconds(delay));
+		// Wait for "delay" milliseconds, in short steps so the observer stops quickly.
+		if (auto now = Time::Now(); now < nextPoll) {
+			std::this_thread::sleep_for(std::chrono::microseconds(std::min<Time>(nextPoll - now, StopCheckInterval)));
+			continue;
+		}
+
+		nextPoll = Time::Now() + delay;
 
 		// Check if one of the old files was erased
 		for (auto it = paths.begin(); it != paths.end();) {
 			if (!std::filesystem::exists(it->first)) {
-				onChange(std::filesystem::path(it->first), Status::Erased);
+				Deliver(it->first, Status::Erased);
 				it = paths.erase(it);
 				continue;
 			}
 
 			++it;
 		}
-		
+
 		// Check if a file was created or modified
 		DoWithFilesInPath([&](const std::filesystem::path &file) {
-			auto lastWriteTime = std::filesystem::last_write_time(file);
-
-			// File creation
-			if (!Contains(file.string())) {
-				// File modification
-				paths[file.string()] = lastWriteTime;
-				onChange(file.string(), Status::Created);
-			} else {
-				if (paths[file.string()] != lastWriteTime) {
-					paths[file.string()] = lastWriteTime;
-					onChange(file.string(), Status::Modified);
-				}
+			std::error_code error;
+			auto lastWriteTime = std::filesystem::last_write_time(file, error);
+			if (error)
+				return;
+
+			auto [it, created] = paths.try_emplace(file.string(), lastWriteTime);
+			if (created) {
+				Deliver(file, Status::Created);
+			} else if (it->second != lastWriteTime) {
+				it->second = lastWriteTime;
+				Deliver(file, Status::Modified);
 			}
 		});
 	}
 }
 
-bool FileObserver::Contains(const std::string &key) const {
-	// TODO C++20: Remove method
-	auto el = paths.find(key);
-	return el != paths.end();
+#if defined(ACID_BUILD_LINUX)
+bool FileObserver::NotifyLoop() {
+	static constexpr uint32_t Mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO;
+
+	auto fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd == -1)
+		return false;
+
+	// A single file is watched through its directory, other files in the directory are ignored.
+	auto watchFile = !std::filesystem::is_directory(path);
+	auto root = watchFile ? path.parent_path() : path;
+	std::unordered_map<int, std::filesystem::path> watches;
+
+	// Adds watches to a directory and every directory in it, reporting their contents as created for directories that are new.
+	// Returns 0, or the error that stopped the watches from being added.
+	auto addWatches = [&](const std::filesystem::path &directory, bool created) {
+		auto addWatch = [&](const std::filesystem::path &watchPath) {
+			auto wd = inotify_add_watch(fd, watchPath.c_str(), Mask | IN_ONLYDIR);
+			if (wd == -1)
+				return errno;
+			watches[wd] = watchPath;
+			return 0;
+		};
+
+		// A new directory removed before it was watched is skipped, the root and running out of watches are failures.
+		if (auto result = addWatch(directory); result != 0)
+			return directory != root && result != ENOSPC && result != ENOMEM ? 0 : result;
+		if (watchFile)
+			return 0;
+
+		std::error_code error;
+		for (auto it = std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied, error);
+			!error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+			if (created)
+				Coalesce(it->path(), Status::Created);
+			if (it->is_directory(error) && !it->is_symlink(error)) {
+				if (auto result = addWatch(it->path()); result == ENOSPC || result == ENOMEM)
+					return result;
+			}
+		}
+
+		return 0;
+	};
+
+	if (auto result = addWatches(root, false); result != 0) {
+		if (result == ENOSPC)
+			Log::Warning("Out of inotify watches for ", path, ", raise fs.inotify.max_user_watches, polling instead\n");
+		close(fd);
+		return false;
+	}
+
+	native = true;
+
+	alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+	auto watching = true;
+
+	while (running && watching) {
+		pollfd pollFd = {fd, POLLIN, 0};
+		auto timeout = FlushPending();
+		if (poll(&pollFd, 1, static_cast<int>((timeout.AsMicroseconds() + 999) / 1000)) <= 0)
+			continue;
+
+		ssize_t length;
+		while (watching && (length = read(fd, buffer.data(), buffer.size())) > 0) {
+			for (auto it = buffer.data(); watching && it < buffer.data() + length;) {
+				auto event = reinterpret_cast<const inotify_event *>(it);
+				it += sizeof(inotify_event) + event->len;
+
+				// Events were dropped, watches are added again to every directory so new directories are watched.
+				if (event->mask & IN_Q_OVERFLOW) {
+					Log::Warning("File observer queue overflowed, changes in ", path, " may be missed\n");
+					watching = addWatches(root, false) == 0;
+					continue;
+				}
+
+				auto watch = watches.find(event->wd);
+				if (watch == watches.end())
+					continue;
+
+				if (event->mask & IN_IGNORED) {
+					watches.erase(watch);
+					continue;
+				}
+
+				// Events on the watched directory itself are reported by its parent.
+				if (event->len == 0)
+					continue;
+
+				auto file = watch->second / event->name;
+				if (watchFile && file.filename() != path.filename())
+					continue;
+
+				if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+					Coalesce(file, Status::Created);
+					if (event->mask & IN_ISDIR)
+						watching = addWatches(file, true) == 0;
+				} else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+					Coalesce(file, Status::Erased);
+
+					// Watches follow a moved directory, they are removed and added again if it was moved inside the path.
+					if ((event->mask & IN_ISDIR) && (event->mask & IN_MOVED_FROM)) {
+						auto prefix = file.string() + '/';
+						for (auto it1 = watches.begin(); it1 != watches.end();) {
+							if (it1->second == file || String::StartsWith(it1->second.string(), prefix)) {
+								inotify_rm_watch(fd, it1->first);
+								it1 = watches.erase(it1);
+								continue;
+							}
+							++it1;
+						}
+					}
+				} else if (!(event->mask & IN_ISDIR)) {
+					Coalesce(file, Status::Modified);
+				}
+			}
+		}
+	}
+
+	FlushPending(true);
+	close(fd);
+
+	if (watching)
+		return true;
+
+	// Directories created while watching could not be watched, the path is polled instead.
+	Log::Warning("Failed to watch new directories in ", path, " with inotify, polling instead\n");
+	return false;
+}
+#endif
+
+void FileObserver::Coalesce(const std::filesystem::path &file, Status status) {
+	auto now = Time::Now();
+	auto [it, inserted] = pending.try_emplace(file, PendingChange{status, now});
+	if (inserted)
+		return;
+
+	auto &change = it->second;
+	change.time = now;
+
+	// A file created and erased before it was reported never changed.
+	if (change.status == Status::Created && status == Status::Erased) {
+		pending.erase(it);
+		return;
+	}
+
+	// Created stays created when it is modified, and a file erased then created again, as editors save, was modified.
+	if (change.status == Status::Created)
+		return;
+	change.status = change.status == Status::Erased && status == Status::Created ? Status::Modified : status;
+}
+
+Time FileObserver::FlushPending(bool force) {
+	auto now = Time::Now();
+	Time next = StopCheckInterval;
+
+	for (auto it = pending.begin(); it != pending.end();) {
+		auto quiet = now - it->second.time;
+		if (force || quiet >= debounce) {
+			Deliver(it->first, it->second.status);
+			it = pending.erase(it);
+			continue;
+		}
+
+		next = std::min(next, debounce - quiet);
+		++it;
+	}
+
+	return next;
+}
+
+void FileObserver::Deliver(const std::filesystem::path &file, Status status) {
+	if (delivery == Delivery::Background) {
+		onChange(file, status);
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(queueMutex);
+	queue.emplace_back(file, status);
 }
 }
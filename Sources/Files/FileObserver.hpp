@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <filesystem>
+#include <map>
+#include <mutex>
 #include <unordered_map>
 #include <thread>
 
@@ -10,6 +13,11 @@
 namespace acid {
 /**
  * @brief Class that can listen to file changes on a path recursively.
+ *
+ * On Linux changes are read from inotify, with a watch on every directory in the path. Other platforms, and Linux when
+ * inotify cannot watch the path, fall back to walking the path every delay and comparing write times.
+ * Changes reported by inotify are coalesced per path until the path has been quiet for the debounce time, so a editor
+ * saving a file in several writes reports a single change.
  */
 class ACID_EXPORT FileObserver {
 public:
@@ -17,22 +25,48 @@ public:
 		Created, Modified, Erased
 	};
 
+	enum class Delivery {
+		/// OnChange is called from the observer thread.
+		Background,
+		/// Changes are queued, OnChange is called from the thread that calls Update.
+		Update
+	};
+
 	/**
 	 * Creates a new file watcher.
 	 * @param path The path to watch recursively.
-	 * @param delay How frequently to check for changes.
+	 * @param delay How frequently to check for changes when polling.
+	 * @param delivery The thread OnChange is called from.
 	 */
-	explicit FileObserver(std::filesystem::path path, const Time &delay = 5s);
+	explicit FileObserver(std::filesystem::path path, const Time &delay = 5s, Delivery delivery = Delivery::Background);
 	~FileObserver();
 
+	/**
+	 * Calls OnChange for the queued changes, when the delivery is Delivery::Update.
+	 */
+	void Update();
+
 	void DoWithFilesInPath(const std::function<void(std::filesystem::path)> &f) const;
 
 	const std::filesystem::path &GetPath() const { return path; }
-	void SetPath(const std::filesystem::path &path) { this->path = path; }
+	/**
+	 * Sets the path to watch, the observer is restarted on the new path.
+	 * @param path The path to watch recursively.
+	 */
+	void SetPath(const std::filesystem::path &path);
 
 	const Time &GetDelay() const { return delay; }
 	void SetDelay(const Time &delay) { this->delay = delay; }
 
+	const Time &GetDebounce() const { return debounce; }
+	void SetDebounce(const Time &debounce) { this->debounce = debounce; }
+
+	/**
+	 * Gets if changes are read from the platform, otherwise the path is polled.
+	 * @return If the observer is not polling.
+	 */
+	bool IsNative() const { return native; }
+
 	/**
 	 * Called when a file or directory has changed.
 	 * @return The delegate.
@@ -40,16 +74,58 @@ public:
 	Delegate<void(std::filesystem::path, Status)> &OnChange() { return onChange; }
 
 private:
+	/**
+	 * @brief A change that is waiting for its path to be quiet.
+	 */
+	class PendingChange {
+	public:
+		Status status;
+		Time time;
+	};
+
+	void Start();
+	void Stop();
+
 	void QueueLoop();
+	void PollLoop();
+#if defined(ACID_BUILD_LINUX)
+	/**
+	 * Reads changes from inotify until the observer is stopped.
+	 * @return If inotify watched the path, false to fall back to polling.
+	 */
+	bool NotifyLoop();
+#endif
 
-	bool Contains(const std::string &key) const;
+	/**
+	 * Adds a change to the pending changes, merged with the pending change to the same path.
+	 * @param file The changed path.
+	 * @param status The change.
+	 */
+	void Coalesce(const std::filesystem::path &file, Status status);
+	/**
+	 * Delivers pending changes that have been quiet for the debounce time.
+	 * @param force If all pending changes are delivered.
+	 * @return The time until the next pending change is quiet, at most the interval the watching thread checks if it was stopped.
+	 */
+	Time FlushPending(bool force = false);
+	void Deliver(const std::filesystem::path &file, Status status);
 
 	std::filesystem::path path;
 	Time delay;
+	Time debounce = 0.1s;
+	Delivery delivery;
 	Delegate<void(std::filesystem::path, Status)> onChange;
 
-	bool running;
+	std::atomic<bool> running = false;
+	std::atomic<bool> native = false;
 	std::thread thread;
+	/// Write times of the files in the path, used when polling.
 	std::unordered_map<std::string, std::filesystem::file_time_type> paths;
+	/// Changes waiting to be quiet, only used by the observer thread.
+	std::map<std::filesystem::path, PendingChange> pending;
+
+	std::mutex queueMutex;
+	/// Changes waiting for Update.
+	std::vector<std::pair<std::filesystem::path, Status>> queue;
 };
 }
@@ -2,7 +2,17 @@
 
 #include <iterator>
 #include <physfs.h>
+#if defined(ACID_BUILD_WINDOWS)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include "Engine/Engine.hpp"
+#include "Pack/AssetPack.hpp"
+#include "Utils/String.hpp"
 #include "Config.hpp"
 
 namespace acid {
@@ -161,8 +171,143 @@ FStream::~FStream() {
 	delete rdbuf();
 }
 
+MappedFile::MappedFile(std::string &&buffer) :
+	size(buffer.size()),
+	buffer(std::move(buffer)) {
+	data = reinterpret_cast<const uint8_t *>(this->buffer.data());
+}
+
+MappedFile::~MappedFile() {
+	Unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept :
+	data(other.data),
+	size(other.size),
+	mapping(other.mapping),
+	mappingSize(other.mappingSize),
+	buffer(std::move(other.buffer)) {
+	// Short buffers are stored inside the string, so the data pointer has to follow the moved buffer.
+	if (!mapping)
+		data = reinterpret_cast<const uint8_t *>(buffer.data());
+	other.data = nullptr;
+	other.size = 0;
+	other.mapping = nullptr;
+	other.mappingSize = 0;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+	if (this == &other)
+		return *this;
+
+	Unmap();
+	data = other.data;
+	size = other.size;
+	mapping = other.mapping;
+	mappingSize = other.mappingSize;
+	buffer = std::move(other.buffer);
+	if (!mapping)
+		data = reinterpret_cast<const uint8_t *>(buffer.data());
+	other.data = nullptr;
+	other.size = 0;
+	other.mapping = nullptr;
+	other.mappingSize = 0;
+	return *this;
+}
+
+std::optional<MappedFile> MappedFile::Open(const std::filesystem::path &path) {
+	return Open(path, 0, std::numeric_limits<uint64_t>::max());
+}
+
+std::optional<MappedFile> MappedFile::Open(const std::filesystem::path &path, uint64_t offset, uint64_t size) {
+	MappedFile file;
+
+#if defined(ACID_BUILD_WINDOWS)
+	auto handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return std::nullopt;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || offset > static_cast<uint64_t>(fileSize.QuadPart)) {
+		CloseHandle(handle);
+		return std::nullopt;
+	}
+
+	size = std::min(size, static_cast<uint64_t>(fileSize.QuadPart) - offset);
+
+	// Views start on the allocation granularity, the range is found after the aligned start.
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	auto alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+
+	// Empty ranges cannot be mapped, they are returned as a empty buffer.
+	if (size != 0) {
+		file.mappingSize = static_cast<std::size_t>(size + offset - alignedOffset);
+		auto mappingHandle = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle)
+			file.mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, static_cast<DWORD>(alignedOffset >> 32), static_cast<DWORD>(alignedOffset),
+				file.mappingSize);
+		// The view keeps the file open, the handles are not needed after mapping.
+		if (mappingHandle)
+			CloseHandle(mappingHandle);
+		if (!file.mapping) {
+			CloseHandle(handle);
+			return std::nullopt;
+		}
+	}
+
+	CloseHandle(handle);
+#else
+	auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return std::nullopt;
+
+	struct stat fileStat = {};
+	if (fstat(fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode) || offset > static_cast<uint64_t>(fileStat.st_size)) {
+		close(fd);
+		return std::nullopt;
+	}
+
+	size = std::min(size, static_cast<uint64_t>(fileStat.st_size) - offset);
+
+	// Mappings start on a page, the range is found after the aligned start.
+	auto alignedOffset = offset - offset % static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+
+	// Empty ranges cannot be mapped, they are returned as a empty buffer.
+	if (size != 0) {
+		file.mappingSize = static_cast<std::size_t>(size + offset - alignedOffset);
+		auto address = mmap(nullptr, file.mappingSize, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(alignedOffset));
+		if (address == MAP_FAILED) {
+			close(fd);
+			return std::nullopt;
+		}
+		file.mapping = address;
+	}
+
+	// The mapping keeps the file open, the descriptor is not needed after mapping.
+	close(fd);
+#endif
+
+	file.size = static_cast<std::size_t>(size);
+	file.data = file.mapping ? static_cast<const uint8_t *>(file.mapping) + (offset - alignedOffset) : reinterpret_cast<const uint8_t *>(file.buffer.data());
+	return file;
+}
+
+void MappedFile::Unmap() {
+	if (!mapping)
+		return;
+
+#if defined(ACID_BUILD_WINDOWS)
+	UnmapViewOfFile(mapping);
+#else
+	munmap(mapping, mappingSize);
+#endif
+	mapping = nullptr;
+}
+
 Files::Files() {
 	PHYSFS_init(Engine::Get()->GetArgv0().c_str());
+	AssetPack::RegisterArchiver();
 	// TODO: Only when not installed. 
 	if (std::filesystem::exists(ACID_RESOURCES_DEV))
 		AddSearchPath(std::string(ACID_RESOURCES_DEV));
@@ -229,37 +374,65 @@ std::optional<std::string> Files::Read(const std::filesystem::path &path) {
 			return std::nullopt;
 		}
 
-		std::ifstream is(path);
-		std::stringstream buffer;
-		buffer << is.rdbuf();
-		return buffer.str();
+		std::ifstream is(path, std::ios::binary);
+		std::string data(static_cast<std::size_t>(std::filesystem::file_size(path)), '\0');
+		is.read(data.data(), static_cast<std::streamsize>(data.size()));
+		data.resize(static_cast<std::size_t>(is.gcount()));
+		return data;
 	}
 
 	auto size = PHYSFS_fileLength(fsFile);
-	std::vector<uint8_t> data(size);
-	PHYSFS_readBytes(fsFile, data.data(), static_cast<PHYSFS_uint64>(size));
+	std::string data(static_cast<std::size_t>(size), '\0');
+	auto read = PHYSFS_readBytes(fsFile, data.data(), static_cast<PHYSFS_uint64>(size));
+	data.resize(read > 0 ? static_cast<std::size_t>(read) : 0);
 
 	if (PHYSFS_close(fsFile) == 0)
 		Log::Error("Failed to close file ", path, ", ", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()), '\n');
 
-	return std::string(data.begin(), data.end());
+	return data;
 }
 
-std::vector<unsigned char> Files::ReadBytes(const std::filesystem::path &path) {
-	IFStream file(path);
-	file >> std::noskipws;
+std::optional<MappedFile> Files::Map(const std::filesystem::path &path) {
+	auto pathStr = path.string();
+	std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
 
-	auto fileSize = file.tellg();
-	file.seekg(0, std::ios::beg);
+	if (PHYSFS_isInit() != 0 && PHYSFS_exists(pathStr.c_str()) != 0) {
+		// Files found in a mounted directory are mapped from their real path, files in archives are read.
+		if (auto realDir = PHYSFS_getRealDir(pathStr.c_str())) {
+			std::string_view relative = pathStr;
+			std::string_view mountPoint = PHYSFS_getMountPoint(realDir);
+			while (String::StartsWith(relative, "/"))
+				relative.remove_prefix(1);
+			while (String::StartsWith(mountPoint, "/"))
+				mountPoint.remove_prefix(1);
+			if (String::StartsWith(relative, mountPoint))
+				relative.remove_prefix(mountPoint.size());
+
+			if (std::filesystem::is_directory(realDir)) {
+				if (auto mapped = MappedFile::Open(std::filesystem::path(realDir) / relative))
+					return mapped;
+			} else if (auto range = AssetPack::FindMounted(realDir, relative)) {
+				// Uncompressed entries in mounted asset packs are mapped straight from the pack.
+				if (auto mapped = MappedFile::Open(realDir, range->first, range->second))
+					return mapped;
+			}
+		}
+	} else if (std::filesystem::is_regular_file(path)) {
+		if (auto mapped = MappedFile::Open(path))
+			return mapped;
+	}
 
-	std::vector<unsigned char> bytes;
-	bytes.reserve(fileSize);
+	if (auto data = Read(path))
+		return MappedFile(std::move(*data));
+	return std::nullopt;
+}
 
-	std::copy(std::istream_iterator<unsigned char>(file),
-		std::istream_iterator<unsigned char>(),
-		back_inserter(bytes));
+std::vector<unsigned char> Files::ReadBytes(const std::filesystem::path &path) {
+	auto file = Map(path);
 
-	return bytes;
+	if (!file)
+		return {};
+	return {file->GetData(), file->GetData() + file->GetSize()};
 }
 
 std::vector<std::string> Files::FilesInPath(const std::filesystem::path &path, bool recursive) {
@@ -37,6 +37,65 @@ public:
 	virtual ~FStream();
 };
 
+/**
+ * @brief Class that holds the read-only contents of a file, mapped into memory when the file is in a native directory.
+ *
+ * Files inside archives cannot be mapped, their contents are read into a buffer owned by the object instead.
+ * Either way the data is valid for as long as the object lives, like the string returned by Files::Read.
+ */
+class ACID_EXPORT MappedFile : NonCopyable {
+public:
+	MappedFile() = default;
+
+	/**
+	 * Creates a file that holds a buffer that was read from a file.
+	 * @param buffer The contents of the file.
+	 */
+	explicit MappedFile(std::string &&buffer);
+
+	~MappedFile();
+
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	/**
+	 * Maps a file into memory.
+	 * @param path The native path of the file.
+	 * @return The mapped file, or std::nullopt if it could not be opened.
+	 */
+	static std::optional<MappedFile> Open(const std::filesystem::path &path);
+
+	/**
+	 * Maps a range of a file into memory.
+	 * @param path The native path of the file.
+	 * @param offset The offset of the range in the file.
+	 * @param size The size of the range, clamped to the end of the file.
+	 * @return The mapped range, or std::nullopt if it could not be opened or starts past the end of the file.
+	 */
+	static std::optional<MappedFile> Open(const std::filesystem::path &path, uint64_t offset, uint64_t size);
+
+	const uint8_t *GetData() const { return data; }
+	std::size_t GetSize() const { return size; }
+	std::string_view GetString() const { return {reinterpret_cast<const char *>(data), size}; }
+
+	/**
+	 * Gets if the contents are mapped from the file, otherwise they were read into a buffer.
+	 * @return If the file is mapped.
+	 */
+	bool IsMapped() const { return mapping != nullptr; }
+
+private:
+	void Unmap();
+
+	const uint8_t *data = nullptr;
+	std::size_t size = 0;
+	/// The start of the mapping, nullptr when the contents are in the buffer.
+	void *mapping = nullptr;
+	/// The size of the mapping, larger than the size when the offset was aligned down to a page.
+	std::size_t mappingSize = 0;
+	std::string buffer;
+};
+
 /**
  * @brief Module used for managing files on engine updates.
  */
@@ -65,6 +124,8 @@ public:
 	 */
 	void ClearSearchPath();
 
+	const std::vector<std::string> &GetSearchPaths() const { return searchPaths; }
+
 	/**
 	 * Gets if the path is found in one of the search paths.
 	 * @param path The path to look for.
@@ -79,6 +140,14 @@ public:
 	 */
 	static std::optional<std::string> Read(const std::filesystem::path &path);
 
+	/**
+	 * Maps a file found by real or partial path into memory, without copying it.
+	 * Files in archives are read into a buffer instead, except uncompressed entries in mounted asset packs.
+	 * @param path The path to map.
+	 * @return The contents of the file.
+	 */
+	static std::optional<MappedFile> Map(const std::filesystem::path &path);
+
 	/**
 	 * Reads all bytes from file found by real or partial path.
 	 * @param path The path to read.
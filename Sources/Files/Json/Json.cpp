@@ -1,47 +1,189 @@
 #include "Json.hpp"
 
-#include "Utils/Enumerate.hpp"
+#include <cerrno>
+#include <charconv>
+
 #include "Utils/String.hpp"
 
 #define ATTRIBUTE_TEXT_SUPPORT 1
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ACID_JSON_SSE2 1
+#include <emmintrin.h>
+#if defined(ACID_BUILD_MSVC)
+#include <intrin.h>
+#endif
+#endif
+
 namespace acid {
-void Json::ParseString(Node &node, std::string_view string) {
-	// Tokenizes the string view into small views that are used to build a Node tree.
-	std::vector<Node::Token> tokens;
-
-	std::size_t tokenStart = 0;
-	enum class QuoteState : char {
-		None = '\0', Single = '\'', Double = '"'
-	} quoteState = QuoteState::None;
-
-	// Iterates over all the characters in the string view.
-	for (auto &&[index, c] : Enumerate(string)) {
-		// If the previous character was a backslash the quote will not break the string.
-		if (c == '\'' && quoteState != QuoteState::Double && string[index - 1] != '\\')
-			quoteState = quoteState == QuoteState::None ? QuoteState::Single : QuoteState::None;
-		else if (c == '"' && quoteState != QuoteState::Single && string[index - 1] != '\\')
-			quoteState = quoteState == QuoteState::None ? QuoteState::Double : QuoteState::None;
-
-		// When not reading a string tokens can be found.
-		// While in a string whitespace and tokens are added to the strings view.
-		if (quoteState == QuoteState::None) {
-			if (String::IsWhitespace(c)) {
-				// On whitespace start save current token.
-				AddToken(std::string_view(string.data() + tokenStart, index - tokenStart), tokens);
-				tokenStart = index + 1;
-			} else if (c == ':' || c == '{' || c == '}' || c == ',' || c == '[' || c == ']') {
-				// Tokens used to read json nodes.
-				AddToken(std::string_view(string.data() + tokenStart, index - tokenStart), tokens);
-				tokens.emplace_back(Node::Type::Token, std::string_view(string.data() + index, 1));
-				tokenStart = index + 1;
-			}
+static constexpr bool IsWhitespace(char c) {
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+#if defined(ACID_JSON_SSE2)
+static uint32_t CountTrailingZeros(uint32_t mask) {
+#if defined(ACID_BUILD_MSVC)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Whitespace runs are usually a single character, long runs come from indentation in beautified files.
+static const char *SkipWhitespace(const char *it, const char *end) {
+	if (it == end || !IsWhitespace(*it))
+		return it;
+
+#if defined(ACID_JSON_SSE2)
+	while (end - it >= 16) {
+		auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+		auto whitespace = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))));
+		auto mask = static_cast<uint32_t>(_mm_movemask_epi8(whitespace)) ^ 0xFFFFu;
+		if (mask != 0)
+			return it + CountTrailingZeros(mask);
+		it += 16;
+	}
+#endif
+
+	while (it != end && IsWhitespace(*it))
+		it++;
+	return it;
+}
+
+// Finds the closing quote or the next escape in a string, 16 characters at a time.
+static const char *FindQuoteOrEscape(const char *it, const char *end, char quote) {
+#if defined(ACID_JSON_SSE2)
+	auto quotes = _mm_set1_epi8(quote);
+	auto escapes = _mm_set1_epi8('\\');
+
+	while (end - it >= 16) {
+		auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+		auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, escapes))));
+		if (mask != 0)
+			return it + CountTrailingZeros(mask);
+		it += 16;
+	}
+#endif
+
+	while (it != end && *it != quote && *it != '\\')
+		it++;
+	return it;
+}
+
+static bool IsNumber(std::string_view view, bool &decimal) {
+	auto it = view.begin();
+	if (it != view.end() && *it == '-')
+		it++;
+
+	auto digitsStart = it;
+	while (it != view.end() && *it >= '0' && *it <= '9')
+		it++;
+	if (it == digitsStart)
+		return false;
+
+	decimal = false;
+	if (it != view.end() && *it == '.') {
+		decimal = true;
+		for (it++; it != view.end() && *it >= '0' && *it <= '9';)
+			it++;
+	}
+
+	if (it != view.end() && (*it == 'e' || *it == 'E')) {
+		decimal = true;
+		if (++it != view.end() && (*it == '+' || *it == '-'))
+			it++;
+		auto exponentStart = it;
+		while (it != view.end() && *it >= '0' && *it <= '9')
+			it++;
+		if (it == exponentStart)
+			return false;
+	}
+
+	return it == view.end();
+}
+
+// Numbers are stored typed when they can be read exactly, otherwise they are kept as text.
+static void SetNumber(Node &node, std::string_view view, bool decimal) {
+	if (!decimal) {
+		int64_t integer;
+		if (auto result = std::from_chars(view.data(), view.data() + view.size(), integer); result.ec == std::errc() && result.ptr == view.data() + view.size()) {
+			node << integer;
+			return;
+		}
+	} else {
+#if defined(__cpp_lib_to_chars)
+		double number;
+		if (auto result = std::from_chars(view.data(), view.data() + view.size(), number); result.ec == std::errc() && result.ptr == view.data() + view.size()) {
+			node << number;
+			return;
 		}
+#else
+		std::string text(view);
+		char *textEnd;
+		errno = 0;
+		if (auto number = std::strtod(text.c_str(), &textEnd); errno == 0 && *textEnd == '\0') {
+			node << number;
+			return;
+		}
+#endif
 	}
 
-	// Converts the tokens into nodes.
-	int32_t k = 0;
-	Convert(node, tokens, k);
+	node.SetValueView(view);
+	node.SetType(decimal ? Node::Type::Decimal : Node::Type::Integer);
+}
+
+static void AppendUtf8(std::string &str, uint32_t codepoint) {
+	if (codepoint < 0x80) {
+		str += static_cast<char>(codepoint);
+	} else if (codepoint < 0x800) {
+		str += static_cast<char>(0xC0 | (codepoint >> 6));
+		str += static_cast<char>(0x80 | (codepoint & 0x3F));
+	} else if (codepoint < 0x10000) {
+		str += static_cast<char>(0xE0 | (codepoint >> 12));
+		str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (codepoint & 0x3F));
+	} else {
+		str += static_cast<char>(0xF0 | (codepoint >> 18));
+		str += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+		str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (codepoint & 0x3F));
+	}
+}
+
+static uint32_t ParseHex4(const char *&it, const char *end) {
+	if (end - it < 4)
+		throw std::runtime_error("Incomplete unicode escape");
+
+	uint32_t value = 0;
+	for (auto last = it + 4; it != last; it++) {
+		value <<= 4;
+		if (*it >= '0' && *it <= '9')
+			value |= *it - '0';
+		else if (*it >= 'a' && *it <= 'f')
+			value |= *it - 'a' + 10;
+		else if (*it >= 'A' && *it <= 'F')
+			value |= *it - 'A' + 10;
+		else
+			throw std::runtime_error("Invalid unicode escape");
+	}
+	return value;
+}
+
+void Json::ParseString(Node &node, std::string_view string) {
+	// Builds the Node tree directly while scanning the string once.
+	auto it = string.data();
+	auto end = it + string.size();
+
+	it = SkipWhitespace(it, end);
+	if (it == end)
+		return;
+
+	ParseValue(node, it, end);
 }
 
 void Json::WriteStream(const Node &node, std::ostream &stream, Node::Format format) {
@@ -50,80 +192,216 @@ void Json::WriteStream(const Node &node, std::ostream &stream, Node::Format form
 	stream << (node.GetType() == Node::Type::Array ? ']' : '}');
 }
 
-void Json::AddToken(std::string_view view, std::vector<Node::Token> &tokens) {
-	if (view.length() != 0) {
-		// Finds the node value type of the string and adds it to the tokens vector.
-		if (view == "null") {
-			tokens.emplace_back(Node::Type::Null, std::string_view());
-		} else if (view == "true" || view == "false") {
-			tokens.emplace_back(Node::Type::Boolean, view);
-		} else if (String::IsNumber(view)) {
-			// This is a quick hack to get if the number is a decimal.
-			if (view.find('.') != std::string::npos) {
-				if (view.size() >= std::numeric_limits<long double>::digits)
-					throw std::runtime_error("Decimal number is too long");
-				tokens.emplace_back(Node::Type::Decimal, view);
-			} else {
-				if (view.size() >= std::numeric_limits<uint64_t>::digits)
-					throw std::runtime_error("Integer number is too long");
-				tokens.emplace_back(Node::Type::Integer, view);
-			}
-		} else { // if (view.front() == view.back() == '\"')
-			tokens.emplace_back(Node::Type::String, view.substr(1, view.length() - 2));
-		}
-	}
-}
+void Json::ParseValue(Node &current, const char *&it, const char *end) {
+	switch (*it) {
+	case '{':
+		it = SkipWhitespace(it + 1, end);
 
-void Json::Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k) {
-	if (tokens[k] == Node::Token(Node::Type::Token, "{")) {
-		k++;
+		while (it != end && *it != '}') {
+			if (*it != '"' && *it != '\'')
+				throw std::runtime_error("Missing object key");
+			std::string_view key;
+			std::string escapedKey;
+			auto keyEscaped = ParseQuoted(it, end, key, escapedKey);
 
-		while (tokens[k] != Node::Token(Node::Type::Token, "}")) {
-			auto key = tokens[k].view;
-			if (k + 2 >= tokens.size())
-				throw std::runtime_error("Missing end of {} array");
-			if (tokens[k + 1].view != ":")
+			it = SkipWhitespace(it, end);
+			if (it == end || *it != ':')
 				throw std::runtime_error("Missing object colon");
-			k += 2;
+			it = SkipWhitespace(it + 1, end);
+			if (it == end)
+				throw std::runtime_error("Missing end of {} object");
+
 #if ATTRIBUTE_TEXT_SUPPORT
 			// Write value string into current value, then continue parsing properties into current.
-			if (key == "#text")
-				Convert(current, tokens, k);
-			else
+			if (key == "#text") {
+				ParseValue(current, it, end);
+			} else
 #endif
-				Convert(current.AddProperty(std::string(key)), tokens, k);
-			if (tokens[k].view == ",")
-				k++;
+			{
+				auto &property = current.AddProperty();
+				if (keyEscaped)
+					property.SetName(std::move(escapedKey));
+				else
+					property.SetNameView(key);
+				ParseValue(property, it, end);
+			}
+
+			it = SkipWhitespace(it, end);
+			if (it != end && *it == ',')
+				it = SkipWhitespace(it + 1, end);
 		}
-		k++;
+
+		if (it == end)
+			throw std::runtime_error("Missing end of {} object");
+		it++;
 
 		current.SetType(Node::Type::Object);
-	} else if (tokens[k] == Node::Token(Node::Type::Token, "[")) {
-		k++;
-
-		while (tokens[k] != Node::Token(Node::Type::Token, "]")) {
-			if (k >= tokens.size())
-				throw std::runtime_error("Missing end of [] object");
-			Convert(current.AddProperty(), tokens, k);
-			if (tokens[k].view == ",")
-				k++;
+		break;
+	case '[': {
+		it = SkipWhitespace(it + 1, end);
+
+		// Arrays of only integers or only decimals are packed, until an element of another type is found.
+		std::vector<int64_t> integers;
+		std::vector<double> decimals;
+		auto packing = current.GetPropertyCount() == 0;
+
+		while (it != end && *it != ']') {
+			if (packing) {
+				Node element(current.GetAllocator());
+				ParseValue(element, it, end);
+
+				if (auto integer = std::get_if<int64_t>(&element.GetTypedValue()); integer && decimals.empty()) {
+					integers.emplace_back(*integer);
+				} else if (auto number = std::get_if<double>(&element.GetTypedValue()); number && integers.empty()) {
+					decimals.emplace_back(*number);
+				} else {
+					packing = false;
+					for (auto integer : integers)
+						current.AddProperty() << integer;
+					for (auto number : decimals)
+						current.AddProperty() << number;
+					current.AddProperty(std::move(element));
+				}
+			} else {
+				ParseValue(current.AddProperty(), it, end);
+			}
+
+			it = SkipWhitespace(it, end);
+			if (it != end && *it == ',')
+				it = SkipWhitespace(it + 1, end);
 		}
-		k++;
 
+		if (it == end)
+			throw std::runtime_error("Missing end of [] array");
+		it++;
+
+		if (packing && !integers.empty())
+			current.SetTypedValue(Node::Packed(integers.data(), integers.size(), current.GetAllocator()));
+		else if (packing && !decimals.empty())
+			current.SetTypedValue(Node::Packed(decimals.data(), decimals.size(), current.GetAllocator()));
 		current.SetType(Node::Type::Array);
-	} else {
-		std::string str(tokens[k].view);
-		if (tokens[k].type == Node::Type::String)
-			str = String::UnfixEscapedChars(str);
-		current.SetValue(str);
-		current.SetType(tokens[k].type);
-		k++;
+		break;
+	}
+	case '"':
+	case '\'': {
+		std::string_view view;
+		std::string escaped;
+		if (ParseQuoted(it, end, view, escaped))
+			current.SetValue(std::move(escaped));
+		else
+			current.SetValueView(view);
+		current.SetType(Node::Type::String);
+		break;
+	}
+	default: {
+		// Literals run until the next structural character or whitespace.
+		auto start = it;
+		while (it != end && !IsWhitespace(*it) && *it != ',' && *it != '}' && *it != ']' && *it != ':')
+			it++;
+		std::string_view view(start, it - start);
+
+		bool decimal;
+		if (view == "null") {
+			current.SetValue({});
+			current.SetType(Node::Type::Null);
+		} else if (view == "true" || view == "false") {
+			current << (view == "true");
+		} else if (IsNumber(view, decimal)) {
+			SetNumber(current, view, decimal);
+		} else if (view.empty()) {
+			throw std::runtime_error("Missing value");
+		} else {
+			// Non-finite decimals are written unquoted, keep them and any other bare words as text.
+			current.SetValueView(view);
+			current.SetType(Node::Type::String);
+		}
+		break;
+	}
+	}
+}
+
+bool Json::ParseQuoted(const char *&it, const char *end, std::string_view &view, std::string &str) {
+	auto quote = *it++;
+	auto start = it;
+	it = FindQuoteOrEscape(it, end, quote);
+
+	// Most strings have no escapes and are used from the source as they are.
+	if (it != end && *it == quote) {
+		view = std::string_view(start, it++ - start);
+		return false;
+	}
+
+	str.assign(start, it);
+
+	while (it != end) {
+		if (*it == quote) {
+			it++;
+			view = str;
+			return true;
+		}
+
+		// Escape sequence.
+		if (++it == end)
+			break;
+
+		switch (auto c = *it++) {
+		case 'n':
+			str += '\n';
+			break;
+		case 'r':
+			str += '\r';
+			break;
+		case 't':
+			str += '\t';
+			break;
+		case 'b':
+			str += '\b';
+			break;
+		case 'f':
+			str += '\f';
+			break;
+		case '"':
+		case '\'':
+		case '\\':
+		case '/':
+			str += c;
+			break;
+		case 'u': {
+			auto codepoint = ParseHex4(it, end);
+			// Characters outside the basic multilingual plane are written as a UTF-16 surrogate pair.
+			if (codepoint >= 0xD800 && codepoint < 0xDC00 && end - it >= 6 && it[0] == '\\' && it[1] == 'u') {
+				it += 2;
+				auto low = ParseHex4(it, end);
+				codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+			AppendUtf8(str, codepoint);
+			break;
+		}
+		default:
+			// Unknown escapes are kept as written.
+			str += '\\';
+			str += c;
+			break;
+		}
+
+		auto next = FindQuoteOrEscape(it, end, quote);
+		str.append(it, next);
+		it = next;
 	}
+
+	throw std::runtime_error("Missing end of string");
 }
 
 void Json::AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent) {
 	auto indents = format.GetIndents(indent);
 
+	// A packed root is written without expanding it, packed properties are written below.
+	if (auto packed = node.GetPacked()) {
+		if (packed->GetSize() != 0)
+			AppendPacked(*packed, stream, format, indent);
+		return;
+	}
+
 	// Only output the value if no properties exist.
 	if (node.GetProperties().empty()) {
 		if (node.GetType() == Node::Type::String)
@@ -153,6 +431,18 @@ void Json::AppendData(const Node &node, std::ostream &stream, Node::Format forma
 			stream << '\"' << it->GetName() << "\":" << format.space;
 		}
 
+		// Packed arrays are written without expanding them into properties.
+		if (auto packed = it->GetPacked(); packed && packed->GetSize() != 0) {
+			stream << '[' << format.newLine;
+			AppendPacked(*packed, stream, format, indent + 1);
+			stream << indents << ']';
+
+			if (it != node.GetProperties().end() - 1)
+				stream << ',';
+			stream << (indent != 0 ? format.newLine : format.space);
+			continue;
+		}
+
 		bool isArray = false;
 		if (!it->GetProperties().empty()) {
 			// If all properties have no names, then this must be an array.
@@ -200,4 +490,26 @@ void Json::AppendData(const Node &node, std::ostream &stream, Node::Format forma
 		stream << (indent != 0 ? format.newLine : format.space);
 	}
 }
+
+void Json::AppendPacked(const Node::Packed &packed, std::ostream &stream, Node::Format format, int32_t indent) {
+	// Written the same way as a primitive array of properties.
+	auto size = packed.GetSize();
+	auto indents = format.GetIndents(indent);
+
+	if (format.inlineArrays)
+		stream << indents;
+
+	for (std::size_t i = 0; i < size; i++) {
+		if (!format.inlineArrays)
+			stream << indents;
+		stream << packed.GetNode(i).GetValue();
+		if (i != size - 1)
+			stream << ',';
+		if (!format.inlineArrays)
+			stream << format.newLine;
+	}
+
+	if (format.inlineArrays)
+		stream << '\n';
+}
 }
@@ -11,9 +11,18 @@ public:
 	static void WriteStream(const Node &node, std::ostream &stream, Node::Format format);
 
 private:
-	static void AddToken(std::string_view view, std::vector<Node::Token> &tokens);
-	static void Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k);
+	static void ParseValue(Node &current, const char *&it, const char *end);
+	/**
+	 * Parses a quoted string, strings without escapes are not copied.
+	 * @param it The opening quote, moved past the closing quote.
+	 * @param end The end of the source.
+	 * @param view Set to the string, a view into the source or into str.
+	 * @param str The string with escapes replaced, only used if the string has escapes.
+	 * @return If the string had escapes and was written into str.
+	 */
+	static bool ParseQuoted(const char *&it, const char *end, std::string_view &view, std::string &str);
 
 	static void AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent);
+	static void AppendPacked(const Node::Packed &packed, std::ostream &stream, Node::Format format, int32_t indent);
 };
 }
@@ -1,6 +1,10 @@
 #include "Node.hpp"
 
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include "NodeArena.hpp"
 
 namespace acid {
 const Node::Format Node::Format::Beautified = Format(2, '\n', ' ', true);
@@ -8,10 +12,90 @@ const Node::Format Node::Format::Minified = Format(0, '\0', '\0', false);
 
 static const Node NullNode = (Node() = nullptr);
 
+// Finds the shortest text that reads back as the same value, whole numbers keep a decimal point so they are read back as decimals.
+template<typename T>
+static std::string FormatDecimal(T value) {
+	char buffer[32];
+#if defined(__cpp_lib_to_chars)
+	std::string text(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+#else
+	std::string text;
+	for (int precision = std::is_same_v<T, float> ? 6 : 15; ; precision++) {
+		std::snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+		if (precision >= (std::is_same_v<T, float> ? 9 : 17) || static_cast<T>(std::strtod(buffer, nullptr)) == value) {
+			text = buffer;
+			break;
+		}
+	}
+#endif
+
+	if (text.find_first_not_of("-0123456789") == std::string::npos)
+		text += ".0";
+	return text;
+}
+
+Node::Packed::Packed(const Packed &packed, const allocator_type &allocator) :
+	element(packed.element),
+	data(packed.data, allocator) {
+}
+
+Node::Packed::Packed(Packed &&packed, const allocator_type &allocator) :
+	element(packed.element),
+	data(std::move(packed.data), allocator) {
+}
+
+std::size_t Node::Packed::GetElementSize(Element element) {
+	switch (element) {
+	case Element::Int8:
+	case Element::UInt8:
+		return 1;
+	case Element::Int16:
+	case Element::UInt16:
+		return 2;
+	case Element::Int32:
+	case Element::UInt32:
+	case Element::Float:
+		return 4;
+	default:
+		return 8;
+	}
+}
+
+Node Node::Packed::GetNode(std::size_t index) const {
+	Node node;
+
+	switch (element) {
+	case Element::UInt64:
+		// Values that do not fit a signed integer are kept as text.
+		if (auto integer = Get<uint64_t>(index); integer > static_cast<uint64_t>(INT64_MAX)) {
+			node.value = std::to_string(integer);
+			break;
+		}
+		[[fallthrough]];
+	default:
+		node.value = Get<int64_t>(index);
+		break;
+	case Element::Float:
+		node.value = Get<float>(index);
+		break;
+	case Element::Double:
+		node.value = Get<double>(index);
+		break;
+	}
+
+	node.type = IsInteger() ? Type::Integer : Type::Decimal;
+	return node;
+}
+
 Node::Node() :
 	type(Type::Object) {
 }
 
+Node::Node(const allocator_type &allocator) :
+	properties(allocator),
+	type(Type::Object) {
+}
+
 Node::Node(const std::string &name) :
 	name(name),
 	type(Type::Object) {
@@ -22,8 +106,35 @@ Node::Node(const std::string &name, const Node &node) :
 	SetName(name);
 }
 
+Node::Node(const Node &node) :
+	Node(node, allocator_type()) {
+}
+
+Node::Node(const Node &node, const allocator_type &allocator) :
+	properties(node.properties, allocator),
+	type(node.type) {
+	CopyNameAndValue(node, true);
+}
+
+Node::Node(Node &&node) noexcept :
+	Node(std::move(node), node.IsArena() ? allocator_type() : node.GetAllocator()) {
+}
+
+Node::Node(Node &&node, const allocator_type &allocator) :
+	properties(std::move(node.properties), allocator),
+	type(node.type) {
+	if (node.GetAllocator() == allocator) {
+		name = std::move(node.name);
+		value = std::move(node.value);
+	} else {
+		CopyNameAndValue(node, true);
+	}
+}
+
 void Node::Clear() {
 	properties.clear();
+	if (std::holds_alternative<Packed>(value))
+		value = std::string();
 }
 
 bool Node::IsValid() const {
@@ -33,17 +144,125 @@ bool Node::IsValid() const {
 		return false;
 	case Type::Object:
 	case Type::Array:
-		return !properties.empty();
+		return GetPropertyCount() != 0;
 	case Type::Null:
 		return true;
 	default:
-		return !value.empty();
+		return HasValue();
 	}
 }
 
+std::size_t Node::GetPropertyCount() const {
+	if (auto packed = GetPacked())
+		return packed->GetSize();
+	return properties.size();
+}
+
+void Node::SetName(std::string name) {
+	if (IsArena())
+		this->name = Store(name);
+	else
+		this->name = std::move(name);
+}
+
+void Node::SetNameView(std::string_view name) {
+	if (IsArena())
+		this->name = name;
+	else
+		this->name = std::string(name);
+}
+
+void Node::SetValue(std::string value) {
+	if (IsArena())
+		this->value = Store(value);
+	else
+		this->value = std::move(value);
+}
+
+void Node::SetValueView(std::string_view value) {
+	if (IsArena())
+		this->value = value;
+	else
+		this->value = std::string(value);
+}
+
+void Node::SetTypedValue(Value value) {
+	if (auto string = std::get_if<std::string>(&value))
+		SetValue(std::move(*string));
+	else if (auto view = std::get_if<std::string_view>(&value))
+		SetValueView(*view);
+	else if (auto packed = std::get_if<Packed>(&value))
+		this->value = Packed(std::move(*packed), GetAllocator());
+	else
+		this->value = std::move(value);
+}
+
+std::string Node::GetValue() const {
+	return std::visit([](const auto &value) -> std::string {
+		using T = std::decay_t<decltype(value)>;
+		if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+			return std::string(value);
+		else if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, int64_t>)
+			return String::To(value);
+		else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+			return FormatDecimal(value);
+		else
+			return {};
+	}, value);
+}
+
+bool Node::HasValue() const {
+	if (auto string = std::get_if<std::string>(&value))
+		return !string->empty();
+	if (auto view = std::get_if<std::string_view>(&value))
+		return !view->empty();
+	return !std::holds_alternative<Packed>(value);
+}
+
+bool Node::IsArena() const {
+	return NodeArena::IsArenaResource(properties.get_allocator().resource());
+}
+
+std::string_view Node::Store(std::string_view string) const {
+	if (string.empty())
+		return {};
+
+	auto data = static_cast<char *>(properties.get_allocator().resource()->allocate(string.size(), 1));
+	std::memcpy(data, string.data(), string.size());
+	return {data, string.size()};
+}
+
+void Node::CopyNameAndValue(const Node &node, bool copyName) {
+	auto shared = node.GetAllocator() == GetAllocator();
+
+	if (copyName) {
+		if (auto view = std::get_if<std::string_view>(&node.name); view && shared)
+			name = *view;
+		else
+			SetName(std::string(node.GetName()));
+	}
+
+	if (auto view = std::get_if<std::string_view>(&node.value); view && !shared)
+		SetValue(std::string(*view));
+	else if (auto packed = std::get_if<Packed>(&node.value))
+		value = Packed(*packed, GetAllocator());
+	else
+		SetTypedValue(node.value);
+}
+
+void Node::UnpackProperties() {
+	auto packed = std::get<Packed>(std::move(value));
+	value = std::string();
+
+	auto size = packed.GetSize();
+	properties.reserve(properties.size() + size);
+	for (std::size_t i = 0; i < size; i++)
+		properties.emplace_back(packed.GetNode(i));
+}
+
 bool Node::HasProperty(const std::string &name) const {
 	for (const auto &property : properties) {
-		if (property.name == name)
+		if (property.GetName() == name)
 			return true;
 	}
 
@@ -51,12 +270,12 @@ bool Node::HasProperty(const std::string &name) const {
 }
 
 bool Node::HasProperty(uint32_t index) const {
-	return index < properties.size();
+	return index < GetPropertyCount();
 }
 
 NodeConstView Node::GetProperty(const std::string &name) const {
 	for (const auto &property : properties) {
-		if (property.name == name)
+		if (property.GetName() == name)
 			return {this, name, &property};
 	}
 
@@ -67,13 +286,17 @@ NodeConstView Node::GetProperty(uint32_t index) const {
 	if (index < properties.size())
 		return {this, index, &properties[index]};
 
+	// Elements of a packed array are returned as copies, so the array is not expanded by reads.
+	if (auto packed = GetPacked(); packed && index - properties.size() < packed->GetSize())
+		return {this, index, packed->GetNode(index - properties.size())};
+
 	return {this, index, nullptr};
 }
 
 // TODO: Duplicate
 NodeView Node::GetProperty(const std::string &name) {
 	for (auto &property : properties) {
-		if (property.name == name)
+		if (property.GetName() == name)
 			return {this, name, &property};
 	}
 
@@ -82,6 +305,7 @@ NodeView Node::GetProperty(const std::string &name) {
 
 // TODO: Duplicate
 NodeView Node::GetProperty(uint32_t index) {
+	Unpack();
 	if (index < properties.size())
 		return {this, index, &properties[index]};
 
@@ -89,30 +313,37 @@ NodeView Node::GetProperty(uint32_t index) {
 }
 
 Node &Node::AddProperty(const Node &node) {
+	Unpack();
 	return properties.emplace_back(node);
 }
 
 Node &Node::AddProperty(Node &&node) {
+	Unpack();
 	return properties.emplace_back(std::move(node));
 }
 
 Node &Node::AddProperty(const std::string &name, const Node &node) {
-	Node newNode = node;
-	newNode.name = name;
-	return properties.emplace_back(std::move(newNode));
+	Unpack();
+	auto &property = properties.emplace_back(node);
+	property.SetName(name);
+	return property;
 }
 
 Node &Node::AddProperty(const std::string &name, Node &&node) {
-	node.name = name;
-	return properties.emplace_back(std::move(node));
+	Unpack();
+	auto &property = properties.emplace_back(std::move(node));
+	property.SetName(name);
+	return property;
 }
 
 Node &Node::AddProperty(uint32_t index, const Node &node) {
+	Unpack();
 	properties.resize(std::max(properties.size(), static_cast<std::size_t>(index + 1)), NullNode);
 	return properties[index] = node;
 }
 
 Node &Node::AddProperty(uint32_t index, Node &&node) {
+	Unpack();
 	properties.resize(std::max(properties.size(), static_cast<std::size_t>(index + 1)), NullNode);
 	return properties[index] = std::move(node);
 }
@@ -120,11 +351,12 @@ Node &Node::AddProperty(uint32_t index, Node &&node) {
 void Node::RemoveProperty(const std::string &name) {
 	//node.parent = nullptr;
 	properties.erase(std::remove_if(properties.begin(), properties.end(), [name](const auto &n) {
-		return n.name == name;
+		return n.GetName() == name;
 	}), properties.end());
 }
 
 void Node::RemoveProperty(const Node &node) {
+	Unpack();
 	//node.parent = nullptr;
 	properties.erase(std::remove_if(properties.begin(), properties.end(), [node](const auto &n) {
 		return n == node;
@@ -135,7 +367,7 @@ std::vector<NodeConstView> Node::GetProperties(const std::string &name) const {
 	std::vector<NodeConstView> properties;
 
 	for (const auto &property : this->properties) {
-		if (property.name == name)
+		if (property.GetName() == name)
 			properties.emplace_back(NodeConstView(this, name, &property));
 	}
 
@@ -170,7 +402,7 @@ std::vector<NodeView> Node::GetProperties(const std::string &name) {
 	std::vector<NodeView> properties;
 
 	for (auto &property : this->properties) {
-		if (property.name == name)
+		if (property.GetName() == name)
 			properties.emplace_back(NodeView(this, name, &property));
 	}
 
@@ -223,7 +455,7 @@ NodeView Node::operator[](uint32_t index) {
 Node &Node::operator=(const Node &rhs) {
 	properties = rhs.properties;
 	//name = rhs.name;
-	value = rhs.value;
+	CopyNameAndValue(rhs, false);
 	type = rhs.type;
 	return *this;
 }
@@ -231,7 +463,10 @@ Node &Node::operator=(const Node &rhs) {
 Node &Node::operator=(Node &&rhs) noexcept {
 	properties = std::move(rhs.properties);
 	//name = std::move(rhs.name);
-	value = std::move(rhs.value);
+	if (rhs.GetAllocator() == GetAllocator())
+		value = std::move(rhs.value);
+	else
+		CopyNameAndValue(rhs, false);
 	type = std::move(rhs.type);
 	return *this;
 }
@@ -253,10 +488,7 @@ Node &Node::operator=(NodeView &&rhs) noexcept {
 }
 
 bool Node::operator==(const Node &rhs) const {
-	return value == rhs.value && properties.size() == rhs.properties.size() &&
-		std::equal(properties.begin(), properties.end(), rhs.properties.begin(), [](const auto &left, const auto &right) {
-		return left == right;
-	});
+	return Compare(rhs) == 0;
 }
 
 bool Node::operator!=(const Node &rhs) const {
@@ -264,12 +496,48 @@ bool Node::operator!=(const Node &rhs) const {
 }
 
 bool Node::operator<(const Node &rhs) const {
-	if (value < rhs.value) return true;
-	if (rhs.value < value) return false;
+	return Compare(rhs) < 0;
+}
+
+int Node::Compare(const Node &rhs) const {
+	// Typed values equal in the same representation have the same text, decimals are left out as zero and negative zero are equal but written differently.
+	auto sameValue = value.index() == rhs.value.index() && !std::holds_alternative<float>(value) && !std::holds_alternative<double>(value) &&
+		value == rhs.value;
+
+	if (!sameValue) {
+		// Values of different representations are compared as text, so an integer read from a file equals one set from code.
+		auto getText = [](const Node &node, std::string &text) -> std::string_view {
+			if (auto string = std::get_if<std::string>(&node.value))
+				return *string;
+			if (auto view = std::get_if<std::string_view>(&node.value))
+				return *view;
+			return text = node.GetValue();
+		};
+
+		std::string lhsText, rhsText;
+		if (auto order = getText(*this, lhsText).compare(getText(rhs, rhsText)))
+			return order < 0 ? -1 : 1;
+	}
 
-	if (properties < rhs.properties) return true;
-	if (rhs.properties < properties) return false;
+	// Packed arrays are compared as the properties they unpack to, after any other properties, without unpacking nodes that may be shared map keys.
+	auto lhsPacked = GetPacked();
+	auto rhsPacked = rhs.GetPacked();
+	auto lhsCount = properties.size() + (lhsPacked ? lhsPacked->GetSize() : 0);
+	auto rhsCount = rhs.properties.size() + (rhsPacked ? rhsPacked->GetSize() : 0);
+
+	auto getProperty = [](const Node &node, const Packed *packed, std::size_t index, Node &element) -> const Node & {
+		if (index < node.properties.size())
+			return node.properties[index];
+		element = packed->GetNode(index - node.properties.size());
+		return element;
+	};
+
+	Node lhsElement, rhsElement;
+	for (std::size_t i = 0; i < std::min(lhsCount, rhsCount); i++) {
+		if (auto order = getProperty(*this, lhsPacked, i, lhsElement).Compare(getProperty(rhs, rhsPacked, i, rhsElement)))
+			return order;
+	}
 
-	return false;
+	return lhsCount < rhsCount ? -1 : lhsCount > rhsCount ? 1 : 0;
 }
 }
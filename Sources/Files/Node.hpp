@@ -1,12 +1,22 @@
 #pragma once
 
+#include <memory_resource>
 #include <ostream>
+#include <variant>
 
 #include "NodeView.hpp"
 
 namespace acid {
 /**
  * @brief Class that is used to represent a tree of UFT-8 values, used in serialization.
+ *
+ * Values are stored by type, numbers and booleans never go through text when set and read with the stream operators.
+ * Arrays of numbers are stored as one packed block instead of a property per element, they are expanded into
+ * properties the first time the properties are accessed, so reading a packed array as nodes is not thread safe.
+ *
+ * Nodes are allocator aware, a tree created in an acid::NodeArena allocates all of its properties, names and values from
+ * the arena, and can keep names and values as views into the parsed source. Copies of such a node, and nodes moved out of
+ * it, are allocated normally and own their strings.
  */
 class ACID_EXPORT Node final {
 public:
@@ -89,11 +99,97 @@ public:
 		std::string_view view;
 	};
 
+	/**
+	 * @brief Class that holds a homogeneous array of numbers in one contiguous block.
+	 */
+	class ACID_EXPORT Packed {
+	public:
+		enum class Element : uint8_t {
+			Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Float, Double
+		};
+
+		/// If the type can be stored in a packed array.
+		template<typename T>
+		static constexpr bool IsElement = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>;
+
+		using allocator_type = std::pmr::polymorphic_allocator<uint8_t>;
+
+		Packed() = default;
+		template<typename T>
+		Packed(const T *data, std::size_t count, const allocator_type &allocator = {});
+		Packed(const Packed &packed, const allocator_type &allocator);
+		Packed(Packed &&packed, const allocator_type &allocator);
+		Packed(const Packed &packed) = default;
+		Packed(Packed &&packed) noexcept = default;
+
+		Packed &operator=(const Packed &rhs) = default;
+		Packed &operator=(Packed &&rhs) noexcept = default;
+
+		bool operator==(const Packed &rhs) const { return element == rhs.element && data == rhs.data; }
+		bool operator!=(const Packed &rhs) const { return !operator==(rhs); }
+		bool operator<(const Packed &rhs) const { return element < rhs.element || (element == rhs.element && data < rhs.data); }
+
+		/**
+		 * Gets a element converted to a type.
+		 * @tparam T The type to convert to.
+		 * @param index The element index.
+		 * @return The element.
+		 */
+		template<typename T>
+		T Get(std::size_t index) const;
+
+		/**
+		 * Copies all elements into an array, this is a memcpy if the element type matches.
+		 * @tparam T The type to convert to.
+		 * @param dest The array to copy to, must hold GetSize elements.
+		 */
+		template<typename T>
+		void CopyTo(T *dest) const;
+
+		/**
+		 * Creates a node holding a element.
+		 * @param index The element index.
+		 * @return The element node.
+		 */
+		Node GetNode(std::size_t index) const;
+
+		Element GetElement() const { return element; }
+		std::size_t GetSize() const { return data.size() / GetElementSize(element); }
+		const uint8_t *GetData() const { return data.data(); }
+
+		/**
+		 * Gets if the elements are integers, otherwise they are decimals.
+		 * @return If the elements are integers.
+		 */
+		bool IsInteger() const { return element < Element::Float; }
+
+		static std::size_t GetElementSize(Element element);
+
+	private:
+		template<typename T>
+		static constexpr Element ElementOf();
+
+		Element element = Element::Int64;
+		std::pmr::vector<uint8_t> data;
+	};
+
+	/// A node value, text is only used for strings and values that do not fit a typed representation.
+	/// Views are only kept by nodes allocated from an arena, they point into the parsed source or the arena.
+	using Value = std::variant<std::string, std::string_view, bool, int64_t, float, double, Packed>;
+	using allocator_type = std::pmr::polymorphic_allocator<Node>;
+
 	Node();
+	explicit Node(const allocator_type &allocator);
 	explicit Node(const std::string &name);
 	Node(const std::string &name, const Node &node);
-	Node(const Node &node) = default;
-	Node(Node &&node) = default;
+	Node(const Node &node);
+	Node(const Node &node, const allocator_type &allocator);
+	/**
+	 * Moves a node, a node in an arena is copied out of it with the default allocator instead so it outlives the arena.
+	 * @param node The node to move.
+	 */
+	Node(Node &&node) noexcept;
+	Node(Node &&node, const allocator_type &allocator);
 
 	template<typename NodeParser>
 	void ParseString(std::string_view string);
@@ -177,22 +273,107 @@ public:
 	bool operator!=(const Node &rhs) const;
 	bool operator<(const Node &rhs) const;
 
-	const std::vector<Node> &GetProperties() const { return properties; }
-	std::vector<Node> &GetProperties() { return properties; }
+	/**
+	 * Gets the properties, a packed array is not expanded so reading a shared tree does not change it.
+	 * @return The properties, without the elements of a packed array.
+	 */
+	const std::pmr::vector<Node> &GetProperties() const { return properties; }
+	std::pmr::vector<Node> &GetProperties() { Unpack(); return properties; }
 
-	const std::string &GetName() const { return name; }
-	void SetName(std::string name) { this->name = std::move(name); }
+	/**
+	 * Calls a function with each property, elements of a packed array are passed as temporary nodes without expanding it.
+	 * @tparam Function The function type, called with a const Node reference.
+	 * @param function The function to call.
+	 */
+	template<typename Function>
+	void ForEachProperty(const Function &function) const;
 
-	const std::string &GetValue() const { return value; }
-	void SetValue(std::string value) { this->value = std::move(value); }
+	/**
+	 * Gets the number of properties, packed arrays are not expanded.
+	 * @return The number of properties.
+	 */
+	std::size_t GetPropertyCount() const;
+
+	std::string_view GetName() const { return std::visit([](const auto &name) { return std::string_view(name); }, name); }
+	void SetName(std::string name);
+
+	/**
+	 * Sets the name without copying it when the node is allocated from an arena, otherwise the name is copied.
+	 * @param name The name, must outlive the arena.
+	 */
+	void SetNameView(std::string_view name);
+
+	/**
+	 * Gets the value written as text, strings are returned as they are.
+	 * @return The value text.
+	 */
+	std::string GetValue() const;
+	void SetValue(std::string value);
+
+	/**
+	 * Sets a string value without copying it when the node is allocated from an arena, otherwise the value is copied.
+	 * @param value The value, must outlive the arena.
+	 */
+	void SetValueView(std::string_view value);
+
+	const Value &GetTypedValue() const { return value; }
+	void SetTypedValue(Value value);
+
+	/**
+	 * Gets the packed array held by this node.
+	 * @return The packed array, or nullptr if the node is not a packed array.
+	 */
+	const Packed *GetPacked() const { return std::get_if<Packed>(&value); }
 
 	const Type &GetType() const { return type; }
 	void SetType(Type type) { this->type = type; }
 
+	allocator_type GetAllocator() const { return properties.get_allocator(); }
+
+	/**
+	 * Gets if the node is allocated from an acid::NodeArena, strings are then stored in the arena.
+	 * @return If the node is allocated from an arena.
+	 */
+	bool IsArena() const;
+
+	/**
+	 * Expands a packed array into properties.
+	 */
+	void Unpack() {
+		if (std::holds_alternative<Packed>(value))
+			UnpackProperties();
+	}
+
 protected:
-	std::vector<Node> properties; // members
-	std::string name; // key
-	std::string value;
+	void UnpackProperties();
+
+	/**
+	 * Compares the values as text and the properties in order with packed arrays expanded, so the order is strict weak across representations.
+	 * Neither node is changed.
+	 * @param rhs The node to compare to.
+	 * @return Less than zero if this node is ordered first, zero if the nodes are equal, otherwise greater than zero.
+	 */
+	int Compare(const Node &rhs) const;
+
+	bool HasValue() const;
+
+	/**
+	 * Copies a string into the arena the node is allocated from.
+	 * @param string The string to copy.
+	 * @return The copy.
+	 */
+	std::string_view Store(std::string_view string) const;
+
+	/**
+	 * Copies the name and value of another node, views are kept only if both nodes share an allocator.
+	 * @param node The node to copy from.
+	 * @param copyName If the name is copied.
+	 */
+	void CopyNameAndValue(const Node &node, bool copyName);
+
+	std::pmr::vector<Node> properties; // members
+	std::variant<std::string, std::string_view> name; // key
+	Value value;
 	Type type;
 };
 }
@@ -18,6 +18,83 @@
 #include "Utils/String.hpp"
 
 namespace acid {
+template<typename T>
+Node::Packed::Packed(const T *data, std::size_t count, const allocator_type &allocator) :
+	element(ElementOf<T>()),
+	data(reinterpret_cast<const uint8_t *>(data), reinterpret_cast<const uint8_t *>(data) + count * sizeof(T), allocator) {
+	static_assert(IsElement<T>, "Packed arrays can only hold numbers");
+}
+
+template<typename T>
+constexpr Node::Packed::Element Node::Packed::ElementOf() {
+	if constexpr (std::is_floating_point_v<T>)
+		return sizeof(T) == sizeof(float) ? Element::Float : Element::Double;
+	else if constexpr (sizeof(T) == 1)
+		return std::is_signed_v<T> ? Element::Int8 : Element::UInt8;
+	else if constexpr (sizeof(T) == 2)
+		return std::is_signed_v<T> ? Element::Int16 : Element::UInt16;
+	else if constexpr (sizeof(T) == 4)
+		return std::is_signed_v<T> ? Element::Int32 : Element::UInt32;
+	else
+		return std::is_signed_v<T> ? Element::Int64 : Element::UInt64;
+}
+
+template<typename T>
+T Node::Packed::Get(std::size_t index) const {
+	auto read = [this, index](auto value) {
+		std::memcpy(&value, data.data() + index * sizeof(value), sizeof(value));
+		return static_cast<T>(value);
+	};
+
+	switch (element) {
+	case Element::Int8:
+		return read(int8_t());
+	case Element::UInt8:
+		return read(uint8_t());
+	case Element::Int16:
+		return read(int16_t());
+	case Element::UInt16:
+		return read(uint16_t());
+	case Element::Int32:
+		return read(int32_t());
+	case Element::UInt32:
+		return read(uint32_t());
+	case Element::Int64:
+		return read(int64_t());
+	case Element::UInt64:
+		return read(uint64_t());
+	case Element::Float:
+		return read(float());
+	default:
+		return read(double());
+	}
+}
+
+template<typename T>
+void Node::Packed::CopyTo(T *dest) const {
+	if constexpr (IsElement<T>) {
+		if (ElementOf<T>() == element) {
+			std::memcpy(dest, data.data(), data.size());
+			return;
+		}
+	}
+
+	auto size = GetSize();
+	for (std::size_t i = 0; i < size; i++)
+		dest[i] = Get<T>(i);
+}
+
+template<typename Function>
+void Node::ForEachProperty(const Function &function) const {
+	for (const auto &property : properties)
+		function(property);
+
+	if (auto packed = GetPacked()) {
+		for (std::size_t i = 0; i < packed->GetSize(); i++)
+			function(packed->GetNode(i));
+	}
+}
+
 template<typename NodeParser>
 void Node::ParseString(std::string_view string) {
 	NodeParser::ParseString(*this, string);
@@ -40,7 +117,23 @@ void Node::ParseStream(std::basic_istream<_Elem> &stream) {
 	}
 
 	// Reading into a string before iterating is much faster.
-	std::string s(std::istreambuf_iterator<_Elem>(stream), {});
+	std::string s;
+
+	// When the stream can seek the string is allocated once and filled with a single read.
+	if constexpr (std::is_same_v<_Elem, char>) {
+		auto start = stream.tellg();
+		if (start != -1 && stream.seekg(0, std::ios::end)) {
+			auto size = static_cast<std::size_t>(stream.tellg() - start);
+			stream.seekg(start);
+			s.resize(size);
+			stream.read(s.data(), size);
+			s.resize(static_cast<std::size_t>(stream.gcount()));
+		}
+		stream.clear();
+	}
+
+	if (s.empty())
+		s.assign(std::istreambuf_iterator<_Elem>(stream), {});
 	ParseString<NodeParser>(s);
 }
 
@@ -54,13 +147,13 @@ std::basic_string<_Elem> Node::WriteString(Format format) const {
 template<typename T>
 T Node::GetName() const {
 	// String to basic type conversion.
-	return String::From<T>(name);
+	return String::From<T>(std::string(GetName()));
 }
 
 template<typename T>
 void Node::SetName(const T &value) {
 	// Basic type to string conversion.
-	name = String::To(value);
+	SetName(String::To(value));
 }
 
 template<typename T>
@@ -190,26 +283,63 @@ Node &operator<<(Node &node, const std::shared_ptr<T> &object) {
 }
 
 inline const Node &operator>>(const Node &node, bool &object) {
-	object = String::From<bool>(node.GetValue());
+	if (auto value = std::get_if<bool>(&node.GetTypedValue()))
+		object = *value;
+	else if (auto integer = std::get_if<int64_t>(&node.GetTypedValue()))
+		object = *integer == 1;
+	else
+		object = String::From<bool>(node.GetValue());
 	return node;
 }
 
 inline Node &operator<<(Node &node, bool object) {
-	node.SetValue(String::To(object));
+	node.SetTypedValue(object);
 	node.SetType(Node::Type::Boolean);
 	return node;
 }
 
 template<typename T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>, int> = 0>
 const Node &operator>>(const Node &node, T &object) {
-	object = String::From<T>(node.GetValue());
+	// Values kept as text are read the same way they were before values were typed.
+	object = std::visit([](const auto &value) -> T {
+		using V = std::decay_t<decltype(value)>;
+		if constexpr (std::is_same_v<V, std::string>) {
+			return String::From<T>(value);
+		} else if constexpr (std::is_same_v<V, std::string_view>) {
+			return String::From<T>(std::string(value));
+		} else if constexpr (std::is_same_v<V, Node::Packed>) {
+			return T();
+		} else if constexpr (std::is_enum_v<T>) {
+			return static_cast<T>(static_cast<std::underlying_type_t<T>>(value));
+		} else {
+			return static_cast<T>(value);
+		}
+	}, node.GetTypedValue());
 	return node;
 }
 
 template<typename T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>, int> = 0>
 Node &operator<<(Node &node, T object) {
-	node.SetValue(String::To(object));
-	node.SetType(std::is_floating_point_v<T> ? Node::Type::Decimal : Node::Type::Integer);
+	if constexpr (std::is_floating_point_v<T>) {
+		if constexpr (sizeof(T) <= sizeof(float))
+			node.SetTypedValue(static_cast<float>(object));
+		else
+			node.SetTypedValue(static_cast<double>(object));
+		node.SetType(Node::Type::Decimal);
+		return node;
+	} else if constexpr (std::is_same_v<T, char>) {
+		node.SetValue(String::To(object));
+	} else if constexpr (std::is_enum_v<T>) {
+		node.SetTypedValue(static_cast<int64_t>(object));
+	} else {
+		// Unsigned values that do not fit a signed integer are kept as text.
+		if (std::is_unsigned_v<T> && static_cast<uint64_t>(object) > static_cast<uint64_t>(INT64_MAX))
+			node.SetValue(String::To(object));
+		else
+			node.SetTypedValue(static_cast<int64_t>(object));
+	}
+
+	node.SetType(Node::Type::Integer);
 	return node;
 }
 
@@ -293,20 +423,37 @@ Node &operator<<(Node &node, const std::optional<T> &optional) {
 
 template<typename T>
 const Node &operator>>(const Node &node, std::vector<T> &vector) {
+	if constexpr (Node::Packed::IsElement<T>) {
+		if (auto packed = node.GetPacked()) {
+			vector.resize(packed->GetSize());
+			packed->CopyTo(vector.data());
+			return node;
+		}
+	}
+
 	vector.clear();
-	vector.reserve(node.GetProperties().size());
+	vector.reserve(node.GetPropertyCount());
 
-	for (const auto &property : node.GetProperties()) {
+	node.ForEachProperty([&vector](const Node &property) {
 		T x;
 		property >> x;
 		vector.emplace_back(std::move(x));
-	}
+	});
 
 	return node;
 }
 
 template<typename T>
 Node &operator<<(Node &node, const std::vector<T> &vector) {
+	// Numbers are packed into one block, unless they are appended to existing properties.
+	if constexpr (Node::Packed::IsElement<T>) {
+		if (node.GetPropertyCount() == 0) {
+			node.SetTypedValue(Node::Packed(vector.data(), vector.size()));
+			node.SetType(Node::Type::Array);
+			return node;
+		}
+	}
+
 	for (const auto &x : vector)
 		node.AddProperty() << x;
 
@@ -318,11 +465,11 @@ template<typename T>
 const Node &operator>>(const Node &node, std::set<T> &vector) {
 	vector.clear();
 
-	for (const auto &property : node.GetProperties()) {
+	node.ForEachProperty([&vector](const Node &property) {
 		T x;
 		property >> x;
 		vector.emplace(std::move(x));
-	}
+	});
 
 	return node;
 }
@@ -340,11 +487,11 @@ template<typename T, typename K>
 const Node &operator>>(const Node &node, std::map<T, K> &map) {
 	map.clear();
 
-	for (const auto &property : node.GetProperties()) {
+	node.ForEachProperty([&map](const Node &property) {
 		std::pair<T, K> pair;
 		property >> pair;
 		map.emplace(std::move(pair));
-	}
+	});
 
 	return node;
 }
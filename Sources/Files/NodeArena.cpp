@@ -0,0 +1,31 @@
+#include "NodeArena.hpp"
+
+namespace acid {
+NodeArena::NodeArena(std::size_t blockSize) :
+	resource(blockSize, &upstream) {
+}
+
+Node &NodeArena::CreateNode() {
+	// The node is never destroyed, all of its memory is in the arena.
+	return *new(resource.allocate(sizeof(Node), alignof(Node))) Node(Node::allocator_type(&resource));
+}
+
+void NodeArena::Release() {
+	resource.release();
+	sources.clear();
+}
+
+bool NodeArena::IsArenaResource(const std::pmr::memory_resource *resource) {
+	return dynamic_cast<const Resource *>(resource) != nullptr;
+}
+
+void *NodeArena::Upstream::do_allocate(std::size_t bytes, std::size_t alignment) {
+	allocationCount++;
+	allocatedSize += bytes;
+	return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void NodeArena::Upstream::do_deallocate(void *p, std::size_t bytes, std::size_t alignment) {
+	std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+}
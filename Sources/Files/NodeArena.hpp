@@ -0,0 +1,98 @@
+#pragma once
+
+#include <deque>
+
+#include "Utils/NonCopyable.hpp"
+#include "Node.hpp"
+
+namespace acid {
+/**
+ * @brief Class that owns node trees that are parsed into a single growing block of memory.
+ *
+ * Every property, name and value of a tree in the arena is allocated from the arena, and names and values that need no
+ * unescaping are views into the parsed source, which the arena keeps. Releasing the arena frees all of its trees at once
+ * without visiting any node, this suits large files that are read once and dropped, like COLLADA meshes and prefabs.
+ *
+ * Nodes in the arena are only valid until it is released, copy a node out of the arena to keep it longer.
+ */
+class ACID_EXPORT NodeArena : NonCopyable {
+public:
+	/**
+	 * Creates a new arena.
+	 * @param blockSize The size of the first block, later blocks grow geometrically.
+	 */
+	explicit NodeArena(std::size_t blockSize = 64 * 1024);
+
+	/**
+	 * Parses a string into a new tree in the arena.
+	 * @tparam NodeParser The parser to use.
+	 * @param source The string to parse, kept until the arena is released.
+	 * @return The root of the new tree.
+	 */
+	template<typename NodeParser>
+	Node &Parse(std::string source) {
+		auto &retained = sources.emplace_back(std::move(source));
+		auto &root = CreateNode();
+		root.ParseString<NodeParser>(retained);
+		return root;
+	}
+
+	/**
+	 * Creates an empty node in the arena.
+	 * @return The new node.
+	 */
+	Node &CreateNode();
+
+	/**
+	 * Frees every tree in the arena, no node destructors are run.
+	 */
+	void Release();
+
+	/**
+	 * Gets the number of blocks allocated from the system.
+	 * @return The number of allocations.
+	 */
+	std::size_t GetAllocationCount() const { return upstream.allocationCount; }
+
+	/**
+	 * Gets the size of all blocks allocated from the system.
+	 * @return The size in bytes.
+	 */
+	std::size_t GetAllocatedSize() const { return upstream.allocatedSize; }
+
+	/**
+	 * Gets if a memory resource belongs to an arena.
+	 * @param resource The resource to check.
+	 * @return If the resource is the resource of an arena.
+	 */
+	static bool IsArenaResource(const std::pmr::memory_resource *resource);
+
+private:
+	/**
+	 * @brief Memory resource that allocates blocks with new and delete, and counts them.
+	 */
+	class Upstream : public std::pmr::memory_resource {
+	public:
+		std::size_t allocationCount = 0;
+		std::size_t allocatedSize = 0;
+
+	private:
+		void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+	};
+
+	/**
+	 * @brief The resource nodes in the arena are allocated from, its type tells arena nodes apart from nodes using other resources.
+	 */
+	class Resource final : public std::pmr::monotonic_buffer_resource {
+	public:
+		using monotonic_buffer_resource::monotonic_buffer_resource;
+	};
+
+	Upstream upstream;
+	Resource resource;
+	/// Sources of the parsed trees, a deque so views into short strings are not moved.
+	std::deque<std::string> sources;
+};
+}
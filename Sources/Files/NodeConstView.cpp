@@ -9,6 +9,13 @@ NodeConstView::NodeConstView(const Node *parent, Key key, const Node *value) :
 	keys{std::move(key)} {
 }
 
+NodeConstView::NodeConstView(const Node *parent, Key key, Node &&element) :
+	parent(parent),
+	keys{std::move(key)},
+	element(std::make_shared<const Node>(std::move(element))) {
+	value = this->element.get();
+}
+
 NodeConstView::NodeConstView(const NodeConstView *parent, Key key) :
 	parent(parent->parent),
 	keys(parent->keys) {
@@ -45,15 +52,16 @@ NodeConstView NodeConstView::operator[](uint32_t index) const {
 	return value->operator[](index);
 }
 
-std::vector<Node> NodeConstView::GetProperties() const {
+const std::pmr::vector<Node> &NodeConstView::GetProperties() const {
+	static const std::pmr::vector<Node> Empty;
 	if (!has_value())
-		return {};
+		return Empty;
 	return value->GetProperties();
 }
 
 std::string NodeConstView::GetName() const {
 	if (!has_value())
 		return "";
-	return value->GetName();
+	return std::string(value->GetName());
 }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <variant>
 #include <string>
 #include <vector>
@@ -21,6 +23,7 @@ protected:
 
 	NodeConstView() = default;
 	NodeConstView(const Node *parent, Key key, const Node *value);
+	NodeConstView(const Node *parent, Key key, Node &&element);
 	NodeConstView(const NodeConstView *parent, Key key);
 
 public:
@@ -52,7 +55,7 @@ public:
 	NodeConstView operator[](const std::string &key) const;
 	NodeConstView operator[](uint32_t index) const;
 
-	std::vector<Node> GetProperties() const;
+	const std::pmr::vector<Node> &GetProperties() const;
 
 	std::string GetName() const;
 	
@@ -60,5 +63,7 @@ protected:
 	const Node *parent = nullptr;
 	const Node *value = nullptr;
 	std::vector<Key> keys;
+	/// A element of a packed array, the view owns it since reads do not expand the array.
+	std::shared_ptr<const Node> element;
 };
 }
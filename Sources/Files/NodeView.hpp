@@ -41,6 +41,6 @@ public:
 	template<typename T>
 	Node &operator=(T &&rhs);
 
-	std::vector<Node> &GetProperties();
+	std::pmr::vector<Node> &GetProperties();
 };
 }
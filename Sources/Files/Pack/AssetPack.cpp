@@ -0,0 +1,478 @@
+#include "AssetPack.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <set>
+#include <miniz/miniz.h>
+#include <physfs.h>
+
+#include "Resources/Resources.hpp"
+#include "Utils/ThreadPool.hpp"
+
+namespace acid {
+static uint64_t ReadUint(const uint8_t *data, std::size_t bytes) {
+	uint64_t value = 0;
+	for (std::size_t i = 0; i < bytes; i++)
+		value |= static_cast<uint64_t>(data[i]) << (8 * i);
+	return value;
+}
+
+static uint64_t GetChunkCount(uint64_t size) {
+	return size / AssetPack::ChunkSize + (size % AssetPack::ChunkSize != 0);
+}
+
+/**
+ * @brief The chunks of a compressed entry being decompressed, shared by the reading thread and the pool workers helping it.
+ *
+ * Chunks are claimed from a counter, the reading thread decompresses chunks too and only waits for chunks that a worker
+ * already claimed. Workers that start after every chunk is claimed return without touching the entry, so reading from a
+ * pool worker cannot deadlock the pool.
+ */
+class ChunkJob {
+public:
+	explicit ChunkJob(uint32_t count, std::function<bool(uint32_t)> &&decompress) :
+		count(count),
+		decompress(std::move(decompress)) {
+	}
+
+	void Run() {
+		for (uint32_t i; (i = next++) < count;) {
+			if (!decompress(i))
+				failed = true;
+			finished++;
+		}
+	}
+
+	bool Wait() const {
+		while (finished < count)
+			std::this_thread::yield();
+		return !failed;
+	}
+
+private:
+	uint32_t count;
+	std::function<bool(uint32_t)> decompress;
+	std::atomic<uint32_t> next = 0;
+	std::atomic<uint32_t> finished = 0;
+	std::atomic<bool> failed = false;
+};
+
+AssetPack::AssetPack(const std::filesystem::path &filename) {
+	if (auto mapped = MappedFile::Open(filename)) {
+		file = std::move(*mapped);
+		ReadContents();
+	}
+
+	if (!open)
+		Log::Error("Failed to open asset pack ", filename, '\n');
+}
+
+AssetPack::AssetPack(MappedFile &&file) :
+	file(std::move(file)) {
+	ReadContents();
+}
+
+void AssetPack::ReadContents() {
+	auto data = file.GetData();
+	auto size = file.GetSize();
+
+	if (size < HeaderSize || std::memcmp(data, Magic.data(), Magic.size()) != 0 || ReadUint(data + 4, 4) != Version || ReadUint(data + 12, 4) != ChunkSize)
+		return;
+
+	auto entryCount = ReadUint(data + 8, 4);
+	auto entriesOffset = ReadUint(data + 16, 8);
+	auto namesOffset = ReadUint(data + 24, 8);
+	auto namesSize = ReadUint(data + 32, 8);
+
+	if (entriesOffset > size || entryCount > (size - entriesOffset) / EntrySize || namesOffset > size || namesSize > size - namesOffset)
+		return;
+
+	names = std::string_view(reinterpret_cast<const char *>(data + namesOffset), static_cast<std::size_t>(namesSize));
+	entries.resize(static_cast<std::size_t>(entryCount));
+
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		auto source = data + entriesOffset + i * EntrySize;
+		auto &entry = entries[i];
+		entry.hash = ReadUint(source, 8);
+		entry.offset = ReadUint(source + 8, 8);
+		entry.size = ReadUint(source + 16, 8);
+		entry.storedSize = ReadUint(source + 24, 8);
+		entry.nameOffset = static_cast<uint32_t>(ReadUint(source + 32, 4));
+		entry.nameSize = static_cast<uint32_t>(ReadUint(source + 36, 4));
+		entry.compression = static_cast<Compression>(source[40]);
+
+		if (entry.offset > size || entry.storedSize > size - entry.offset || entry.nameOffset > namesSize || entry.nameSize > namesSize - entry.nameOffset ||
+			entry.compression > Compression::Deflate || (entry.compression == Compression::None && entry.storedSize != entry.size) ||
+			// A deflated entry stores a chunk table with 4 bytes per chunk, so its size is bounded by what is stored.
+			(entry.compression == Compression::Deflate && GetChunkCount(entry.size) * sizeof(uint32_t) > entry.storedSize)) {
+			entries.clear();
+			return;
+		}
+	}
+
+	// The writer sorts the table, checking it keeps lookups correct for packs from other tools.
+	if (!std::is_sorted(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+		return a.hash < b.hash;
+	})) {
+		entries.clear();
+		return;
+	}
+
+	open = true;
+}
+
+const AssetPack::Entry *AssetPack::Find(std::string_view name) const {
+	auto normalized = NormalizeName(name);
+	auto hash = Hash(normalized);
+
+	auto [first, last] = std::equal_range(entries.begin(), entries.end(), hash, [](const auto &a, const auto &b) {
+		if constexpr (std::is_same_v<std::decay_t<decltype(a)>, Entry>)
+			return a.hash < b;
+		else
+			return a < b.hash;
+	});
+
+	// Entries with the same hash are told apart by name.
+	for (auto it = first; it != last; ++it) {
+		if (GetName(*it) == normalized)
+			return &*it;
+	}
+
+	return nullptr;
+}
+
+std::string_view AssetPack::GetName(const Entry &entry) const {
+	return names.substr(entry.nameOffset, entry.nameSize);
+}
+
+std::optional<std::string_view> AssetPack::GetView(const Entry &entry) const {
+	if (entry.compression != Compression::None)
+		return std::nullopt;
+	return file.GetString().substr(static_cast<std::size_t>(entry.offset), static_cast<std::size_t>(entry.size));
+}
+
+bool AssetPack::Read(const Entry &entry, uint8_t *output, ThreadPool *threadPool) const {
+	auto stored = file.GetData() + entry.offset;
+
+	if (entry.compression == Compression::None) {
+		std::memcpy(output, stored, static_cast<std::size_t>(entry.size));
+		return true;
+	}
+
+	// Compressed entries start with a table of the compressed size of each chunk.
+	auto chunkCount = static_cast<uint32_t>(GetChunkCount(entry.size));
+	if (entry.storedSize < chunkCount * sizeof(uint32_t))
+		return false;
+
+	std::vector<uint64_t> offsets(chunkCount + 1);
+	offsets[0] = chunkCount * sizeof(uint32_t);
+	for (uint32_t i = 0; i < chunkCount; i++)
+		offsets[i + 1] = offsets[i] + ReadUint(stored + i * sizeof(uint32_t), sizeof(uint32_t));
+
+	if (offsets[chunkCount] > entry.storedSize)
+		return false;
+
+	auto decompress = [&](uint32_t i) {
+		auto chunkSize = static_cast<std::size_t>(std::min<uint64_t>(ChunkSize, entry.size - static_cast<uint64_t>(i) * ChunkSize));
+		auto source = stored + offsets[i];
+		auto sourceSize = static_cast<std::size_t>(offsets[i + 1] - offsets[i]);
+		auto destination = output + static_cast<std::size_t>(i) * ChunkSize;
+
+		// Chunks that did not compress are stored as they are.
+		if (sourceSize == chunkSize) {
+			std::memcpy(destination, source, chunkSize);
+			return true;
+		}
+
+		return tinfl_decompress_mem_to_mem(destination, chunkSize, source, sourceSize, TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF) == chunkSize;
+	};
+
+	if (!threadPool || chunkCount == 1) {
+		for (uint32_t i = 0; i < chunkCount; i++) {
+			if (!decompress(i))
+				return false;
+		}
+		return true;
+	}
+
+	auto job = std::make_shared<ChunkJob>(chunkCount, decompress);
+	auto helpers = std::min<std::size_t>(threadPool->GetWorkers().size(), chunkCount - 1);
+	for (std::size_t i = 0; i < helpers; i++)
+		threadPool->Enqueue([job]() { job->Run(); });
+
+	job->Run();
+	return job->Wait();
+}
+
+std::optional<std::string> AssetPack::Read(std::string_view name, ThreadPool *threadPool) const {
+	auto entry = Find(name);
+	if (!entry)
+		return std::nullopt;
+
+	std::string data(static_cast<std::size_t>(entry->size), '\0');
+	if (!Read(*entry, reinterpret_cast<uint8_t *>(data.data()), threadPool)) {
+		Log::Error("Asset pack entry ", std::quoted(name), " is corrupt\n");
+		return std::nullopt;
+	}
+
+	return data;
+}
+
+uint64_t AssetPack::Hash(std::string_view name) {
+	// FNV-1a, the same hash as String::fnv1a_64.
+	uint64_t hash = 0xcbf29ce484222325;
+	for (auto c : NormalizeName(name))
+		hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+	return hash;
+}
+
+std::string AssetPack::NormalizeName(std::string_view name) {
+	std::string normalized(name);
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	normalized.erase(0, normalized.find_first_not_of('/'));
+	return normalized;
+}
+
+/**
+ * @brief A pack mounted into PhysFS, with the directories implied by its entry names.
+ */
+class MountedPack {
+public:
+	MountedPack(PHYSFS_Io *io, AssetPack &&pack) :
+		io(io),
+		pack(std::move(pack)) {
+		for (const auto &entry : this->pack.GetEntries()) {
+			auto name = this->pack.GetName(entry);
+
+			for (std::size_t start = 0;;) {
+				auto separator = name.find('/', start);
+				auto parent = start == 0 ? std::string() : std::string(name.substr(0, start - 1));
+				children[parent].emplace(name.substr(start, separator == std::string_view::npos ? std::string_view::npos : separator - start));
+				if (separator == std::string_view::npos)
+					break;
+				start = separator + 1;
+			}
+		}
+	}
+
+	~MountedPack() {
+		if (io)
+			io->destroy(io);
+	}
+
+	PHYSFS_Io *io;
+	AssetPack pack;
+	/// Names of the files and directories in each directory.
+	std::map<std::string, std::set<std::string>, std::less<>> children;
+};
+
+/**
+ * @brief A PhysFS stream that reads from memory, either a view into a mapped pack or a decompressed buffer.
+ */
+class MemoryIo {
+public:
+	std::shared_ptr<const std::string> buffer;
+	std::string_view data;
+	uint64_t position = 0;
+
+	static PHYSFS_Io *Create(std::shared_ptr<const std::string> buffer, std::string_view data) {
+		auto io = new PHYSFS_Io();
+		io->version = 0;
+		io->opaque = new MemoryIo{std::move(buffer), data};
+		io->read = [](PHYSFS_Io *io, void *buf, PHYSFS_uint64 len) -> PHYSFS_sint64 {
+			auto memory = static_cast<MemoryIo *>(io->opaque);
+			auto count = std::min<uint64_t>(len, memory->data.size() - memory->position);
+			std::memcpy(buf, memory->data.data() + memory->position, static_cast<std::size_t>(count));
+			memory->position += count;
+			return static_cast<PHYSFS_sint64>(count);
+		};
+		io->write = [](PHYSFS_Io *, const void *, PHYSFS_uint64) -> PHYSFS_sint64 {
+			PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+			return -1;
+		};
+		io->seek = [](PHYSFS_Io *io, PHYSFS_uint64 offset) -> int {
+			auto memory = static_cast<MemoryIo *>(io->opaque);
+			if (offset > memory->data.size()) {
+				PHYSFS_setErrorCode(PHYSFS_ERR_PAST_EOF);
+				return 0;
+			}
+			memory->position = offset;
+			return 1;
+		};
+		io->tell = [](PHYSFS_Io *io) -> PHYSFS_sint64 {
+			return static_cast<PHYSFS_sint64>(static_cast<MemoryIo *>(io->opaque)->position);
+		};
+		io->length = [](PHYSFS_Io *io) -> PHYSFS_sint64 {
+			return static_cast<PHYSFS_sint64>(static_cast<MemoryIo *>(io->opaque)->data.size());
+		};
+		io->duplicate = [](PHYSFS_Io *io) -> PHYSFS_Io * {
+			auto memory = static_cast<MemoryIo *>(io->opaque);
+			return Create(memory->buffer, memory->data);
+		};
+		io->flush = [](PHYSFS_Io *) -> int {
+			return 1;
+		};
+		io->destroy = [](PHYSFS_Io *io) {
+			delete static_cast<MemoryIo *>(io->opaque);
+			delete io;
+		};
+		return io;
+	}
+};
+
+/// Packs mounted into PhysFS by their real path, used to map uncompressed entries straight from the pack file.
+static std::mutex mountedMutex;
+static std::map<std::filesystem::path, MountedPack *> mountedPacks;
+
+static void *OpenArchive(PHYSFS_Io *io, const char *name, int forWrite, int *claimed) {
+	std::array<char, 4> magic = {};
+	if (forWrite || io->seek(io, 0) == 0 || io->read(io, magic.data(), magic.size()) != static_cast<PHYSFS_sint64>(magic.size()) || magic != AssetPack::Magic)
+		return nullptr;
+
+	*claimed = 1;
+
+	// Packs on a native path are mapped, packs inside other archives are read into memory.
+	auto file = MappedFile::Open(name);
+	if (!file) {
+		std::string buffer(static_cast<std::size_t>(io->length(io)), '\0');
+		if (io->seek(io, 0) == 0 || io->read(io, buffer.data(), buffer.size()) != static_cast<PHYSFS_sint64>(buffer.size())) {
+			PHYSFS_setErrorCode(PHYSFS_ERR_IO);
+			return nullptr;
+		}
+		file = MappedFile(std::move(buffer));
+	}
+
+	AssetPack pack(std::move(*file));
+	if (!pack.IsOpen()) {
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	auto mounted = new MountedPack(io, std::move(pack));
+	if (mounted->pack.GetFile().IsMapped()) {
+		std::unique_lock<std::mutex> lock(mountedMutex);
+		mountedPacks[name] = mounted;
+	}
+	return mounted;
+}
+
+static PHYSFS_EnumerateCallbackResult Enumerate(void *opaque, const char *dirname, PHYSFS_EnumerateCallback cb, const char *origdir, void *callbackdata) {
+	auto mounted = static_cast<MountedPack *>(opaque);
+	auto it = mounted->children.find(std::string_view(dirname));
+	if (it == mounted->children.end())
+		return PHYSFS_ENUM_OK;
+
+	for (const auto &child : it->second) {
+		auto result = cb(callbackdata, origdir, child.c_str());
+		if (result != PHYSFS_ENUM_OK)
+			return result;
+	}
+
+	return PHYSFS_ENUM_OK;
+}
+
+static PHYSFS_Io *OpenRead(void *opaque, const char *filename) {
+	auto &pack = static_cast<MountedPack *>(opaque)->pack;
+	auto entry = pack.Find(filename);
+
+	if (!entry) {
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return nullptr;
+	}
+
+	if (auto view = pack.GetView(*entry))
+		return MemoryIo::Create(nullptr, *view);
+
+	auto buffer = std::make_shared<std::string>(static_cast<std::size_t>(entry->size), '\0');
+	auto threadPool = Resources::Get() ? &Resources::Get()->GetThreadPool() : nullptr;
+
+	if (!pack.Read(*entry, reinterpret_cast<uint8_t *>(buffer->data()), threadPool)) {
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return nullptr;
+	}
+
+	std::string_view data = *buffer;
+	return MemoryIo::Create(std::move(buffer), data);
+}
+
+static PHYSFS_Io *OpenWrite(void *, const char *) {
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return nullptr;
+}
+
+static int Modify(void *, const char *) {
+	PHYSFS_setErrorCode(PHYSFS_ERR_READ_ONLY);
+	return 0;
+}
+
+static int Stat(void *opaque, const char *filename, PHYSFS_Stat *stat) {
+	auto mounted = static_cast<MountedPack *>(opaque);
+	stat->modtime = -1;
+	stat->createtime = -1;
+	stat->accesstime = -1;
+	stat->readonly = 1;
+
+	if (auto entry = mounted->pack.Find(filename)) {
+		stat->filesize = static_cast<PHYSFS_sint64>(entry->size);
+		stat->filetype = PHYSFS_FILETYPE_REGULAR;
+		return 1;
+	}
+
+	if (mounted->children.find(std::string_view(filename)) != mounted->children.end()) {
+		stat->filesize = 0;
+		stat->filetype = PHYSFS_FILETYPE_DIRECTORY;
+		return 1;
+	}
+
+	PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+	return 0;
+}
+
+static void CloseArchive(void *opaque) {
+	auto mounted = static_cast<MountedPack *>(opaque);
+
+	{
+		std::unique_lock<std::mutex> lock(mountedMutex);
+		for (auto it = mountedPacks.begin(); it != mountedPacks.end(); ++it) {
+			if (it->second == mounted) {
+				mountedPacks.erase(it);
+				break;
+			}
+		}
+	}
+
+	delete mounted;
+}
+
+void AssetPack::RegisterArchiver() {
+	static const PHYSFS_Archiver Archiver = {
+		0,
+		{"apak", "Acid asset pack", "Acid", "https://github.com/EQMG/Acid", 0},
+		&OpenArchive,
+		&Enumerate,
+		&OpenRead,
+		&OpenWrite,
+		&OpenWrite,
+		&Modify,
+		&Modify,
+		&Stat,
+		&CloseArchive
+	};
+
+	if (PHYSFS_registerArchiver(&Archiver) == 0)
+		Log::Warning("Failed to register asset pack archiver, ", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()), '\n');
+}
+
+std::optional<std::pair<uint64_t, uint64_t>> AssetPack::FindMounted(const std::filesystem::path &pack, std::string_view name) {
+	std::unique_lock<std::mutex> lock(mountedMutex);
+	auto it = mountedPacks.find(pack);
+	if (it == mountedPacks.end())
+		return std::nullopt;
+
+	auto entry = it->second->pack.Find(name);
+	if (!entry || entry->compression != Compression::None)
+		return std::nullopt;
+	return std::make_pair(entry->offset, entry->size);
+}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+
+#include "Files/Files.hpp"
+
+namespace acid {
+class ThreadPool;
+
+/**
+ * @brief Class that reads a engine asset pack, a archive made for fast random access at runtime.
+ *
+ * The table of contents is sorted by the hash of each entry name, so entries are found with a binary search.
+ * Each entry is either stored uncompressed, aligned to 64 KB so it can be mapped straight from the pack file,
+ * or compressed with deflate in independent 64 KB chunks that are decompressed in parallel.
+ *
+ * Packs are written with acid::AssetPackWriter. Adding a pack with the .apak extension as a search path mounts it into
+ * acid::Files like any other archive, files in the pack are then read with Files::Read and Files::Map.
+ */
+class ACID_EXPORT AssetPack : NonCopyable {
+public:
+	enum class Compression : uint8_t {
+		None, Deflate
+	};
+
+	/**
+	 * @brief A entry in the table of contents.
+	 */
+	class Entry {
+	public:
+		/// Hash of the entry name.
+		uint64_t hash = 0;
+		/// Offset of the entry data in the pack.
+		uint64_t offset = 0;
+		/// Size of the entry when uncompressed.
+		uint64_t size = 0;
+		/// Size of the entry data in the pack, including the chunk table of compressed entries.
+		uint64_t storedSize = 0;
+		/// Offset and size of the entry name in the names block.
+		uint32_t nameOffset = 0;
+		uint32_t nameSize = 0;
+		Compression compression = Compression::None;
+	};
+
+	static constexpr std::array<char, 4> Magic = {'A', 'P', 'A', 'K'};
+	static constexpr uint32_t Version = 1;
+	static constexpr std::size_t HeaderSize = 40;
+	static constexpr std::size_t EntrySize = 48;
+	/// Alignment of uncompressed entries, the allocation granularity of memory mappings on every platform.
+	static constexpr uint64_t Alignment = 64 * 1024;
+	/// Size of the uncompressed data in each chunk of a compressed entry.
+	static constexpr uint32_t ChunkSize = 64 * 1024;
+
+	/**
+	 * Opens a pack from a native path, the pack is memory mapped.
+	 * @param filename The path of the pack.
+	 */
+	explicit AssetPack(const std::filesystem::path &filename);
+
+	/**
+	 * Opens a pack from its contents.
+	 * @param file The contents of the pack.
+	 */
+	explicit AssetPack(MappedFile &&file);
+
+	/**
+	 * Gets if the pack was opened and its table of contents is valid.
+	 * @return If the pack is open.
+	 */
+	bool IsOpen() const { return open; }
+
+	/**
+	 * Finds a entry by name.
+	 * @param name The name of the entry, relative to the pack root.
+	 * @return The entry, or nullptr if it is not in the pack.
+	 */
+	const Entry *Find(std::string_view name) const;
+
+	/**
+	 * Gets the name of a entry.
+	 * @param entry The entry.
+	 * @return The name.
+	 */
+	std::string_view GetName(const Entry &entry) const;
+
+	/**
+	 * Gets the data of a uncompressed entry without copying it.
+	 * @param entry The entry.
+	 * @return The data in the pack, or std::nullopt if the entry is compressed.
+	 */
+	std::optional<std::string_view> GetView(const Entry &entry) const;
+
+	/**
+	 * Reads the uncompressed data of a entry.
+	 * @param entry The entry.
+	 * @param output The buffer to write to, at least the size of the entry.
+	 * @param threadPool The pool used to decompress chunks in parallel, nullptr to decompress on the calling thread.
+	 * @return If the entry was read, false if its data is corrupt.
+	 */
+	bool Read(const Entry &entry, uint8_t *output, ThreadPool *threadPool = nullptr) const;
+
+	/**
+	 * Reads the uncompressed data of a entry.
+	 * @param name The name of the entry.
+	 * @param threadPool The pool used to decompress chunks in parallel, nullptr to decompress on the calling thread.
+	 * @return The data, or std::nullopt if the entry is not in the pack or is corrupt.
+	 */
+	std::optional<std::string> Read(std::string_view name, ThreadPool *threadPool = nullptr) const;
+
+	const std::vector<Entry> &GetEntries() const { return entries; }
+	const MappedFile &GetFile() const { return file; }
+
+	/**
+	 * Hashes a entry name, separators are normalized to forward slashes and leading slashes are ignored.
+	 * @param name The name.
+	 * @return The hash.
+	 */
+	static uint64_t Hash(std::string_view name);
+
+	/**
+	 * Normalizes a entry name, separators are replaced with forward slashes and leading slashes are removed.
+	 * @param name The name.
+	 * @return The normalized name.
+	 */
+	static std::string NormalizeName(std::string_view name);
+
+	/**
+	 * Registers the pack archiver with PhysFS, called when acid::Files is created.
+	 */
+	static void RegisterArchiver();
+
+	/**
+	 * Finds a uncompressed entry in a pack that is mounted into acid::Files.
+	 * @param pack The real path of the pack.
+	 * @param name The name of the entry.
+	 * @return The offset and size of the entry in the pack file, or std::nullopt if it is not found or is compressed.
+	 */
+	static std::optional<std::pair<uint64_t, uint64_t>> FindMounted(const std::filesystem::path &pack, std::string_view name);
+
+private:
+	void ReadContents();
+
+	MappedFile file;
+	bool open = false;
+	std::vector<Entry> entries;
+	std::string_view names;
+};
+}
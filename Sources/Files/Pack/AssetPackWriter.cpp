@@ -0,0 +1,137 @@
+#include "AssetPackWriter.hpp"
+
+#include <miniz/miniz.h>
+
+namespace acid {
+AssetPackWriter::AssetPackWriter(const std::filesystem::path &filename) :
+	filename(filename),
+	stream(filename, std::ios::binary | std::ios::trunc) {
+	if (!stream) {
+		Log::Error("Failed to create asset pack ", filename, '\n');
+		return;
+	}
+
+	// The header is written again by Finish, once the table of contents is known.
+	stream.write(std::string(AssetPack::HeaderSize, '\0').data(), AssetPack::HeaderSize);
+	offset = AssetPack::HeaderSize;
+}
+
+AssetPackWriter::~AssetPackWriter() {
+	Finish();
+}
+
+bool AssetPackWriter::AddEntry(std::string_view name, std::string_view data, std::optional<AssetPack::Compression> compression) {
+	if (!stream)
+		return false;
+
+	auto normalized = AssetPack::NormalizeName(name);
+	if (!entryNames.emplace(normalized).second) {
+		Log::Error("Asset pack ", filename, " already has a entry ", std::quoted(normalized), '\n');
+		return false;
+	}
+
+	std::string compressed;
+	if (compression != AssetPack::Compression::None && !data.empty()) {
+		compressed = Compress(data);
+		if (!compression && compressed.size() * 10 > data.size() * 9)
+			compression = AssetPack::Compression::None;
+	}
+	if (data.empty())
+		compression = AssetPack::Compression::None;
+
+	AssetPack::Entry entry;
+	entry.hash = AssetPack::Hash(normalized);
+	entry.size = data.size();
+	entry.nameOffset = static_cast<uint32_t>(names.size());
+	entry.nameSize = static_cast<uint32_t>(normalized.size());
+	entry.compression = compression.value_or(AssetPack::Compression::Deflate);
+
+	std::string_view stored = entry.compression == AssetPack::Compression::None ? data : compressed;
+	if (entry.compression == AssetPack::Compression::None)
+		Pad(AssetPack::Alignment);
+
+	entry.offset = offset;
+	entry.storedSize = stored.size();
+	stream.write(stored.data(), static_cast<std::streamsize>(stored.size()));
+	offset += stored.size();
+
+	names += normalized;
+	entries.emplace_back(entry);
+	return static_cast<bool>(stream);
+}
+
+bool AssetPackWriter::Finish() {
+	if (!stream.is_open())
+		return false;
+
+	auto namesOffset = offset;
+	stream.write(names.data(), static_cast<std::streamsize>(names.size()));
+	offset += names.size();
+	Pad(8);
+
+	// Entries are sorted by hash so they can be found with a binary search.
+	std::sort(entries.begin(), entries.end(), [](const AssetPack::Entry &a, const AssetPack::Entry &b) {
+		return a.hash < b.hash;
+	});
+
+	auto entriesOffset = offset;
+	for (const auto &entry : entries) {
+		WriteUint(entry.hash, 8);
+		WriteUint(entry.offset, 8);
+		WriteUint(entry.size, 8);
+		WriteUint(entry.storedSize, 8);
+		WriteUint(entry.nameOffset, 4);
+		WriteUint(entry.nameSize, 4);
+		WriteUint(static_cast<uint8_t>(entry.compression), 1);
+		WriteUint(0, 7);
+	}
+
+	stream.seekp(0);
+	stream.write(AssetPack::Magic.data(), AssetPack::Magic.size());
+	WriteUint(AssetPack::Version, 4);
+	WriteUint(entries.size(), 4);
+	WriteUint(AssetPack::ChunkSize, 4);
+	WriteUint(entriesOffset, 8);
+	WriteUint(namesOffset, 8);
+	WriteUint(names.size(), 8);
+
+	auto written = static_cast<bool>(stream);
+	stream.close();
+
+	if (!written)
+		Log::Error("Failed to write asset pack ", filename, '\n');
+	return written;
+}
+
+void AssetPackWriter::WriteUint(uint64_t value, std::size_t bytes) {
+	for (std::size_t i = 0; i < bytes; i++)
+		stream.put(static_cast<char>((value >> (8 * i)) & 0xff));
+	offset += bytes;
+}
+
+void AssetPackWriter::Pad(uint64_t alignment) {
+	if (auto remainder = offset % alignment)
+		WriteUint(0, static_cast<std::size_t>(alignment - remainder));
+}
+
+std::string AssetPackWriter::Compress(std::string_view data) {
+	auto chunkCount = (data.size() + AssetPack::ChunkSize - 1) / AssetPack::ChunkSize;
+	auto flags = static_cast<int>(tdefl_create_comp_flags_from_zip_params(MZ_DEFAULT_LEVEL, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+
+	std::string compressed(chunkCount * sizeof(uint32_t), '\0');
+	std::string chunk(AssetPack::ChunkSize, '\0');
+
+	for (std::size_t i = 0; i < chunkCount; i++) {
+		auto source = data.substr(i * AssetPack::ChunkSize, AssetPack::ChunkSize);
+		// Chunks that do not get smaller are stored as they are, the reader finds them by their size.
+		auto size = tdefl_compress_mem_to_mem(chunk.data(), source.size() - 1, source.data(), source.size(), flags);
+		auto stored = size != 0 ? std::string_view(chunk.data(), size) : source;
+
+		for (std::size_t j = 0; j < sizeof(uint32_t); j++)
+			compressed[i * sizeof(uint32_t) + j] = static_cast<char>((stored.size() >> (8 * j)) & 0xff);
+		compressed += stored;
+	}
+
+	return compressed;
+}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <fstream>
+#include <unordered_set>
+
+#include "AssetPack.hpp"
+
+namespace acid {
+/**
+ * @brief Class that writes a engine asset pack, read at runtime with acid::AssetPack.
+ *
+ * Entries are written to the file as they are added, only the table of contents is held in memory until Finish.
+ */
+class ACID_EXPORT AssetPackWriter : NonCopyable {
+public:
+	/**
+	 * Creates a new pack, replacing any existing file.
+	 * @param filename The native path of the pack.
+	 */
+	explicit AssetPackWriter(const std::filesystem::path &filename);
+
+	/**
+	 * Finishes the pack if Finish was not called.
+	 */
+	~AssetPackWriter();
+
+	/**
+	 * Adds a entry to the pack.
+	 * @param name The name of the entry, relative to the pack root.
+	 * @param data The uncompressed data of the entry.
+	 * @param compression The compression to store the entry with, by default deflate is used only when it saves at least 10%.
+	 * Uncompressed entries are aligned so they can be memory mapped.
+	 * @return If the entry was added, false if the name is already in the pack or the file could not be written.
+	 */
+	bool AddEntry(std::string_view name, std::string_view data, std::optional<AssetPack::Compression> compression = std::nullopt);
+
+	/**
+	 * Writes the table of contents and closes the file, no entries can be added after.
+	 * @return If the pack was written.
+	 */
+	bool Finish();
+
+	bool IsOpen() const { return stream.is_open(); }
+
+private:
+	void WriteUint(uint64_t value, std::size_t bytes);
+	void Pad(uint64_t alignment);
+	/**
+	 * Compresses data in independent chunks, prefixed with the compressed size of each chunk.
+	 * @param data The data to compress.
+	 * @return The compressed data.
+	 */
+	static std::string Compress(std::string_view data);
+
+	std::filesystem::path filename;
+	std::ofstream stream;
+	uint64_t offset = 0;
+	std::vector<AssetPack::Entry> entries;
+	std::string names;
+	std::unordered_set<std::string> entryNames;
+};
+}
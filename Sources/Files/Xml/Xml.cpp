@@ -1,54 +1,42 @@
 #include "Xml.hpp"
 
+#include <algorithm>
 #include <sstream>
 
-#include "Utils/Enumerate.hpp"
-#include "Utils/String.hpp"
+#include "XmlReader.hpp"
 
 namespace acid {
 void Xml::ParseString(Node &node, std::string_view string) {
-	// Tokenizes the string view into small views that are used to build a Node tree.
-	std::vector<Node::Token> tokens;
-
-	std::size_t tokenStart = 0;
-	enum class QuoteState : char {
-		None = '\0', Single = '\'', Double = '"'
-	} quoteState = QuoteState::None;
-	enum class TagState : char {
-		None = '\0', Open = '<', Close = '>'
-	} tagState = TagState::None;
-
-	// Iterates over all the characters in the string view.
-	for (auto &&[index, c] : Enumerate(string)) {
-		// If the previous character was a backslash the quote will not break the string.
-		if (c == '\'' && quoteState != QuoteState::Double && string[index - 1] != '\\')
-			quoteState = quoteState == QuoteState::None ? QuoteState::Single : QuoteState::None;
-		else if (c == '"' && quoteState != QuoteState::Single && string[index - 1] != '\\')
-			quoteState = quoteState == QuoteState::None ? QuoteState::Double : QuoteState::None;
-
-		// When not reading a string tokens can be found.
-		// While in a string whitespace and tokens are added to the strings view.
-		if (quoteState == QuoteState::None) {
-			if (tagState == TagState::Open && String::IsWhitespace(c)) {
-				// On whitespace start save current token.
-				AddToken(std::string_view(string.data() + tokenStart, index - tokenStart), tokens);
-				tokenStart = index + 1;
-			} else if (c == '<' || c == '>' || (tagState == TagState::Open && (c == '?' || c == '!' || c == '=' || c == '/'))) {
-				// Tokens used to read XML nodes.
-				AddToken(std::string_view(string.data() + tokenStart, index - tokenStart), tokens);
-				tokens.emplace_back(Node::Type::Token, std::string_view(string.data() + index, 1));
-				if (c == '<')
-					tagState = TagState::Open;
-				else if (c == '>')
-					tagState = TagState::Close;
-				tokenStart = index + 1;
-			}
+	// Builds the tree from the reader events, the top of the stack is the innermost open element.
+	XmlReader reader(string);
+	std::vector<Node *> stack = {&node};
+
+	while (true) {
+		switch (reader.Next()) {
+		case XmlReader::Event::StartElement:
+			stack.emplace_back(&CreateProperty(*stack.back(), reader.GetName()));
+			break;
+		case XmlReader::Event::Attribute: {
+			// Attributes are added as properties.
+			auto &attribute = stack.back()->AddProperty();
+			attribute.SetName("-" + std::string(reader.GetName()));
+			attribute.SetValueView(reader.GetValue());
+			attribute.SetType(Node::Type::String);
+			break;
+		}
+		case XmlReader::Event::Text:
+			stack.back()->SetValueView(reader.GetValue());
+			stack.back()->SetType(Node::Type::String);
+			break;
+		case XmlReader::Event::EndElement:
+			stack.pop_back();
+			break;
+		case XmlReader::Event::EndDocument:
+			return;
+		default:
+			throw std::runtime_error(std::string(reader.GetError()));
 		}
 	}
-
-	// Converts the tokens into nodes.
-	int32_t k = 0;
-	Convert(node, tokens, k);
 }
 
 void Xml::WriteStream(const Node &node, std::ostream &stream, Node::Format format) {
@@ -64,79 +52,42 @@ void Xml::WriteStream(const Node &node, std::ostream &stream, Node::Format forma
 	stream << "</" << node.GetName() << ">";
 }
 
-void Xml::AddToken(std::string_view view, std::vector<Node::Token> &tokens) {
-	if (view.length() != 0 && !std::all_of(view.cbegin(), view.cend(), String::IsWhitespace))
-		tokens.emplace_back(Node::Type::String, view);
-}
-
-void Xml::Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k) {
-	// Only start to parse if we are at the start of a tag.
-	if (tokens[k] != Node::Token(Node::Type::Token, "<"))
-		return;
-	k++;
-
-	// Ignore prolog and DOCTYPE.
-	if (tokens[k] == Node::Token(Node::Type::Token, "?") || tokens[k] == Node::Token(Node::Type::Token, "!")) {
-		k += 2;
-		while (tokens[k] != Node::Token(Node::Type::Token, ">"))
-			k++;
-		k++;
-		Convert(current, tokens, k);
-		return;
-	}
-
-	// The next token after the open tag is the name.
-	auto name = tokens[k].view;
-	k++;
-	// Create the property that will contain the attributes and children found in the tag.
-	auto &property = CreateProperty(current, std::string(name));
-
-	while (tokens[k] != Node::Token(Node::Type::Token, ">")) {
-		// Attributes are added as properties.
-		if (tokens[k] == Node::Token(Node::Type::Token, "=")) {
-			property.AddProperty("-" + std::string(tokens[k - 1].view)) = tokens[k + 1].view.substr(1, tokens[k + 1].view.size() - 2);
-			k++;
-		}
-		k++;
-	}
-	k++;
-
-	// Inline tag has no children.
-	if (tokens[k - 2] == Node::Token(Node::Type::Token, "/"))
-		return;
-	// Continue through all children until the end tag is found.
-	while (!(tokens[k] == Node::Token(Node::Type::Token, "<") && tokens[k + 1] == Node::Token(Node::Type::Token, "/") && tokens[k + 2].view == name)) {
-		if (tokens[k].type == Node::Type::String) {
-			property = tokens[k].view;
-			k++;
-		} else {
-			// TODO: If the token at k is not a '<' this will cause a infinite loop, or if k + 2 > tokens.size() vector access will be violated.
-			Convert(property, tokens, k);
-		}
-	}
-	k += 4;
-}
+Node &Xml::CreateProperty(Node &current, std::string_view name) {
+	auto &properties = current.GetProperties();
 
-Node &Xml::CreateProperty(Node &current, const std::string &name) {
 	// Combine duplicate tags.
-	if (auto duplicate = current[name]) {
+	if (auto duplicate = std::find_if(properties.begin(), properties.end(), [name](const Node &property) {
+		return property.GetName() == name;
+	}); duplicate != properties.end()) {
 		// If the node is already an array add the new property to it.
 		if (duplicate->GetType() == Node::Type::Array)
 			return duplicate->AddProperty();
 
-		// Copy the duplicate node so we can add it to the new array.
-		Node original("", duplicate);
-		current.RemoveProperty(duplicate);
-		auto &array = current.AddProperty(name);
+		// Move the duplicate node so we can add it to the new array.
+		Node original(std::move(*duplicate));
+		original.SetNameView({});
+		properties.erase(duplicate);
+		auto &array = current.AddProperty();
+		array.SetNameView(name);
 		array.SetType(Node::Type::Array);
 		array.AddProperty(std::move(original));
 		return array.AddProperty();
 	}
 
-	return current.AddProperty(name);
+	auto &property = current.AddProperty();
+	property.SetNameView(name);
+	return property;
 }
 
 void Xml::AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent) {
+	// Packed arrays are written from an expanded copy, the node being written is not changed.
+	if (node.GetPacked()) {
+		Node expanded(node);
+		expanded.Unpack();
+		AppendData(expanded, stream, format, indent);
+		return;
+	}
+
 	stream << node.GetValue();
 
 	auto indents = format.GetIndents(indent + 1);
@@ -11,9 +11,7 @@ public:
 	static void WriteStream(const Node &node, std::ostream &stream, Node::Format format);
 
 private:
-	static void AddToken(std::string_view view, std::vector<Node::Token> &tokens);
-	static void Convert(Node &current, const std::vector<Node::Token> &tokens, int32_t &k);
-	static Node &CreateProperty(Node &current, const std::string &name);
+	static Node &CreateProperty(Node &current, std::string_view name);
 	
 	static void AppendData(const Node &node, std::ostream &stream, Node::Format format, int32_t indent);
 };
@@ -0,0 +1,291 @@
+#include "XmlReader.hpp"
+
+#include <algorithm>
+
+#include "Utils/String.hpp"
+
+namespace acid {
+XmlReader::XmlReader(std::string_view source) :
+	source(source),
+	it(source.data()),
+	end(source.data() + source.size()) {
+}
+
+XmlReader::Event XmlReader::Next() {
+	if (event == Event::EndDocument || event == Event::Error)
+		return event;
+
+	event = inTag ? ReadTag() : ReadContent();
+	return event;
+}
+
+bool XmlReader::NextChild(std::size_t depth) {
+	while (true) {
+		switch (Next()) {
+		case Event::StartElement:
+			if (elements.size() == depth + 1)
+				return true;
+			break;
+		case Event::EndElement:
+			if (elements.size() + 1 == depth)
+				return false;
+			break;
+		case Event::EndDocument:
+		case Event::Error:
+			return false;
+		default:
+			break;
+		}
+	}
+}
+
+std::string_view XmlReader::GetAttribute(std::string_view attribute) const {
+	if (!inTag)
+		return {};
+
+	for (auto p = it;;) {
+		while (p != end && String::IsWhitespace(*p))
+			p++;
+		if (p == end || *p == '/' || *p == '>')
+			return {};
+
+		std::string_view attributeName, attributeValue;
+		if (ParseAttribute(p, end, attributeName, attributeValue))
+			return {};
+		if (attributeName == attribute)
+			return attributeValue;
+	}
+}
+
+bool XmlReader::Skip() {
+	if (elements.empty())
+		return false;
+
+	auto depth = elements.size() - 1;
+
+	while (true) {
+		switch (Next()) {
+		case Event::EndElement:
+			if (elements.size() == depth)
+				return true;
+			break;
+		case Event::EndDocument:
+		case Event::Error:
+			return false;
+		default:
+			break;
+		}
+	}
+}
+
+std::string_view XmlReader::ReadText() {
+	if (elements.empty())
+		return {};
+
+	auto depth = elements.size();
+	std::string_view text;
+	auto found = false;
+
+	while (true) {
+		switch (Next()) {
+		case Event::Text:
+			if (elements.size() == depth && !found) {
+				text = value;
+				found = true;
+			}
+			break;
+		case Event::EndElement:
+			if (elements.size() == depth - 1)
+				return text;
+			break;
+		case Event::EndDocument:
+		case Event::Error:
+			return {};
+		default:
+			break;
+		}
+	}
+}
+
+XmlReader::Event XmlReader::ReadContent() {
+	while (true) {
+		if (it == end) {
+			if (!elements.empty())
+				return SetError("Missing end of element");
+			name = {};
+			value = {};
+			return Event::EndDocument;
+		}
+
+		if (*it != '<') {
+			auto textStart = it;
+			it = std::find(it, end, '<');
+			std::string_view text(textStart, it - textStart);
+
+			// Whitespace between elements and text outside of the root element is not reported.
+			if (elements.empty() || std::all_of(text.cbegin(), text.cend(), String::IsWhitespace))
+				continue;
+
+			name = elements.back();
+			value = text;
+			return Event::Text;
+		}
+
+		std::string_view tag(it, end - it);
+
+		if (String::StartsWith(tag, "<!--")) {
+			if (!SkipPast("-->"))
+				return SetError("Missing end of comment");
+			continue;
+		}
+
+		if (String::StartsWith(tag, "<![CDATA[")) {
+			auto textStart = it + 9;
+			if (!SkipPast("]]>"))
+				return SetError("Missing end of CDATA section");
+			if (elements.empty())
+				continue;
+
+			name = elements.back();
+			value = std::string_view(textStart, it - 3 - textStart);
+			return Event::Text;
+		}
+
+		// Ignore prolog and processing instructions.
+		if (String::StartsWith(tag, "<?")) {
+			if (!SkipPast("?>"))
+				return SetError("Missing end of processing instruction");
+			continue;
+		}
+
+		// Ignore DOCTYPE, including a internal subset in brackets.
+		if (String::StartsWith(tag, "<!")) {
+			int32_t brackets = 0;
+			for (it += 2; it != end; it++) {
+				if (*it == '[')
+					brackets++;
+				else if (*it == ']')
+					brackets--;
+				else if (*it == '>' && brackets <= 0)
+					break;
+			}
+			if (it == end)
+				return SetError("Missing end of declaration");
+			it++;
+			continue;
+		}
+
+		if (String::StartsWith(tag, "</")) {
+			it += 2;
+			auto nameStart = it;
+			while (it != end && !String::IsWhitespace(*it) && *it != '>')
+				it++;
+			name = std::string_view(nameStart, it - nameStart);
+
+			while (it != end && String::IsWhitespace(*it))
+				it++;
+			if (it == end || *it != '>')
+				return SetError("Missing end of tag");
+			it++;
+
+			if (elements.empty() || elements.back() != name)
+				return SetError("End tag does not match the open element");
+			elements.pop_back();
+			value = {};
+			return Event::EndElement;
+		}
+
+		it++;
+		auto nameStart = it;
+		while (it != end && !String::IsWhitespace(*it) && *it != '>' && *it != '/')
+			it++;
+		name = std::string_view(nameStart, it - nameStart);
+
+		if (name.empty())
+			return SetError("Missing element name");
+
+		elements.emplace_back(name);
+		value = {};
+		inTag = true;
+		return Event::StartElement;
+	}
+}
+
+XmlReader::Event XmlReader::ReadTag() {
+	while (it != end && String::IsWhitespace(*it))
+		it++;
+	if (it == end)
+		return SetError("Missing end of tag");
+
+	// Self closing tags end the element directly.
+	if (*it == '/') {
+		if (end - it < 2 || it[1] != '>')
+			return SetError("Missing end of tag");
+		it += 2;
+		inTag = false;
+		name = elements.back();
+		value = {};
+		elements.pop_back();
+		return Event::EndElement;
+	}
+
+	if (*it == '>') {
+		it++;
+		inTag = false;
+		return ReadContent();
+	}
+
+	if (auto message = ParseAttribute(it, end, name, value))
+		return SetError(message);
+	return Event::Attribute;
+}
+
+const char *XmlReader::ParseAttribute(const char *&it, const char *end, std::string_view &name, std::string_view &value) {
+	auto nameStart = it;
+	while (it != end && !String::IsWhitespace(*it) && *it != '=' && *it != '>' && *it != '/')
+		it++;
+	name = std::string_view(nameStart, it - nameStart);
+
+	if (name.empty())
+		return "Missing attribute name";
+
+	while (it != end && String::IsWhitespace(*it))
+		it++;
+	if (it == end || *it != '=')
+		return "Missing attribute value";
+	it++;
+	while (it != end && String::IsWhitespace(*it))
+		it++;
+	if (it == end || (*it != '"' && *it != '\''))
+		return "Missing attribute quote";
+
+	auto quote = *it++;
+	auto valueStart = it;
+	it = std::find(it, end, quote);
+	if (it == end)
+		return "Missing end of attribute value";
+
+	value = std::string_view(valueStart, it - valueStart);
+	it++;
+	return nullptr;
+}
+
+bool XmlReader::SkipPast(std::string_view token) {
+	auto position = source.find(token, GetOffset());
+
+	if (position == std::string_view::npos) {
+		it = end;
+		return false;
+	}
+
+	it = source.data() + position + token.size();
+	return true;
+}
+
+XmlReader::Event XmlReader::SetError(std::string_view message) {
+	error = message;
+	name = {};
+	value = {};
+	return Event::Error;
+}
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief Class that reads a XML document as a stream of events, without building a node tree.
+ *
+ * Each call to Next moves to the next element start, attribute, text or element end in the document.
+ * Names and values are views into the source string, which must outlive the reader. Text and attribute values are
+ * returned as they are in the source, entities are not replaced. Prologs, comments and DOCTYPE declarations are skipped,
+ * CDATA sections are returned as text.
+ *
+ * A loader only interested in a part of a document can stream through it and call Skip on every element it does not need,
+ * reading values like large number arrays straight from the source with String::ParseNumbers.
+ */
+class ACID_EXPORT XmlReader {
+public:
+	enum class Event {
+		/// Next has not been called yet.
+		None,
+		/// A element tag was opened, GetName is the element name.
+		StartElement,
+		/// An attribute of the last opened element, GetName is the attribute name and GetValue its value.
+		Attribute,
+		/// Text inside the current element, GetValue is the text. Whitespace between elements is not reported.
+		Text,
+		/// A element was closed, GetName is the element name. Self closing tags report the end directly after their attributes.
+		EndElement,
+		/// The end of the document was reached.
+		EndDocument,
+		/// The document is malformed, GetError describes the problem. Every following call returns this again.
+		Error
+	};
+
+	/**
+	 * Creates a new reader.
+	 * @param source The document to read.
+	 */
+	explicit XmlReader(std::string_view source);
+
+	/**
+	 * Reads the next event from the document.
+	 * @return The event.
+	 */
+	Event Next();
+
+	/**
+	 * Moves to the next child of a element, skipping attributes, text and the rest of the previous child.
+	 * @param depth The depth of the parent element, from GetDepth while it is the current element.
+	 * @return If a child was found, false when the parent element ended.
+	 */
+	bool NextChild(std::size_t depth);
+
+	/**
+	 * Finds a attribute of the element that was just started, without moving the reader.
+	 * Attributes that were already read with Next are not found.
+	 * @param attribute The attribute name.
+	 * @return The attribute value, empty if it was not found.
+	 */
+	std::string_view GetAttribute(std::string_view attribute) const;
+
+	/**
+	 * Skips the remaining attributes and children of the current element, the reader is left on its EndElement event.
+	 * @return If the element end was found.
+	 */
+	bool Skip();
+
+	/**
+	 * Reads the text content of the current element, the reader is left on its EndElement event.
+	 * Child elements are skipped, when the text is split by children or comments only the first part is returned.
+	 * @return The text, empty if the element has no text.
+	 */
+	std::string_view ReadText();
+
+	Event GetEvent() const { return event; }
+	std::string_view GetName() const { return name; }
+	std::string_view GetValue() const { return value; }
+	std::string_view GetError() const { return error; }
+
+	/**
+	 * Gets the number of open elements, a element is counted from its StartElement up to, but not including, its EndElement.
+	 * @return The depth.
+	 */
+	std::size_t GetDepth() const { return elements.size(); }
+
+	/**
+	 * Gets the offset of the reader in the source.
+	 * @return The offset in bytes.
+	 */
+	std::size_t GetOffset() const { return static_cast<std::size_t>(it - source.data()); }
+
+private:
+	Event ReadContent();
+	Event ReadTag();
+	/**
+	 * Parses a attribute in a start tag.
+	 * @param it The start of the attribute name, moved past the closing quote of the value.
+	 * @param end The end of the source.
+	 * @param name Set to the attribute name.
+	 * @param value Set to the attribute value.
+	 * @return The error message if the attribute is malformed, otherwise nullptr.
+	 */
+	static const char *ParseAttribute(const char *&it, const char *end, std::string_view &name, std::string_view &value);
+
+	bool SkipPast(std::string_view token);
+	Event SetError(std::string_view message);
+
+	std::string_view source;
+	const char *it;
+	const char *end;
+
+	Event event = Event::None;
+	std::string_view name;
+	std::string_view value;
+	std::string_view error;
+
+	/// Names of the open elements.
+	std::vector<std::string_view> elements;
+	/// If the reader is inside a start tag, reading attributes.
+	bool inTag = false;
+};
+}
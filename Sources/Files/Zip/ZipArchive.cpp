@@ -1,13 +1,32 @@
 #include "ZipArchive.hpp"
 
 #include <algorithm>
+#include <deque>
 #include <fstream>
 #include <random>
+#include <unordered_set>
 
+#include "Files/Files.hpp"
 #include "Utils/String.hpp"
+#include "Utils/ThreadPool.hpp"
 #include "ZipException.hpp"
 
 namespace acid {
+/**
+ * @brief The data of a entry after it was compressed on a worker thread, waiting to be written to the archive in order.
+ */
+class DeflatedEntry {
+public:
+	/// The raw deflate stream, nullptr if the data is stored uncompressed.
+	std::unique_ptr<void, decltype(&mz_free)> deflated = {nullptr, &mz_free};
+	std::size_t deflatedSize = 0;
+	/// The uncompressed data, pointing into the entry or the mapped source file.
+	std::string_view data;
+	uint32_t crc = 0;
+	/// The source file of entries added with ZipArchive::AddFile, kept mapped until the entry is written.
+	std::optional<MappedFile> file;
+};
+
 ZipArchive::ZipArchive(const std::filesystem::path &filename) :
 	archivePath(filename) {
 	std::ifstream f(filename.c_str());
@@ -61,16 +80,20 @@ void ZipArchive::Open(const std::filesystem::path &filename) {
 		zipEntries.emplace_back(std::make_unique<ZipEntry>(info));
 	}
 
-	// Remove entries with identical names. The newest entries will be retained.
-	auto isEqual = [](const auto &a, const auto &b) { return a->GetFilename() == b->GetFilename(); };
+	// Remove entries with identical names, appended entries can replace any earlier entry. The newest entries will be retained.
+	std::unordered_set<std::string> names;
 	std::reverse(zipEntries.begin(), zipEntries.end());
-	zipEntries.erase(std::unique(zipEntries.begin(), zipEntries.end(), isEqual), zipEntries.end());
+	zipEntries.erase(std::remove_if(zipEntries.begin(), zipEntries.end(), [&](const auto &entry) {
+		return !names.emplace(entry->GetFilename()).second;
+	}), zipEntries.end());
 	std::reverse(zipEntries.begin(), zipEntries.end());
+	isEntryDeleted = false;
 }
 
 void ZipArchive::Close() {
 	if (isOpen)
 		mz_zip_reader_end(&archive);
+	isOpen = false;
 	zipEntries.clear();
 	archivePath = "";
 }
@@ -158,7 +181,7 @@ bool ZipArchive::HasEntry(const std::string &entryName) const {
 	return std::find(result.begin(), result.end(), entryName) != result.end();
 }
 
-void ZipArchive::Write(std::filesystem::path filename) {
+void ZipArchive::Write(std::filesystem::path filename, ThreadPool *threadPool) {
 	if (filename.empty())
 		filename = archivePath;
 
@@ -171,14 +194,12 @@ void ZipArchive::Write(std::filesystem::path filename) {
 	mz_zip_writer_init_file(&tempArchive, tempPathU8.c_str(), 0);
 
 	// Iterate through the ZipEntries and add entries to the temporary file
-	for (const auto &file : zipEntries) {
-		if (!file->IsModified()) {
-			if (!mz_zip_writer_add_from_zip_reader(&tempArchive, &archive, file->GetIndex()))
-				ThrowException(archive.m_last_error, "Failed copying archive entry.");
-		} else {
-			if (!mz_zip_writer_add_mem(&tempArchive, file->GetFilename().c_str(), file->entryData.data(), file->entryData.size(), MZ_DEFAULT_COMPRESSION))
-				ThrowException(archive.m_last_error, "Failed adding archive entry.");
-		}
+	try {
+		WriteEntries(tempArchive, threadPool, false);
+	} catch (...) {
+		mz_zip_writer_end(&tempArchive);
+		std::filesystem::remove(tempPath);
+		throw;
 	}
 
 	// Finalize and close the temporary archive
@@ -198,13 +219,56 @@ void ZipArchive::Write(std::filesystem::path filename) {
 
 }
 
+void ZipArchive::Append(ThreadPool *threadPool) {
+	// Deleted entries are still in the central directory, removing them needs the archive to be rewritten.
+	if (!isOpen || isEntryDeleted) {
+		Write("", threadPool);
+		return;
+	}
+
+	auto filename = archivePath;
+	auto filenameU8 = filename.u8string();
+
+	// Convert the reader into a writer in place, new entries are written after the existing entries.
+	if (!mz_zip_writer_init_from_reader_v2(&archive, filenameU8.c_str(), 0))
+		ThrowException(archive.m_last_error, "Error opening archive file " + filenameU8 + " for appending.");
+	isOpen = false;
+
+	try {
+		WriteEntries(archive, threadPool, true);
+	} catch (...) {
+		mz_zip_writer_finalize_archive(&archive);
+		mz_zip_writer_end(&archive);
+		Close();
+		Open(filename);
+		throw;
+	}
+
+	// Finalize the archive, which rewrites the central directory, then reopen it for reading.
+	if (!mz_zip_writer_finalize_archive(&archive)) {
+		auto error = archive.m_last_error;
+		mz_zip_writer_end(&archive);
+		Close();
+		Open(filename);
+		ThrowException(error, "Failed finalizing archive " + filenameU8 + ".");
+	}
+	mz_zip_writer_end(&archive);
+
+	Close();
+	Open(filename);
+}
+
 void ZipArchive::Write(std::ostream &stream) {
 	// TODO: Implement
 }
 
 void ZipArchive::DeleteEntry(const std::string &name) {
 	zipEntries.erase(std::remove_if(zipEntries.begin(), zipEntries.end(), [&](const auto &entry) {
-		return name == entry->GetFilename();
+		if (name != entry->GetFilename())
+			return false;
+		if (entry->IsInArchive())
+			isEntryDeleted = true;
+		return true;
 	}), zipEntries.end());
 }
 
@@ -214,9 +278,9 @@ ZipEntry *ZipArchive::GetEntry(const std::string &name) {
 		return name == entry->GetFilename();
 	});
 
-	// Extract the data from the archive to the ZipEntry object.
+	// Extract the data from the archive to the ZipEntry object, by index as appended archives can have older entries with the same name.
 	(*result)->entryData.resize(static_cast<std::size_t>((*result)->GetUncompressedSize()));
-	mz_zip_reader_extract_file_to_mem(&archive, name.c_str(), (*result)->entryData.data(), (*result)->entryData.size(), 0);
+	mz_zip_reader_extract_to_mem(&archive, (*result)->GetIndex(), (*result)->entryData.data(), (*result)->entryData.size(), 0);
 
 	// Check that the operation was successful
 	if (!(*result)->entryData.data())
@@ -240,7 +304,7 @@ void ZipArchive::ExtractEntry(const std::string &name, const std::filesystem::pa
 
 	// Extract the data from the archive to the ZipEntry object.
 	(*result)->entryData.resize((*result)->GetUncompressedSize());
-	mz_zip_reader_extract_file_to_file(&archive, name.c_str(), destU8.c_str(), 0);
+	mz_zip_reader_extract_to_file(&archive, (*result)->GetIndex(), destU8.c_str(), 0);
 
 	// Check that the operation was successful
 	if (!(*result)->entryData.data())
@@ -309,6 +373,26 @@ ZipEntry *ZipArchive::AddEntry(const std::string &name, const ZipEntry &entry) {
 	return zipEntries.emplace_back(std::make_unique<ZipEntry>(name, entry.GetData())).get();
 }
 
+ZipEntry *ZipArchive::AddFile(const std::string &name, const std::filesystem::path &filename) {
+	// Check if an entry with the given name already exists in the archive.
+	auto result = std::find_if(zipEntries.begin(), zipEntries.end(), [&](const auto &entry) {
+		return name == entry->GetFilename();
+	});
+
+	// If the entry exists, replace the existing data with the file, and return the ZipEntry object.
+	if (result != zipEntries.end()) {
+		(*result)->entryData.clear();
+		(*result)->sourceFile = filename;
+		(*result)->isModified = true;
+		return (*result).get();
+	}
+
+	// Otherwise, add a new entry with the given name and file, and return the object.
+	auto &entry = zipEntries.emplace_back(std::make_unique<ZipEntry>(name, ZipEntryData()));
+	entry->sourceFile = filename;
+	return entry.get();
+}
+
 void ZipArchive::ThrowException(mz_zip_error error, const std::string &errorString) {
 	switch (error) {
 	case MZ_ZIP_UNDEFINED_ERROR:
@@ -394,4 +478,83 @@ std::string ZipArchive::GenerateRandomName(int length) {
 
 	return result + ".tmp";
 }
+
+void ZipArchive::WriteEntries(mz_zip_archive &writer, ThreadPool *threadPool, bool modifiedOnly) {
+	static const auto Flags = static_cast<int>(tdefl_create_comp_flags_from_zip_params(MZ_DEFAULT_LEVEL, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+
+	auto deflate = [](const ZipEntry *entry) {
+		DeflatedEntry result;
+		result.data = std::string_view(reinterpret_cast<const char *>(entry->entryData.data()), entry->entryData.size());
+
+		if (!entry->sourceFile.empty()) {
+			result.file = MappedFile::Open(entry->sourceFile);
+			if (!result.file)
+				return result;
+			result.data = result.file->GetString();
+		}
+
+		result.crc = static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const uint8_t *>(result.data.data()), result.data.size()));
+		if (!result.data.empty())
+			result.deflated.reset(tdefl_compress_mem_to_heap(result.data.data(), result.data.size(), &result.deflatedSize, Flags));
+		return result;
+	};
+
+	std::vector<const ZipEntry *> modified;
+	for (const auto &file : zipEntries) {
+		if (file->IsModified())
+			modified.emplace_back(file.get());
+	}
+
+	// Entries are compressed ahead of the writer, bounded so only a few compressed entries are held in memory at once.
+	std::deque<std::future<DeflatedEntry>> pending;
+	std::size_t next = 0;
+	auto window = threadPool ? 2 * std::max<std::size_t>(threadPool->GetWorkers().size(), 1) : 0;
+
+	auto enqueue = [&]() {
+		while (next < modified.size() && pending.size() < window)
+			pending.emplace_back(threadPool->Enqueue(deflate, modified[next++]));
+	};
+	auto fail = [&](mz_zip_error error, const std::string &errorString) {
+		// Workers reference the entries, they have to finish before the error leaves the archive.
+		for (auto &future : pending)
+			future.wait();
+		ThrowException(error, errorString);
+	};
+
+	for (const auto &file : zipEntries) {
+		if (!file->IsModified()) {
+			if (!modifiedOnly && !mz_zip_writer_add_from_zip_reader(&writer, &archive, file->GetIndex()))
+				fail(writer.m_last_error, "Failed copying archive entry.");
+			continue;
+		}
+
+		DeflatedEntry entry;
+		if (threadPool) {
+			enqueue();
+			entry = pending.front().get();
+			pending.pop_front();
+			enqueue();
+		} else {
+			entry = deflate(file.get());
+		}
+
+		if (!file->sourceFile.empty() && !entry.file)
+			fail(MZ_ZIP_FILE_OPEN_FAILED, "Failed opening archive entry source " + file->sourceFile.string() + ".");
+
+		auto filename = file->GetFilename();
+		mz_bool added;
+
+		// Data that did not get smaller is stored, miniz writes it without compressing.
+		if (entry.deflated && entry.deflatedSize < entry.data.size()) {
+			added = mz_zip_writer_add_mem_ex_v2(&writer, filename.c_str(), entry.deflated.get(), entry.deflatedSize, nullptr, 0,
+				MZ_DEFAULT_LEVEL | MZ_ZIP_FLAG_COMPRESSED_DATA, entry.data.size(), entry.crc, nullptr, nullptr, 0, nullptr, 0);
+		} else {
+			added = mz_zip_writer_add_mem_ex_v2(&writer, filename.c_str(), entry.data.data(), entry.data.size(), nullptr, 0,
+				MZ_NO_COMPRESSION, 0, 0, nullptr, nullptr, 0, nullptr, 0);
+		}
+
+		if (!added)
+			fail(writer.m_last_error, "Failed adding archive entry.");
+	}
+}
 }
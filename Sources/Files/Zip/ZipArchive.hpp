@@ -32,6 +32,8 @@
 #include "ZipEntry.hpp"
 
 namespace acid {
+class ThreadPool;
+
 /**
  * @brief The ZipArchive class represents the zip archive file as a whole. It consists of the individual zip entries, which
  * can be both files and folders. It is the main access point into a .zip archive on disk and can be
@@ -172,9 +174,20 @@ public:
 	/**
 	 * @brief Save the archive with a new name. The original archive will remain unchanged.
 	 * @param filename The new filename.
+	 * @param threadPool The pool used to compress new and modified entries in parallel, nullptr to compress on the calling thread.
+	 * Entries are still written in order.
 	 * @note If no filename is provided, the file will be saved with the existing name, overwriting any existing data.
 	 */
-	void Write(std::filesystem::path filename = "");
+	void Write(std::filesystem::path filename = "", ThreadPool *threadPool = nullptr);
+
+	/**
+	 * @brief Save the archive in place, appending new and modified entries after the existing data. Unchanged entries are
+	 * not rewritten, only the central directory is. Modified entries leave their old data in the file, the newest entry with
+	 * a name is the one that is read.
+	 * @param threadPool The pool used to compress entries in parallel, nullptr to compress on the calling thread.
+	 * @note If entries were deleted the archive is rewritten with Write instead.
+	 */
+	void Append(ThreadPool *threadPool = nullptr);
 
 	/**
 	 * @brief
@@ -243,6 +256,16 @@ public:
 	 */
 	ZipEntry *AddEntry(const std::string &name, const ZipEntry &entry);
 
+	/**
+	 * @brief Add a new entry to the archive from a file on disk. The file is not read until the archive is written,
+	 * where it is memory mapped and compressed straight from the mapping.
+	 * @param name The name of the entry to add.
+	 * @param filename The native path of the file to add.
+	 * @return The ZipEntry object that has been added to the archive.
+	 * @note If an entry with given name already exists, it will be overwritten.
+	 */
+	ZipEntry *AddFile(const std::string &name, const std::filesystem::path &filename);
+
 private:
 	/**
 	 * @brief Throws the correct exception based on the error code, and adds a description.
@@ -259,9 +282,18 @@ private:
 	 */
 	static std::string GenerateRandomName(int length);
 
+	/**
+	 * @brief Writes entries to a archive, compressing modified entries on the thread pool.
+	 * @param writer The archive to write to.
+	 * @param threadPool The pool to compress on, or nullptr.
+	 * @param modifiedOnly If true, unchanged entries are skipped; otherwise they are copied from the current archive.
+	 */
+	void WriteEntries(mz_zip_archive &writer, ThreadPool *threadPool, bool modifiedOnly);
+
 	mz_zip_archive archive = {}; /// The struct used by miniz, to handle archive files.
 	std::filesystem::path archivePath; /// The path of the archive file.
 	bool isOpen = false; /// A flag indicating if the file is currently open for reading and writing.
+	bool isEntryDeleted = false; /// A flag indicating if entries were deleted since the archive was opened, which cannot be appended.
 
 	std::vector<std::unique_ptr<ZipEntry>> zipEntries; /// Data structure for all entries in the archive.
 };
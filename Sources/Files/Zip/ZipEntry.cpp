@@ -14,7 +14,8 @@ ZipEntryMetaData::ZipEntryMetaData(const ZipEntryInfo &info) :
 }
 
 ZipEntry::ZipEntry(const ZipEntryInfo &info) :
-	entryInfo(info) {
+	entryInfo(info),
+	isInArchive(true) {
 	GetNewIndex(info.m_file_index);
 }
 
@@ -26,21 +27,18 @@ ZipEntry::ZipEntry(const std::string &name, const ZipEntryData &data) {
 
 ZipEntry::ZipEntry(const std::string &name, const std::string &data) {
 	entryInfo = CreateInfo(name);
-	entryData.reserve(data.size());
-	for (auto &ch : data)
-		entryData.emplace_back(static_cast<std::byte>(ch));
+	auto begin = reinterpret_cast<const std::byte *>(data.data());
+	entryData.assign(begin, begin + data.size());
 	isModified = true;
 }
 
 std::string ZipEntry::GetDataAsString() const {
-	std::string result;
-	for (auto &ch : entryData)
-		result += static_cast<char>(ch);
-	return result;
+	return {reinterpret_cast<const char *>(entryData.data()), entryData.size()};
 }
 
 void ZipEntry::SetData(const ZipEntryData &data) {
 	entryData = data;
+	sourceFile.clear();
 	isModified = true;
 }
 
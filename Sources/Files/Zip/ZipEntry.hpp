@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <vector>
 #include <string>
+#include <filesystem>
 
 #include <miniz/miniz.h>
 
@@ -60,12 +61,9 @@ public:
 	std::string GetDataAsString() const;
 
 	void SetData(const std::string &data) {
-		ZipEntryData result;
-
-		for (auto &ch : data)
-			result.emplace_back(static_cast<std::byte>(ch));
-
-		entryData = result;
+		auto begin = reinterpret_cast<const std::byte *>(data.data());
+		entryData.assign(begin, begin + data.size());
+		sourceFile.clear();
 		isModified = true;
 	}
 
@@ -92,12 +90,17 @@ public:
 
 private:
 	bool IsModified() const { return isModified; }
+	bool IsInArchive() const { return isInArchive; }
 
 	static uint32_t GetNewIndex(uint32_t latestIndex = 0);
 	static ZipEntryInfo CreateInfo(const std::string &name);
 
 	ZipEntryInfo entryInfo = {};
 	ZipEntryData entryData;
+	/// The file the entry data is read from when the archive is written, empty when the data is in entryData.
+	std::filesystem::path sourceFile;
 	bool isModified = false;
+	/// If the entry was read from the archive, its record stays in the central directory until the archive is rewritten.
+	bool isInArchive = false;
 };
 }
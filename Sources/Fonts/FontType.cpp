@@ -54,9 +54,15 @@ void FontType::Load() {
 	auto debugStart = Time::Now();
 #endif
 
-	auto bytes = Files::ReadBytes(filename);
+	auto fileLoaded = Files::Map(filename);
+
+	if (!fileLoaded) {
+		Log::Error("Font could not be loaded: ", filename, '\n');
+		return;
+	}
+
 	stbtt_fontinfo fontinfo;
-	stbtt_InitFont(&fontinfo, bytes.data(), stbtt_GetFontOffsetForIndex(bytes.data(), 0));
+	stbtt_InitFont(&fontinfo, fileLoaded->GetData(), stbtt_GetFontOffsetForIndex(fileLoaded->GetData(), 0));
 
 	auto layerCount = NEHE.size();
 	//image = std::make_unique<Image2dArray>(Vector2ui(size, size), layerCount, VK_FORMAT_R32G32B32_SFLOAT);
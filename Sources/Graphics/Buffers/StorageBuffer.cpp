@@ -9,6 +9,10 @@ StorageBuffer::StorageBuffer(VkDeviceSize size, const void *data) :
 	Buffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, data) {
 }
 
+StorageBuffer::StorageBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) :
+	Buffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | usage, properties) {
+}
+
 void StorageBuffer::Update(const void *newData) {
 	void *data;
 	MapMemory(&data);
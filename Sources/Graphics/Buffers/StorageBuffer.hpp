@@ -8,6 +8,14 @@ class ACID_EXPORT StorageBuffer : public Descriptor, public Buffer {
 public:
 	explicit StorageBuffer(VkDeviceSize size, const void *data = nullptr);
 
+	/**
+	 * Creates a new storage buffer with more usages and other memory properties, such as a device local buffer of draw commands written by a compute pipeline.
+	 * @param size Size of the buffer in bytes.
+	 * @param usage Usage flag bitmask added to the storage usage (i.e. indirect, transfer source).
+	 * @param properties Memory properties for this buffer.
+	 */
+	StorageBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+
 	void Update(const void *newData);
 
 	WriteDescriptorSet GetWriteDescriptor(uint32_t binding, VkDescriptorType descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
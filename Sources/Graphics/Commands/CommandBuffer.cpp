@@ -7,6 +7,7 @@ CommandBuffer::CommandBuffer(bool begin, VkQueueFlagBits queueType, VkCommandBuf
 	commandPool(Graphics::Get()->GetCommandPool()),
 	queueType(queueType) {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	commandPool->FreeReleased();
 
 	VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
 	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -20,9 +21,8 @@ CommandBuffer::CommandBuffer(bool begin, VkQueueFlagBits queueType, VkCommandBuf
 }
 
 CommandBuffer::~CommandBuffer() {
-	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
-
-	vkFreeCommandBuffers(*logicalDevice, commandPool->GetCommandPool(), 1, &commandBuffer);
+	// Command buffers outliving the thread that recorded them, like asynchronous uploads, are freed by the pool's thread.
+	commandPool->Free(commandBuffer);
 }
 
 void CommandBuffer::Begin(VkCommandBufferUsageFlags usage) {
@@ -18,6 +18,32 @@ CommandPool::CommandPool(const std::thread::id &threadId) :
 CommandPool::~CommandPool() {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
+	// Destroying the pool frees any released command buffers.
 	vkDestroyCommandPool(*logicalDevice, commandPool, nullptr);
 }
+
+void CommandPool::Free(VkCommandBuffer commandBuffer) {
+	if (std::this_thread::get_id() != threadId) {
+		std::lock_guard<std::mutex> lock(releasedMutex);
+		released.emplace_back(commandBuffer);
+		return;
+	}
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	vkFreeCommandBuffers(*logicalDevice, commandPool, 1, &commandBuffer);
+}
+
+void CommandPool::FreeReleased() {
+	std::vector<VkCommandBuffer> commandBuffers;
+	{
+		std::lock_guard<std::mutex> lock(releasedMutex);
+		commandBuffers.swap(released);
+	}
+
+	if (commandBuffers.empty())
+		return;
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	vkFreeCommandBuffers(*logicalDevice, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <mutex>
 #include <thread>
+#include <vector>
 #include <volk.h>
 
 #include "Export.hpp"
@@ -15,6 +17,18 @@ public:
 
 	~CommandPool();
 
+	/**
+	 * Frees a command buffer allocated from this pool. Pools are not synchronized, so buffers released from another thread
+	 * are freed when the owning thread next allocates from the pool.
+	 * @param commandBuffer The command buffer to free.
+	 */
+	void Free(VkCommandBuffer commandBuffer);
+
+	/**
+	 * Frees the command buffers released from other threads, this is called from the thread that owns the pool.
+	 */
+	void FreeReleased();
+
 	operator const VkCommandPool &() const { return commandPool; }
 
 	const VkCommandPool &GetCommandPool() const { return commandPool; }
@@ -23,5 +37,8 @@ public:
 private:
 	VkCommandPool commandPool = VK_NULL_HANDLE;
 	std::thread::id threadId;
+
+	std::mutex releasedMutex;
+	std::vector<VkCommandBuffer> released;
 };
 }
@@ -60,5 +60,14 @@ public:
 	virtual ~Descriptor() = default;
 
 	virtual WriteDescriptorSet GetWriteDescriptor(uint32_t binding, VkDescriptorType descriptorType, const std::optional<OffsetSize> &offsetSize) const = 0;
+
+	/**
+	 * Gets the number of times the contents of this descriptor were replaced, descriptors written with a older generation are written again.
+	 * @return The generation.
+	 */
+	uint32_t GetGeneration() const { return generation; }
+
+protected:
+	uint32_t generation = 0;
 };
 }
@@ -67,7 +67,7 @@ void Graphics::Update() {
 	for (auto &renderStage : renderer->renderStages) {
 		renderStage->Update();
 
-		if (!StartRenderpass(*renderStage))
+		if (!StartRenderpass(*renderStage, stage.first))
 			return;
 
 		auto &commandBuffer = commandBuffers[swapchain->GetActiveImageIndex()];
@@ -302,7 +302,7 @@ void Graphics::RecreateAttachmentsMap() {
 		attachments.insert(renderStage->descriptors.begin(), renderStage->descriptors.end());
 }
 
-bool Graphics::StartRenderpass(RenderStage &renderStage) {
+bool Graphics::StartRenderpass(RenderStage &renderStage, uint32_t renderpass) {
 	if (renderStage.IsOutOfDate()) {
 		RecreatePass(renderStage);
 		return false;
@@ -313,6 +313,9 @@ bool Graphics::StartRenderpass(RenderStage &renderStage) {
 	if (!commandBuffer->IsRunning())
 		commandBuffer->Begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
 
+	// Compute and transfer commands can not be recorded inside a renderpass.
+	renderer->subrenderHolder.PreRenderStage(renderpass, *commandBuffer);
+
 	VkRect2D renderArea = {};
 	renderArea.offset = {renderStage.GetRenderArea().GetOffset().x, renderStage.GetRenderArea().GetOffset().y};
 	renderArea.extent = {renderStage.GetRenderArea().GetExtent().x, renderStage.GetRenderArea().GetExtent().y};
@@ -367,5 +370,6 @@ void Graphics::EndRenderpass(RenderStage &renderStage) {
 	}
 
 	currentFrame = (currentFrame + 1) % swapchain->GetImageCount();
+	frameCount++;
 }
 }
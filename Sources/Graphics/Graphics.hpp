@@ -51,6 +51,11 @@ public:
 	const Descriptor *GetAttachment(const std::string &name) const;
 	const Swapchain *GetSwapchain() const { return swapchain.get(); }
 	const VkPipelineCache &GetPipelineCache() const { return pipelineCache; }
+	/**
+	 * Gets the number of frames submitted, objects used by a frame can be destroyed once the swapchain image count more frames are submitted.
+	 * @return The number of submitted frames.
+	 */
+	uint64_t GetFrameCount() const { return frameCount; }
 	void SetFramebufferResized() { framebufferResized = true; }
 	const PhysicalDevice *GetPhysicalDevice() const { return physicalDevice.get(); }
 	const Surface *GetSurface() const { return surface.get(); }
@@ -63,7 +68,7 @@ private:
 	void RecreateCommandBuffers();
 	void RecreatePass(RenderStage &renderStage);
 	void RecreateAttachmentsMap();
-	bool StartRenderpass(RenderStage &renderStage);
+	bool StartRenderpass(RenderStage &renderStage, uint32_t renderpass);
 	void EndRenderpass(RenderStage &renderStage);
 
 	std::unique_ptr<Renderer> renderer;
@@ -79,6 +84,7 @@ private:
 	std::vector<VkSemaphore> renderCompletes;
 	std::vector<VkFence> flightFences;
 	std::size_t currentFrame = 0;
+	uint64_t frameCount = 0;
 	bool framebufferResized = false;
 
 	std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
@@ -1,8 +1,10 @@
 #include "Image.hpp"
 
 #include <cstring>
+#include <optional>
 
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/Compressed/CompressedBitmap.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Files/Files.hpp"
@@ -198,6 +200,13 @@ void Image::CreateImageView(const VkImage &image, VkImageView &imageView, VkImag
 
 void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout, uint32_t mipLevels,
 	uint32_t baseArrayLayer, uint32_t layerCount) {
+	CommandBuffer commandBuffer;
+	CreateMipmaps(commandBuffer, image, extent, format, dstImageLayout, mipLevels, baseArrayLayer, layerCount);
+	commandBuffer.SubmitIdle();
+}
+
+void Image::CreateMipmaps(const CommandBuffer &commandBuffer, const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout,
+	uint32_t mipLevels, uint32_t baseArrayLayer, uint32_t layerCount) {
 	auto physicalDevice = Graphics::Get()->GetPhysicalDevice();
 
 	// Get device properites for the requested Image format.
@@ -208,8 +217,6 @@ void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkForm
 	assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT);
 	assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
 
-	CommandBuffer commandBuffer;
-
 	for (uint32_t i = 1; i < mipLevels; i++) {
 		VkImageMemoryBarrier barrier0 = {};
 		barrier0.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -272,14 +279,17 @@ void Image::CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkForm
 	barrier.subresourceRange.baseArrayLayer = baseArrayLayer;
 	barrier.subresourceRange.layerCount = layerCount;
 	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-	commandBuffer.SubmitIdle();
 }
 
 void Image::TransitionImageLayout(const VkImage &image, VkFormat format, VkImageLayout srcImageLayout, VkImageLayout dstImageLayout,
 	VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer) {
 	CommandBuffer commandBuffer;
+	TransitionImageLayout(commandBuffer, image, format, srcImageLayout, dstImageLayout, imageAspect, mipLevels, baseMipLevel, layerCount, baseArrayLayer);
+	commandBuffer.SubmitIdle();
+}
 
+void Image::TransitionImageLayout(const CommandBuffer &commandBuffer, const VkImage &image, VkFormat format, VkImageLayout srcImageLayout,
+	VkImageLayout dstImageLayout, VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer) {
 	VkImageMemoryBarrier imageMemoryBarrier = {};
 	imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 	imageMemoryBarrier.oldLayout = srcImageLayout;
@@ -348,8 +358,6 @@ void Image::TransitionImageLayout(const VkImage &image, VkFormat format, VkImage
 	}
 
 	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-	commandBuffer.SubmitIdle();
 }
 
 void Image::InsertImageMemoryBarrier(const CommandBuffer &commandBuffer, const VkImage &image, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
@@ -374,7 +382,12 @@ void Image::InsertImageMemoryBarrier(const CommandBuffer &commandBuffer, const V
 
 void Image::CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent, uint32_t layerCount, uint32_t baseArrayLayer) {
 	CommandBuffer commandBuffer;
+	CopyBufferToImage(commandBuffer, buffer, image, extent, layerCount, baseArrayLayer);
+	commandBuffer.SubmitIdle();
+}
 
+void Image::CopyBufferToImage(const CommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent, uint32_t layerCount,
+	uint32_t baseArrayLayer) {
 	VkBufferImageCopy region = {};
 	region.bufferOffset = 0;
 	region.bufferRowLength = 0;
@@ -386,8 +399,67 @@ void Image::CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, cons
 	region.imageOffset = {0, 0, 0};
 	region.imageExtent = extent;
 	vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+}
 
-	commandBuffer.SubmitIdle();
+std::unique_ptr<Buffer> Image::LoadLevels(const CommandBuffer &commandBuffer, const CompressedBitmap &bitmap, VkImageViewType viewType, bool anisotropic,
+	bool mipmap, uint32_t baseLevel) {
+	auto decompressed = DecompressUnsupported(bitmap);
+	const auto &loadBitmap = decompressed ? *decompressed : bitmap;
+	const auto &baseSize = loadBitmap.GetLevels()[baseLevel].size;
+	format = loadBitmap.GetFormat();
+	extent = {baseSize.x, baseSize.y, 1};
+	arrayLayers = loadBitmap.GetLayerCount();
+
+	// Block compressed levels cannot be blitted, they only have the levels that were stored. Without mipmaps only the first level is used.
+	auto generateMipmaps = mipmap && loadBitmap.GetLevelCount() == 1 && !CompressedBitmap::IsBlockCompressed(format);
+	mipLevels = generateMipmaps ? GetMipLevels(extent) : mipmap ? loadBitmap.GetLevelCount() - baseLevel : 1;
+
+	// The sampler covers every stored level, so levels streamed in above the base level are sampled without a new sampler.
+	CreateImage(image, memory, extent, format, samples, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mipLevels, arrayLayers, VK_IMAGE_TYPE_2D);
+	CreateImageSampler(sampler, filter, addressMode, anisotropic, mipLevels + baseLevel);
+	CreateImageView(image, view, viewType, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+	TransitionImageLayout(commandBuffer, image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+
+	auto baseOffset = loadBitmap.GetLevels()[baseLevel].offset;
+	auto bufferStaging = std::make_unique<Buffer>(loadBitmap.GetLength() - baseOffset, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, loadBitmap.GetData(baseLevel));
+
+	// Layers of a level are tightly packed, so each level is copied with one region.
+	auto copyLevels = std::min(mipLevels, loadBitmap.GetLevelCount() - baseLevel);
+	std::vector<VkBufferImageCopy> regions;
+	regions.reserve(copyLevels);
+	for (uint32_t i = 0; i < copyLevels; i++) {
+		const auto &level = loadBitmap.GetLevels()[baseLevel + i];
+		VkBufferImageCopy region = {};
+		region.bufferOffset = level.offset - baseOffset;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = i;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = arrayLayers;
+		region.imageExtent = {level.size.x, level.size.y, 1};
+		regions.emplace_back(region);
+	}
+
+	vkCmdCopyBufferToImage(commandBuffer, bufferStaging->GetBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+	if (generateMipmaps)
+		CreateMipmaps(commandBuffer, image, extent, format, layout, mipLevels, 0, arrayLayers);
+	else
+		TransitionImageLayout(commandBuffer, image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+	return bufferStaging;
+}
+
+std::optional<CompressedBitmap> Image::DecompressUnsupported(const CompressedBitmap &bitmap) {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	// Block compressed formats need the device feature and sampling support for the format, otherwise they are decompressed.
+	if (!CompressedBitmap::IsBlockCompressed(bitmap.GetFormat()) || (logicalDevice->GetEnabledFeatures().textureCompressionBC &&
+		FindSupportedFormat({bitmap.GetFormat()}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != VK_FORMAT_UNDEFINED)) {
+		return std::nullopt;
+	}
+
+	Log::Warning("Block compressed format of ", bitmap.GetFilename(), " is not supported, decompressing to RGBA8\n");
+	return bitmap.Decompress();
 }
 
 bool Image::CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, VkFormat srcFormat, const VkExtent3D &extent,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include "Graphics/Commands/CommandBuffer.hpp"
@@ -8,6 +9,8 @@
 
 namespace acid {
 class Bitmap;
+class Buffer;
+class CompressedBitmap;
 
 /**
  * @brief A representation of a Vulkan image, sampler, and view.
@@ -52,7 +55,7 @@ public:
 	VkFilter GetFilter() const { return filter; }
 	VkSamplerAddressMode GetAddressMode() const { return addressMode; }
 	VkImageLayout GetLayout() const { return layout; }
-	const VkImage &GetImage() { return image; }
+	const VkImage &GetImage() const { return image; }
 	const VkDeviceMemory &GetMemory() { return memory; }
 	const VkSampler &GetSampler() const { return sampler; }
 	const VkImageView &GetView() const { return view; }
@@ -89,16 +92,43 @@ public:
 		uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer);
 	static void CreateMipmaps(const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout, uint32_t mipLevels,
 		uint32_t baseArrayLayer, uint32_t layerCount);
+	static void CreateMipmaps(const CommandBuffer &commandBuffer, const VkImage &image, const VkExtent3D &extent, VkFormat format, VkImageLayout dstImageLayout,
+		uint32_t mipLevels, uint32_t baseArrayLayer, uint32_t layerCount);
 	static void TransitionImageLayout(const VkImage &image, VkFormat format, VkImageLayout srcImageLayout, VkImageLayout dstImageLayout,
 		VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer);
+	static void TransitionImageLayout(const CommandBuffer &commandBuffer, const VkImage &image, VkFormat format, VkImageLayout srcImageLayout,
+		VkImageLayout dstImageLayout, VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer);
 	static void InsertImageMemoryBarrier(const CommandBuffer &commandBuffer, const VkImage &image, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
 		VkImageLayout oldImageLayout, VkImageLayout newImageLayout, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask,
 		VkImageAspectFlags imageAspect, uint32_t mipLevels, uint32_t baseMipLevel, uint32_t layerCount, uint32_t baseArrayLayer);
 	static void CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent, uint32_t layerCount, uint32_t baseArrayLayer);
+	static void CopyBufferToImage(const CommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const VkExtent3D &extent, uint32_t layerCount,
+		uint32_t baseArrayLayer);
 	static bool CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, VkFormat srcFormat, const VkExtent3D &extent,
 		VkImageLayout srcImageLayout, uint32_t mipLevel, uint32_t arrayLayer);
 
 protected:
+	/**
+	 * Creates the image from a bitmap with a stored mip chain, recording the upload of every level and layer as they are stored.
+	 * Block compressed formats the device cannot sample are decompressed to RGBA8.
+	 * @param commandBuffer The command buffer to record the upload into, the image is ready once it has been submitted and finished.
+	 * @param bitmap The bitmap to load from.
+	 * @param viewType The type of the image view.
+	 * @param anisotropic If anisotropic filtering is enabled.
+	 * @param mipmap If the stored levels are used, or generated when the bitmap has a single level and is not block compressed.
+	 * @param baseLevel The first stored level held in the image, the sampler still covers every stored level.
+	 * @return The staging buffer the upload reads from, it must be kept until the command buffer has finished.
+	 */
+	std::unique_ptr<Buffer> LoadLevels(const CommandBuffer &commandBuffer, const CompressedBitmap &bitmap, VkImageViewType viewType, bool anisotropic, bool mipmap,
+		uint32_t baseLevel = 0);
+
+	/**
+	 * Decompresses a bitmap to RGBA8 if it has a block compressed format the device cannot sample.
+	 * @param bitmap The bitmap to check.
+	 * @return The decompressed bitmap, or std::nullopt if the device can sample the format of the bitmap.
+	 */
+	static std::optional<CompressedBitmap> DecompressUnsupported(const CompressedBitmap &bitmap);
+
 	VkExtent3D extent;
 	VkSampleCountFlagBits samples;
 	VkImageUsageFlags usage;
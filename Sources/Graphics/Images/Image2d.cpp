@@ -3,11 +3,14 @@
 #include <cstring>
 
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/Compressed/CompressedBitmap.hpp"
+#include "Bitmaps/Compressed/TextureManifest.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Resources/Resources.hpp"
 #include "Files/Node.hpp"
 #include "Image.hpp"
+#include "TextureStreamer.hpp"
 
 namespace acid {
 std::shared_ptr<Image2d> Image2d::Create(const Node &node) {
@@ -18,23 +21,27 @@ std::shared_ptr<Image2d> Image2d::Create(const Node &node) {
 	Resources::Get()->Add(node, std::dynamic_pointer_cast<Resource>(result));
 	node >> *result;
 	result->Load();
+	if (result->stream)
+		TextureStreamer::Get()->Add(result);
 	return result;
 }
 
-std::shared_ptr<Image2d> Image2d::Create(const std::filesystem::path &filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap) {
-	Image2d temp(filename, filter, addressMode, anisotropic, mipmap, false);
+std::shared_ptr<Image2d> Image2d::Create(const std::filesystem::path &filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap,
+	bool streamed) {
+	Image2d temp(filename, filter, addressMode, anisotropic, mipmap, streamed, false);
 	Node node;
 	node << temp;
 	return Create(node);
 }
 
-Image2d::Image2d(std::filesystem::path filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap, bool load) :
+Image2d::Image2d(std::filesystem::path filename, VkFilter filter, VkSamplerAddressMode addressMode, bool anisotropic, bool mipmap, bool streamed, bool load) :
 	Image(filter, addressMode, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
 		VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
 		VK_FORMAT_R8G8B8A8_UNORM, 1, 1, {0, 0, 1}),
 	filename(std::move(filename)),
 	anisotropic(anisotropic),
-	mipmap(mipmap) {
+	mipmap(mipmap),
+	streamed(streamed) {
 	if (load) {
 		Image2d::Load();
 	}
@@ -62,6 +69,18 @@ Image2d::Image2d(std::unique_ptr<Bitmap> &&bitmap, VkFormat format, VkImageLayou
 	Image2d::Load(std::move(bitmap));
 }
 
+Image2d::~Image2d() {
+	// A streaming step that is still running is waited for, the image it fills is destroyed with this image.
+	if (!stream || stream->fence == VK_NULL_HANDLE)
+		return;
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &stream->fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+	vkDestroyFence(*logicalDevice, stream->fence, nullptr);
+	vkFreeMemory(*logicalDevice, stream->pendingMemory, nullptr);
+	vkDestroyImage(*logicalDevice, stream->pendingImage, nullptr);
+}
+
 void Image2d::SetPixels(const uint8_t *pixels, uint32_t layerCount, uint32_t baseArrayLayer) {
 	Buffer bufferStaging(extent.width * extent.height * components * arrayLayers, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
 		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
@@ -74,12 +93,43 @@ void Image2d::SetPixels(const uint8_t *pixels, uint32_t layerCount, uint32_t bas
 	CopyBufferToImage(bufferStaging.GetBuffer(), image, extent, layerCount, baseArrayLayer);
 }
 
+std::vector<std::filesystem::path> Image2d::GetDependencies() const {
+	if (filename.empty())
+		return {};
+	if (auto cooked = TextureManifest::FindCooked(filename))
+		return {filename, *cooked};
+	return {filename};
+}
+
+std::shared_ptr<Resource> Image2d::Reload() const {
+	if (filename.empty())
+		return nullptr;
+	return std::make_shared<Image2d>(filename, filter, addressMode, anisotropic, mipmap, streamed);
+}
+
+void Image2d::Swap(Resource &reloaded) {
+	auto &other = dynamic_cast<Image2d &>(reloaded);
+	std::swap(extent, other.extent);
+	std::swap(format, other.format);
+	std::swap(mipLevels, other.mipLevels);
+	std::swap(components, other.components);
+	std::swap(image, other.image);
+	std::swap(memory, other.memory);
+	std::swap(sampler, other.sampler);
+	std::swap(view, other.view);
+	std::swap(stream, other.stream);
+
+	// Descriptor sets with the old view are written again.
+	generation++;
+}
+
 const Node &operator>>(const Node &node, Image2d &image) {
 	node["filename"].Get(image.filename);
 	node["filter"].Get(image.filter);
 	node["addressMode"].Get(image.addressMode);
 	node["anisotropic"].Get(image.anisotropic);
 	node["mipmap"].Get(image.mipmap);
+	node["streamed"].Get(image.streamed);
 	return node;
 }
 
@@ -89,14 +139,46 @@ Node &operator<<(Node &node, const Image2d &image) {
 	node["addressMode"].Set(image.addressMode);
 	node["anisotropic"].Set(image.anisotropic);
 	node["mipmap"].Set(image.mipmap);
+	node["streamed"].Set(image.streamed);
 	return node;
 }
 
 void Image2d::Load(std::unique_ptr<Bitmap> loadBitmap) {
+	// Containers keep their stored format and mip chain, the format of this image is replaced. Textures with a cooked variant load it instead.
+	if (!filename.empty() && !loadBitmap) {
+		auto compressedFilename = CompressedBitmap::IsContainer(filename) ? std::make_optional(filename) : TextureManifest::FindCooked(filename);
+		if (compressedFilename) {
+			CompressedBitmap compressedBitmap(*compressedFilename);
+			if (compressedBitmap) {
+				components = 4;
+				// Block compressed containers are only streamed with their stored levels, RGBA8 containers can be given a mip chain.
+				if (streamed && mipmap && TextureStreamer::Get() && (compressedBitmap.GetLevelCount() > 1 || !CompressedBitmap::IsBlockCompressed(compressedBitmap.GetFormat()))) {
+					LoadStreamed(compressedBitmap.GetLevelCount() > 1 ? std::move(compressedBitmap) : compressedBitmap.GenerateMipmaps(false));
+					return;
+				}
+
+				CommandBuffer commandBuffer;
+				auto bufferStaging = LoadLevels(commandBuffer, compressedBitmap, VK_IMAGE_VIEW_TYPE_2D, anisotropic, mipmap);
+				commandBuffer.SubmitIdle();
+				return;
+			}
+
+			// A cooked variant that cannot be loaded falls back to its source.
+			if (*compressedFilename == filename)
+				return;
+		}
+	}
+
 	if (!filename.empty() && !loadBitmap) {
 		loadBitmap = std::make_unique<Bitmap>(filename);
-		extent = {loadBitmap->GetSize().y, loadBitmap->GetSize().y, 1};
+		extent = {loadBitmap->GetSize().x, loadBitmap->GetSize().y, 1};
 		components = loadBitmap->GetBytesPerPixel();
+
+		// Streamed images keep every level on the host, so their mip chain is generated there instead of blitted.
+		if (streamed && mipmap && TextureStreamer::Get() && *loadBitmap) {
+			LoadStreamed(CompressedBitmap(*loadBitmap).GenerateMipmaps(false));
+			return;
+		}
 	}
 		
 	if (extent.width == 0 || extent.height == 0)
@@ -133,4 +215,21 @@ void Image2d::Load(std::unique_ptr<Bitmap> loadBitmap) {
 		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	}
 }
+
+void Image2d::LoadStreamed(CompressedBitmap &&bitmap) {
+	if (auto decompressed = DecompressUnsupported(bitmap))
+		bitmap = std::move(*decompressed);
+
+	// Only the levels no larger than the minimum resident size are loaded, finer levels are streamed in once the image is drawn.
+	stream = std::make_unique<Stream>();
+	stream->minLevel = bitmap.GetLevelCount() - 1;
+	while (stream->minLevel > 0 && bitmap.GetLevels()[stream->minLevel - 1].size.Max() <= TextureStreamer::MinResidentSize)
+		stream->minLevel--;
+	stream->imageLevel = stream->viewLevel = stream->targetLevel = stream->minLevel;
+	stream->bitmap = std::move(bitmap);
+
+	CommandBuffer commandBuffer;
+	auto bufferStaging = LoadLevels(commandBuffer, stream->bitmap, VK_IMAGE_VIEW_TYPE_2D, anisotropic, true, stream->minLevel);
+	commandBuffer.SubmitIdle();
+}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/Compressed/CompressedBitmap.hpp"
 #include "Resources/Resource.hpp"
 #include "Image.hpp"
 
@@ -24,10 +25,11 @@ public:
 	 * @param addressMode The addressing mode for outside [0..1] range.
 	 * @param anisotropic If anisotropic filtering is enabled.
 	 * @param mipmap If mapmaps will be generated.
+	 * @param streamed If only the low levels are loaded, finer levels are streamed in by the {@link TextureStreamer} for the size the image is drawn at.
 	 * @return The 2D image with the requested values.
 	 */
 	static std::shared_ptr<Image2d> Create(const std::filesystem::path &filename, VkFilter filter = VK_FILTER_LINEAR,
-		VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, bool anisotropic = true, bool mipmap = true);
+		VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT, bool anisotropic = true, bool mipmap = true, bool streamed = false);
 
 	/**
 	 * Creates a new 2D image.
@@ -36,10 +38,13 @@ public:
 	 * @param addressMode The addressing mode for outside [0..1] range.
 	 * @param anisotropic If anisotropic filtering is enabled.
 	 * @param mipmap If mapmaps will be generated.
+	 * @param streamed If only the low levels are loaded, finer levels are streamed in by the {@link TextureStreamer} for the size the image is drawn at.
+	 * Only {@link Image2d#Create} registers the image with the streamer, a streamed image constructed directly keeps just its low levels until it
+	 * is passed to {@link TextureStreamer#Add}.
 	 * @param load If this resource will be loaded immediately, otherwise {@link Image2d#Load} can be called later.
 	 */
 	explicit Image2d(std::filesystem::path filename, VkFilter filter = VK_FILTER_LINEAR, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-		bool anisotropic = true, bool mipmap = true, bool load = true);
+		bool anisotropic = true, bool mipmap = true, bool streamed = false, bool load = true);
 
 	/**
 	 * Creates a new 2D image.
@@ -75,7 +80,7 @@ public:
 		VkFilter filter = VK_FILTER_LINEAR, VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
 		VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT, bool anisotropic = false, bool mipmap = false);
 
-	~Image2d() = default;
+	~Image2d();
 
 	/**
 	 * Sets the pixels of this image.
@@ -85,23 +90,69 @@ public:
 	 */
 	void SetPixels(const uint8_t *pixels, uint32_t layerCount, uint32_t baseArrayLayer);
 
+	/**
+	 * Requests the size this image is drawn at, a streamed image keeps the levels needed by the largest size requested recently.
+	 * @param size The size in pixels the image covers on screen.
+	 */
+	void RequestSize(float size) {
+		if (stream)
+			stream->requestedSize = std::max(stream->requestedSize, size);
+	}
+
 	std::type_index GetTypeIndex() const override { return typeid(Image2d); }
+	std::vector<std::filesystem::path> GetDependencies() const override;
+	std::shared_ptr<Resource> Reload() const override;
+	void Swap(Resource &reloaded) override;
 
 	const std::filesystem::path &GetFilename() const { return filename; }
 	bool IsAnisotropic() const { return anisotropic; }
 	bool IsMipmap() const { return mipmap; }
+	bool IsStreamed() const { return stream != nullptr; }
 	uint32_t GetComponents() const { return components; }
 
 	friend const Node &operator>>(const Node &node, Image2d &image);
 	friend Node &operator<<(Node &node, const Image2d &image);
 
 private:
+	friend class TextureStreamer;
+
+	/**
+	 * @brief The levels of a streamed image, and the step that is streaming it between residencies.
+	 *
+	 * Levels are numbered from the finest stored level. The image holds the levels from the image level, the view only sees the levels
+	 * from the view level, so levels still being uploaded are never sampled.
+	 */
+	class Stream {
+	public:
+		CompressedBitmap bitmap;
+		/// The coarsest levels are always resident.
+		uint32_t minLevel = 0;
+		uint32_t imageLevel = 0;
+		uint32_t viewLevel = 0;
+		uint32_t targetLevel = 0;
+		float requestedSize = 0.0f;
+		/// The requested size held over frames, decaying once the image is no longer drawn.
+		float size = 0.0f;
+
+		/// The image being filled when the levels held are changed, swapped in once the step has finished.
+		VkImage pendingImage = VK_NULL_HANDLE;
+		VkDeviceMemory pendingMemory = VK_NULL_HANDLE;
+		uint32_t pendingLevel = 0;
+		std::unique_ptr<CommandBuffer> commandBuffer;
+		std::unique_ptr<Buffer> bufferStaging;
+		VkFence fence = VK_NULL_HANDLE;
+	};
+
 	void Load(std::unique_ptr<Bitmap> loadBitmap = nullptr);
+	void LoadStreamed(CompressedBitmap &&bitmap);
 
 	std::filesystem::path filename;
 
 	bool anisotropic;
 	bool mipmap;
+	bool streamed = false;
 	uint32_t components = 0;
+
+	std::unique_ptr<Stream> stream;
 };
 }
@@ -1,14 +1,49 @@
 #include "ImageCube.hpp"
 
+#include <atomic>
 #include <cstring>
 
 #include "Bitmaps/Bitmap.hpp"
+#include "Bitmaps/Compressed/CompressedBitmap.hpp"
+#include "Bitmaps/Compressed/TextureManifest.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Graphics/Graphics.hpp"
 #include "Resources/Resources.hpp"
 #include "Image.hpp"
 
 namespace acid {
+/**
+ * @brief The sides of a cubemap being decoded, claimed from a counter by the loading thread and the pool workers helping it.
+ */
+class SideJob {
+public:
+	SideJob(uint32_t count, std::function<bool(uint32_t)> &&decode) :
+		count(count),
+		decode(std::move(decode)) {
+	}
+
+	void Run() {
+		for (uint32_t i; (i = next++) < count;) {
+			if (!decode(i))
+				failed = true;
+			finished++;
+		}
+	}
+
+	bool Wait() const {
+		while (finished < count)
+			std::this_thread::yield();
+		return !failed;
+	}
+
+private:
+	uint32_t count;
+	std::function<bool(uint32_t)> decode;
+	std::atomic<uint32_t> next = 0;
+	std::atomic<uint32_t> finished = 0;
+	std::atomic<bool> failed = false;
+};
+
 std::shared_ptr<ImageCube> ImageCube::Create(const Node &node) {
 	if (auto resource = Resources::Get()->Find<ImageCube>(node))
 		return resource;
@@ -66,6 +101,11 @@ ImageCube::ImageCube(std::unique_ptr<Bitmap> &&bitmap, VkFormat format, VkImageL
 ImageCube::~ImageCube() {
 	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
 
+	// The image cannot be destroyed while it is being uploaded.
+	if (uploadFence != VK_NULL_HANDLE)
+		Graphics::CheckVk(vkWaitForFences(*logicalDevice, 1, &uploadFence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+	IsResident();
+
 	vkDestroyImageView(*logicalDevice, view, nullptr);
 	vkDestroySampler(*logicalDevice, sampler, nullptr);
 	vkFreeMemory(*logicalDevice, memory, nullptr);
@@ -99,6 +139,22 @@ void ImageCube::SetPixels(const uint8_t *pixels, uint32_t layerCount, uint32_t b
 	CopyBufferToImage(bufferStaging.GetBuffer(), image, extent, layerCount, baseArrayLayer);
 }
 
+bool ImageCube::IsResident() {
+	if (uploadFence == VK_NULL_HANDLE)
+		return true;
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (vkGetFenceStatus(*logicalDevice, uploadFence) != VK_SUCCESS)
+		return false;
+
+	vkDestroyFence(*logicalDevice, uploadFence, nullptr);
+	uploadFence = VK_NULL_HANDLE;
+	uploadCommandBuffer = nullptr;
+	uploadBufferStaging = nullptr;
+	return true;
+}
+
 const Node &operator>>(const Node &node, ImageCube &image) {
 	node["filename"].Get(image.filename);
 	node["fileSuffix"].Get(image.fileSuffix);
@@ -122,25 +178,30 @@ Node &operator<<(Node &node, const ImageCube &image) {
 }
 
 void ImageCube::Load(std::unique_ptr<Bitmap> loadBitmap) {
-	if (!filename.empty() && !loadBitmap) {
-		uint8_t *offset = nullptr;
+	auto commandBuffer = std::make_unique<CommandBuffer>();
+	std::unique_ptr<Buffer> bufferStaging;
 
-		for (const auto &side : fileSides) {
-			Bitmap bitmapSide(filename / (side + fileSuffix));
-			auto lengthSide = bitmapSide.GetLength();
-
-			if (!loadBitmap) {
-				loadBitmap = std::make_unique<Bitmap>(std::make_unique<uint8_t[]>(lengthSide * arrayLayers), bitmapSide.GetSize(),
-					bitmapSide.GetBytesPerPixel());
-				offset = loadBitmap->GetData().get();
-			}
-
-			std::memcpy(offset, bitmapSide.GetData().get(), lengthSide);
-			offset += lengthSide;
+	// Containers keep their stored format and mip chain, either one container with six faces or one container per side. Sides
+	// with cooked variants load them instead.
+	if (!filename.empty() && !loadBitmap) {
+		if (auto compressedBitmap = LoadSides()) {
+			components = 4;
+			bufferStaging = LoadLevels(*commandBuffer, compressedBitmap, VK_IMAGE_VIEW_TYPE_CUBE, anisotropic, mipmap);
+			SubmitUpload(std::move(commandBuffer), std::move(bufferStaging));
+			return;
 		}
 
-		extent = {loadBitmap->GetSize().y, loadBitmap->GetSize().y, 1};
-		components = loadBitmap->GetBytesPerPixel();
+		if (CompressedBitmap::IsContainer(filename) || CompressedBitmap::IsContainer(fileSuffix))
+			return;
+
+		bufferStaging = LoadSidePixels();
+		if (!bufferStaging)
+			return;
+	}
+
+	if (loadBitmap) {
+		bufferStaging = std::make_unique<Buffer>(loadBitmap->GetLength() * arrayLayers, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, loadBitmap->GetData().get());
 	}
 
 	if (extent.width == 0 || extent.height == 0) {
@@ -154,28 +215,119 @@ void ImageCube::Load(std::unique_ptr<Bitmap> loadBitmap) {
 	CreateImageSampler(sampler, filter, addressMode, anisotropic, mipLevels);
 	CreateImageView(image, view, VK_IMAGE_VIEW_TYPE_CUBE, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 
-	if (loadBitmap || mipmap) {
-		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+	if (bufferStaging || mipmap) {
+		TransitionImageLayout(*commandBuffer, image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT,
+			mipLevels, 0, arrayLayers, 0);
 	}
 
-	if (loadBitmap) {
-		Buffer bufferStaging(loadBitmap->GetLength() * arrayLayers, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-		uint8_t *data;
-		bufferStaging.MapMemory(reinterpret_cast<void**>(&data));
-		std::memcpy(data, loadBitmap->GetData().get(), bufferStaging.GetSize());
-		bufferStaging.UnmapMemory();
-
-		CopyBufferToImage(bufferStaging.GetBuffer(), image, extent, arrayLayers, 0);
+	if (bufferStaging) {
+		CopyBufferToImage(*commandBuffer, bufferStaging->GetBuffer(), image, extent, arrayLayers, 0);
 	}
 
 	if (mipmap) {
-		CreateMipmaps(image, extent, format, layout, mipLevels, 0, arrayLayers);
-	} else if (loadBitmap) {
-		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+		CreateMipmaps(*commandBuffer, image, extent, format, layout, mipLevels, 0, arrayLayers);
+	} else if (bufferStaging) {
+		TransitionImageLayout(*commandBuffer, image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	} else {
-		TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
+		TransitionImageLayout(*commandBuffer, image, format, VK_IMAGE_LAYOUT_UNDEFINED, layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, arrayLayers, 0);
 	}
+
+	// Cubemaps from files upload without waiting, images created in memory are used by other queues right away.
+	if (!filename.empty()) {
+		SubmitUpload(std::move(commandBuffer), std::move(bufferStaging));
+	} else {
+		commandBuffer->SubmitIdle();
+	}
+}
+
+CompressedBitmap ImageCube::LoadSides() const {
+	if (CompressedBitmap::IsContainer(filename)) {
+		CompressedBitmap bitmap(filename);
+		if (bitmap && bitmap.GetLayerCount() != 6) {
+			Log::Error("Cubemap ", filename, " does not have 6 faces\n");
+			return {};
+		}
+		return bitmap;
+	}
+
+	CompressedBitmap bitmap;
+
+	for (uint32_t i = 0; i < fileSides.size(); i++) {
+		auto sideFilename = filename / (fileSides[i] + fileSuffix);
+		if (!CompressedBitmap::IsContainer(sideFilename)) {
+			auto cooked = TextureManifest::FindCooked(sideFilename);
+			if (!cooked)
+				return {};
+			sideFilename = *cooked;
+		}
+
+		CompressedBitmap bitmapSide(sideFilename);
+		if (!bitmapSide)
+			return {};
+
+		if (!bitmap) {
+			bitmap = CompressedBitmap(bitmapSide.GetFormat(), bitmapSide.GetSize(), bitmapSide.GetLevelCount(), 6);
+		} else if (bitmapSide.GetFormat() != bitmap.GetFormat() || bitmapSide.GetSize() != bitmap.GetSize() ||
+			bitmapSide.GetLevelCount() != bitmap.GetLevelCount()) {
+			Log::Error("Cubemap side ", bitmapSide.GetFilename(), " does not match the format, size and levels of the other sides\n");
+			return {};
+		}
+
+		for (uint32_t level = 0; level < bitmap.GetLevelCount(); level++)
+			std::memcpy(bitmap.GetData(level, i), bitmapSide.GetData(level), bitmap.GetLevels()[level].layerLength);
+	}
+
+	return bitmap;
+}
+
+std::unique_ptr<Buffer> ImageCube::LoadSidePixels() {
+	if (fileSides.size() != arrayLayers) {
+		Log::Error("Cubemap ", filename, " needs ", arrayLayers, " sides\n");
+		return nullptr;
+	}
+
+	// Sides have the same size, so the size from the first header places every side in the staging buffer before any are decoded.
+	auto size = Bitmap::LoadSize(filename / (fileSides[0] + fileSuffix));
+	if (!size)
+		return nullptr;
+
+	std::size_t lengthSide = size->x * size->y * 4;
+	auto bufferStaging = std::make_unique<Buffer>(lengthSide * arrayLayers, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	uint8_t *data;
+	bufferStaging->MapMemory(reinterpret_cast<void **>(&data));
+
+	auto job = std::make_shared<SideJob>(arrayLayers, [this, data, lengthSide, size = *size](uint32_t i) {
+		return Bitmap::LoadPixels(filename / (fileSides[i] + fileSuffix), data + i * lengthSide, size);
+	});
+
+	auto &threadPool = Resources::Get()->GetThreadPool();
+	auto helpers = std::min<std::size_t>(threadPool.GetWorkers().size(), arrayLayers - 1);
+	for (std::size_t i = 0; i < helpers; i++)
+		threadPool.Enqueue([job]() { job->Run(); });
+
+	job->Run();
+	auto loaded = job->Wait();
+	bufferStaging->UnmapMemory();
+
+	if (!loaded)
+		return nullptr;
+
+	extent = {size->x, size->y, 1};
+	components = 4;
+	return bufferStaging;
+}
+
+void ImageCube::SubmitUpload(std::unique_ptr<CommandBuffer> &&commandBuffer, std::unique_ptr<Buffer> &&bufferStaging) {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	Graphics::CheckVk(vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &uploadFence));
+
+	commandBuffer->Submit(VK_NULL_HANDLE, VK_NULL_HANDLE, uploadFence);
+	uploadCommandBuffer = std::move(commandBuffer);
+	uploadBufferStaging = std::move(bufferStaging);
 }
 }
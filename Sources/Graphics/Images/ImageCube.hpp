@@ -5,6 +5,7 @@
 
 namespace acid {
 class Bitmap;
+class CompressedBitmap;
 
 /**
  * @brief Resource that represents a cubemap image.
@@ -95,6 +96,14 @@ public:
 	 */
 	void SetPixels(const uint8_t *pixels, uint32_t layerCount, uint32_t baseArrayLayer);
 
+	/**
+	 * Gets if the pixels of this image have finished uploading, cubemaps loaded from files are uploaded without waiting for the device.
+	 * The graphics queue sees the upload in submission order, other queues need to wait for it. The staging memory is kept until this returns true,
+	 * the upload command buffer is then released to the loading thread's pool.
+	 * @return If the upload has finished.
+	 */
+	bool IsResident();
+
 	std::type_index GetTypeIndex() const override { return typeid(ImageCube); }
 
 	const std::filesystem::path &GetFilename() const { return filename; }
@@ -109,6 +118,13 @@ private:
 	friend Node &operator<<(Node &node, const ImageCube &image);
 
 	void Load(std::unique_ptr<Bitmap> loadBitmap = nullptr);
+	CompressedBitmap LoadSides() const;
+	/**
+	 * Decodes the sides in parallel straight into a staging buffer.
+	 * @return The staging buffer holding every side, or nullptr if a side could not be decoded.
+	 */
+	std::unique_ptr<Buffer> LoadSidePixels();
+	void SubmitUpload(std::unique_ptr<CommandBuffer> &&commandBuffer, std::unique_ptr<Buffer> &&bufferStaging);
 
 	std::filesystem::path filename;
 	std::string fileSuffix;
@@ -118,5 +134,9 @@ private:
 	bool anisotropic;
 	bool mipmap;
 	uint32_t components = 0;
+
+	std::unique_ptr<CommandBuffer> uploadCommandBuffer;
+	std::unique_ptr<Buffer> uploadBufferStaging;
+	VkFence uploadFence = VK_NULL_HANDLE;
 };
 }
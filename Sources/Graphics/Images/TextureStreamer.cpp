@@ -0,0 +1,254 @@
+#include "TextureStreamer.hpp"
+
+#include <cmath>
+#include <queue>
+
+#include "Graphics/Buffers/Buffer.hpp"
+
+namespace acid {
+/// The time in seconds for the size a image was requested at to halve once it is no longer drawn.
+static constexpr float SIZE_HALF_LIFE = 0.5f;
+
+TextureStreamer::TextureStreamer() {
+	// The budget defaults to half of the largest device local heap.
+	const auto &memoryProperties = Graphics::Get()->GetPhysicalDevice()->GetMemoryProperties();
+
+	for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+		if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+			budget = std::max(budget, static_cast<std::size_t>(memoryProperties.memoryHeaps[i].size / 2));
+	}
+}
+
+TextureStreamer::~TextureStreamer() {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	Graphics::CheckVk(vkDeviceWaitIdle(*logicalDevice));
+
+	for (const auto &retiredImage : retired) {
+		vkDestroyImageView(*logicalDevice, retiredImage.view, nullptr);
+		vkFreeMemory(*logicalDevice, retiredImage.memory, nullptr);
+		vkDestroyImage(*logicalDevice, retiredImage.image, nullptr);
+	}
+}
+
+void TextureStreamer::Update() {
+	auto graphics = Graphics::Get();
+	auto logicalDevice = graphics->GetLogicalDevice();
+	auto frameCount = graphics->GetFrameCount();
+	auto decay = std::exp2(-Engine::Get()->GetDelta().AsSeconds() / SIZE_HALF_LIFE);
+
+	std::vector<std::shared_ptr<Image2d>> streamed;
+	streamed.reserve(images.size());
+	images.erase(std::remove_if(images.begin(), images.end(), [&](const std::weak_ptr<Image2d> &image) {
+		auto locked = image.lock();
+		if (!locked || !locked->stream)
+			return true;
+		streamed.emplace_back(std::move(locked));
+		return false;
+	}), images.end());
+
+	residentLength = 0;
+
+	for (const auto &image : streamed) {
+		FinishStep(*image, frameCount);
+
+		auto &stream = *image->stream;
+		stream.size = std::max(stream.requestedSize, stream.size * decay);
+		stream.requestedSize = 0.0f;
+		stream.targetLevel = GetTargetLevel(stream);
+		residentLength += GetLength(stream, stream.targetLevel);
+	}
+
+	// Images with the most texels per pixel lose the least detail, so they are given coarser levels first until the levels fit the budget.
+	auto texelsPerPixel = [](const Image2d::Stream &stream) {
+		if (stream.size <= 0.0f)
+			return std::numeric_limits<float>::infinity();
+		return static_cast<float>(stream.bitmap.GetLevels()[stream.targetLevel].size.Max()) / stream.size;
+	};
+
+	std::priority_queue<std::pair<float, Image2d *>> coarsen;
+	for (const auto &image : streamed) {
+		if (image->stream->targetLevel < image->stream->minLevel)
+			coarsen.emplace(texelsPerPixel(*image->stream), image.get());
+	}
+
+	while (residentLength > budget && !coarsen.empty()) {
+		auto image = coarsen.top().second;
+		auto &stream = *image->stream;
+		coarsen.pop();
+		residentLength -= GetLength(stream, stream.targetLevel) - GetLength(stream, stream.targetLevel + 1);
+		stream.targetLevel++;
+		if (stream.targetLevel < stream.minLevel)
+			coarsen.emplace(texelsPerPixel(stream), image);
+	}
+
+	// Images with the fewest texels per pixel in view are streamed first, only steps that move levels on the device run past the upload limit.
+	std::sort(streamed.begin(), streamed.end(), [](const std::shared_ptr<Image2d> &a, const std::shared_ptr<Image2d> &b) {
+		auto &streamA = *a->stream, &streamB = *b->stream;
+		return streamA.bitmap.GetLevels()[streamA.viewLevel].size.Max() * streamB.size < streamB.bitmap.GetLevels()[streamB.viewLevel].size.Max() * streamA.size;
+	});
+
+	std::size_t uploaded = 0;
+	for (const auto &image : streamed) {
+		if (image->stream->fence == VK_NULL_HANDLE)
+			uploaded += StartStep(*image, uploaded < uploadLimit);
+	}
+
+	// Allocations replaced before the frames in flight were submitted are finished once every swapchain image has been submitted again.
+	auto imageCount = graphics->GetSwapchain() ? graphics->GetSwapchain()->GetImageCount() : 0;
+	retired.erase(std::remove_if(retired.begin(), retired.end(), [&](const RetiredImage &retiredImage) {
+		if (imageCount != 0 && frameCount <= retiredImage.frame + imageCount)
+			return false;
+		vkDestroyImageView(*logicalDevice, retiredImage.view, nullptr);
+		vkFreeMemory(*logicalDevice, retiredImage.memory, nullptr);
+		vkDestroyImage(*logicalDevice, retiredImage.image, nullptr);
+		return true;
+	}), retired.end());
+}
+
+void TextureStreamer::Add(const std::shared_ptr<Image2d> &image) {
+	images.emplace_back(image);
+}
+
+uint32_t TextureStreamer::GetTargetLevel(const Image2d::Stream &stream) {
+	// Texels of levels finer than the size the image is drawn at would be smaller than a pixel.
+	if (stream.size <= 0.0f)
+		return stream.minLevel;
+
+	auto level = std::floor(std::log2(static_cast<float>(stream.bitmap.GetSize().Max()) / stream.size));
+	return std::min(static_cast<uint32_t>(std::max(level, 0.0f)), stream.minLevel);
+}
+
+std::size_t TextureStreamer::GetLength(const Image2d::Stream &stream, uint32_t level) {
+	// Levels are stored from the finest, so the levels from a level are the end of the bitmap.
+	if (level >= stream.bitmap.GetLevelCount())
+		return 0;
+	return stream.bitmap.GetLength() - stream.bitmap.GetLevels()[level].offset;
+}
+
+void TextureStreamer::FinishStep(Image2d &image, uint64_t frameCount) {
+	auto &stream = *image.stream;
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	if (stream.fence == VK_NULL_HANDLE || vkGetFenceStatus(*logicalDevice, stream.fence) != VK_SUCCESS)
+		return;
+
+	vkDestroyFence(*logicalDevice, stream.fence, nullptr);
+	stream.fence = VK_NULL_HANDLE;
+	stream.commandBuffer = nullptr;
+	stream.bufferStaging = nullptr;
+
+	auto &retiredImage = retired.emplace_back(RetiredImage{VK_NULL_HANDLE, VK_NULL_HANDLE, image.view, frameCount});
+
+	if (stream.pendingImage != VK_NULL_HANDLE) {
+		// The new allocation replaces the image, it holds every level that was seen through the view.
+		retiredImage.image = image.image;
+		retiredImage.memory = image.memory;
+		image.image = stream.pendingImage;
+		image.memory = stream.pendingMemory;
+		stream.pendingImage = VK_NULL_HANDLE;
+		stream.pendingMemory = VK_NULL_HANDLE;
+		stream.imageLevel = stream.pendingLevel;
+		stream.viewLevel = std::max(stream.viewLevel, stream.imageLevel);
+
+		const auto &size = stream.bitmap.GetLevels()[stream.imageLevel].size;
+		image.extent = {size.x, size.y, 1};
+		image.mipLevels = stream.bitmap.GetLevelCount() - stream.imageLevel;
+	} else {
+		stream.viewLevel = stream.pendingLevel;
+	}
+
+	Image::CreateImageView(image.image, image.view, VK_IMAGE_VIEW_TYPE_2D, image.format, VK_IMAGE_ASPECT_COLOR_BIT,
+		stream.bitmap.GetLevelCount() - stream.viewLevel, stream.viewLevel - stream.imageLevel, image.arrayLayers, 0);
+
+	// Descriptor sets with the old view are written again.
+	image.generation++;
+}
+
+std::size_t TextureStreamer::StartStep(Image2d &image, bool upload) {
+	auto &stream = *image.stream;
+
+	if (stream.targetLevel != stream.imageLevel) {
+		StartReallocate(image, stream.targetLevel);
+		return 0;
+	}
+
+	if (upload && stream.viewLevel > stream.targetLevel)
+		return StartUpload(image, stream.viewLevel - 1);
+
+	return 0;
+}
+
+void TextureStreamer::StartReallocate(Image2d &image, uint32_t level) {
+	auto &stream = *image.stream;
+	auto levelCount = stream.bitmap.GetLevelCount();
+	const auto &size = stream.bitmap.GetLevels()[level].size;
+
+	Image::CreateImage(stream.pendingImage, stream.pendingMemory, {size.x, size.y, 1}, image.format, image.samples, VK_IMAGE_TILING_OPTIMAL, image.usage,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, levelCount - level, image.arrayLayers, VK_IMAGE_TYPE_2D);
+	stream.pendingLevel = level;
+
+	// Levels that are not copied stay in the transfer layout until they are uploaded.
+	auto commandBuffer = std::make_unique<CommandBuffer>();
+	Image::TransitionImageLayout(*commandBuffer, stream.pendingImage, image.format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		VK_IMAGE_ASPECT_COLOR_BIT, levelCount - level, 0, image.arrayLayers, 0);
+
+	// Only the levels seen through the view have been uploaded, they are copied on the device.
+	auto copyLevel = std::max(level, stream.viewLevel);
+	auto copyCount = levelCount - copyLevel;
+
+	std::vector<VkImageCopy> regions;
+	regions.reserve(copyCount);
+	for (uint32_t i = copyLevel; i < levelCount; i++) {
+		const auto &levelSize = stream.bitmap.GetLevels()[i].size;
+		VkImageCopy region = {};
+		region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i - stream.imageLevel, 0, image.arrayLayers};
+		region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i - level, 0, image.arrayLayers};
+		region.extent = {levelSize.x, levelSize.y, 1};
+		regions.emplace_back(region);
+	}
+
+	Image::TransitionImageLayout(*commandBuffer, image.image, image.format, image.layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT,
+		copyCount, copyLevel - stream.imageLevel, image.arrayLayers, 0);
+	vkCmdCopyImage(*commandBuffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stream.pendingImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		static_cast<uint32_t>(regions.size()), regions.data());
+	Image::TransitionImageLayout(*commandBuffer, image.image, image.format, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.layout, VK_IMAGE_ASPECT_COLOR_BIT,
+		copyCount, copyLevel - stream.imageLevel, image.arrayLayers, 0);
+	Image::TransitionImageLayout(*commandBuffer, stream.pendingImage, image.format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, image.layout, VK_IMAGE_ASPECT_COLOR_BIT,
+		copyCount, copyLevel - level, image.arrayLayers, 0);
+
+	Submit(stream, std::move(commandBuffer));
+}
+
+std::size_t TextureStreamer::StartUpload(Image2d &image, uint32_t level) {
+	auto &stream = *image.stream;
+	const auto &bitmapLevel = stream.bitmap.GetLevels()[level];
+	auto length = bitmapLevel.layerLength * stream.bitmap.GetLayerCount();
+
+	stream.bufferStaging = std::make_unique<Buffer>(length, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stream.bitmap.GetData(level));
+	stream.pendingLevel = level;
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - stream.imageLevel, 0, image.arrayLayers};
+	region.imageExtent = {bitmapLevel.size.x, bitmapLevel.size.y, 1};
+
+	auto commandBuffer = std::make_unique<CommandBuffer>();
+	vkCmdCopyBufferToImage(*commandBuffer, stream.bufferStaging->GetBuffer(), image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	Image::TransitionImageLayout(*commandBuffer, image.image, image.format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, image.layout, VK_IMAGE_ASPECT_COLOR_BIT,
+		1, level - stream.imageLevel, image.arrayLayers, 0);
+
+	Submit(stream, std::move(commandBuffer));
+	return length;
+}
+
+void TextureStreamer::Submit(Image2d::Stream &stream, std::unique_ptr<CommandBuffer> &&commandBuffer) {
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	Graphics::CheckVk(vkCreateFence(*logicalDevice, &fenceCreateInfo, nullptr, &stream.fence));
+
+	commandBuffer->Submit(VK_NULL_HANDLE, VK_NULL_HANDLE, stream.fence);
+	stream.commandBuffer = std::move(commandBuffer);
+}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Engine/Engine.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Image2d.hpp"
+
+namespace acid {
+/**
+ * @brief Module that streams the levels of streamed 2D images in and out under a memory budget.
+ *
+ * Streamed images start with only their coarse levels resident. Each frame an image is given the finest level needed for the largest
+ * size it was requested to be drawn at, if the levels do not fit the budget the images with the most texels per pixel are given
+ * coarser levels first. A image is moved into a new allocation holding its new levels, the levels it already holds are copied on the
+ * device, then finer levels are uploaded one per step. The view of the image is clamped to the levels that have been uploaded, so
+ * levels still being written are never sampled. Steps are submitted with a fence and applied once they finish, the replaced
+ * allocations are destroyed once the frames that used them have finished.
+ */
+class ACID_EXPORT TextureStreamer : public Module::Registrar<TextureStreamer> {
+	inline static const bool Registered = Register(Stage::Post, Requires<Graphics>());
+public:
+	/// The largest size of the levels that are always resident.
+	static constexpr uint32_t MinResidentSize = 64;
+
+	TextureStreamer();
+	~TextureStreamer();
+
+	void Update() override;
+
+	/**
+	 * Adds a streamed image, it is streamed until it is destroyed. Images from Image2d::Create are added when they are created,
+	 * images constructed directly with streamed set must be added here.
+	 * @param image The image to stream.
+	 */
+	void Add(const std::shared_ptr<Image2d> &image);
+
+	/**
+	 * Gets the memory the levels of streamed images may use.
+	 * @return The budget in bytes.
+	 */
+	std::size_t GetBudget() const { return budget; }
+	void SetBudget(std::size_t budget) { this->budget = budget; }
+
+	/**
+	 * Gets the memory that may be uploaded each frame, at least one level is uploaded each frame.
+	 * @return The limit in bytes.
+	 */
+	std::size_t GetUploadLimit() const { return uploadLimit; }
+	void SetUploadLimit(std::size_t uploadLimit) { this->uploadLimit = uploadLimit; }
+
+	/**
+	 * Gets the memory used by the levels streamed images are streaming to, as of the last update.
+	 * @return The memory in bytes.
+	 */
+	std::size_t GetResidentLength() const { return residentLength; }
+
+private:
+	/**
+	 * @brief A allocation replaced by a step, destroyed once the frames that used it have finished.
+	 */
+	class RetiredImage {
+	public:
+		VkImage image;
+		VkDeviceMemory memory;
+		VkImageView view;
+		uint64_t frame;
+	};
+
+	static uint32_t GetTargetLevel(const Image2d::Stream &stream);
+	static std::size_t GetLength(const Image2d::Stream &stream, uint32_t level);
+
+	void FinishStep(Image2d &image, uint64_t frameCount);
+	std::size_t StartStep(Image2d &image, bool upload);
+	void StartReallocate(Image2d &image, uint32_t level);
+	std::size_t StartUpload(Image2d &image, uint32_t level);
+	void Submit(Image2d::Stream &stream, std::unique_ptr<CommandBuffer> &&commandBuffer);
+
+	std::vector<std::weak_ptr<Image2d>> images;
+	std::vector<RetiredImage> retired;
+	std::size_t budget = 0;
+	std::size_t uploadLimit = 16 * 1024 * 1024;
+	std::size_t residentLength = 0;
+};
+}
@@ -37,8 +37,9 @@ PipelineCompute::~PipelineCompute() {
 }
 
 void PipelineCompute::CmdRender(const CommandBuffer &commandBuffer, const Vector2ui &extent) const {
-	auto groupCountX = static_cast<uint32_t>(std::ceil(static_cast<float>(extent.x) / static_cast<float>(*shader->GetLocalSizes()[0])));
-	auto groupCountY = static_cast<uint32_t>(std::ceil(static_cast<float>(extent.y) / static_cast<float>(*shader->GetLocalSizes()[1])));
+	// Local sizes of one are not reflected.
+	auto groupCountX = static_cast<uint32_t>(std::ceil(static_cast<float>(extent.x) / static_cast<float>(shader->GetLocalSizes()[0].value_or(1))));
+	auto groupCountY = static_cast<uint32_t>(std::ceil(static_cast<float>(extent.y) / static_cast<float>(shader->GetLocalSizes()[1].value_or(1))));
 	vkCmdDispatch(commandBuffer, groupCountX, groupCountY, 1);
 }
 
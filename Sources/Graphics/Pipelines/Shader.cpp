@@ -17,39 +17,44 @@ namespace acid {
 class ShaderIncluder :
 	public glslang::TShader::Includer {
 public:
+	explicit ShaderIncluder(std::vector<std::filesystem::path> &includes) :
+		includes(includes) {
+	}
+
 	IncludeResult *includeLocal(const char *headerName, const char *includerName, size_t inclusionDepth) override {
 		auto directory = std::filesystem::path(includerName).parent_path();
-		auto fileLoaded = Files::Read(directory / headerName);
-
-		if (!fileLoaded) {
-			Log::Error("Shader Include could not be loaded: ", std::quoted(headerName), '\n');
-			return nullptr;
-		}
-
-		auto content = new char[fileLoaded->size()];
-		std::memcpy(content, fileLoaded->c_str(), fileLoaded->size());
-		return new IncludeResult(headerName, content, fileLoaded->size(), content);
+		return Include((directory / headerName).lexically_normal(), headerName);
 	}
 
 	IncludeResult *includeSystem(const char *headerName, const char *includerName, size_t inclusionDepth) override {
-		auto fileLoaded = Files::Read(headerName);
+		return Include(headerName, headerName);
+	}
+
+	void releaseInclude(IncludeResult *result) override {
+		if (result) {
+			delete[] static_cast<char *>(result->userData);
+			delete result;
+		}
+	}
+private:
+	IncludeResult *Include(const std::filesystem::path &filename, const char *headerName) {
+		auto fileLoaded = Files::Read(filename);
 
 		if (!fileLoaded) {
 			Log::Error("Shader Include could not be loaded: ", std::quoted(headerName), '\n');
 			return nullptr;
 		}
 
+		// Includes are recorded so the shader is reloaded when they change, the include is named by its path so nested includes are found relative to it.
+		if (std::find(includes.begin(), includes.end(), filename) == includes.end())
+			includes.emplace_back(filename);
+
 		auto content = new char[fileLoaded->size()];
 		std::memcpy(content, fileLoaded->c_str(), fileLoaded->size());
-		return new IncludeResult(headerName, content, fileLoaded->size(), content);
+		return new IncludeResult(filename.generic_string(), content, fileLoaded->size(), content);
 	}
 
-	void releaseInclude(IncludeResult *result) override {
-		if (result) {
-			delete[] static_cast<char *>(result->userData);
-			delete result;
-		}
-	}
+	std::vector<std::filesystem::path> &includes;
 };
 
 Shader::Shader() {
@@ -316,7 +321,7 @@ VkShaderModule Shader::CreateShaderModule(const std::filesystem::path &moduleNam
 	shader.setEnvClient(glslang::EShClientVulkan, defaultVersion);
 	shader.setEnvTarget(glslang::EShTargetSpv, volkGetInstanceVersion() >= VK_API_VERSION_1_1 ? glslang::EShTargetSpv_1_3 : glslang::EShTargetSpv_1_0);
 
-	ShaderIncluder includer;
+	ShaderIncluder includer(includes);
 
 	std::string str;
 
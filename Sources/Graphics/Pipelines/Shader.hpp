@@ -290,6 +290,8 @@ public:
 	void CreateReflection();
 
 	const std::filesystem::path &GetName() const { return stages.back(); }
+	const std::vector<std::filesystem::path> &GetStages() const { return stages; }
+	const std::vector<std::filesystem::path> &GetIncludes() const { return includes; }
 	uint32_t GetLastDescriptorBinding() const { return lastDescriptorBinding; }
 	const std::map<std::string, Uniform> &GetUniforms() const { return uniforms; };
 	const std::map<std::string, UniformBlock> &GetUniformBlocks() const { return uniformBlocks; };
@@ -311,6 +313,8 @@ private:
 	static int32_t ComputeSize(const glslang::TType *ttype);
 
 	std::vector<std::filesystem::path> stages;
+	/// Files included by the stages, found while preprocessing.
+	std::vector<std::filesystem::path> includes;
 	std::map<std::string, Uniform> uniforms;
 	std::map<std::string, UniformBlock> uniformBlocks;
 	std::map<std::string, Attribute> attributes;
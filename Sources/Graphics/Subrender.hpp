@@ -20,6 +20,12 @@ public:
 
 	virtual ~Subrender() = default;
 
+	/**
+	 * Runs before the renderpass of this subrenders stage begins, where compute and transfer commands can be recorded.
+	 * @param commandBuffer The command buffer to record commands into.
+	 */
+	virtual void PreRender(const CommandBuffer &commandBuffer) {}
+
 	/**
 	 * Runs the render pipeline in the current renderpass.
 	 * @param commandBuffer The command buffer to record render command into.
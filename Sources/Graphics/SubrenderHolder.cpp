@@ -28,4 +28,16 @@ void SubrenderHolder::RenderStage(const Pipeline::Stage &stage, const CommandBuf
 		}
 	}
 }
+
+void SubrenderHolder::PreRenderStage(uint32_t renderpass, const CommandBuffer &commandBuffer) {
+	for (const auto &[stageIndex, typeId] : stages) {
+		if (stageIndex.first.first != renderpass)
+			continue;
+
+		if (auto &subrender = subrenders[typeId]) {
+			if (subrender->IsEnabled())
+				subrender->PreRender(commandBuffer);
+		}
+	}
+}
 }
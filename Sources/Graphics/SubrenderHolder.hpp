@@ -81,6 +81,13 @@ private:
 	 */
 	void RenderStage(const Pipeline::Stage &stage, const CommandBuffer &commandBuffer);
 
+	/**
+	 * Iterates through all Subrenders in a renderpass, before the renderpass begins.
+	 * @param renderpass The renderpass index.
+	 * @param commandBuffer The command buffer to record commands into.
+	 */
+	void PreRenderStage(uint32_t renderpass, const CommandBuffer &commandBuffer);
+
 	/// List of all Subrenders.
 	std::unordered_map<TypeId, std::unique_ptr<Subrender>> subrenders;
 	/// List of subrender stages.
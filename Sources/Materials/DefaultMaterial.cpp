@@ -42,12 +42,30 @@ void DefaultMaterial::PushDescriptors(DescriptorsHandler &descriptorSet) {
 	descriptorSet.Push("samplerNormal", imageNormal);
 }
 
+bool DefaultMaterial::PushObject(std::array<Vector4f, 2> &values) const {
+	// Images are bound once for a batch, so only materials without images share one.
+	if (imageDiffuse || imageMaterial || imageNormal)
+		return false;
+
+	values[0] = {baseDiffuse.r, baseDiffuse.g, baseDiffuse.b, baseDiffuse.a};
+	values[1] = {metallic, roughness, static_cast<float>(ignoreFog), static_cast<float>(ignoreLighting)};
+	return true;
+}
+
+void DefaultMaterial::RequestImageSize(float screenSize) {
+	for (const auto &image : {imageDiffuse, imageMaterial, imageNormal}) {
+		if (image)
+			image->RequestSize(screenSize);
+	}
+}
+
 std::vector<Shader::Define> DefaultMaterial::GetDefines() const {
 	return {
 		{"DIFFUSE_MAPPING", String::To<int32_t>(imageDiffuse != nullptr)},
 		{"MATERIAL_MAPPING", String::To<int32_t>(imageMaterial != nullptr)},
 		{"NORMAL_MAPPING", String::To<int32_t>(imageNormal != nullptr)},
 		{"ANIMATED", String::To<int32_t>(animated)},
+		{"INDIRECT", "0"},
 		{"MAX_JOINTS", String::To(AnimatedMesh::MaxJoints)},
 		{"MAX_WEIGHTS", String::To(AnimatedMesh::MaxWeights)}
 	};
@@ -18,6 +18,8 @@ public:
 	void CreatePipeline(const Shader::VertexInput &vertexInput, bool animated) override;
 	void PushUniforms(UniformHandler &uniformObject, const Transform *transform) override;
 	void PushDescriptors(DescriptorsHandler &descriptorSet) override;
+	bool PushObject(std::array<Vector4f, 2> &values) const override;
+	void RequestImageSize(float screenSize) override;
 
 	const Colour &GetBaseDiffuse() const { return baseDiffuse; }
 	void SetBaseDiffuse(const Colour &baseDiffuse) { this->baseDiffuse = baseDiffuse; }
@@ -4,6 +4,7 @@
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
 #include "Maths/Transform.hpp"
+#include "Maths/Vector4.hpp"
 #include "MaterialPipeline.hpp"
 
 namespace acid {
@@ -31,6 +32,20 @@ public:
 	 */
 	virtual void PushDescriptors(DescriptorsHandler &descriptorSet) = 0;
 
+	/**
+	 * Used to write the values of one object when meshes are culled and drawn in batches on the GPU, see {@link MeshesSubrender::Culling}.
+	 * The materials shader is compiled with INDIRECT set, and reads the values from BufferObjects at gl_InstanceIndex instead of UniformObject.
+	 * @param values The values to write.
+	 * @return If this material can be batched, meshes with materials that can not are culled and drawn one at a time.
+	 */
+	virtual bool PushObject(std::array<Vector4f, 2> &values) const { return false; }
+
+	/**
+	 * Used to give the streamed images of this material the size they are drawn at, the finest level needed is streamed in.
+	 * @param screenSize The height in pixels the model is drawn at.
+	 */
+	virtual void RequestImageSize(float screenSize) {}
+
 	/**
 	 * Gets the material pipeline defined in this material.
 	 * @return The material pipeline.
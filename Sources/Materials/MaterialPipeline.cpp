@@ -42,6 +42,36 @@ bool MaterialPipeline::BindPipeline(const CommandBuffer &commandBuffer) {
 	return true;
 }
 
+std::vector<std::filesystem::path> MaterialPipeline::GetDependencies() const {
+	auto dependencies = pipelineCreate.GetShaderStages();
+
+	if (pipeline) {
+		const auto &includes = pipeline->GetShader()->GetIncludes();
+		dependencies.insert(dependencies.end(), includes.begin(), includes.end());
+	}
+
+	return dependencies;
+}
+
+std::shared_ptr<Resource> MaterialPipeline::Reload() const {
+	auto result = std::make_shared<MaterialPipeline>(pipelineStage, pipelineCreate);
+	result->renderStage = Graphics::Get()->GetRenderStage(pipelineStage.first);
+
+	// A pipeline that has no render stage yet is created from the changed files when it is first bound.
+	if (!result->renderStage)
+		return nullptr;
+
+	result->pipeline.reset(pipelineCreate.Create(pipelineStage));
+	return result;
+}
+
+void MaterialPipeline::Swap(Resource &reloaded) {
+	// The render stage is swapped with the pipeline, if the stage was recreated since the reload BindPipeline creates the pipeline again.
+	auto &other = dynamic_cast<MaterialPipeline &>(reloaded);
+	std::swap(renderStage, other.renderStage);
+	std::swap(pipeline, other.pipeline);
+}
+
 const Node &operator>>(const Node &node, MaterialPipeline &pipeline) {
 	node["renderpass"].Get(pipeline.pipelineStage.first);
 	node["subpass"].Get(pipeline.pipelineStage.second);
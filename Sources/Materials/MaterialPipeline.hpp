@@ -39,6 +39,9 @@ public:
 	bool BindPipeline(const CommandBuffer &commandBuffer);
 
 	std::type_index GetTypeIndex() const override { return typeid(MaterialPipeline); }
+	std::vector<std::filesystem::path> GetDependencies() const override;
+	std::shared_ptr<Resource> Reload() const override;
+	void Swap(Resource &reloaded) override;
 
 	const Pipeline::Stage &GetStage() const { return pipelineStage; }
 	const PipelineGraphicsCreate &GetPipelineCreate() const { return pipelineCreate; }
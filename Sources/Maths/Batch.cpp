@@ -0,0 +1,230 @@
+#include "Batch.hpp"
+
+#include "Physics/Frustum.hpp"
+#include "Simd.hpp"
+
+namespace acid {
+#if defined(ACID_SIMD_SSE)
+#define ACID_BATCH_FLOAT4 1
+using Float4 = __m128;
+
+static Float4 Load(const float *data) { return _mm_loadu_ps(data); }
+static Float4 Load3(const float *data) { return _mm_setr_ps(data[0], data[1], data[2], data[2]); }
+static void Store(float *data, Float4 a) { _mm_storeu_ps(data, a); }
+static Float4 Splat(float a) { return _mm_set1_ps(a); }
+static Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+static Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+static Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+static Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+static uint32_t LessEqual(Float4 a, Float4 b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(a, b))); }
+#elif defined(ACID_SIMD_NEON)
+#define ACID_BATCH_FLOAT4 1
+using Float4 = float32x4_t;
+
+static Float4 Load(const float *data) { return vld1q_f32(data); }
+static Float4 Load3(const float *data) {
+	float lanes[4] = {data[0], data[1], data[2], data[2]};
+	return vld1q_f32(lanes);
+}
+static void Store(float *data, Float4 a) { vst1q_f32(data, a); }
+static Float4 Splat(float a) { return vdupq_n_f32(a); }
+static Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+static Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+static Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+static Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+static uint32_t LessEqual(Float4 a, Float4 b) {
+	auto mask = vcleq_f32(a, b);
+	return (vgetq_lane_u32(mask, 0) & 1) | (vgetq_lane_u32(mask, 1) & 2) | (vgetq_lane_u32(mask, 2) & 4) | (vgetq_lane_u32(mask, 3) & 8);
+}
+#endif
+
+void Batch::Transform(const Matrix4 &matrix, const Vector3Soa &points, Vector3Soa &result) {
+	auto count = points.GetSize();
+	result.Resize(count);
+	std::size_t i = 0;
+
+#if defined(ACID_BATCH_FLOAT4)
+	Float4 columns[4][4];
+	for (uint32_t row = 0; row < 4; row++) {
+		for (uint32_t col = 0; col < 4; col++)
+			columns[row][col] = Splat(matrix.rows[row][col]);
+	}
+
+	for (; i + 4 <= count; i += 4) {
+		auto x = Load(&points.x[i]);
+		auto y = Load(&points.y[i]);
+		auto z = Load(&points.z[i]);
+
+		for (uint32_t col = 0; col < 3; col++) {
+			auto sum = Mul(columns[0][col], x);
+			sum = Add(sum, Mul(columns[1][col], y));
+			sum = Add(sum, Mul(columns[2][col], z));
+			sum = Add(sum, columns[3][col]);
+			Store(col == 0 ? &result.x[i] : col == 1 ? &result.y[i] : &result.z[i], sum);
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+		result.Set(i, Vector3f(matrix.Transform(Vector4f(points.Get(i)))));
+}
+
+void Batch::Multiply(const Matrix4 *left, const Matrix4 *right, Matrix4 *result, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++) {
+		// The AVX kernel in Matrix4 multiplies two rows per register, faster than four floats at a time.
+#if defined(ACID_BATCH_FLOAT4) && !defined(ACID_SIMD_AVX)
+		// Every row is found before any is stored, so the result may be either input.
+		Float4 rows[4] = {Load(&left[i].rows[0].x), Load(&left[i].rows[1].x), Load(&left[i].rows[2].x), Load(&left[i].rows[3].x)};
+		Float4 sums[4];
+
+		for (uint32_t row = 0; row < 4; row++) {
+			const auto &weights = right[i].rows[row];
+			sums[row] = Mul(Splat(weights.x), rows[0]);
+			sums[row] = Add(sums[row], Mul(Splat(weights.y), rows[1]));
+			sums[row] = Add(sums[row], Mul(Splat(weights.z), rows[2]));
+			sums[row] = Add(sums[row], Mul(Splat(weights.w), rows[3]));
+		}
+
+		for (uint32_t row = 0; row < 4; row++)
+			Store(&result[i].rows[row].x, sums[row]);
+#else
+		result[i] = left[i].Multiply(right[i]);
+#endif
+	}
+}
+
+void Batch::Extents(const Vector3Soa &points, Vector3f &min, Vector3f &max) {
+	auto count = points.GetSize();
+	min = Vector3f::Infinity;
+	max = -Vector3f::Infinity;
+	std::size_t i = 0;
+
+#if defined(ACID_BATCH_FLOAT4)
+	if (count >= 4) {
+		Float4 mins[3] = {Splat(min.x), Splat(min.y), Splat(min.z)};
+		Float4 maxs[3] = {Splat(max.x), Splat(max.y), Splat(max.z)};
+
+		for (; i + 4 <= count; i += 4) {
+			auto x = Load(&points.x[i]);
+			auto y = Load(&points.y[i]);
+			auto z = Load(&points.z[i]);
+			mins[0] = Min(mins[0], x);
+			mins[1] = Min(mins[1], y);
+			mins[2] = Min(mins[2], z);
+			maxs[0] = Max(maxs[0], x);
+			maxs[1] = Max(maxs[1], y);
+			maxs[2] = Max(maxs[2], z);
+		}
+
+		float lanes[4];
+		for (uint32_t component = 0; component < 3; component++) {
+			Store(lanes, mins[component]);
+			min[component] = std::min({lanes[0], lanes[1], lanes[2], lanes[3]});
+			Store(lanes, maxs[component]);
+			max[component] = std::max({lanes[0], lanes[1], lanes[2], lanes[3]});
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		auto point = points.Get(i);
+		min = min.Min(point);
+		max = max.Max(point);
+	}
+}
+
+void Batch::Extents(const Vector3f *points, std::size_t count, std::size_t stride, Vector3f &min, Vector3f &max) {
+	auto data = reinterpret_cast<const uint8_t *>(points);
+
+#if defined(ACID_BATCH_FLOAT4)
+	// Each register holds one point, the last lane repeats z so it never widens the box.
+	auto mins = Splat(std::numeric_limits<float>::infinity());
+	auto maxs = Splat(-std::numeric_limits<float>::infinity());
+
+	for (std::size_t i = 0; i < count; i++) {
+		auto point = Load3(&reinterpret_cast<const Vector3f *>(data + i * stride)->x);
+		mins = Min(mins, point);
+		maxs = Max(maxs, point);
+	}
+
+	float lanes[4];
+	Store(lanes, mins);
+	min = {lanes[0], lanes[1], lanes[2]};
+	Store(lanes, maxs);
+	max = {lanes[0], lanes[1], lanes[2]};
+#else
+	min = Vector3f::Infinity;
+	max = -Vector3f::Infinity;
+
+	for (std::size_t i = 0; i < count; i++) {
+		const auto &point = *reinterpret_cast<const Vector3f *>(data + i * stride);
+		min = min.Min(point);
+		max = max.Max(point);
+	}
+#endif
+}
+
+void Batch::SpheresInFrustum(const Frustum &frustum, const Vector3Soa &positions, const float *radii, uint8_t *contained) {
+	const auto &planes = frustum.GetPlanes();
+	auto count = positions.GetSize();
+	std::size_t i = 0;
+
+#if defined(ACID_BATCH_FLOAT4)
+	for (; i + 4 <= count; i += 4) {
+		auto x = Load(&positions.x[i]);
+		auto y = Load(&positions.y[i]);
+		auto z = Load(&positions.z[i]);
+		auto negativeRadii = Mul(Load(&radii[i]), Splat(-1.0f));
+		uint32_t outside = 0;
+
+		for (const auto &plane : planes) {
+			auto distance = Mul(Splat(plane[0]), x);
+			distance = Add(distance, Mul(Splat(plane[1]), y));
+			distance = Add(distance, Mul(Splat(plane[2]), z));
+			distance = Add(distance, Splat(plane[3]));
+			outside |= LessEqual(distance, negativeRadii);
+		}
+
+		for (uint32_t lane = 0; lane < 4; lane++)
+			contained[i + lane] = (outside >> lane & 1) == 0;
+	}
+#endif
+
+	for (; i < count; i++)
+		contained[i] = frustum.SphereInFrustum(positions.Get(i), radii[i]);
+}
+
+void Batch::CubesInFrustum(const Frustum &frustum, const Vector3Soa &mins, const Vector3Soa &maxs, uint8_t *contained) {
+	const auto &planes = frustum.GetPlanes();
+	auto count = mins.GetSize();
+	std::size_t i = 0;
+
+#if defined(ACID_BATCH_FLOAT4)
+	// A cube is outside a plane when the corner furthest along the planes normal is, that corner takes the larger product on each axis.
+	for (; i + 4 <= count; i += 4) {
+		auto minX = Load(&mins.x[i]);
+		auto minY = Load(&mins.y[i]);
+		auto minZ = Load(&mins.z[i]);
+		auto maxX = Load(&maxs.x[i]);
+		auto maxY = Load(&maxs.y[i]);
+		auto maxZ = Load(&maxs.z[i]);
+		uint32_t outside = 0;
+
+		for (const auto &plane : planes) {
+			auto a = Splat(plane[0]), b = Splat(plane[1]), c = Splat(plane[2]);
+			auto distance = Max(Mul(a, minX), Mul(a, maxX));
+			distance = Add(distance, Max(Mul(b, minY), Mul(b, maxY)));
+			distance = Add(distance, Max(Mul(c, minZ), Mul(c, maxZ)));
+			distance = Add(distance, Splat(plane[3]));
+			outside |= LessEqual(distance, Splat(0.0f));
+		}
+
+		for (uint32_t lane = 0; lane < 4; lane++)
+			contained[i + lane] = (outside >> lane & 1) == 0;
+	}
+#endif
+
+	for (; i < count; i++)
+		contained[i] = frustum.CubeInFrustum(mins.Get(i), maxs.Get(i));
+}
+}
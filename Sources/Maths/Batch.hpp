@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Matrix4.hpp"
+#include "Vector3Soa.hpp"
+
+namespace acid {
+class Frustum;
+
+/**
+ * @brief Class that runs maths over many elements at once, the inner loops work on several elements per vector register.
+ *
+ * Points are read from {@link Vector3Soa} arrays so each register holds one component of consecutive points, the remainder that does not
+ * fill a register is run one element at a time. Results may be written over the inputs they are computed from.
+ */
+class ACID_EXPORT Batch {
+public:
+	/**
+	 * Transforms points by a matrix, as {@link Matrix4#Transform} with a w of one.
+	 * @param matrix The matrix to transform by.
+	 * @param points The points to transform.
+	 * @param result The transformed points, resized to the number of points.
+	 */
+	static void Transform(const Matrix4 &matrix, const Vector3Soa &points, Vector3Soa &result);
+
+	/**
+	 * Multiplies pairs of matrices, as {@link Matrix4#Multiply}.
+	 * @param left The matrices multiplied.
+	 * @param right The matrices multiplied by.
+	 * @param result The resultant matrices.
+	 * @param count The number of pairs.
+	 */
+	static void Multiply(const Matrix4 *left, const Matrix4 *right, Matrix4 *result, std::size_t count);
+
+	/**
+	 * Finds the bounding box of points.
+	 * @param points The points.
+	 * @param min The minimum of the points, infinity when there are none.
+	 * @param max The maximum of the points, negative infinity when there are none.
+	 */
+	static void Extents(const Vector3Soa &points, Vector3f &min, Vector3f &max);
+
+	/**
+	 * Finds the bounding box of points held in an array of structures, such as the positions of vertices.
+	 * @param points The first point.
+	 * @param count The number of points.
+	 * @param stride The number of bytes from one point to the next.
+	 * @param min The minimum of the points, infinity when there are none.
+	 * @param max The maximum of the points, negative infinity when there are none.
+	 */
+	static void Extents(const Vector3f *points, std::size_t count, std::size_t stride, Vector3f &min, Vector3f &max);
+
+	/**
+	 * Gets if spheres are contained in a frustum, as {@link Frustum#SphereInFrustum}.
+	 * @param frustum The frustum.
+	 * @param positions The spheres positions.
+	 * @param radii The spheres radii.
+	 * @param contained If each sphere is contained, one byte for each sphere.
+	 */
+	static void SpheresInFrustum(const Frustum &frustum, const Vector3Soa &positions, const float *radii, uint8_t *contained);
+
+	/**
+	 * Gets if cubes are contained in a frustum, as {@link Frustum#CubeInFrustum}.
+	 * @param frustum The frustum.
+	 * @param mins The cubes min points.
+	 * @param maxs The cubes max points.
+	 * @param contained If each cube is contained, one byte for each cube.
+	 */
+	static void CubesInFrustum(const Frustum &frustum, const Vector3Soa &mins, const Vector3Soa &maxs, uint8_t *contained);
+};
+}
@@ -1,19 +1,14 @@
 #include "Maths.hpp"
 
-#include <random>
+#include "Random.hpp"
 
 namespace acid {
-static std::random_device RandomDevice;
-static std::mt19937 RandomGenerator(RandomDevice());
-
 float Maths::Random(float min, float max) {
-	std::uniform_real_distribution<float> dist(min, max);
-	return dist(RandomGenerator);
+	return acid::Random::Get().Uniform(min, max);
 }
 
 float Maths::RandomNormal(float standardDeviation, float mean) {
-	std::normal_distribution<float> dist(mean, standardDeviation);
-	return dist(RandomGenerator);
+	return acid::Random::Get().Normal(standardDeviation, mean);
 }
 
 float Maths::RandomLog(float min, float max) {
@@ -19,7 +19,7 @@ public:
 	Maths() = delete;
 
 	/**
-	 * Generates a random value from between a range.
+	 * Generates a random value from between a range, using the calling threads {@link Random} generator.
 	 * @param min The min value.
 	 * @param max The max value.
 	 * @return The randomly selected value within the range.
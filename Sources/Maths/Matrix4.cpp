@@ -5,8 +5,28 @@
 
 #include "Matrix2.hpp"
 #include "Matrix3.hpp"
+#include "Simd.hpp"
 
 namespace acid {
+#if defined(ACID_SIMD_SSE)
+static __m128 Swizzle(__m128 a, int imm) {
+	return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(a), imm));
+}
+
+// Row major 2x2 matrices held in one register, used by the block inverse.
+static __m128 Matrix2Multiply(__m128 a, __m128 b) {
+	return _mm_add_ps(_mm_mul_ps(a, Swizzle(b, _MM_SHUFFLE(3, 0, 3, 0))), _mm_mul_ps(Swizzle(a, _MM_SHUFFLE(2, 3, 0, 1)), Swizzle(b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+static __m128 Matrix2AdjugateMultiply(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(Swizzle(a, _MM_SHUFFLE(0, 0, 3, 3)), b), _mm_mul_ps(Swizzle(a, _MM_SHUFFLE(2, 2, 1, 1)), Swizzle(b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+static __m128 Matrix2MultiplyAdjugate(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(a, Swizzle(b, _MM_SHUFFLE(0, 3, 0, 3))), _mm_mul_ps(Swizzle(a, _MM_SHUFFLE(2, 3, 0, 1)), Swizzle(b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+#endif
+
 Matrix4::Matrix4(float diagonal) {
 	std::memset(rows, 0, 4 * sizeof(Vector4f));
 	rows[0][0] = diagonal;
@@ -63,11 +83,55 @@ Matrix4 Matrix4::Subtract(const Matrix4 &other) const {
 Matrix4 Matrix4::Multiply(const Matrix4 &other) const {
 	Matrix4 result;
 
+	// Each row of the result is the rows of this matrix weighted by a row of the other matrix.
+#if defined(ACID_SIMD_AVX)
+	auto row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rows[0]));
+	auto row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rows[1]));
+	auto row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rows[2]));
+	auto row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&rows[3]));
+
+	for (uint32_t row = 0; row < 4; row += 2) {
+		auto weights = _mm256_loadu_ps(&other[row][0]);
+		auto sum = _mm256_mul_ps(_mm256_permute_ps(weights, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(weights, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(weights, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(weights, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+		_mm256_storeu_ps(&result[row][0], sum);
+	}
+#elif defined(ACID_SIMD_SSE)
+	auto row0 = _mm_load_ps(&rows[0][0]);
+	auto row1 = _mm_load_ps(&rows[1][0]);
+	auto row2 = _mm_load_ps(&rows[2][0]);
+	auto row3 = _mm_load_ps(&rows[3][0]);
+
+	for (uint32_t row = 0; row < 4; row++) {
+		auto weights = _mm_load_ps(&other[row][0]);
+		auto sum = _mm_mul_ps(Swizzle(weights, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+		sum = _mm_add_ps(sum, _mm_mul_ps(Swizzle(weights, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+		sum = _mm_add_ps(sum, _mm_mul_ps(Swizzle(weights, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+		sum = _mm_add_ps(sum, _mm_mul_ps(Swizzle(weights, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+		_mm_store_ps(&result[row][0], sum);
+	}
+#elif defined(ACID_SIMD_NEON)
+	auto row0 = vld1q_f32(&rows[0][0]);
+	auto row1 = vld1q_f32(&rows[1][0]);
+	auto row2 = vld1q_f32(&rows[2][0]);
+	auto row3 = vld1q_f32(&rows[3][0]);
+
+	for (uint32_t row = 0; row < 4; row++) {
+		auto sum = vmulq_n_f32(row0, other[row][0]);
+		sum = vmlaq_n_f32(sum, row1, other[row][1]);
+		sum = vmlaq_n_f32(sum, row2, other[row][2]);
+		sum = vmlaq_n_f32(sum, row3, other[row][3]);
+		vst1q_f32(&result[row][0], sum);
+	}
+#else
 	for (uint32_t row = 0; row < 4; row++) {
 		for (uint32_t col = 0; col < 4; col++) {
 			result[row][col] = rows[0][col] * other[row][0] + rows[1][col] * other[row][1] + rows[2][col] * other[row][2] + rows[3][col] * other[row][3];
 		}
 	}
+#endif
 
 	return result;
 }
@@ -75,9 +139,23 @@ Matrix4 Matrix4::Multiply(const Matrix4 &other) const {
 Vector4f Matrix4::Multiply(const Vector4f &other) const {
 	Vector4f result;
 
+#if defined(ACID_SIMD_SSE)
+	auto sum = _mm_mul_ps(_mm_set1_ps(other.x), _mm_load_ps(&rows[0][0]));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(other.y), _mm_load_ps(&rows[1][0])));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(other.z), _mm_load_ps(&rows[2][0])));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(other.w), _mm_load_ps(&rows[3][0])));
+	_mm_storeu_ps(&result[0], sum);
+#elif defined(ACID_SIMD_NEON)
+	auto sum = vmulq_n_f32(vld1q_f32(&rows[0][0]), other.x);
+	sum = vmlaq_n_f32(sum, vld1q_f32(&rows[1][0]), other.y);
+	sum = vmlaq_n_f32(sum, vld1q_f32(&rows[2][0]), other.z);
+	sum = vmlaq_n_f32(sum, vld1q_f32(&rows[3][0]), other.w);
+	vst1q_f32(&result[0], sum);
+#else
 	for (uint32_t row = 0; row < 4; row++) {
 		result[row] = rows[0][row] * other.x + rows[1][row] * other.y + rows[2][row] * other.z + rows[3][row] * other.w;
 	}
+#endif
 
 	return result;
 }
@@ -95,13 +173,7 @@ Matrix4 Matrix4::Divide(const Matrix4 &other) const {
 }
 
 Vector4f Matrix4::Transform(const Vector4f &other) const {
-	Vector4f result;
-
-	for (uint32_t row = 0; row < 4; row++) {
-		result[row] = rows[0][row] * other.x + rows[1][row] * other.y + rows[2][row] * other.z + rows[3][row] * other.w;
-	}
-
-	return result;
+	return Multiply(other);
 }
 
 Matrix4 Matrix4::Translate(const Vector2f &other) const {
@@ -198,6 +270,55 @@ Matrix4 Matrix4::Negate() const {
 Matrix4 Matrix4::Inverse() const {
 	Matrix4 result;
 
+#if defined(ACID_SIMD_SSE)
+	// Inverts by 2x2 blocks, the inverse of the transpose is the transpose of the inverse so this works in either order.
+	auto row0 = _mm_load_ps(&rows[0][0]);
+	auto row1 = _mm_load_ps(&rows[1][0]);
+	auto row2 = _mm_load_ps(&rows[2][0]);
+	auto row3 = _mm_load_ps(&rows[3][0]);
+
+	auto a = _mm_movelh_ps(row0, row1);
+	auto b = _mm_movehl_ps(row1, row0);
+	auto c = _mm_movelh_ps(row2, row3);
+	auto d = _mm_movehl_ps(row3, row2);
+
+	// The determinants of the blocks (|A|, |B|, |C|, |D|).
+	auto detSub = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+		_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))));
+	auto detA = Swizzle(detSub, _MM_SHUFFLE(0, 0, 0, 0));
+	auto detB = Swizzle(detSub, _MM_SHUFFLE(1, 1, 1, 1));
+	auto detC = Swizzle(detSub, _MM_SHUFFLE(2, 2, 2, 2));
+	auto detD = Swizzle(detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+	auto dc = Matrix2AdjugateMultiply(d, c);
+	auto ab = Matrix2AdjugateMultiply(a, b);
+	auto x = _mm_sub_ps(_mm_mul_ps(detD, a), Matrix2Multiply(b, dc));
+	auto w = _mm_sub_ps(_mm_mul_ps(detA, d), Matrix2Multiply(c, ab));
+	auto y = _mm_sub_ps(_mm_mul_ps(detB, c), Matrix2MultiplyAdjugate(d, ab));
+	auto z = _mm_sub_ps(_mm_mul_ps(detC, b), Matrix2MultiplyAdjugate(a, dc));
+
+	// |M| = |A||D| + |B||C| - tr((A#B)(D#C)).
+	auto trace = _mm_mul_ps(ab, Swizzle(dc, _MM_SHUFFLE(3, 1, 2, 0)));
+	trace = _mm_add_ps(trace, Swizzle(trace, _MM_SHUFFLE(2, 3, 0, 1)));
+	trace = _mm_add_ps(trace, Swizzle(trace, _MM_SHUFFLE(1, 0, 3, 2)));
+	auto det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+	if (_mm_cvtss_f32(det) == 0.0f) {
+		throw std::runtime_error("Can't invert a matrix with a determinant of zero");
+	}
+
+	auto invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps(x, invDet);
+	y = _mm_mul_ps(y, invDet);
+	z = _mm_mul_ps(z, invDet);
+	w = _mm_mul_ps(w, invDet);
+
+	// Takes the adjugate of each block while storing the rows.
+	_mm_store_ps(&result[0][0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_store_ps(&result[1][0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+	_mm_store_ps(&result[2][0], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_store_ps(&result[3][0], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+#else
 	auto det = Determinant();
 
 	if (det == 0.0f) {
@@ -217,6 +338,7 @@ Matrix4 Matrix4::Inverse() const {
 			result[i][j] = cofactor / det;
 		}
 	}
+#endif
 
 	return result;
 }
@@ -224,11 +346,23 @@ Matrix4 Matrix4::Inverse() const {
 Matrix4 Matrix4::Transpose() const {
 	Matrix4 result;
 
+#if defined(ACID_SIMD_SSE)
+	auto row0 = _mm_load_ps(&rows[0][0]);
+	auto row1 = _mm_load_ps(&rows[1][0]);
+	auto row2 = _mm_load_ps(&rows[2][0]);
+	auto row3 = _mm_load_ps(&rows[3][0]);
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+	_mm_store_ps(&result[0][0], row0);
+	_mm_store_ps(&result[1][0], row1);
+	_mm_store_ps(&result[2][0], row2);
+	_mm_store_ps(&result[3][0], row3);
+#else
 	for (uint32_t row = 0; row < 4; row++) {
 		for (uint32_t col = 0; col < 4; col++) {
 			result[row][col] = rows[col][row];
 		}
 	}
+#endif
 
 	return result;
 }
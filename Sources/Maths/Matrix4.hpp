@@ -9,7 +9,7 @@ class Matrix2;
 class Matrix3;
 
 /**
- * @brief Holds a row major 4x4 matrix.
+ * @brief Holds a row major 4x4 matrix, the rows are 16 byte aligned so they load directly into vector registers.
  */
 class ACID_EXPORT Matrix4 {
 public:
@@ -272,7 +272,7 @@ public:
 	friend Node &operator<<(Node &node, const Matrix4 &matrix);
 	friend std::ostream &operator<<(std::ostream &stream, const Matrix4 &matrix);
 
-	Vector4f rows[4];
+	alignas(16) Vector4f rows[4];
 };
 }
 
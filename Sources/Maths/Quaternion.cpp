@@ -1,5 +1,7 @@
 #include "Quaternion.hpp"
 
+#include "Simd.hpp"
+
 namespace acid {
 const Quaternion Quaternion::Zero(0.0f, 0.0f, 0.0f, 0.0f);
 const Quaternion Quaternion::One(1.0f, 1.0f, 1.0f, 1.0f);
@@ -248,12 +250,28 @@ Quaternion operator-(const Quaternion &lhs, const Quaternion &rhs) {
 }
 
 Quaternion operator*(const Quaternion &lhs, const Quaternion &rhs) {
+#if defined(ACID_SIMD_SSE)
+	// The product is lhs.w * rhs plus three shuffled products of lhs.xyz, the w lane of the first two is negated.
+	auto l = _mm_loadu_ps(&lhs.x);
+	auto r = _mm_loadu_ps(&rhs.x);
+	auto negateW = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, static_cast<int32_t>(0x80000000)));
+
+	auto result = _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(3, 3, 3, 3)), r);
+	result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 3, 3, 3))), negateW));
+	result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 0, 2))), negateW));
+	result = _mm_sub_ps(result, _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 0, 2, 1))));
+
+	Quaternion quaternion;
+	_mm_storeu_ps(&quaternion.x, result);
+	return quaternion;
+#else
 	return {
 		lhs.x * rhs.w + lhs.w * rhs.x + lhs.y * rhs.z - lhs.z * rhs.y,
 		lhs.y * rhs.w + lhs.w * rhs.y + lhs.z * rhs.x - lhs.x * rhs.z,
 		lhs.z * rhs.w + lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x,
 		lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z
 	};
+#endif
 }
 
 Vector3f operator*(const Vector3f &lhs, const Quaternion &rhs) {
@@ -0,0 +1,102 @@
+#include "Random.hpp"
+
+#include <atomic>
+#include <random>
+
+#include "Maths.hpp"
+
+namespace acid {
+static std::atomic<uint64_t> &Streams() {
+	static std::atomic<uint64_t> streams(static_cast<uint64_t>(std::random_device()()) << 32 | std::random_device()());
+	return streams;
+}
+
+static uint64_t SplitMix(uint64_t &x) {
+	auto z = x += 0x9E3779B97F4A7C15;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+	return z ^ (z >> 31);
+}
+
+Random::Random() {
+	Seed(Streams().fetch_add(1));
+}
+
+Random::Random(uint64_t seed) {
+	Seed(seed);
+}
+
+Random &Random::Get() {
+	thread_local Random random;
+	return random;
+}
+
+void Random::Reseed(uint64_t seed) {
+	// Gets the generator first, creating it would take a seed from the counter.
+	auto &random = Get();
+	Streams() = seed;
+	random.Seed(Streams().fetch_add(1));
+}
+
+void Random::Seed(uint64_t seed) {
+	auto a = SplitMix(seed);
+	auto b = SplitMix(seed);
+	state = {static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32), static_cast<uint32_t>(b), static_cast<uint32_t>(b >> 32)};
+}
+
+float Random::Normal(float standardDeviation, float mean) {
+	// The uniform in (0, 1] keeps the logarithm finite.
+	auto radius = std::sqrt(-2.0f * std::log(1.0f - Uniform()));
+	return mean + standardDeviation * radius * std::cos(2.0f * Maths::PI<float> * Uniform());
+}
+
+Vector3f Random::UnitVector() {
+	auto theta = Uniform(0.0f, 2.0f * Maths::PI<float>);
+	auto z = Uniform(-1.0f, 1.0f);
+	auto rootOneMinusZSquared = std::sqrt(1.0f - z * z);
+	return {rootOneMinusZSquared * std::cos(theta), rootOneMinusZSquared * std::sin(theta), z};
+}
+
+Vector3f Random::ConeDirection(const Vector3f &direction, float angle) {
+	Vector3f result;
+	ConeDirections(direction, angle, &result, 1);
+	return result;
+}
+
+void Random::Uniform(float *values, std::size_t count, float min, float max) {
+	for (std::size_t i = 0; i < count; i++)
+		values[i] = Uniform(min, max);
+}
+
+void Random::Normal(float *values, std::size_t count, float standardDeviation, float mean) {
+	for (std::size_t i = 0; i < count; i += 2) {
+		auto radius = standardDeviation * std::sqrt(-2.0f * std::log(1.0f - Uniform()));
+		auto theta = 2.0f * Maths::PI<float> * Uniform();
+		values[i] = mean + radius * std::cos(theta);
+
+		if (i + 1 < count)
+			values[i + 1] = mean + radius * std::sin(theta);
+	}
+}
+
+void Random::UnitVectors(Vector3f *vectors, std::size_t count) {
+	for (std::size_t i = 0; i < count; i++)
+		vectors[i] = UnitVector();
+}
+
+void Random::ConeDirections(const Vector3f &direction, float angle, Vector3f *vectors, std::size_t count) {
+	// Any axis not parallel to the direction gives the two perpendiculars the cone is generated around.
+	auto other = std::abs(direction.y) < 0.99f ? Vector3f::Up : Vector3f::Right;
+	auto tangent = other.Cross(direction).Normalize();
+	auto bitangent = direction.Cross(tangent);
+	auto cosAngle = std::cos(angle);
+
+	for (std::size_t i = 0; i < count; i++) {
+		// Heights on the axis are uniform over the spherical cap, so the directions are uniform over its area.
+		auto theta = Uniform(0.0f, 2.0f * Maths::PI<float>);
+		auto z = Uniform(cosAngle, 1.0f);
+		auto rootOneMinusZSquared = std::sqrt(std::max(1.0f - z * z, 0.0f));
+		vectors[i] = tangent * (rootOneMinusZSquared * std::cos(theta)) + bitangent * (rootOneMinusZSquared * std::sin(theta)) + direction * z;
+	}
+}
+}
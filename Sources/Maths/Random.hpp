@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+
+#include "Vector3.hpp"
+
+namespace acid {
+/**
+ * @brief Class that generates pseudo random numbers with xoshiro128**, small and fast enough to keep one on every thread.
+ *
+ * Generators that are not given a seed take the next seed from a shared counter, reseeding that counter with
+ * {@link Random#Reseed} makes every generator created after it repeat the same values, so a run can be replayed.
+ */
+class ACID_EXPORT Random {
+public:
+	/**
+	 * Constructor for Random, seeded from the next seed of the shared counter.
+	 */
+	Random();
+
+	/**
+	 * Constructor for Random.
+	 * @param seed The seed, the same seed always generates the same values.
+	 */
+	explicit Random(uint64_t seed);
+
+	/**
+	 * Gets the generator for the calling thread, it must not be shared with other threads.
+	 * @return The calling threads generator.
+	 */
+	static Random &Get();
+
+	/**
+	 * Sets the shared seed counter and reseeds the calling threads generator from it.
+	 * @param seed The seed to replay from.
+	 */
+	static void Reseed(uint64_t seed);
+
+	/**
+	 * Restarts the generator from a seed.
+	 * @param seed The seed, expanded with SplitMix64 into the generators state.
+	 */
+	void Seed(uint64_t seed);
+
+	/**
+	 * Generates the next 32 random bits.
+	 * @return The random bits.
+	 */
+	uint32_t Next() {
+		auto result = RotateLeft(state[1] * 5, 7) * 9;
+		auto t = state[1] << 9;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = RotateLeft(state[3], 11);
+		return result;
+	}
+
+	/**
+	 * Generates a value from a uniform distribution.
+	 * @param min The min value.
+	 * @param max The max value.
+	 * @return The randomly selected value within the range.
+	 */
+	float Uniform(float min = 0.0f, float max = 1.0f) {
+		// The top 24 bits fill the float mantissa exactly, giving a value in [0, 1).
+		return min + static_cast<float>(Next() >> 8) * 0x1.0p-24f * (max - min);
+	}
+
+	/**
+	 * Generates an index in a range without bias from the modulus.
+	 * @param count The number of indices, must be greater than zero.
+	 * @return The randomly selected index, less than count.
+	 */
+	uint32_t Index(uint32_t count) {
+		return static_cast<uint32_t>((static_cast<uint64_t>(Next()) * count) >> 32);
+	}
+
+	/**
+	 * Generates a value from a normal distribution, using Box-Muller.
+	 * @param standardDeviation The standards deviation of the distribution.
+	 * @param mean The mean of the distribution.
+	 * @return A normally distributed value.
+	 */
+	float Normal(float standardDeviation = 1.0f, float mean = 0.0f);
+
+	/**
+	 * Generates a direction uniformly over the unit sphere.
+	 * @return The random unit vector.
+	 */
+	Vector3f UnitVector();
+
+	/**
+	 * Generates a direction uniformly within a cone.
+	 * @param direction The cones axis, a unit vector.
+	 * @param angle The angle from the axis to the cones edge, in radians.
+	 * @return The random unit vector.
+	 */
+	Vector3f ConeDirection(const Vector3f &direction, float angle);
+
+	/**
+	 * Fills values from a uniform distribution.
+	 * @param values The values to fill.
+	 * @param count The number of values.
+	 * @param min The min value.
+	 * @param max The max value.
+	 */
+	void Uniform(float *values, std::size_t count, float min = 0.0f, float max = 1.0f);
+
+	/**
+	 * Fills values from a normal distribution, each Box-Muller step fills two values.
+	 * @param values The values to fill.
+	 * @param count The number of values.
+	 * @param standardDeviation The standards deviation of the distribution.
+	 * @param mean The mean of the distribution.
+	 */
+	void Normal(float *values, std::size_t count, float standardDeviation = 1.0f, float mean = 0.0f);
+
+	/**
+	 * Fills directions uniformly over the unit sphere.
+	 * @param vectors The vectors to fill.
+	 * @param count The number of vectors.
+	 */
+	void UnitVectors(Vector3f *vectors, std::size_t count);
+
+	/**
+	 * Fills directions uniformly within a cone, the basis around the axis is found once for every direction.
+	 * @param direction The cones axis, a unit vector.
+	 * @param angle The angle from the axis to the cones edge, in radians.
+	 * @param vectors The vectors to fill.
+	 * @param count The number of vectors.
+	 */
+	void ConeDirections(const Vector3f &direction, float angle, Vector3f *vectors, std::size_t count);
+
+private:
+	static constexpr uint32_t RotateLeft(uint32_t x, int k) {
+		return (x << k) | (x >> (32 - k));
+	}
+
+	std::array<uint32_t, 4> state;
+};
+}
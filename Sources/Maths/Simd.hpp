@@ -0,0 +1,17 @@
+#pragma once
+
+// Selects the vector instruction set the maths kernels are built with, defining ACID_NO_SIMD builds the scalar reference kernels.
+#if !defined(ACID_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ACID_SIMD_SSE 1
+#if defined(__AVX__)
+#define ACID_SIMD_AVX 1
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define ACID_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
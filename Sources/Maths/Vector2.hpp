@@ -203,7 +203,7 @@ public:
 	 * @return The lowest vector.
 	 */
 	template<typename K>
-	constexpr auto Min(const Vector2<K> &other);
+	constexpr auto Min(const Vector2<K> &other) const;
 
 	/**
 	 * Gets the maximum vector size between this vector and other.
@@ -212,7 +212,7 @@ public:
 	 * @return The maximum vector.
 	 */
 	template<typename K>
-	constexpr auto Max(const Vector2<K> &other);
+	constexpr auto Max(const Vector2<K> &other) const;
 
 	/**
 	 * Gets the distance between this vector and another vector.
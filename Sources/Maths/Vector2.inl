@@ -153,14 +153,14 @@ constexpr auto Vector2<T>::MinMax() const {
 
 template<typename T>
 template<typename K>
-constexpr auto Vector2<T>::Min(const Vector2<K> &other) {
+constexpr auto Vector2<T>::Min(const Vector2<K> &other) const {
 	using THighestP = decltype(x + other.x);
 	return Vector2<THighestP>(std::min<THighestP>(x, other.x), std::min<THighestP>(y, other.y));
 }
 
 template<typename T>
 template<typename K>
-constexpr auto Vector2<T>::Max(const Vector2<K> &other) {
+constexpr auto Vector2<T>::Max(const Vector2<K> &other) const {
 	using THighestP = decltype(x + other.x);
 	return Vector2<THighestP>(std::max<THighestP>(x, other.x), std::max<THighestP>(y, other.y));
 }
@@ -166,14 +166,14 @@ constexpr auto Vector3<T>::MinMax() const {
 
 template<typename T>
 template<typename K>
-constexpr auto Vector3<T>::Min(const Vector3<K> &other) {
+constexpr auto Vector3<T>::Min(const Vector3<K> &other) const {
 	using THighestP = decltype(x + other.x);
 	return Vector3<THighestP>(std::min<THighestP>(x, other.x), std::min<THighestP>(y, other.y), std::min<THighestP>(z, other.z));
 }
 
 template<typename T>
 template<typename K>
-constexpr auto Vector3<T>::Max(const Vector3<K> &other) {
+constexpr auto Vector3<T>::Max(const Vector3<K> &other) const {
 	using THighestP = decltype(x + other.x);
 	return Vector3<THighestP>(std::max<THighestP>(x, other.x), std::max<THighestP>(y, other.y), std::max<THighestP>(z, other.z));
 }
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include "Vector3.hpp"
+
+namespace acid {
+/**
+ * @brief Holds 3D vectors as an array of each component, so batch kernels load consecutive vectors into one register.
+ */
+class ACID_EXPORT Vector3Soa {
+public:
+	Vector3Soa() = default;
+
+	/**
+	 * Constructor for Vector3Soa.
+	 * @param size The number of vectors, each is zero.
+	 */
+	explicit Vector3Soa(std::size_t size) :
+		x(size),
+		y(size),
+		z(size) {
+	}
+
+	std::size_t GetSize() const { return x.size(); }
+	void Resize(std::size_t size) {
+		x.resize(size);
+		y.resize(size);
+		z.resize(size);
+	}
+
+	void Clear() {
+		x.clear();
+		y.clear();
+		z.clear();
+	}
+
+	Vector3f Get(std::size_t index) const { return {x[index], y[index], z[index]}; }
+	void Set(std::size_t index, const Vector3f &vector) {
+		x[index] = vector.x;
+		y[index] = vector.y;
+		z[index] = vector.z;
+	}
+
+	void Add(const Vector3f &vector) {
+		x.emplace_back(vector.x);
+		y.emplace_back(vector.y);
+		z.emplace_back(vector.z);
+	}
+
+	std::vector<float> x, y, z;
+};
+}
@@ -158,7 +158,7 @@ constexpr auto Vector4<T>::MinMax() const {
 
 template<typename T>
 template<typename K>
-constexpr auto Vector4<T>::Min(const Vector4<K> &other) {
+constexpr auto Vector4<T>::Min(const Vector4<K> &other) const {
 	using THighestP = decltype(x + other.x);
 	return Vector4<THighestP>(std::min<THighestP>(x, other.x), std::min<THighestP>(y, other.y), std::min<THighestP>(z, other.z),
 		std::min<THighestP>(w, other.w));
@@ -166,7 +166,7 @@ constexpr auto Vector4<T>::Min(const Vector4<K> &other) {
 
 template<typename T>
 template<typename K>
-constexpr auto Vector4<T>::Max(const Vector4<K> &other) {
+constexpr auto Vector4<T>::Max(const Vector4<K> &other) const {
 	using THighestP = decltype(x + other.x);
 	return Vector4<THighestP>(std::max<THighestP>(x, other.x), std::max<THighestP>(y, other.y), std::max<THighestP>(z, other.z),
 		std::max<THighestP>(w, other.w));
@@ -3,6 +3,7 @@
 #include "Scenes/Entity.hpp"
 #include "Maths/Transform.hpp"
 #include "Scenes/Scenes.hpp"
+#include "Devices/Window.hpp"
 
 namespace acid {
 Mesh::Mesh(std::shared_ptr<Model> model, std::unique_ptr<Material> &&material) :
@@ -26,17 +27,22 @@ bool Mesh::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniform
 	if (!model || !material)
 		return false;
 
-	// Checks if the mesh is in view.
-	if (auto rigidbody = GetEntity()->GetComponent<Rigidbody>()) {
-		if (!rigidbody->InFrustum(Scenes::Get()->GetCamera()->GetViewFrustum()))
-			return false;
-	}
-
 	// Check if we are in the correct pipeline stage.
 	auto materialPipeline = material->GetPipelineMaterial();
 	if (!materialPipeline || materialPipeline->GetStage() != pipelineStage)
 		return false;
 
+	// Gives the streamed images the height the bounding sphere is projected to.
+	if (auto camera = Scenes::Get()->GetCamera()) {
+		if (auto transform = GetEntity()->GetComponent<Transform>()) {
+			auto scale = transform->GetScale();
+			auto radius = model->GetRadius() * std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)});
+			auto distance = (camera->GetPosition() - transform->GetPosition()).Length();
+			auto height = static_cast<float>(Window::Get()->GetSize().y);
+			material->RequestImageSize(distance > radius ? height * radius / (distance * std::tan(camera->GetFieldOfView() / 2.0f)) : height);
+		}
+	}
+
 	// Binds the material pipeline.
 	if (!materialPipeline->BindPipeline(commandBuffer))
 		return false;
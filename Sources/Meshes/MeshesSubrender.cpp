@@ -1,14 +1,142 @@
 #include "MeshesSubrender.hpp"
 
+#include <cstring>
+
 #include "Animations/AnimatedMesh.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Graphics/Images/Image.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Mesh.hpp"
 
 namespace acid {
-MeshesSubrender::MeshesSubrender(const Pipeline::Stage &pipelineStage, Sort sort) :
+/// Meshes are batched when their model is indexed and their material can write its values for a batch.
+static bool PushObject(const Mesh &mesh, std::array<Vector4f, 2> &values) {
+	auto model = mesh.GetModel();
+	auto material = mesh.GetMaterial();
+	return model && model->GetIndexBuffer() && material && material->GetPipelineMaterial() && material->PushObject(values);
+}
+
+/// Replaces a buffer that can not hold a size, buffers grow to fit the batched meshes and are kept between frames.
+static void Reserve(std::unique_ptr<StorageBuffer> &buffer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) {
+	if (!buffer || buffer->GetSize() < size)
+		buffer = std::make_unique<StorageBuffer>(std::max(size, buffer ? 2 * buffer->GetSize() : 0), usage, properties);
+}
+
+static void Upload(const StorageBuffer &buffer, const void *data, std::size_t size) {
+	void *mapped;
+	buffer.MapMemory(&mapped);
+	std::memcpy(mapped, data, size);
+	buffer.UnmapMemory();
+}
+
+MeshesSubrender::MeshesSubrender(const Pipeline::Stage &pipelineStage, Sort sort, Culling culling) :
 	Subrender(pipelineStage),
 	sort(sort),
+	culling(culling),
 	uniformScene(true) {
+	if (culling == Culling::Cpu)
+		return;
+
+	pipelineCull = std::make_unique<PipelineCompute>("Shaders/Defaults/Cull.comp",
+		std::vector<Shader::Define>{{"OCCLUSION", String::To<int32_t>(culling == Culling::Occlusion)}});
+
+	if (culling == Culling::Occlusion)
+		pipelineTiles = std::make_unique<PipelineCompute>("Shaders/Defaults/Tiles.comp");
+}
+
+void MeshesSubrender::PreRender(const CommandBuffer &commandBuffer) {
+	drawBatches.clear();
+
+	if (!IsIndirect())
+		return;
+
+	auto camera = Scenes::Get()->GetCamera();
+	if (!camera)
+		return;
+
+	// The fence of this frame was waited on before recording, so the GPU has finished with the buffers and descriptors of the frame.
+	auto graphics = Graphics::Get();
+	auto frameCountInFlight = graphics->GetSwapchain()->GetImageCount();
+	frames.resize(frameCountInFlight);
+	frameIndex = graphics->GetFrameCount() % frameCountInFlight;
+	auto &frame = frames[frameIndex];
+
+	GatherBatches(graphics->GetFrameCount(), frameCountInFlight);
+
+	if (objects.empty())
+		return;
+
+	auto commandCount = static_cast<uint32_t>(objects.size());
+	auto commandsSize = sizeof(VkDrawIndexedIndirectCommand) * commandCount;
+	auto countsSize = sizeof(uint32_t) * drawBatches.size();
+
+	Reserve(frame.objectsBuffer, sizeof(Object) * objects.size(), 0, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	Reserve(frame.batchesBuffer, sizeof(Vector2ui) * batchCommands.size(), 0, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	Reserve(frame.commandsBuffer, commandsSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	Reserve(frame.countsBuffer, countsSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	Upload(*frame.objectsBuffer, objects.data(), sizeof(Object) * objects.size());
+	Upload(*frame.batchesBuffer, batchCommands.data(), sizeof(Vector2ui) * batchCommands.size());
+
+	// Commands culled from the end of a batch draw no instances.
+	vkCmdFillBuffer(commandBuffer, frame.commandsBuffer->GetBuffer(), 0, commandsSize, 0);
+	vkCmdFillBuffer(commandBuffer, frame.countsBuffer->GetBuffer(), 0, countsSize, 0);
+
+	for (const auto &buffer : {frame.commandsBuffer.get(), frame.countsBuffer.get()}) {
+		Buffer::InsertBufferMemoryBarrier(commandBuffer, buffer->GetBuffer(), VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+	}
+
+	Cull cull = {};
+	cull.viewProjection = previousViewProjection;
+	cull.planes = camera->GetViewFrustum().GetPlanes();
+	cull.objectCount = commandCount;
+	previousViewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+
+	if (pipelineTiles) {
+		// Tiles sample the depth with a single sample.
+		auto depth = dynamic_cast<const Image *>(graphics->GetAttachment("depth"));
+		if (depth && depth->GetSamples() != VK_SAMPLE_COUNT_1_BIT)
+			depth = nullptr;
+
+		auto depthSize = depth ? depth->GetSize() : Vector2ui();
+		cull.tiles = (depthSize + 15u) / 16u;
+		cull.depthSize = depthSize;
+		Reserve(frame.tilesBuffer, sizeof(float) * std::max(cull.tiles.x * cull.tiles.y, 1u), 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		// The depth of the last frame is only tested when it was drawn at the same size.
+		cull.occlusion = depth && depthSize == previousDepthSize && UpdateTiles(commandBuffer, frame, *depth, depthSize);
+		previousDepthSize = depthSize;
+	}
+
+	pipelineCull->BindPipeline(commandBuffer);
+
+	frame.descriptorSetCull.Push("UniformCull", frame.uniformCull);
+	frame.descriptorSetCull.Push("BufferObjects", frame.objectsBuffer.get());
+	frame.descriptorSetCull.Push("BufferBatches", frame.batchesBuffer.get());
+	frame.descriptorSetCull.Push("BufferCommands", frame.commandsBuffer.get());
+	frame.descriptorSetCull.Push("BufferCounts", frame.countsBuffer.get());
+	frame.descriptorSetCull.Push("BufferTiles", frame.tilesBuffer.get());
+
+	if (!frame.descriptorSetCull.Update(*pipelineCull)) {
+		drawBatches.clear();
+		return;
+	}
+
+	// The uniform is only bound to its block once the descriptor has been pushed, a cull without it would read an unwritten buffer.
+	if (!frame.uniformCull.GetUniformBuffer()) {
+		drawBatches.clear();
+		return;
+	}
+
+	frame.uniformCull.Push(cull, 0, sizeof(Cull));
+
+	frame.descriptorSetCull.BindDescriptor(commandBuffer, *pipelineCull);
+	pipelineCull->CmdRender(commandBuffer, {commandCount, 1});
+
+	for (const auto &buffer : {frame.commandsBuffer.get(), frame.countsBuffer.get()}) {
+		Buffer::InsertBufferMemoryBarrier(commandBuffer, buffer->GetBuffer(), VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+	}
 }
 
 void MeshesSubrender::Render(const CommandBuffer &commandBuffer) {
@@ -17,7 +145,47 @@ void MeshesSubrender::Render(const CommandBuffer &commandBuffer) {
 	uniformScene.Push("view", camera->GetViewMatrix());
 	uniformScene.Push("cameraPos", camera->GetPosition());
 
-	auto meshes = Scenes::Get()->GetStructure()->QueryComponents<Mesh>();
+	for (auto &[key, batch] : batches)
+		batch.drawn = false;
+
+	// Batched meshes were culled before the renderpass, each batch draws the commands the cull pipeline packed for it.
+	for (const auto &batch : drawBatches) {
+		if (!batch->pipeline->BindPipeline(commandBuffer))
+			continue;
+
+		const auto &pipeline = *batch->pipeline->GetPipeline();
+		const auto &frame = frames[frameIndex];
+		auto &descriptorSet = batch->descriptorSets[frameIndex];
+
+		descriptorSet.Push("UniformScene", uniformScene);
+		descriptorSet.Push("BufferObjects", frame.objectsBuffer.get());
+		batch->material->PushDescriptors(descriptorSet);
+
+		if (!descriptorSet.Update(pipeline))
+			continue;
+
+		descriptorSet.BindDescriptor(commandBuffer, pipeline);
+		batch->drawn = batch->model->CmdRenderIndirect(commandBuffer, *frame.commandsBuffer, sizeof(VkDrawIndexedIndirectCommand) * batch->firstCommand,
+			batch->count, frame.countsBuffer.get(), sizeof(uint32_t) * batch->index);
+	}
+
+	// Only the entities in view are drawn, the scene structure culls them through its spatial tree.
+	auto entities = Scenes::Get()->GetStructure()->QueryFrustum(camera->GetViewFrustum());
+
+	std::vector<Mesh *> meshes;
+	std::vector<AnimatedMesh *> animatedMeshes;
+	for (const auto &entity : entities) {
+		for (const auto &mesh : entity->GetComponents<Mesh>()) {
+			if (mesh->IsEnabled() && !IsDrawn(*mesh))
+				meshes.emplace_back(mesh);
+		}
+
+		for (const auto &animatedMesh : entity->GetComponents<AnimatedMesh>()) {
+			if (animatedMesh->IsEnabled())
+				animatedMeshes.emplace_back(animatedMesh);
+		}
+	}
+
 	if (sort == Sort::Front)
 		std::sort(meshes.begin(), meshes.end(), std::greater<>());
 	else if (sort == Sort::Back)
@@ -27,8 +195,145 @@ void MeshesSubrender::Render(const CommandBuffer &commandBuffer) {
 		mesh->CmdRender(commandBuffer, uniformScene, GetStage());
 
 	// TODO: Split animated meshes into it's own subrender.
-	auto animatedMeshes = Scenes::Get()->GetStructure()->QueryComponents<AnimatedMesh>();
 	for (const auto &animatedMesh : animatedMeshes)
 		animatedMesh->CmdRender(commandBuffer, uniformScene, GetStage());
 }
+
+bool MeshesSubrender::IsIndirect() const {
+	// Commands start their instances at the index of their object, which needs the first instance feature.
+	return pipelineCull && sort == Sort::None && Graphics::Get()->GetLogicalDevice()->GetEnabledFeatures().drawIndirectFirstInstance;
+}
+
+bool MeshesSubrender::IsDrawn(const Mesh &mesh) const {
+	std::array<Vector4f, 2> values;
+	if (drawBatches.empty() || !PushObject(mesh, values))
+		return false;
+
+	auto it = batches.find({mesh.GetModel(), mesh.GetMaterial()->GetPipelineMaterial().get()});
+	return it != batches.end() && it->second.drawn;
+}
+
+void MeshesSubrender::GatherBatches(uint64_t frameCount, uint32_t frameCountInFlight) {
+	objects.clear();
+	batchCommands.clear();
+
+	for (auto &[key, batch] : batches)
+		batch.count = 0;
+
+	for (const auto &mesh : Scenes::Get()->GetStructure()->QueryComponents<Mesh>()) {
+		Object object = {};
+
+		if (!PushObject(*mesh, object.values))
+			continue;
+
+		auto model = mesh->GetModel();
+		auto material = mesh->GetMaterial();
+		const auto &materialPipeline = material->GetPipelineMaterial();
+
+		if (materialPipeline->GetStage() != GetStage())
+			continue;
+
+		auto &batch = batches[{model, materialPipeline.get()}];
+
+		if (!batch.pipeline) {
+			// The batch pipeline is the materials pipeline with its shaders reading the values of each mesh from BufferObjects.
+			const auto &pipelineCreate = materialPipeline->GetPipelineCreate();
+			auto defines = pipelineCreate.GetDefines();
+
+			for (auto &[defineName, defineValue] : defines) {
+				if (defineName == "INDIRECT")
+					defineValue = "1";
+			}
+
+			batch.pipeline = MaterialPipeline::Create(materialPipeline->GetStage(), {
+				pipelineCreate.GetShaderStages(), pipelineCreate.GetVertexInputs(), defines, pipelineCreate.GetMode(), pipelineCreate.GetDepth(),
+				pipelineCreate.GetTopology(), pipelineCreate.GetPolygonMode(), pipelineCreate.GetCullMode(), pipelineCreate.GetFrontFace(),
+				pipelineCreate.GetPushDescriptors()
+			});
+		}
+
+		if (batch.count++ == 0) {
+			batch.index = static_cast<uint32_t>(drawBatches.size());
+			batch.model = model;
+			batch.material = material;
+			batch.frame = frameCount;
+			batch.descriptorSets.resize(frameCountInFlight);
+			drawBatches.emplace_back(&batch);
+		}
+
+		if (auto transform = mesh->GetEntity()->GetComponent<Transform>())
+			object.transform = transform->GetWorldMatrix();
+
+		object.min = model->GetMinExtents();
+		object.max = model->GetMaxExtents();
+		object.batch = batch.index;
+		objects.emplace_back(object);
+	}
+
+	// Batches without meshes are removed with the pipelines and descriptors they hold, once no frame in flight can be drawing with them.
+	for (auto it = batches.begin(); it != batches.end();) {
+		if (it->second.count == 0 && frameCount > it->second.frame + frameCountInFlight)
+			it = batches.erase(it);
+		else
+			++it;
+	}
+
+	uint32_t firstCommand = 0;
+
+	for (const auto &batch : drawBatches) {
+		batch->firstCommand = firstCommand;
+		firstCommand += batch->count;
+		batchCommands.emplace_back(batch->model->GetIndexCount(), batch->firstCommand);
+	}
+}
+
+bool MeshesSubrender::UpdateTiles(const CommandBuffer &commandBuffer, Frame &frame, const Image &depth, const Vector2ui &depthSize) {
+	pipelineTiles->BindPipeline(commandBuffer);
+
+	// The depth is sampled in a read only layout, the descriptor of the attachment has the layout the renderpass leaves it in.
+	auto shader = pipelineTiles->GetShader();
+	auto location = shader->GetDescriptorLocation("samplerDepth");
+	if (!location)
+		return false;
+
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.sampler = depth.GetSampler();
+	imageInfo.imageView = depth.GetView();
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = VK_NULL_HANDLE; // Will be set in the descriptor handler.
+	descriptorWrite.dstBinding = *location;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.descriptorType = *shader->GetDescriptorType(*location);
+	WriteDescriptorSet writeDescriptorSet(descriptorWrite, imageInfo);
+
+	frame.descriptorSetTiles.Push("samplerDepth", &depth, std::move(writeDescriptorSet));
+	frame.descriptorSetTiles.Push("BufferTiles", frame.tilesBuffer.get());
+
+	if (!frame.descriptorSetTiles.Update(*pipelineTiles))
+		return false;
+
+	VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	if (Image::HasStencil(depth.GetFormat()))
+		aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+
+	// The depth was written by the last frames renderpass, it is given back to the renderpass in the layout it left the depth in.
+	Image::InsertImageMemoryBarrier(commandBuffer, depth.GetImage(), VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, aspectMask, 1, 0, 1, 0);
+
+	frame.descriptorSetTiles.BindDescriptor(commandBuffer, *pipelineTiles);
+	pipelineTiles->CmdRender(commandBuffer, depthSize);
+
+	Image::InsertImageMemoryBarrier(commandBuffer, depth.GetImage(), VK_ACCESS_SHADER_READ_BIT,
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+		VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, aspectMask, 1, 0, 1, 0);
+	Buffer::InsertBufferMemoryBarrier(commandBuffer, frame.tilesBuffer->GetBuffer(), VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+	return true;
+}
 }
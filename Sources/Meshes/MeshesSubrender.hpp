@@ -1,22 +1,136 @@
 ﻿#pragma once
 
+#include <map>
+
 #include "Graphics/Subrender.hpp"
+#include "Graphics/Buffers/StorageBuffer.hpp"
 #include "Graphics/Buffers/UniformHandler.hpp"
+#include "Graphics/Descriptors/DescriptorsHandler.hpp"
+#include "Graphics/Pipelines/PipelineCompute.hpp"
 #include "Graphics/Pipelines/PipelineGraphics.hpp"
+#include "Maths/Matrix4.hpp"
 
 namespace acid {
+class Image;
+class Material;
+class MaterialPipeline;
+class Mesh;
+class Model;
+
+/**
+ * @brief Subrender that draws the meshes in a scene.
+ *
+ * When culling on the GPU, meshes that share a model and a material pipeline are drawn as one batch. A compute pipeline tests
+ * the box of every batched mesh and packs a draw command for each one in view, so the CPU binds and draws once for each batch instead of each mesh.
+ */
 class ACID_EXPORT MeshesSubrender : public Subrender {
 public:
 	enum class Sort {
 		None, Front, Back
 	};
 
-	explicit MeshesSubrender(const Pipeline::Stage &pipelineStage, Sort sort = Sort::None);
+	enum class Culling {
+		/// Meshes in the view frustum are found in the scene structure and drawn one at a time.
+		Cpu,
+		/// Meshes with materials that can be batched are culled against the view frustum on the GPU and drawn with indirect commands.
+		Gpu,
+		/// Culls as Gpu, and also culls meshes behind the depth drawn in the last frame.
+		Occlusion
+	};
 
+	/**
+	 * Creates a new meshes subrender.
+	 * @param pipelineStage The pipeline stage meshes are drawn in.
+	 * @param sort The order meshes are drawn in, sorted meshes are always culled on the CPU.
+	 * @param culling Where meshes are culled, the GPU is used only when the device supports indirect draws with a first instance.
+	 */
+	explicit MeshesSubrender(const Pipeline::Stage &pipelineStage, Sort sort = Sort::None, Culling culling = Culling::Cpu);
+
+	void PreRender(const CommandBuffer &commandBuffer) override;
 	void Render(const CommandBuffer &commandBuffer) override;
 
 private:
+	/// The values of a batched mesh, laid out as Object in Shaders/Defaults/Object.glsl.
+	class Object {
+	public:
+		Matrix4 transform;
+		Vector3f min;
+		uint32_t batch;
+		Vector3f max;
+		uint32_t padding;
+		std::array<Vector4f, 2> values;
+	};
+	static_assert(sizeof(Object) == 128, "Object must have the size of Object in Object.glsl");
+
+	/// The values of the cull pipeline, laid out as UniformCull in Shaders/Defaults/Cull.comp.
+	class Cull {
+	public:
+		Matrix4 viewProjection;
+		std::array<std::array<float, 4>, 6> planes;
+		Vector2ui tiles;
+		Vector2f depthSize;
+		uint32_t objectCount;
+		uint32_t occlusion;
+		Vector2ui padding;
+	};
+	static_assert(sizeof(Cull) == 192, "Cull must have the size of UniformCull in Cull.comp");
+
+	class IndirectBatch {
+	public:
+		std::shared_ptr<MaterialPipeline> pipeline;
+		const Model *model = nullptr;
+		const Material *material = nullptr;
+		uint32_t index = 0;
+		uint32_t firstCommand = 0;
+		uint32_t count = 0;
+		/// The last frame the batch had meshes, it is kept until the frames in flight that drew it have finished.
+		uint64_t frame = 0;
+		/// If the batch was drawn this frame, its meshes are left out of the meshes drawn one at a time.
+		bool drawn = false;
+		/// The descriptors of each frame in flight.
+		std::vector<DescriptorsHandler> descriptorSets;
+	};
+
+	/// The buffers and descriptors of a frame in flight, they are written again once the GPU has finished the last frame that used them.
+	class Frame {
+	public:
+		std::unique_ptr<StorageBuffer> objectsBuffer;
+		std::unique_ptr<StorageBuffer> batchesBuffer;
+		std::unique_ptr<StorageBuffer> commandsBuffer;
+		std::unique_ptr<StorageBuffer> countsBuffer;
+		std::unique_ptr<StorageBuffer> tilesBuffer;
+		UniformHandler uniformCull;
+		DescriptorsHandler descriptorSetCull;
+		DescriptorsHandler descriptorSetTiles;
+	};
+
+	bool IsIndirect() const;
+	bool IsDrawn(const Mesh &mesh) const;
+	void GatherBatches(uint64_t frameCount, uint32_t frameCountInFlight);
+	bool UpdateTiles(const CommandBuffer &commandBuffer, Frame &frame, const Image &depth, const Vector2ui &depthSize);
+
 	Sort sort;
+	Culling culling;
 	UniformHandler uniformScene;
+
+	/// Batches by the model and material pipeline of their meshes.
+	std::map<std::pair<const Model *, const MaterialPipeline *>, IndirectBatch> batches;
+	/// The batches drawn this frame, in the order of their commands.
+	std::vector<IndirectBatch *> drawBatches;
+	std::vector<Object> objects;
+	/// The index count and first command of each drawn batch.
+	std::vector<Vector2ui> batchCommands;
+
+	std::unique_ptr<PipelineCompute> pipelineCull;
+	std::unique_ptr<PipelineCompute> pipelineTiles;
+
+	/// A frame for each swapchain image, the frame being recorded is found from the frame count.
+	std::vector<Frame> frames;
+	std::size_t frameIndex = 0;
+
+	/// The view projection the depth tested for occlusion was drawn with.
+	Matrix4 previousViewProjection;
+	/// The size of the depth drawn last frame, zero when no depth was drawn.
+	Vector2ui previousDepthSize;
 };
 }
@@ -52,7 +52,7 @@ void GltfModel::Load() {
 #endif
 
 	auto folder = filename.parent_path();
-	auto fileLoaded = Files::Read(filename);
+	auto fileLoaded = Files::Map(filename);
 
 	if (!fileLoaded) {
 		Log::Error("Model could not be loaded: ", filename, '\n');
@@ -64,11 +64,11 @@ void GltfModel::Load() {
 	std::string warn, err;
 
 	if (filename.extension() == ".glb") {
-		if (!gltfContext.LoadBinaryFromMemory(&gltfModel, &err, &warn, reinterpret_cast<uint8_t *>(fileLoaded->data()), static_cast<uint32_t>(fileLoaded->size()))) {
+		if (!gltfContext.LoadBinaryFromMemory(&gltfModel, &err, &warn, fileLoaded->GetData(), static_cast<uint32_t>(fileLoaded->GetSize()))) {
 			throw std::runtime_error(warn + err);
 		}
 	} else {
-		if (!gltfContext.LoadASCIIFromString(&gltfModel, &err, &warn, fileLoaded->c_str(), static_cast<uint32_t>(fileLoaded->size()), folder.string())) {
+		if (!gltfContext.LoadASCIIFromString(&gltfModel, &err, &warn, fileLoaded->GetString().data(), static_cast<uint32_t>(fileLoaded->GetSize()), folder.string())) {
 			throw std::runtime_error(warn + err);
 		}
 	}
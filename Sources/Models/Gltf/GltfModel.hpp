@@ -31,6 +31,9 @@ public:
 	 */
 	explicit GltfModel(std::filesystem::path filename, bool load = true);
 
+	std::vector<std::filesystem::path> GetDependencies() const override { return {filename}; }
+	std::shared_ptr<Resource> Reload() const override { return std::make_shared<GltfModel>(filename); }
+
 	friend const Node &operator>>(const Node &node, GltfModel &model);
 	friend Node &operator<<(Node &node, const GltfModel &model);
 
@@ -1,5 +1,6 @@
 #include "Model.hpp"
 
+#include "Graphics/Graphics.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Resources/Resources.hpp"
 
@@ -24,6 +25,31 @@ bool Model::CmdRender(const CommandBuffer &commandBuffer, uint32_t instances) co
 	return true;
 }
 
+bool Model::CmdRenderIndirect(const CommandBuffer &commandBuffer, const Buffer &commands, VkDeviceSize offset, uint32_t maxDrawCount, const Buffer *counts,
+	VkDeviceSize countOffset) const {
+	if (!vertexBuffer || !indexBuffer)
+		return false;
+
+	VkBuffer vertexBuffers[1] = {vertexBuffer->GetBuffer()};
+	VkDeviceSize offsets[1] = {0};
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+	vkCmdBindIndexBuffer(commandBuffer, indexBuffer->GetBuffer(), 0, GetIndexType());
+
+	auto logicalDevice = Graphics::Get()->GetLogicalDevice();
+	auto stride = static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+
+	if (counts && logicalDevice->IsDrawIndirectCount()) {
+		Instance::FvkCmdDrawIndexedIndirectCountKHR(*logicalDevice, commandBuffer, commands.GetBuffer(), offset, counts->GetBuffer(), countOffset, maxDrawCount, stride);
+	} else if (logicalDevice->GetEnabledFeatures().multiDrawIndirect) {
+		vkCmdDrawIndexedIndirect(commandBuffer, commands.GetBuffer(), offset, maxDrawCount, stride);
+	} else {
+		for (uint32_t i = 0; i < maxDrawCount; i++)
+			vkCmdDrawIndexedIndirect(commandBuffer, commands.GetBuffer(), offset + i * stride, 1, stride);
+	}
+
+	return true;
+}
+
 std::vector<uint32_t> Model::GetIndices(std::size_t offset) const {
 	Buffer indexStaging(indexBuffer->GetSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
 		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
@@ -71,6 +97,17 @@ void Model::SetIndices(const std::vector<uint32_t> &indices) {
 	commandBuffer.SubmitIdle();
 }
 
+void Model::Swap(Resource &reloaded) {
+	auto &other = dynamic_cast<Model &>(reloaded);
+	std::swap(vertexBuffer, other.vertexBuffer);
+	std::swap(indexBuffer, other.indexBuffer);
+	std::swap(vertexCount, other.vertexCount);
+	std::swap(indexCount, other.indexCount);
+	std::swap(minExtents, other.minExtents);
+	std::swap(maxExtents, other.maxExtents);
+	std::swap(radius, other.radius);
+}
+
 std::vector<float> Model::GetPointCloud() const {
 	if (!vertexBuffer) return {};
 
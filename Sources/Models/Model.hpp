@@ -4,6 +4,7 @@
 #include <functional>
 #include <unordered_map>
 
+#include "Maths/Batch.hpp"
 #include "Maths/Vector3.hpp"
 #include "Graphics/Buffers/Buffer.hpp"
 #include "Resources/Resource.hpp"
@@ -126,7 +127,21 @@ public:
 
 	bool CmdRender(const CommandBuffer &commandBuffer, uint32_t instances = 1) const;
 
+	/**
+	 * Draws the model with indexed draw commands read from a buffer, such as commands written by a compute pipeline.
+	 * @param commandBuffer The command buffer to record into.
+	 * @param commands The buffer of VkDrawIndexedIndirectCommand.
+	 * @param offset The byte offset of the first command.
+	 * @param maxDrawCount The number of commands, or the most that are drawn when there is a count buffer.
+	 * @param counts The buffer the number of commands is read from, used only when the device has VK_KHR_draw_indirect_count.
+	 * @param countOffset The byte offset of the count.
+	 * @return If the model has the index buffer commands need.
+	 */
+	bool CmdRenderIndirect(const CommandBuffer &commandBuffer, const Buffer &commands, VkDeviceSize offset, uint32_t maxDrawCount, const Buffer *counts = nullptr,
+		VkDeviceSize countOffset = 0) const;
+
 	std::type_index GetTypeIndex() const override { return typeid(Model); }
+	void Swap(Resource &reloaded) override;
 
 	template<typename T>
 	std::vector<T> GetVertices(std::size_t offset = 0) const;
@@ -225,13 +240,18 @@ void Model::Initialize(const std::vector<T> &vertices, const std::vector<uint32_
 	SetVertices(vertices);
 	SetIndices(indices);
 
-	minExtents = Vector3f::Infinity;
-	maxExtents = -Vector3f::Infinity;
-
-	for (const auto &vertex : vertices) {
-		Vector3f position(vertex.position);
-		minExtents = minExtents.Min(position);
-		maxExtents = maxExtents.Max(position);
+	if constexpr (std::is_same_v<decltype(T::position), Vector3f>) {
+		// 3D positions are read straight from the vertices.
+		Batch::Extents(vertices.empty() ? nullptr : &vertices[0].position, vertices.size(), sizeof(T), minExtents, maxExtents);
+	} else {
+		minExtents = Vector3f::Infinity;
+		maxExtents = -Vector3f::Infinity;
+
+		for (const auto &vertex : vertices) {
+			Vector3f position(vertex.position);
+			minExtents = minExtents.Min(position);
+			maxExtents = maxExtents.Max(position);
+		}
 	}
 
 	radius = std::max(minExtents.Length(), maxExtents.Length());
@@ -30,6 +30,9 @@ public:
 	 */
 	explicit ObjModel(std::filesystem::path filename, bool load = true);
 
+	std::vector<std::filesystem::path> GetDependencies() const override { return {filename}; }
+	std::shared_ptr<Resource> Reload() const override { return std::make_shared<ObjModel>(filename); }
+
 	friend const Node &operator>>(const Node &node, ObjModel &model);
 	friend Node &operator<<(Node &node, const ObjModel &model);
 
@@ -1,5 +1,9 @@
 #include "Http.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
 #include "Engine/Log.hpp"
 #include "Utils/String.hpp"
 
@@ -34,9 +38,95 @@ void Http::SetHost(const std::string &host, uint16_t port) {
 		hostName.erase(hostName.size() - 1);
 
 	this->host = {hostName};
+
+	// Pooled connections are to the previous host.
+	CloseConnections();
 }
 
 HttpResponse Http::SendRequest(const HttpRequest &request, const Time &timeout) {
+	return SendRequest(request, nullptr, timeout);
+}
+
+HttpResponse Http::SendRequest(const HttpRequest &request, const BodyCallback &callback, const Time &timeout) {
+	auto toSend = PrepareRequest(request);
+	auto requestStr = toSend.Prepare();
+
+	// A pooled connection may have been closed by the server while idle, then the request is sent again on a new connection.
+	for (uint32_t attempt = 0; attempt < 2; attempt++) {
+		auto connection = OpenConnection(timeout);
+
+		if (!connection)
+			break;
+
+		auto reused = connection->reused;
+		HttpResponse received;
+		bool keepAlive = false;
+
+		if (connection->socket.Send(requestStr.c_str(), requestStr.size()) == Socket::Status::Done &&
+			ReadResponse(*connection, toSend, received, callback, keepAlive)) {
+			if (keepAlive)
+				ReleaseConnection(std::move(connection));
+			return received;
+		}
+
+		// Only a request that got no response at all is sent again, part of the body may have reached the callback already.
+		if (!reused || received.status != HttpResponse::Status::ConnectionFailed || received.majorVersion != 0)
+			return received;
+	}
+
+	return {};
+}
+
+std::vector<HttpResponse> Http::SendRequests(const std::vector<HttpRequest> &requests, const Time &timeout) {
+	std::vector<HttpRequest> toSend;
+	toSend.reserve(requests.size());
+	for (const auto &request : requests)
+		toSend.emplace_back(PrepareRequest(request));
+
+	std::vector<HttpResponse> responses(requests.size());
+	std::size_t answered = 0;
+	uint32_t failures = 0;
+
+	while (answered < toSend.size() && failures < 2) {
+		auto connection = OpenConnection(timeout);
+
+		if (!connection)
+			break;
+
+		auto reused = connection->reused;
+
+		// Write every remaining request before reading any response, so the server can work through them back to back.
+		std::string pipelined;
+		for (auto i = answered; i < toSend.size(); i++)
+			pipelined += toSend[i].Prepare();
+
+		if (connection->socket.Send(pipelined.c_str(), pipelined.size()) != Socket::Status::Done) {
+			failures += reused ? 0 : 1;
+			continue;
+		}
+
+		auto progress = answered;
+		bool keepAlive = true;
+
+		while (answered < toSend.size() && keepAlive && ReadResponse(*connection, toSend[answered], responses[answered], nullptr, keepAlive))
+			answered++;
+
+		if (answered == toSend.size() && keepAlive)
+			ReleaseConnection(std::move(connection));
+
+		// Only give up when a fresh connection made no progress, a server may limit the requests it answers per connection.
+		if (answered == progress && !reused)
+			failures++;
+	}
+
+	return responses;
+}
+
+void Http::CloseConnections() {
+	connections.clear();
+}
+
+HttpRequest Http::PrepareRequest(const HttpRequest &request) const {
 	// First make sure that the request is valid -- add missing mandatory fields.
 	HttpRequest toSend(request);
 
@@ -58,37 +148,172 @@ HttpResponse Http::SendRequest(const HttpRequest &request, const Time &timeout)
 	if (toSend.method == HttpRequest::Method::Post && !toSend.HasField("Content-Type"))
 		toSend.SetField("Content-Type", "application/x-www-form-urlencoded");
 
-	if (toSend.majorVersion * 10 + toSend.minorVersion >= 11 && !toSend.HasField("Connection"))
-		toSend.SetField("Connection", "close");
+	// HTTP/1.1 connections are persistent by default, HTTP/1.0 servers close after each response unless asked to keep alive.
+	if (!toSend.HasField("Connection"))
+		toSend.SetField("Connection", "keep-alive");
+
+	return toSend;
+}
+
+std::unique_ptr<Http::Connection> Http::OpenConnection(const Time &timeout) {
+	if (!connections.empty()) {
+		auto connection = std::move(connections.back());
+		connections.pop_back();
+		return connection;
+	}
+
+	auto connection = std::make_unique<Connection>();
+
+	if (connection->socket.Connect(host, port, timeout) != Socket::Status::Done)
+		return nullptr;
 
-	// Prepare the response.
-	HttpResponse received;
+	connectionCount++;
+	return connection;
+}
+
+void Http::ReleaseConnection(std::unique_ptr<Connection> connection) {
+	if (connections.size() >= MaxIdleConnections)
+		return;
+
+	connection->reused = true;
+	connections.emplace_back(std::move(connection));
+}
+
+bool Http::ReadResponse(Connection &connection, const HttpRequest &request, HttpResponse &response, const BodyCallback &callback, bool &keepAlive) {
+	keepAlive = false;
+	std::size_t headerEnd;
 
-	// Connect the socket to the host.
-	if (connection.Connect(host, port, timeout) == Socket::Status::Done) {
-		// Convert the request to string and send it through the connected socket.
-		auto requestStr = toSend.Prepare();
+	// Informational responses (100 Continue) come before the final response to the request.
+	do {
+		while ((headerEnd = connection.buffer.find("\r\n\r\n")) == std::string::npos) {
+			if (!Fill(connection))
+				return false;
+		}
+
+		response = {};
+		response.ParseHeader(connection.buffer.substr(0, headerEnd + 4));
+		connection.buffer.erase(0, headerEnd + 4);
+	} while (static_cast<uint32_t>(response.status) / 100 == 1);
 
-		if (!requestStr.empty()) {
-			// Send it through the socket.
-			if (connection.Send(requestStr.c_str(), requestStr.size()) == Socket::Status::Done) {
-				// Wait for the server's response.
-				std::string receivedStr;
-				std::size_t size = 0;
-				char buffer[1024];
+	if (response.status == HttpResponse::Status::InvalidResponse)
+		return true;
 
-				while (connection.Receive(buffer, sizeof(buffer), size) == Socket::Status::Done)
-					receivedStr.append(buffer, buffer + size);
+	auto emit = [&](const char *data, std::size_t size) {
+		if (!callback) {
+			response.body.append(data, size);
+			return true;
+		}
+		return callback(data, size);
+	};
 
-				// Build the Response object from the received data.
-				received.Parse(receivedStr);
+	auto status = static_cast<uint32_t>(response.status);
+	auto connectionField = String::Lowercase(response.GetField("Connection"));
+	auto persistent = connectionField != "close" &&
+		(response.majorVersion * 10 + response.minorVersion >= 11 || connectionField == "keep-alive");
+
+	// Responses to HEAD requests, 204 and 304 never have a body, whatever their fields say.
+	if (request.method == HttpRequest::Method::Head || status == 204 || status == 304) {
+		keepAlive = persistent;
+		return true;
+	}
+
+	if (String::Lowercase(response.GetField("Transfer-Encoding")) == "chunked") {
+		for (;;) {
+			std::size_t lineEnd;
+			while ((lineEnd = connection.buffer.find("\r\n")) == std::string::npos) {
+				if (!Fill(connection))
+					return Truncated(response);
 			}
+
+			// The chunk size is hexadecimal, anything after it on the line is a chunk extension.
+			auto length = std::strtoull(connection.buffer.c_str(), nullptr, 16);
+			connection.buffer.erase(0, lineEnd + 2);
+
+			if (length == 0)
+				break;
+
+			while (length > 0) {
+				if (connection.buffer.empty() && !Fill(connection))
+					return Truncated(response);
+
+				auto size = std::min<std::size_t>(length, connection.buffer.size());
+				if (!emit(connection.buffer.data(), size))
+					return true;
+				connection.buffer.erase(0, size);
+				length -= size;
+			}
+
+			while (connection.buffer.size() < 2) {
+				if (!Fill(connection))
+					return Truncated(response);
+			}
+			connection.buffer.erase(0, 2);
 		}
 
-		// Close the connection.
-		connection.Disconnect();
+		// Read all trailers (if present), up to the empty line ending the message.
+		for (;;) {
+			if (connection.buffer.compare(0, 2, "\r\n") == 0) {
+				connection.buffer.erase(0, 2);
+				break;
+			}
+
+			if (auto trailersEnd = connection.buffer.find("\r\n\r\n"); trailersEnd != std::string::npos) {
+				std::istringstream in(connection.buffer.substr(0, trailersEnd + 4));
+				response.ParseFields(in);
+				connection.buffer.erase(0, trailersEnd + 4);
+				break;
+			}
+
+			if (!Fill(connection))
+				return Truncated(response);
+		}
+
+		keepAlive = persistent;
+		return true;
+	}
+
+	if (auto contentLength = response.fields.find("content-length"); contentLength != response.fields.end()) {
+		auto length = std::strtoull(contentLength->second.c_str(), nullptr, 10);
+
+		while (length > 0) {
+			if (connection.buffer.empty() && !Fill(connection))
+				return Truncated(response);
+
+			auto size = std::min<std::size_t>(length, connection.buffer.size());
+			if (!emit(connection.buffer.data(), size))
+				return true;
+			connection.buffer.erase(0, size);
+			length -= size;
+		}
+
+		keepAlive = persistent;
+		return true;
 	}
 
-	return received;
+	// Without a length the body ends when the server closes the connection, which can't be reused.
+	do {
+		if (!emit(connection.buffer.data(), connection.buffer.size()))
+			return true;
+		connection.buffer.clear();
+	} while (Fill(connection));
+
+	return true;
+}
+
+bool Http::Truncated(HttpResponse &response) {
+	// The connection closed before the whole body was read, the response is incomplete.
+	response.status = HttpResponse::Status::ConnectionFailed;
+	return false;
+}
+
+bool Http::Fill(Connection &connection) {
+	char buffer[16384];
+	std::size_t size = 0;
+
+	if (connection.socket.Receive(buffer, sizeof(buffer), size) != Socket::Status::Done)
+		return false;
+
+	connection.buffer.append(buffer, size);
+	return true;
 }
 }
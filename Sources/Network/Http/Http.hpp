@@ -1,5 +1,9 @@
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include "Network/Tcp/TcpSocket.hpp"
 #include "Network/IpAddress.hpp"
 #include "HttpRequest.hpp"
@@ -31,6 +35,10 @@ namespace acid {
  * acid::Http provides a simple function, SendRequest, to send a acid::HttpRequest and
  * return the corresponding acid::HttpResponse
  * from the server.
+ *
+ * HTTP/1.1 requests keep their connection open after the response, idle connections are pooled and reused
+ * by later requests to the same host. SendRequests pipelines several requests over one connection,
+ * and a body callback can be given to stream large responses instead of buffering them.
  */
 class ACID_EXPORT Http {
 public:
@@ -55,7 +63,7 @@ public:
 	 * This function just stores the host address and port, it doesn't actually connect to it until you send a request.
 	 * The port has a default value of 0, which means that the HTTP client will use the right port according to the
 	 * protocol used (80 for HTTP). You should leave it like this unless you really need a port other than the
-	 * standard one, or use an unknown protocol.
+	 * standard one, or use an unknown protocol. Idle connections kept open to the previous host are closed.
 	 * @param host Web server to connect to.
 	 * @param port Port to use for connection.
 	 */
@@ -74,9 +82,71 @@ public:
 	 */
 	HttpResponse SendRequest(const HttpRequest &request, const Time &timeout = 0s);
 
+	/**
+	 * Called with each piece of a response body as it is received.
+	 * Return false to stop the transfer, the connection is then closed.
+	 */
+	using BodyCallback = std::function<bool(const char *data, std::size_t size)>;
+
+	/**
+	 * Send a HTTP request and stream the body of the server's response.
+	 * The body is passed to \a callback as it arrives and is not stored in the returned response,
+	 * chunked transfers are decoded before the callback is called.
+	 * @param request Request to send.
+	 * @param callback Function receiving the response body.
+	 * @param timeout Maximum time to wait.
+	 * @return Server's response, without the body.
+	 */
+	HttpResponse SendRequest(const HttpRequest &request, const BodyCallback &callback, const Time &timeout = 0s);
+
+	/**
+	 * Send several HTTP requests over one connection without waiting for each response (pipelining).
+	 * Responses are returned in the order of the requests. If the server closes the connection early,
+	 * the requests it did not answer are sent again on a new connection.
+	 * @param requests Requests to send.
+	 * @param timeout Maximum time to wait for the connection.
+	 * @return Server's responses.
+	 */
+	std::vector<HttpResponse> SendRequests(const std::vector<HttpRequest> &requests, const Time &timeout = 0s);
+
+	/**
+	 * Close all idle connections kept open for reuse.
+	 */
+	void CloseConnections();
+
+	/**
+	 * Gets the number of connections opened to the host since the client was created.
+	 * @return The number of connections opened.
+	 */
+	uint32_t GetConnectionCount() const { return connectionCount; }
+
 private:
-	/// Connection to the host.
-	TcpSocket connection;
+	/**
+	 * @brief A connection to the host, with data received past the end of the last response.
+	 */
+	class Connection {
+	public:
+		TcpSocket socket;
+		std::string buffer;
+		/// If a response has been read before, the server may have closed the connection while it was idle.
+		bool reused = false;
+	};
+
+	/// Maximum number of idle connections kept open.
+	static constexpr std::size_t MaxIdleConnections = 4;
+
+	HttpRequest PrepareRequest(const HttpRequest &request) const;
+	std::unique_ptr<Connection> OpenConnection(const Time &timeout);
+	void ReleaseConnection(std::unique_ptr<Connection> connection);
+	static bool ReadResponse(Connection &connection, const HttpRequest &request, HttpResponse &response, const BodyCallback &callback,
+		bool &keepAlive);
+	static bool Truncated(HttpResponse &response);
+	static bool Fill(Connection &connection);
+
+	/// Idle connections to the host, kept open for reuse.
+	std::vector<std::unique_ptr<Connection>> connections;
+	/// Number of connections opened to the host.
+	uint32_t connectionCount = 0;
 	/// Web host address.
 	IpAddress host;
 	/// Web host name.
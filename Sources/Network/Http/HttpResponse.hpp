@@ -119,6 +119,7 @@ public:
 	 * <li>Nothing (for HEAD requests).</li>
 	 * <li>An error message (in case of an error).</li>
 	 * </ul>
+	 * The body is empty if it was streamed to a Http::BodyCallback.
 	 * @return The response body.
 	 */
 	const std::string &GetBody() const { return body; }
@@ -128,10 +129,10 @@ private:
 
 	/**
 	 * Construct the header from a response string.
-	 * This function is used by Http to build the response of a request.
-	 * @param data Content of the response to parse.
+	 * This function is used by Http to build the response of a request, the body is decoded by Http as it is received.
+	 * @param data Status line and header fields of the response.
 	 */
-	void Parse(const std::string &data);
+	void ParseHeader(const std::string &data);
 
 	/**
 	 * Read values passed in the answer header.
@@ -9,10 +9,37 @@
 #endif
 
 #include "Socket.hpp"
+#include "PacketBufferPool.hpp"
 
 namespace acid {
 Packet::Packet() :
+	data(PacketBufferPool::Acquire()),
 	isValid(true) {
+	data.resize(HeaderSize);
+}
+
+Packet::Packet(Packet &&other) noexcept :
+	data(std::move(other.data)),
+	readPos(other.readPos),
+	sendPos(other.sendPos),
+	isValid(other.isValid) {
+	other.Clear();
+	other.sendPos = 0;
+}
+
+Packet::~Packet() {
+	PacketBufferPool::Release(std::move(data));
+}
+
+Packet &Packet::operator=(Packet &&other) noexcept {
+	// Our buffer goes to the other packet, so it keeps a reserved header without allocating.
+	data.swap(other.data);
+	readPos = other.readPos;
+	sendPos = other.sendPos;
+	isValid = other.isValid;
+	other.Clear();
+	other.sendPos = 0;
+	return *this;
 }
 
 void Packet::Append(const void *data, std::size_t sizeInBytes) {
@@ -23,18 +50,22 @@ void Packet::Append(const void *data, std::size_t sizeInBytes) {
 	}
 }
 
+void Packet::Reserve(std::size_t sizeInBytes) {
+	data.reserve(HeaderSize + sizeInBytes);
+}
+
 void Packet::Clear() {
-	data.clear();
-	readPos = 0;
+	data.resize(HeaderSize);
+	readPos = HeaderSize;
 	isValid = true;
 }
 
 const void *Packet::GetData() const {
-	return !data.empty() ? &data[0] : nullptr;
+	return data.size() > HeaderSize ? &data[HeaderSize] : nullptr;
 }
 
 std::size_t Packet::GetDataSize() const {
-	return data.size();
+	return data.size() > HeaderSize ? data.size() - HeaderSize : 0;
 }
 
 bool Packet::EndOfStream() const {
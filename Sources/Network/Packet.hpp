@@ -27,16 +27,32 @@ namespace acid {
 class ACID_EXPORT Packet {
 	friend class TcpSocket;
 	friend class UdpSocket;
+	friend class UdpConnection;
 
 public:
 	/// A bool-like type that cannot be converted to integer or pointer types.
 	typedef bool (Packet::*BoolType)(std::size_t);
 
+	/// Bytes reserved in front of the packet data, TcpSocket writes the length prefix there so the packet can be sent without copying.
+	static constexpr std::size_t HeaderSize = sizeof(uint32_t);
+
 	/**
-	 * Creates an empty packet.
+	 * Creates an empty packet, the data buffer is taken from acid::PacketBufferPool.
 	 */
 	Packet();
-	virtual ~Packet() = default;
+	Packet(const Packet &other) = default;
+	/**
+	 * Moves the data of a packet, the moved from packet is left empty with its header reserved.
+	 * @param other The packet to move from.
+	 */
+	Packet(Packet &&other) noexcept;
+	/**
+	 * Destructor that returns the data buffer to acid::PacketBufferPool.
+	 */
+	virtual ~Packet();
+
+	Packet &operator=(const Packet &other) = default;
+	Packet &operator=(Packet &&other) noexcept;
 
 	/**
 	 * Append data to the end of the packet.
@@ -45,6 +61,12 @@ public:
 	 */
 	void Append(const void *data, std::size_t sizeInBytes);
 
+	/**
+	 * Reserve capacity for data, so a packet of known size is built without reallocating.
+	 * @param sizeInBytes Number of data bytes to reserve.
+	 */
+	void Reserve(std::size_t sizeInBytes);
+
 	/**
 	 * Clear the packet, after calling Clear, the packet is empty.
 	 */
@@ -165,10 +187,10 @@ protected:
 	 */
 	bool CheckSize(std::size_t size);
 
-	/// Data stored in the packet.
+	/// Data stored in the packet, prefixed by HeaderSize reserved bytes.
 	std::vector<char> data;
 	/// Current reading position in the packet.
-	std::size_t readPos = 0;
+	std::size_t readPos = HeaderSize;
 	/// Current send position in the packet (for handling partial sends).
 	std::size_t sendPos = 0;
 	/// Reading state of the packet.
@@ -0,0 +1,31 @@
+#include "PacketBufferPool.hpp"
+
+namespace acid {
+std::vector<char> PacketBufferPool::Acquire(std::size_t capacity) {
+	auto &buffers = Buffers();
+	std::vector<char> buffer;
+
+	if (!buffers.empty()) {
+		buffer = std::move(buffers.back());
+		buffers.pop_back();
+	}
+
+	buffer.reserve(capacity);
+	return buffer;
+}
+
+void PacketBufferPool::Release(std::vector<char> &&buffer) {
+	auto &buffers = Buffers();
+
+	if (buffer.capacity() == 0 || buffer.capacity() > MaxCapacity || buffers.size() >= MaxBuffers)
+		return;
+
+	buffer.clear();
+	buffers.emplace_back(std::move(buffer));
+}
+
+std::vector<std::vector<char>> &PacketBufferPool::Buffers() {
+	thread_local std::vector<std::vector<char>> buffers;
+	return buffers;
+}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Export.hpp"
+
+namespace acid {
+/**
+ * @brief A per-thread free list of packet byte buffers.
+ *
+ * Packets acquire their storage from the pool when constructed and release it when destroyed,
+ * so a steady stream of packets reuses the same allocations instead of growing a new buffer each time.
+ * Each thread keeps its own list, which makes acquire and release lock free. Buffers larger than
+ * MaxCapacity are freed instead of pooled, so a single huge packet does not pin memory.
+ */
+class ACID_EXPORT PacketBufferPool {
+public:
+	/// Maximum number of buffers kept per thread.
+	static constexpr std::size_t MaxBuffers = 64;
+	/// Largest buffer capacity that is kept in the pool.
+	static constexpr std::size_t MaxCapacity = 256 * 1024;
+	/// Capacity given to new buffers, large enough for most packets to never reallocate.
+	static constexpr std::size_t DefaultCapacity = 1024;
+
+	/**
+	 * Takes an empty buffer from the pool, allocating one if the pool is empty.
+	 * @param capacity The minimum capacity of the buffer.
+	 * @return The empty buffer.
+	 */
+	static std::vector<char> Acquire(std::size_t capacity = DefaultCapacity);
+
+	/**
+	 * Returns a buffer to the pool, the contents are discarded.
+	 * @param buffer The buffer to release.
+	 */
+	static void Release(std::vector<char> &&buffer);
+
+private:
+	static std::vector<std::vector<char>> &Buffers();
+};
+}
@@ -42,6 +42,7 @@ using SocketAddrLength = unsigned int;
  */
 class ACID_EXPORT Socket {
 	friend class SocketSelector;
+	friend class SocketPoller;
 public:
 	/**
 	 * @brief Status codes that may be returned by socket functions.
@@ -0,0 +1,279 @@
+#include "SocketPoller.hpp"
+
+#include <unordered_map>
+#if defined(ACID_BUILD_WINDOWS)
+#include <WinSock2.h>
+#elif defined(ACID_BUILD_LINUX)
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <poll.h>
+#include <errno.h>
+#endif
+
+#include "Engine/Log.hpp"
+#include "Socket.hpp"
+
+namespace acid {
+static int32_t TimeoutMilliseconds(const Time &timeout) {
+	// Rounds up so that a small timeout does not become a busy poll.
+	return timeout != 0s ? static_cast<int32_t>((timeout.AsMicroseconds() + 999) / 1000) : -1;
+}
+
+#if defined(ACID_BUILD_LINUX)
+struct SocketPoller::SocketPollerImpl {
+	/// The epoll instance handle.
+	int epoll = -1;
+	/// Events filled by epoll_wait, grows when it is filled completely.
+	std::vector<epoll_event> events = std::vector<epoll_event>(64);
+	/// Sockets in the poller by handle.
+	std::unordered_map<SocketHandle, Socket *> sockets;
+};
+
+static uint32_t ToNative(const BitMask<SocketEvent> &events) {
+	uint32_t native = EPOLLET | EPOLLRDHUP;
+	if (events & SocketEvent::Read)
+		native |= EPOLLIN;
+	if (events & SocketEvent::Write)
+		native |= EPOLLOUT;
+	return native;
+}
+
+static BitMask<SocketEvent> FromNative(uint32_t native) {
+	BitMask<SocketEvent> events;
+	if (native & EPOLLIN)
+		events |= SocketEvent::Read;
+	if (native & EPOLLOUT)
+		events |= SocketEvent::Write;
+	if (native & (EPOLLHUP | EPOLLRDHUP))
+		events |= SocketEvent::Hangup;
+	if (native & EPOLLERR)
+		events |= SocketEvent::Error;
+	return events;
+}
+
+SocketPoller::SocketPoller() :
+	impl(std::make_unique<SocketPollerImpl>()) {
+	impl->epoll = epoll_create1(EPOLL_CLOEXEC);
+
+	if (impl->epoll == -1)
+		Log::Error("Failed to create epoll instance: ", errno, '\n');
+}
+
+SocketPoller::~SocketPoller() {
+	if (impl->epoll != -1)
+		close(impl->epoll);
+}
+
+bool SocketPoller::Add(Socket &socket, const BitMask<SocketEvent> &events) {
+	auto handle = socket.GetHandle();
+
+	if (handle == Socket::InvalidSocketHandle() || impl->sockets.find(handle) != impl->sockets.end())
+		return false;
+
+	socket.SetBlocking(false);
+
+	epoll_event event = {};
+	event.events = ToNative(events);
+	event.data.ptr = &socket;
+
+	if (epoll_ctl(impl->epoll, EPOLL_CTL_ADD, handle, &event) == -1) {
+		Log::Error("Failed to add socket to epoll: ", errno, '\n');
+		return false;
+	}
+
+	impl->sockets.emplace(handle, &socket);
+	return true;
+}
+
+bool SocketPoller::Modify(Socket &socket, const BitMask<SocketEvent> &events) {
+	auto handle = socket.GetHandle();
+
+	if (impl->sockets.find(handle) == impl->sockets.end())
+		return false;
+
+	epoll_event event = {};
+	event.events = ToNative(events);
+	event.data.ptr = &socket;
+	return epoll_ctl(impl->epoll, EPOLL_CTL_MOD, handle, &event) != -1;
+}
+
+void SocketPoller::Remove(Socket &socket) {
+	auto handle = socket.GetHandle();
+
+	if (impl->sockets.erase(handle) == 0)
+		return;
+
+	epoll_ctl(impl->epoll, EPOLL_CTL_DEL, handle, nullptr);
+
+	// The socket may still be in the ready list of the current iteration.
+	for (auto &r : ready) {
+		if (r.socket == &socket)
+			r.events = SocketEvent::None;
+	}
+}
+
+void SocketPoller::Clear() {
+	for (const auto &[handle, socket] : impl->sockets)
+		epoll_ctl(impl->epoll, EPOLL_CTL_DEL, handle, nullptr);
+
+	impl->sockets.clear();
+	ready.clear();
+}
+
+std::size_t SocketPoller::Wait(Time timeout) {
+	ready.clear();
+
+	auto count = epoll_wait(impl->epoll, impl->events.data(), static_cast<int>(impl->events.size()), TimeoutMilliseconds(timeout));
+
+	if (count <= 0)
+		return 0;
+
+	ready.reserve(count);
+
+	for (int i = 0; i < count; i++) {
+		auto &event = impl->events[i];
+		ready.push_back({static_cast<Socket *>(event.data.ptr), FromNative(event.events)});
+	}
+
+	// Any remaining events are returned by the next wait, grow so they can be collected in one call.
+	if (static_cast<std::size_t>(count) == impl->events.size())
+		impl->events.resize(impl->events.size() * 2);
+
+	return ready.size();
+}
+
+std::size_t SocketPoller::GetSocketCount() const {
+	return impl->sockets.size();
+}
+#else
+#if defined(ACID_BUILD_WINDOWS)
+using PollFd = WSAPOLLFD;
+#define ACID_POLL WSAPoll
+#else
+using PollFd = pollfd;
+#define ACID_POLL poll
+#endif
+
+struct SocketPoller::SocketPollerImpl {
+	/// Poll descriptors, parallel to sockets.
+	std::vector<PollFd> fds;
+	std::vector<Socket *> sockets;
+	/// Index into fds by handle.
+	std::unordered_map<SocketHandle, std::size_t> indices;
+};
+
+static short ToNative(const BitMask<SocketEvent> &events) {
+	short native = 0;
+	if (events & SocketEvent::Read)
+		native |= POLLIN;
+	if (events & SocketEvent::Write)
+		native |= POLLOUT;
+	return native;
+}
+
+static BitMask<SocketEvent> FromNative(short native) {
+	BitMask<SocketEvent> events;
+	if (native & POLLIN)
+		events |= SocketEvent::Read;
+	if (native & POLLOUT)
+		events |= SocketEvent::Write;
+	if (native & POLLHUP)
+		events |= SocketEvent::Hangup;
+	if (native & (POLLERR | POLLNVAL))
+		events |= SocketEvent::Error;
+	return events;
+}
+
+SocketPoller::SocketPoller() :
+	impl(std::make_unique<SocketPollerImpl>()) {
+}
+
+SocketPoller::~SocketPoller() = default;
+
+bool SocketPoller::Add(Socket &socket, const BitMask<SocketEvent> &events) {
+	auto handle = socket.GetHandle();
+
+	if (handle == Socket::InvalidSocketHandle() || impl->indices.find(handle) != impl->indices.end())
+		return false;
+
+	socket.SetBlocking(false);
+
+	PollFd fd = {};
+	fd.fd = handle;
+	fd.events = ToNative(events);
+	impl->indices.emplace(handle, impl->fds.size());
+	impl->fds.emplace_back(fd);
+	impl->sockets.emplace_back(&socket);
+	return true;
+}
+
+bool SocketPoller::Modify(Socket &socket, const BitMask<SocketEvent> &events) {
+	auto it = impl->indices.find(socket.GetHandle());
+
+	if (it == impl->indices.end())
+		return false;
+
+	impl->fds[it->second].events = ToNative(events);
+	return true;
+}
+
+void SocketPoller::Remove(Socket &socket) {
+	auto it = impl->indices.find(socket.GetHandle());
+
+	if (it == impl->indices.end())
+		return;
+
+	// Swap the last socket into the removed slot.
+	auto index = it->second;
+	impl->indices.erase(it);
+
+	if (index != impl->fds.size() - 1) {
+		impl->fds[index] = impl->fds.back();
+		impl->sockets[index] = impl->sockets.back();
+		impl->indices[impl->fds[index].fd] = index;
+	}
+
+	impl->fds.pop_back();
+	impl->sockets.pop_back();
+
+	for (auto &r : ready) {
+		if (r.socket == &socket)
+			r.events = SocketEvent::None;
+	}
+}
+
+void SocketPoller::Clear() {
+	impl->fds.clear();
+	impl->sockets.clear();
+	impl->indices.clear();
+	ready.clear();
+}
+
+std::size_t SocketPoller::Wait(Time timeout) {
+	ready.clear();
+
+	if (impl->fds.empty())
+		return 0;
+
+	auto count = ACID_POLL(impl->fds.data(), static_cast<unsigned long>(impl->fds.size()), TimeoutMilliseconds(timeout));
+
+	if (count <= 0)
+		return 0;
+
+	ready.reserve(count);
+
+	for (std::size_t i = 0; i < impl->fds.size() && ready.size() < static_cast<std::size_t>(count); i++) {
+		if (impl->fds[i].revents != 0)
+			ready.push_back({impl->sockets[i], FromNative(impl->fds[i].revents)});
+	}
+
+	return ready.size();
+}
+
+std::size_t SocketPoller::GetSocketCount() const {
+	return impl->fds.size();
+}
+#endif
+}
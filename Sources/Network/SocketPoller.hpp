@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Maths/Time.hpp"
+#include "Utils/EnumClass.hpp"
+
+namespace acid {
+class Socket;
+
+enum class SocketEvent : uint8_t {
+	None = 0,
+	/// The socket has data to receive, or a listener has a connection to accept.
+	Read = 1,
+	/// The socket can send without blocking, or a non-blocking connect has finished.
+	Write = 2,
+	/// The remote peer closed the connection.
+	Hangup = 4,
+	/// An error is pending on the socket.
+	Error = 8
+};
+
+ENABLE_BITMASK_OPERATORS(SocketEvent);
+
+/**
+ * @brief Socket pollers are a scalable alternative to acid::SocketSelector for processes that hold many sockets.
+ *
+ * On Linux the poller is backed by epoll in edge-triggered mode, there is no limit on the number of sockets
+ * and waiting does not rebuild any state, so the cost of Wait grows with the number of ready sockets instead of
+ * the number of registered sockets. Other platforms fall back to poll (WSAPoll on Windows) with the same interface,
+ * which also removes the FD_SETSIZE limit but is level-triggered.
+ *
+ * All types of sockets can be used in a poller:
+ * \li acid::TcpListener
+ * \li acid::TcpSocket
+ * \li acid::UdpSocket
+ *
+ * Because readiness is only reported when it changes, sockets are switched to non-blocking mode when added,
+ * and after a read event the socket must be drained until it returns Socket::Status::NotReady.
+ * Like the selector, the poller keeps a weak reference to each socket, remove sockets before they are closed or destroyed.
+ *
+ * Using a poller is simple:
+ * \li add all the sockets that you want to observe with the events you are interested in
+ * \li wait until some of them are ready
+ * \li iterate the ready list returned by GetReady
+ */
+class ACID_EXPORT SocketPoller {
+public:
+	/**
+	 * @brief A socket reported by the last call to Wait, with the events that are ready on it.
+	 */
+	class Ready {
+	public:
+		/// The socket that is ready.
+		Socket *socket = nullptr;
+		/// The events that are ready on the socket.
+		BitMask<SocketEvent> events;
+	};
+
+	/**
+	 * Default constructor.
+	 */
+	SocketPoller();
+
+	/**
+	 * Destructor that releases the OS poller, the sockets are not closed.
+	 */
+	~SocketPoller();
+
+	SocketPoller(const SocketPoller &) = delete;
+	SocketPoller &operator=(const SocketPoller &) = delete;
+
+	/**
+	 * Add a socket to the poller.
+	 * This function does nothing if the socket is not valid or has already been added.
+	 * @param socket Reference to the socket to add, it will be set to non-blocking.
+	 * @param events The events to wait for.
+	 * @return True if the socket was added, false otherwise.
+	 */
+	bool Add(Socket &socket, const BitMask<SocketEvent> &events = SocketEvent::Read);
+
+	/**
+	 * Change the events a socket is waiting for.
+	 * @param socket Reference to a socket already in the poller.
+	 * @param events The events to wait for.
+	 * @return True if the socket was modified, false otherwise.
+	 */
+	bool Modify(Socket &socket, const BitMask<SocketEvent> &events);
+
+	/**
+	 * Remove a socket from the poller.
+	 * This function doesn't destroy the socket, it simply removes the reference that the poller has to it.
+	 * @param socket Reference to the socket to remove.
+	 */
+	void Remove(Socket &socket);
+
+	/**
+	 * Remove all the sockets stored in the poller.
+	 */
+	void Clear();
+
+	/**
+	 * Wait until one or more sockets are ready.
+	 * If you use a timeout and no socket is ready before the timeout is over, the function returns 0.
+	 * @param timeout Maximum time to wait, (use 0s for infinity).
+	 * @return The number of sockets that are ready.
+	 */
+	std::size_t Wait(Time timeout = 0s);
+
+	/**
+	 * Gets the sockets reported as ready by the last call to Wait.
+	 * @return The ready list.
+	 */
+	const std::vector<Ready> &GetReady() const { return ready; }
+
+	/**
+	 * Gets the number of sockets in the poller.
+	 * @return The number of sockets.
+	 */
+	std::size_t GetSocketCount() const;
+
+private:
+	struct SocketPollerImpl;
+
+	/// Opaque pointer to the implementation (which requires OS-specific types).
+	std::unique_ptr<SocketPollerImpl> impl;
+	std::vector<Ready> ready;
+};
+}
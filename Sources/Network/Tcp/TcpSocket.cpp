@@ -5,7 +5,10 @@
 #include <WinSock2.h>
 #else
 #include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
+#include <climits>
 #endif
 
 #include "Engine/Log.hpp"
@@ -24,6 +27,41 @@ const int32_t flags = MSG_NOSIGNAL;
 const int32_t flags = 0;
 #endif
 
+// Scatter-gather buffers, these share a layout with the OS type so they can be passed straight through.
+#if defined(ACID_BUILD_WINDOWS)
+using IoBuffer = WSABUF;
+
+static IoBuffer MakeIoBuffer(const char *data, std::size_t size) {
+	return {static_cast<ULONG>(size), const_cast<CHAR *>(data)};
+}
+
+static char *&IoBufferData(IoBuffer &buffer) { return buffer.buf; }
+static ULONG &IoBufferSize(IoBuffer &buffer) { return buffer.len; }
+
+static int64_t SendIoBuffers(SocketHandle handle, IoBuffer *buffers, std::size_t count) {
+	DWORD sent = 0;
+	if (WSASend(handle, buffers, static_cast<DWORD>(std::min<std::size_t>(count, 1024)), &sent, 0, nullptr, nullptr) == SOCKET_ERROR)
+		return -1;
+	return sent;
+}
+#else
+using IoBuffer = iovec;
+
+static IoBuffer MakeIoBuffer(const char *data, std::size_t size) {
+	return {const_cast<char *>(data), size};
+}
+
+static char *&IoBufferData(IoBuffer &buffer) { return reinterpret_cast<char *&>(buffer.iov_base); }
+static std::size_t &IoBufferSize(IoBuffer &buffer) { return buffer.iov_len; }
+
+static int64_t SendIoBuffers(SocketHandle handle, IoBuffer *buffers, std::size_t count) {
+	msghdr message = {};
+	message.msg_iov = buffers;
+	message.msg_iovlen = std::min<std::size_t>(count, IOV_MAX);
+	return sendmsg(handle, &message, flags);
+}
+#endif
+
 TcpSocket::TcpSocket() :
 	Socket(Type::Tcp) {
 }
@@ -220,39 +258,92 @@ Socket::Status TcpSocket::Receive(void *data, std::size_t size, std::size_t &rec
 }
 
 Socket::Status TcpSocket::Send(Packet &packet) {
+	auto packets = &packet;
+	return Send(&packets, 1);
+}
+
+Socket::Status TcpSocket::Send(Packet *const *packets, std::size_t count) {
 	// TCP is a stream protocol, it doesn't preserve messages boundaries.
 	// This means that we have to send the packet size first, so that the
 	// receiver knows the actual end of the packet in the data stream.
 
-	// We allocate an extra memory block so that the size can be sent
-	// together with the data in a single call. This may seem inefficient,
-	// but it is actually required to avoid partial send, which could cause
-	// data corruption on the receiving end.
+	// The size is written into the header bytes each packet reserves in front of its data,
+	// the size and data are then gathered into a single send so they can't be split by a
+	// partial send, which could cause data corruption on the receiving end.
+	std::vector<IoBuffer> buffers;
+	std::vector<std::size_t> frameSizes(count);
+	buffers.reserve(count * 2);
 
-	// Get the data to send from the packet.
-	auto dataSize = packet.OnSend();
+	for (std::size_t i = 0; i < count; ++i) {
+		auto packet = packets[i];
 
-	// First convert the packet size to network byte order
-	uint32_t packetSize = htonl(static_cast<uint32_t>(dataSize.second));
+		// Get the data to send from the packet.
+		auto [data, size] = packet->OnSend();
 
-	// Allocate memory for the data block to send
-	std::vector<char> blockToSend(sizeof(packetSize) + dataSize.second);
+		// Write the packet size in network byte order into the reserved header.
+		uint32_t packetSize = htonl(static_cast<uint32_t>(size));
+		std::memcpy(packet->data.data(), &packetSize, sizeof(packetSize));
 
-	// Copy the packet size and data into the block to send
-	std::memcpy(&blockToSend[0], &packetSize, sizeof(packetSize));
+		auto header = packet->data.data();
+		auto frameSize = frameSizes[i] = Packet::HeaderSize + size;
 
-	if (dataSize.second > 0)
-		std::memcpy(&blockToSend[0] + sizeof(packetSize), dataSize.first, dataSize.second);
+		if (packet->sendPos >= frameSize)
+			continue;
 
-	// Send the data block.
-	std::size_t sent;
-	auto status = Send(&blockToSend[0] + packet.sendPos, blockToSend.size() - packet.sendPos, sent);
+		// Packets that send their own data are contiguous with the header, others are gathered from two buffers.
+		if (size == 0 || data == header + Packet::HeaderSize) {
+			buffers.emplace_back(MakeIoBuffer(header + packet->sendPos, frameSize - packet->sendPos));
+		} else if (packet->sendPos < Packet::HeaderSize) {
+			buffers.emplace_back(MakeIoBuffer(header + packet->sendPos, Packet::HeaderSize - packet->sendPos));
+			buffers.emplace_back(MakeIoBuffer(static_cast<const char *>(data), size));
+		} else {
+			buffers.emplace_back(MakeIoBuffer(static_cast<const char *>(data) + packet->sendPos - Packet::HeaderSize, frameSize - packet->sendPos));
+		}
+	}
+
+	// Loop until every byte has been sent.
+	std::size_t sent = 0;
+	auto status = Status::Done;
 
-	// In the case of a partial send, record the location to resume from
-	if (status == Status::Partial)
-		packet.sendPos += sent;
-	else if (status == Status::Done)
-		packet.sendPos = 0;
+	for (std::size_t first = 0; first < buffers.size();) {
+		auto result = SendIoBuffers(GetHandle(), &buffers[first], buffers.size() - first);
+
+		// Check for errors.
+		if (result < 0) {
+			status = GetErrorStatus();
+
+			if (status == Status::NotReady && sent)
+				status = Status::Partial;
+
+			break;
+		}
+
+		sent += static_cast<std::size_t>(result);
+
+		// Skip the buffers that were sent completely, and advance into the one that was sent partially.
+		for (auto remaining = static_cast<std::size_t>(result); remaining > 0 && first < buffers.size();) {
+			if (remaining >= IoBufferSize(buffers[first])) {
+				remaining -= IoBufferSize(buffers[first]);
+				++first;
+			} else {
+				IoBufferData(buffers[first]) += remaining;
+				IoBufferSize(buffers[first]) -= static_cast<std::size_t>(remaining);
+				remaining = 0;
+			}
+		}
+	}
+
+	if (status == Status::Done) {
+		for (std::size_t i = 0; i < count; ++i)
+			packets[i]->sendPos = 0;
+	} else if (status == Status::Partial) {
+		// In the case of a partial send, record the location to resume from in each packet.
+		for (std::size_t i = 0; i < count && sent > 0; ++i) {
+			auto consumed = std::min(sent, frameSizes[i] - std::min(packets[i]->sendPos, frameSizes[i]));
+			packets[i]->sendPos += consumed;
+			sent -= consumed;
+		}
+	}
 
 	return status;
 }
@@ -283,23 +374,22 @@ Socket::Status TcpSocket::Receive(Packet &packet) {
 		packetSize = ntohl(pendingPacket.size);
 	}
 
-	// Loop until we receive all the packet data.
-	char buffer[1024];
+	// The size comes from the peer, refuse it before allocating. The stream can't be resynchronized after this.
+	if (packetSize > maxPacketSize) {
+		Disconnect();
+		return Status::Error;
+	}
+
+	// Loop until we receive all the packet data, straight into the pending buffer.
+	pendingPacket.data.resize(packetSize);
 
-	while (pendingPacket.data.size() < packetSize) {
+	while (pendingPacket.dataReceived < packetSize) {
 		// Receive a chunk of data.
-		auto sizeToGet = std::min(static_cast<std::size_t>(packetSize - pendingPacket.data.size()), sizeof(buffer));
-		auto status = Receive(buffer, sizeToGet, received);
+		auto status = Receive(&pendingPacket.data[pendingPacket.dataReceived], packetSize - pendingPacket.dataReceived, received);
+		pendingPacket.dataReceived += received;
 
 		if (status != Status::Done)
 			return status;
-
-		// Append it into the packet.
-		if (received > 0) {
-			pendingPacket.data.resize(pendingPacket.data.size() + received);
-			auto begin = &pendingPacket.data[0] + pendingPacket.data.size() - received;
-			std::memcpy(begin, buffer, received);
-		}
 	}
 
 	// We have received all the packet data: we can copy it to the user packet.
@@ -40,6 +40,8 @@ public:
 	uint32_t size = 0;
 	/// Number of size bytes received so far.
 	std::size_t sizeReceived = 0;
+	/// Number of data bytes received so far.
+	std::size_t dataReceived = 0;
 	/// Data of the packet.
 	std::vector<char> data;
 };
@@ -50,6 +52,9 @@ public:
 class ACID_EXPORT TcpSocket : public Socket {
 	friend class TcpListener;
 public:
+	/// Largest packet accepted by default, in bytes.
+	static constexpr uint32_t DefaultMaxPacketSize = 16 * 1024 * 1024;
+
 	/**
 	 * Default constructor.
 	 */
@@ -134,17 +139,35 @@ public:
 	 */
 	Status Send(Packet &packet);
 
+	/**
+	 * Send several formatted packets to the remote peer, gathered into as few system calls as possible.
+	 * Each packet is framed with its size written in place into the packet's reserved header, no data is copied.
+	 * In non-blocking mode, if this function returns Status::Partial, you \em must retry sending the same unmodified
+	 * packets, packets that were already sent completely are skipped on the retry.
+	 * This function will fail if the socket is not connected.
+	 * @param packets Packets to send, in order.
+	 * @param count Number of packets.
+	 * @return Status code.
+	 */
+	Status Send(Packet *const *packets, std::size_t count);
+
 	/**
 	 * Receive a formatted packet of data from the remote peer.
 	 * In blocking mode, this function will wait until the whole packet has been received.
 	 * This function will fail if the socket is not connected.
+	 * If the peer announces a packet larger than the maximum packet size the socket is disconnected and Status::Error is returned.
 	 * @param packet Packet to fill with the received data.
 	 * @return Status code.
 	 */
 	Status Receive(Packet &packet);
 
+	uint32_t GetMaxPacketSize() const { return maxPacketSize; }
+	void SetMaxPacketSize(uint32_t maxPacketSize) { this->maxPacketSize = maxPacketSize; }
+
 private:
 	/// Temporary data of the packet currently being received.
 	PendingPacket pendingPacket;
+	/// Largest packet size accepted from the peer, in bytes.
+	uint32_t maxPacketSize = DefaultMaxPacketSize;
 };
 }
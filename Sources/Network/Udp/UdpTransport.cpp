@@ -0,0 +1,677 @@
+#include "UdpTransport.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "Engine/Log.hpp"
+#include "Network/Packet.hpp"
+
+namespace acid {
+static constexpr uint16_t ProtocolId = 0xAC1D;
+static constexpr std::size_t MaxDatagramSize = 65507;
+
+enum class DatagramType : uint8_t {
+	Connect, Accept, Data, Disconnect
+};
+
+/// Protocol id, type, sequence, ack and ack bits.
+static constexpr std::size_t DatagramHeaderSize = 2 + 1 + 2 + 2 + 4;
+/// Channel, message id and length.
+static constexpr std::size_t MessageHeaderSize = 1 + 2 + 2;
+/// Fragment index and count, present when the channel byte has FragmentFlag set.
+static constexpr std::size_t FragmentHeaderSize = 2 + 2;
+static constexpr uint8_t FragmentFlag = 0x80;
+/// Set on the datagram type when the ack fields are valid, they are not until a datagram is received from the peer.
+static constexpr uint8_t AckFlag = 0x80;
+static constexpr uint16_t MaxFragments = 0xFFFF;
+/// Reliable messages further than this ahead of the oldest unacknowledged message are held back.
+static constexpr uint16_t ReliableWindow = 1024;
+/// Unreliable assemblies kept per channel before the oldest are dropped.
+static constexpr std::size_t MaxAssemblies = 32;
+/// Reliable assemblies in progress per channel, new reliable messages past this are refused until earlier ones are delivered.
+static constexpr std::size_t MaxReliableAssemblies = 256;
+/// Datagrams received before an ack is sent without waiting for the next update.
+static constexpr uint32_t AckBurst = 16;
+
+static constexpr Time ConnectInterval = 250ms;
+static constexpr Time KeepAliveInterval = 250ms;
+static constexpr Time ConnectionTimeout = 5s;
+static constexpr Time MinResendTimeout = 30ms;
+static constexpr Time MaxBurst = 50ms;
+/// Round trips this far above twice the lowest round trip are taken as a sign of congestion.
+static constexpr Time CongestionDelay = 20ms;
+/// Smoothed packet loss above which losses are taken as a sign of congestion.
+static constexpr float CongestionLoss = 0.25f;
+
+static constexpr float MinSendRate = 16.0f * 1024.0f;
+static constexpr float InitialSendRate = 256.0f * 1024.0f;
+static constexpr float MaxSendRate = 8.0f * 1024.0f * 1024.0f;
+
+// Payload carried by each fragment of a message that does not fit in one datagram.
+static std::size_t GetFragmentSize(std::size_t mtu) {
+	return mtu - DatagramHeaderSize - MessageHeaderSize - FragmentHeaderSize;
+}
+
+// Sequence numbers wrap around, a is newer than b if it is ahead by less than half the range.
+static bool SequenceGreater(uint16_t a, uint16_t b) {
+	return a != b && static_cast<uint16_t>(a - b) < 0x8000;
+}
+
+static void Write8(std::vector<uint8_t> &buffer, uint8_t value) {
+	buffer.emplace_back(value);
+}
+
+static void Write16(std::vector<uint8_t> &buffer, uint16_t value) {
+	buffer.emplace_back(static_cast<uint8_t>(value >> 8));
+	buffer.emplace_back(static_cast<uint8_t>(value));
+}
+
+static void Write32(std::vector<uint8_t> &buffer, uint32_t value) {
+	Write16(buffer, static_cast<uint16_t>(value >> 16));
+	Write16(buffer, static_cast<uint16_t>(value));
+}
+
+static uint16_t Read16(const uint8_t *data) {
+	return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+static uint32_t Read32(const uint8_t *data) {
+	return (static_cast<uint32_t>(Read16(data)) << 16) | Read16(data + 2);
+}
+
+static std::vector<uint8_t> DatagramHeader(DatagramType type) {
+	std::vector<uint8_t> buffer;
+	Write16(buffer, ProtocolId);
+	Write8(buffer, static_cast<uint8_t>(type));
+	return buffer;
+}
+
+UdpConnection::UdpConnection(UdpTransport &transport, const IpAddress &address, uint16_t port, State state) :
+	transport(transport),
+	address(address),
+	port(port),
+	state(state),
+	sendRate(InitialSendRate) {
+	for (auto delivery : transport.GetChannels()) {
+		Channel channel;
+		channel.delivery = delivery;
+		channels.emplace_back(std::move(channel));
+	}
+
+	created = lastReceive = lastUpdate = Time::Now();
+	lastSend = created - ConnectInterval;
+}
+
+bool UdpConnection::Send(uint8_t channel, Packet &packet) {
+	if (state == State::Disconnected || channel >= channels.size())
+		return false;
+
+	auto [data, size] = packet.OnSend();
+
+	if (size > transport.GetMaxMessageSize()) {
+		Log::Error("Cannot send message over UdpTransport, ", size, " bytes is greater than the maximum message size\n");
+		return false;
+	}
+
+	auto &sendChannel = channels[channel];
+	auto messageId = sendChannel.nextSendId++;
+
+	// Messages that do not fit in one datagram are split into fragments that are reassembled by the peer.
+	auto fragmentSize = GetFragmentSize(transport.GetMtu());
+	auto fragmentCount = static_cast<uint16_t>(size + MessageHeaderSize + DatagramHeaderSize <= transport.GetMtu() ? 1 : (size + fragmentSize - 1) / fragmentSize);
+	auto bytes = static_cast<const uint8_t *>(data);
+
+	for (uint16_t i = 0; i < fragmentCount; i++) {
+		Unit unit;
+		unit.channel = channel;
+		unit.messageId = messageId;
+		unit.fragmentIndex = i;
+		unit.fragmentCount = fragmentCount;
+		auto offset = static_cast<std::size_t>(i) * fragmentSize;
+		auto length = fragmentCount == 1 ? size : std::min(fragmentSize, size - offset);
+		unit.data.assign(bytes + offset, bytes + offset + length);
+
+		if (sendChannel.delivery == UdpDelivery::Reliable) {
+			auto key = UnitKey(channel, messageId, i);
+			reliableQueue.emplace_back(std::move(unit));
+			reliableUnits[key] = std::prev(reliableQueue.end());
+		} else {
+			unreliableQueue.emplace_back(std::move(unit));
+		}
+	}
+
+	return true;
+}
+
+bool UdpConnection::Receive(uint8_t &channel, Packet &packet) {
+	if (receivedMessages.empty())
+		return false;
+
+	auto &[messageChannel, data] = receivedMessages.front();
+	channel = messageChannel;
+	packet.Clear();
+	if (!data.empty())
+		packet.OnReceive(data.data(), data.size());
+	receivedMessages.pop_front();
+	return true;
+}
+
+void UdpConnection::Disconnect() {
+	if (state == State::Disconnected)
+		return;
+
+	// The notice is not acknowledged, so it is sent a few times in case some are lost.
+	for (uint32_t i = 0; i < 3; i++)
+		transport.SendControl(address, port, static_cast<uint8_t>(DatagramType::Disconnect));
+
+	state = State::Disconnected;
+	transport.onDisconnect(*this);
+}
+
+uint64_t UdpConnection::UnitKey(uint8_t channel, uint16_t messageId, uint16_t fragmentIndex) {
+	return (static_cast<uint64_t>(channel) << 32) | (static_cast<uint64_t>(messageId) << 16) | fragmentIndex;
+}
+
+void UdpConnection::Update(const Time &now) {
+	if (state == State::Disconnected)
+		return;
+
+	if (now - lastReceive > ConnectionTimeout) {
+		Log::Warning("UdpConnection to ", address, ':', port, " timed out\n");
+		state = State::Disconnected;
+		transport.onDisconnect(*this);
+		return;
+	}
+
+	if (state == State::Connecting) {
+		if (now - lastSend >= ConnectInterval) {
+			transport.SendControl(address, port, static_cast<uint8_t>(DatagramType::Connect));
+			lastSend = now;
+		}
+		return;
+	}
+
+	// Datagrams that are still unacknowledged long after the resend timeout are counted as lost.
+	auto lostAfter = std::max(roundTripTime * int64_t(2) + roundTripVariance * int64_t(4), Time(200ms));
+	for (auto &datagram : sentDatagrams) {
+		if (datagram.valid && !datagram.acked && now - datagram.sent > lostAfter) {
+			datagram.valid = false;
+			OnDatagramLost(now);
+		}
+	}
+
+	// Refill the send budget, capped so an idle connection can't burst far above its rate.
+	sendBudget = std::min(sendBudget + sendRate * (now - lastUpdate).AsSeconds(), std::max(sendRate * MaxBurst.AsSeconds(), static_cast<float>(transport.GetMtu())));
+	lastUpdate = now;
+
+	auto resendTimeout = std::max(roundTripTime + roundTripVariance * int64_t(4), MinResendTimeout);
+	auto payloadSize = transport.GetMtu() - DatagramHeaderSize;
+
+	std::vector<Unit *> datagram;
+	std::size_t datagramSize = 0;
+	bool sentData = false;
+
+	// Datagrams are held back when the send budget is spent, or when every slot for tracking acks is in flight.
+	auto flush = [&]() -> bool {
+		if (datagram.empty())
+			return true;
+		auto &slot = sentDatagrams[localSequence % sentDatagrams.size()];
+		if (sendBudget <= 0.0f || (slot.valid && !slot.acked))
+			return false;
+		SendDatagram(datagram, now);
+		datagram.clear();
+		datagramSize = 0;
+		sentData = true;
+		return true;
+	};
+
+	auto add = [&](Unit &unit) -> bool {
+		auto unitSize = MessageHeaderSize + (unit.fragmentCount > 1 ? FragmentHeaderSize : 0) + unit.data.size();
+		if (datagramSize + unitSize > payloadSize && !flush())
+			return false;
+		datagram.emplace_back(&unit);
+		datagramSize += unitSize;
+		return true;
+	};
+
+	// Reliable units that are new or overdue for a resend go first, in the order they were queued.
+	bool budgetLeft = true;
+	if (!reliableQueue.empty()) {
+		std::vector<uint16_t> windowStart(channels.size());
+		std::vector<bool> windowSet(channels.size());
+
+		for (auto &unit : reliableQueue) {
+			if (!windowSet[unit.channel]) {
+				windowStart[unit.channel] = unit.messageId;
+				windowSet[unit.channel] = true;
+			}
+
+			if (static_cast<uint16_t>(unit.messageId - windowStart[unit.channel]) >= ReliableWindow)
+				continue;
+			if (unit.sent != Time() && now - unit.sent < resendTimeout)
+				continue;
+			if (!(budgetLeft = add(unit)))
+				break;
+		}
+	}
+
+	// Unreliable units are only useful now, any that do not fit in the send budget are dropped.
+	if (budgetLeft) {
+		for (auto &unit : unreliableQueue) {
+			if (!add(unit))
+				break;
+		}
+	}
+
+	flush();
+	datagram.clear();
+	unreliableQueue.clear();
+
+	// Acknowledge received datagrams even when there is nothing else to send, and keep the connection alive.
+	if (!sentData && (ackPending || now - lastSend >= KeepAliveInterval))
+		SendDatagram(datagram, now);
+}
+
+void UdpConnection::ProcessDatagram(const uint8_t *data, std::size_t size, const Time &now) {
+	lastReceive = now;
+
+	if (size < DatagramHeaderSize)
+		return;
+
+	auto sequence = Read16(data + 3);
+	auto ack = Read16(data + 5);
+	auto ackBits = Read32(data + 7);
+
+	// Duplicates are dropped.
+	if (remoteReceived && !SequenceGreater(sequence, remoteSequence)) {
+		auto distance = static_cast<uint16_t>(remoteSequence - sequence);
+		if (distance == 0 || distance > 32 || (remoteAckBits & (1u << (distance - 1))))
+			return;
+	}
+
+	if (data[2] & AckFlag)
+		ProcessAcks(ack, ackBits, now);
+
+	// A message may not have more fragments than the largest message needs.
+	auto fragmentSize = GetFragmentSize(transport.GetMtu());
+	auto maxFragments = (transport.GetMaxMessageSize() + fragmentSize - 1) / fragmentSize;
+
+	for (std::size_t offset = DatagramHeaderSize; offset + MessageHeaderSize <= size;) {
+		Unit unit;
+		auto channelByte = data[offset];
+		unit.channel = channelByte & ~FragmentFlag;
+		unit.messageId = Read16(data + offset + 1);
+		auto length = Read16(data + offset + 3);
+		offset += MessageHeaderSize;
+
+		if (channelByte & FragmentFlag) {
+			if (offset + FragmentHeaderSize > size)
+				return;
+			unit.fragmentIndex = Read16(data + offset);
+			unit.fragmentCount = Read16(data + offset + 2);
+			offset += FragmentHeaderSize;
+		}
+
+		if (offset + length > size || unit.channel >= channels.size() || unit.fragmentIndex >= unit.fragmentCount || unit.fragmentCount > maxFragments)
+			break;
+
+		unit.data.assign(data + offset, data + offset + length);
+		offset += length;
+
+		// A refused reliable message must be sent again, so the datagram is not acked and the peer sees it as lost.
+		if (!ProcessMessage(unit))
+			return;
+	}
+
+	// Track which of the peers datagrams were received.
+	if (!remoteReceived) {
+		remoteSequence = sequence;
+		remoteAckBits = 0;
+		remoteReceived = true;
+	} else if (SequenceGreater(sequence, remoteSequence)) {
+		auto shift = static_cast<uint16_t>(sequence - remoteSequence);
+		remoteAckBits = shift >= 32 ? (shift == 32 ? 1u << 31 : 0) : (remoteAckBits << shift) | (1u << (shift - 1));
+		remoteSequence = sequence;
+	} else {
+		remoteAckBits |= 1u << (static_cast<uint16_t>(remoteSequence - sequence) - 1);
+	}
+
+	ackPending = true;
+
+	// Acks only cover the last 33 datagrams, answer long bursts before the oldest fall out of the window.
+	if (++receivedSinceAck >= AckBurst) {
+		std::vector<Unit *> units;
+		SendDatagram(units, now);
+	}
+}
+
+void UdpConnection::ProcessAcks(uint16_t ack, uint32_t ackBits, const Time &now) {
+	for (uint32_t i = 0; i <= 32; i++) {
+		if (i > 0 && !(ackBits & (1u << (i - 1))))
+			continue;
+
+		auto sequence = static_cast<uint16_t>(ack - i);
+		auto &datagram = sentDatagrams[sequence % sentDatagrams.size()];
+
+		if (!datagram.valid || datagram.acked || datagram.sequence != sequence)
+			continue;
+
+		datagram.acked = true;
+
+		// Smoothed round trip time and variance, as in TCP (RFC 6298).
+		auto sample = now - datagram.sent;
+		if (!roundTripSampled) {
+			roundTripTime = sample;
+			roundTripVariance = sample / int64_t(2);
+			roundTripSampled = true;
+		} else {
+			auto difference = sample > roundTripTime ? sample - roundTripTime : roundTripTime - sample;
+			roundTripVariance = roundTripVariance * 0.75f + difference * 0.25f;
+			roundTripTime = roundTripTime * 0.875f + sample * 0.125f;
+		}
+
+		packetLoss *= 0.99f;
+
+		// Queues building up along the path show as round trips well above the lowest seen, back off before they overflow.
+		if (minRoundTripTime == 0s || sample < minRoundTripTime)
+			minRoundTripTime = sample;
+
+		if (sample > minRoundTripTime * int64_t(2) + CongestionDelay) {
+			OnCongestion(now);
+		} else {
+			// Additive increase, about one datagram per round trip at steady state.
+			sendRate = std::min(sendRate + static_cast<float>(datagram.size * transport.GetMtu()) / std::max(sendRate * roundTripTime.AsSeconds(), 1.0f), MaxSendRate);
+		}
+
+		for (auto key : datagram.reliable) {
+			if (auto it = reliableUnits.find(key); it != reliableUnits.end()) {
+				reliableQueue.erase(it->second);
+				reliableUnits.erase(it);
+			}
+		}
+
+		datagram.reliable.clear();
+	}
+}
+
+bool UdpConnection::ProcessMessage(const Unit &unit) {
+	auto &channel = channels[unit.channel];
+
+	switch (channel.delivery) {
+	case UdpDelivery::Reliable:
+		// Already delivered, the ack for it was lost.
+		if (SequenceGreater(channel.receiveId, unit.messageId))
+			return true;
+		if (static_cast<uint16_t>(unit.messageId - channel.receiveId) >= ReliableWindow)
+			return true;
+		break;
+	case UdpDelivery::UnreliableSequenced:
+		if (channel.received && !SequenceGreater(unit.messageId, channel.receiveId))
+			return true;
+		break;
+	default:
+		break;
+	}
+
+	auto found = channel.assemblies.find(unit.messageId);
+
+	if (found == channel.assemblies.end()) {
+		// Acked reliable fragments can't be dropped later, so new messages wait while the channel is full. The next message to
+		// deliver is always taken so the channel can't stall.
+		if (channel.delivery == UdpDelivery::Reliable && channel.assemblies.size() >= MaxReliableAssemblies && unit.messageId != channel.receiveId)
+			return false;
+		found = channel.assemblies.emplace(unit.messageId, Assembly()).first;
+	}
+
+	auto &assembly = found->second;
+
+	if (assembly.fragments.empty()) {
+		assembly.fragmentCount = unit.fragmentCount;
+		assembly.fragments.resize(unit.fragmentCount);
+	}
+
+	if (unit.fragmentCount != assembly.fragmentCount || !assembly.fragments[unit.fragmentIndex].empty() || (unit.data.empty() && unit.fragmentCount > 1))
+		return true;
+
+	assembly.fragments[unit.fragmentIndex] = unit.data;
+	assembly.fragmentsReceived++;
+
+	if (channel.delivery == UdpDelivery::Reliable) {
+		// Deliver every complete message in order.
+		for (auto it = channel.assemblies.find(channel.receiveId); it != channel.assemblies.end() &&
+			it->second.fragmentsReceived == it->second.fragmentCount; it = channel.assemblies.find(channel.receiveId)) {
+			Deliver(unit.channel, std::move(it->second));
+			channel.assemblies.erase(it);
+			channel.receiveId++;
+		}
+		return true;
+	}
+
+	if (assembly.fragmentsReceived == assembly.fragmentCount) {
+		Deliver(unit.channel, std::move(assembly));
+		channel.assemblies.erase(unit.messageId);
+
+		if (channel.delivery == UdpDelivery::UnreliableSequenced) {
+			channel.receiveId = unit.messageId;
+			channel.received = true;
+
+			// Partial messages older than the one delivered can never be delivered.
+			for (auto it = channel.assemblies.begin(); it != channel.assemblies.end();) {
+				if (!SequenceGreater(it->first, unit.messageId))
+					it = channel.assemblies.erase(it);
+				else
+					++it;
+			}
+		}
+	}
+
+	// Lost fragments leave incomplete unreliable messages behind, drop the oldest.
+	while (channel.assemblies.size() > MaxAssemblies) {
+		auto oldest = channel.assemblies.begin();
+		for (auto it = channel.assemblies.begin(); it != channel.assemblies.end(); ++it) {
+			if (SequenceGreater(oldest->first, it->first))
+				oldest = it;
+		}
+		channel.assemblies.erase(oldest);
+	}
+
+	return true;
+}
+
+void UdpConnection::Deliver(uint8_t index, Assembly &&assembly) {
+	if (assembly.fragments.size() == 1) {
+		receivedMessages.emplace_back(index, std::move(assembly.fragments[0]));
+		return;
+	}
+
+	std::vector<uint8_t> message;
+	for (auto &fragment : assembly.fragments)
+		message.insert(message.end(), fragment.begin(), fragment.end());
+	receivedMessages.emplace_back(index, std::move(message));
+}
+
+void UdpConnection::SendDatagram(std::vector<Unit *> &units, const Time &now) {
+	auto sequence = localSequence++;
+	auto buffer = DatagramHeader(DatagramType::Data);
+	buffer.reserve(transport.GetMtu());
+	if (remoteReceived)
+		buffer[2] |= AckFlag;
+	Write16(buffer, sequence);
+	Write16(buffer, remoteSequence);
+	Write32(buffer, remoteAckBits);
+
+	// Datagrams that only carry acks are not tracked, they are never resent and would take slots from data.
+	SentDatagram *record = nullptr;
+
+	if (!units.empty()) {
+		record = &sentDatagrams[sequence % sentDatagrams.size()];
+		record->valid = true;
+		record->acked = false;
+		record->sequence = sequence;
+		record->sent = now;
+		record->reliable.clear();
+	}
+
+	for (auto unit : units) {
+		auto fragmented = unit->fragmentCount > 1;
+		Write8(buffer, unit->channel | (fragmented ? FragmentFlag : 0));
+		Write16(buffer, unit->messageId);
+		Write16(buffer, static_cast<uint16_t>(unit->data.size()));
+		if (fragmented) {
+			Write16(buffer, unit->fragmentIndex);
+			Write16(buffer, unit->fragmentCount);
+		}
+		buffer.insert(buffer.end(), unit->data.begin(), unit->data.end());
+
+		if (channels[unit->channel].delivery == UdpDelivery::Reliable) {
+			unit->sent = now;
+			record->reliable.emplace_back(UnitKey(unit->channel, unit->messageId, unit->fragmentIndex));
+		}
+	}
+
+	if (record)
+		record->size = buffer.size();
+
+	sendBudget -= static_cast<float>(buffer.size());
+	ackPending = false;
+	receivedSinceAck = 0;
+	lastSend = now;
+	transport.SendDatagram(address, port, std::move(buffer));
+}
+
+void UdpConnection::OnDatagramLost(const Time &now) {
+	packetLoss = packetLoss * 0.99f + 0.01f;
+
+	// Some random loss is normal on wireless links, only sustained heavy loss is treated as congestion.
+	if (packetLoss > CongestionLoss)
+		OnCongestion(now);
+}
+
+void UdpConnection::OnCongestion(const Time &now) {
+	// Multiplicative decrease, at most once per round trip so one congestion event only halves the rate once.
+	if (now - lastCongestion > roundTripTime) {
+		sendRate = std::max(sendRate * 0.5f, MinSendRate);
+		lastCongestion = now;
+	}
+}
+
+UdpTransport::UdpTransport(std::vector<UdpDelivery> channels, std::size_t mtu) :
+	channels(std::move(channels)),
+	mtu(std::clamp<std::size_t>(mtu, 64, MaxDatagramSize)),
+	receiveBuffer(MaxDatagramSize),
+	random(std::random_device()()) {
+	if (this->channels.empty() || this->channels.size() > FragmentFlag)
+		throw std::runtime_error("UdpTransport requires between 1 and 127 channels");
+}
+
+Socket::Status UdpTransport::Bind(uint16_t port, const IpAddress &address) {
+	auto status = socket.Bind(port, address);
+	socket.SetBlocking(false);
+	return status;
+}
+
+UdpConnection *UdpTransport::Connect(const IpAddress &address, uint16_t port) {
+	if (auto connection = FindConnection(address, port))
+		return connection;
+
+	// Binds to any free port if Bind was not called.
+	if (socket.GetLocalPort() == 0)
+		Bind();
+
+	return connections.emplace_back(std::make_unique<UdpConnection>(*this, address, port, UdpConnection::State::Connecting)).get();
+}
+
+void UdpTransport::Update() {
+	auto now = Time::Now();
+
+	// Connections that were closed in the last update are released now.
+	connections.erase(std::remove_if(connections.begin(), connections.end(), [](const auto &connection) {
+		return connection->GetState() == UdpConnection::State::Disconnected;
+	}), connections.end());
+
+	IpAddress address;
+	uint16_t port;
+	std::size_t received;
+
+	while (socket.Receive(receiveBuffer.data(), receiveBuffer.size(), received, address, port) == Socket::Status::Done) {
+		if (received < 3 || Read16(receiveBuffer.data()) != ProtocolId)
+			continue;
+
+		auto type = static_cast<DatagramType>(receiveBuffer[2] & ~AckFlag);
+		auto connection = FindConnection(address, port);
+
+		switch (type) {
+		case DatagramType::Connect:
+			if (!connection) {
+				connection = connections.emplace_back(std::make_unique<UdpConnection>(*this, address, port, UdpConnection::State::Connected)).get();
+				onConnect(*connection);
+			}
+			// Accepts are resent for every connect in case the previous accept was lost.
+			SendControl(address, port, static_cast<uint8_t>(DatagramType::Accept));
+			break;
+		case DatagramType::Accept:
+			if (connection && connection->state == UdpConnection::State::Connecting) {
+				connection->state = UdpConnection::State::Connected;
+				connection->lastReceive = now;
+				onConnect(*connection);
+			}
+			break;
+		case DatagramType::Data:
+			if (connection && connection->state == UdpConnection::State::Connected)
+				connection->ProcessDatagram(receiveBuffer.data(), received, now);
+			break;
+		case DatagramType::Disconnect:
+			if (connection && connection->state != UdpConnection::State::Disconnected) {
+				connection->state = UdpConnection::State::Disconnected;
+				onDisconnect(*connection);
+			}
+			break;
+		}
+	}
+
+	for (auto &connection : connections)
+		connection->Update(now);
+
+	while (!delayed.empty() && delayed.front().deliver <= now) {
+		auto &datagram = delayed.front();
+		socket.Send(datagram.data.data(), datagram.data.size(), datagram.address, datagram.port);
+		delayed.pop_front();
+	}
+}
+
+std::size_t UdpTransport::GetMaxMessageSize() const {
+	return std::min(maxMessageSize, MaxFragments * GetFragmentSize(mtu));
+}
+
+void UdpTransport::SendDatagram(const IpAddress &address, uint16_t port, std::vector<uint8_t> &&data) {
+	if (simulation.loss > 0.0f && std::uniform_real_distribution<float>(0.0f, 1.0f)(random) < simulation.loss)
+		return;
+
+	if (simulation.latency > 0s || simulation.jitter > 0s) {
+		auto jitter = simulation.jitter * std::uniform_real_distribution<float>(0.0f, 1.0f)(random);
+		auto deliver = Time::Now() + simulation.latency + jitter;
+		// Keep the queue ordered by delivery time, jitter may reorder datagrams like a real network.
+		auto it = std::upper_bound(delayed.begin(), delayed.end(), deliver, [](const Time &time, const DelayedDatagram &datagram) {
+			return time < datagram.deliver;
+		});
+		delayed.insert(it, {deliver, address, port, std::move(data)});
+		return;
+	}
+
+	socket.Send(data.data(), data.size(), address, port);
+}
+
+void UdpTransport::SendControl(const IpAddress &address, uint16_t port, uint8_t type) {
+	SendDatagram(address, port, DatagramHeader(static_cast<DatagramType>(type)));
+}
+
+UdpConnection *UdpTransport::FindConnection(const IpAddress &address, uint16_t port) const {
+	for (const auto &connection : connections) {
+		if (connection->address == address && connection->port == port)
+			return connection.get();
+	}
+
+	return nullptr;
+}
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <list>
+#include <map>
+#include <random>
+#include <unordered_map>
+
+#include "Maths/Time.hpp"
+#include "Utils/Delegate.hpp"
+#include "Utils/NonCopyable.hpp"
+#include "Network/Udp/UdpSocket.hpp"
+
+namespace acid {
+class UdpTransport;
+
+/**
+ * @brief How messages on a transport channel are delivered.
+ */
+enum class UdpDelivery : uint8_t {
+	/// Messages may be lost, duplicated copies are dropped.
+	Unreliable,
+	/// Messages may be lost, messages older than the newest delivered message are dropped.
+	UnreliableSequenced,
+	/// Messages are resent until acknowledged and delivered exactly once in the order they were sent.
+	Reliable
+};
+
+/**
+ * @brief A connection to a remote peer over a acid::UdpTransport.
+ *
+ * Messages are queued with Send and leave the next time the transport is updated,
+ * small messages are coalesced into datagrams up to the transport MTU and large messages are fragmented.
+ * Every datagram acknowledges the last 33 datagrams received from the peer, which drives reliable
+ * resends, round trip time estimation and the send rate.
+ *
+ * Connections are owned by the transport, a connection stays valid until the transport update after
+ * it was disconnected.
+ */
+class ACID_EXPORT UdpConnection : NonCopyable {
+	friend class UdpTransport;
+public:
+	enum class State {
+		Connecting, Connected, Disconnected
+	};
+
+	UdpConnection(UdpTransport &transport, const IpAddress &address, uint16_t port, State state);
+
+	/**
+	 * Queues a message to the peer.
+	 * @param channel The channel index to send on.
+	 * @param packet The packet holding the message.
+	 * @return If the message was queued, false if the channel is invalid, the message too large or the connection is closed.
+	 */
+	bool Send(uint8_t channel, Packet &packet);
+
+	/**
+	 * Takes the next message received from the peer.
+	 * @param channel The channel the message was sent on.
+	 * @param packet Packet to fill with the message.
+	 * @return If a message was available.
+	 */
+	bool Receive(uint8_t &channel, Packet &packet);
+
+	/**
+	 * Closes the connection, the peer is notified.
+	 */
+	void Disconnect();
+
+	const IpAddress &GetAddress() const { return address; }
+	uint16_t GetPort() const { return port; }
+	State GetState() const { return state; }
+
+	/**
+	 * Gets the smoothed round trip time to the peer.
+	 * @return The round trip time.
+	 */
+	const Time &GetRoundTripTime() const { return roundTripTime; }
+
+	/**
+	 * Gets the fraction of sent datagrams that were not acknowledged, smoothed over time.
+	 * @return The packet loss between 0 and 1.
+	 */
+	float GetPacketLoss() const { return packetLoss; }
+
+	/**
+	 * Gets the congestion controlled send rate.
+	 * @return The send rate in bytes per second.
+	 */
+	float GetSendRate() const { return sendRate; }
+
+private:
+	/**
+	 * @brief A message, or one fragment of a message, waiting to be sent.
+	 */
+	class Unit {
+	public:
+		uint8_t channel = 0;
+		uint16_t messageId = 0;
+		uint16_t fragmentIndex = 0;
+		uint16_t fragmentCount = 1;
+		std::vector<uint8_t> data;
+		/// Time this unit was last sent, zero if it has not been sent.
+		Time sent;
+	};
+
+	/**
+	 * @brief A datagram that has been sent and not yet acknowledged or lost.
+	 */
+	class SentDatagram {
+	public:
+		bool valid = false;
+		bool acked = false;
+		uint16_t sequence = 0;
+		Time sent;
+		std::size_t size = 0;
+		/// Keys of the reliable units carried by the datagram.
+		std::vector<uint64_t> reliable;
+	};
+
+	/**
+	 * @brief A message being rebuilt from its fragments.
+	 */
+	class Assembly {
+	public:
+		uint16_t fragmentCount = 0;
+		uint16_t fragmentsReceived = 0;
+		std::vector<std::vector<uint8_t>> fragments;
+	};
+
+	class Channel {
+	public:
+		UdpDelivery delivery = UdpDelivery::Unreliable;
+		uint16_t nextSendId = 0;
+		/// Next message to deliver on reliable channels, newest delivered message on sequenced channels.
+		uint16_t receiveId = 0;
+		bool received = false;
+		std::map<uint16_t, Assembly> assemblies;
+	};
+
+	static uint64_t UnitKey(uint8_t channel, uint16_t messageId, uint16_t fragmentIndex);
+
+	void Update(const Time &now);
+	void ProcessDatagram(const uint8_t *data, std::size_t size, const Time &now);
+	void ProcessAcks(uint16_t ack, uint32_t ackBits, const Time &now);
+	bool ProcessMessage(const Unit &unit);
+	void Deliver(uint8_t index, Assembly &&assembly);
+	void SendDatagram(std::vector<Unit *> &units, const Time &now);
+	void OnDatagramLost(const Time &now);
+	void OnCongestion(const Time &now);
+
+	UdpTransport &transport;
+	IpAddress address;
+	uint16_t port;
+	State state;
+
+	std::vector<Channel> channels;
+	std::list<Unit> reliableQueue;
+	std::unordered_map<uint64_t, std::list<Unit>::iterator> reliableUnits;
+	std::vector<Unit> unreliableQueue;
+	std::deque<std::pair<uint8_t, std::vector<uint8_t>>> receivedMessages;
+
+	uint16_t localSequence = 0;
+	std::array<SentDatagram, 256> sentDatagrams;
+	uint16_t remoteSequence = 0;
+	uint32_t remoteAckBits = 0;
+	bool remoteReceived = false;
+	bool ackPending = false;
+	uint32_t receivedSinceAck = 0;
+
+	Time roundTripTime = 100ms;
+	Time roundTripVariance = 50ms;
+	bool roundTripSampled = false;
+	Time minRoundTripTime;
+	float packetLoss = 0.0f;
+	float sendRate;
+	float sendBudget = 0.0f;
+	Time lastCongestion;
+	Time lastUpdate;
+	Time lastSend;
+	Time lastReceive;
+	Time created;
+};
+
+/**
+ * @brief A connection oriented message transport on top of a acid::UdpSocket.
+ *
+ * The transport owns one socket and any number of connections, each with the same set of channels.
+ * Update must be called regularly (for example once per frame) to receive datagrams, resend lost reliable messages
+ * and flush queued messages.
+ *
+ * For testing, a simulation can drop and delay outgoing datagrams so loss and latency can be reproduced over loopback.
+ */
+class ACID_EXPORT UdpTransport : NonCopyable {
+	friend class UdpConnection;
+public:
+	/// Default maximum size of a datagram, kept below common path MTUs after IP and UDP headers.
+	static constexpr std::size_t DefaultMtu = 1200;
+	/// Largest message sent or accepted by default, in bytes.
+	static constexpr std::size_t DefaultMaxMessageSize = 1024 * 1024;
+
+	/**
+	 * @brief Network conditions applied to outgoing datagrams.
+	 */
+	class Simulation {
+	public:
+		/// Fraction of datagrams dropped, between 0 and 1.
+		float loss = 0.0f;
+		/// Delay added to every datagram.
+		Time latency;
+		/// Random extra delay added to every datagram, up to this value.
+		Time jitter;
+	};
+
+	/**
+	 * Creates a new transport.
+	 * @param channels The delivery mode of each channel, channels are indexed in this order.
+	 * @param mtu The maximum datagram size.
+	 */
+	explicit UdpTransport(std::vector<UdpDelivery> channels = {UdpDelivery::Reliable, UdpDelivery::UnreliableSequenced}, std::size_t mtu = DefaultMtu);
+
+	/**
+	 * Binds the transport socket, required before accepting connections.
+	 * @param port Port to bind to, 0 to let the system choose.
+	 * @param address Address of the interface to bind to.
+	 * @return Status code.
+	 */
+	Socket::Status Bind(uint16_t port = 0, const IpAddress &address = IpAddress::Any);
+
+	uint16_t GetLocalPort() const { return socket.GetLocalPort(); }
+
+	/**
+	 * Starts connecting to a remote transport, OnConnect is called when the peer accepts.
+	 * @param address Address of the peer.
+	 * @param port Port of the peer.
+	 * @return The new connection.
+	 */
+	UdpConnection *Connect(const IpAddress &address, uint16_t port);
+
+	/**
+	 * Receives datagrams, updates every connection and sends queued messages.
+	 */
+	void Update();
+
+	const std::vector<std::unique_ptr<UdpConnection>> &GetConnections() const { return connections; }
+
+	const std::vector<UdpDelivery> &GetChannels() const { return channels; }
+	std::size_t GetMtu() const { return mtu; }
+
+	/**
+	 * Gets the largest message that can be sent or received, the set maximum limited by the number of fragments.
+	 * Fragmented messages from a peer announcing more fragments than this allows are dropped.
+	 * @return The maximum message size in bytes.
+	 */
+	std::size_t GetMaxMessageSize() const;
+	void SetMaxMessageSize(std::size_t maxMessageSize) { this->maxMessageSize = maxMessageSize; }
+
+	const Simulation &GetSimulation() const { return simulation; }
+	void SetSimulation(const Simulation &simulation) { this->simulation = simulation; }
+
+	/**
+	 * Called when a connection is established, either accepted or after Connect succeeds.
+	 * @return The delegate.
+	 */
+	Delegate<void(UdpConnection &)> &OnConnect() { return onConnect; }
+
+	/**
+	 * Called when a connection is closed by either side or times out.
+	 * @return The delegate.
+	 */
+	Delegate<void(UdpConnection &)> &OnDisconnect() { return onDisconnect; }
+
+private:
+	class DelayedDatagram {
+	public:
+		Time deliver;
+		IpAddress address;
+		uint16_t port;
+		std::vector<uint8_t> data;
+	};
+
+	void SendDatagram(const IpAddress &address, uint16_t port, std::vector<uint8_t> &&data);
+	void SendControl(const IpAddress &address, uint16_t port, uint8_t type);
+	UdpConnection *FindConnection(const IpAddress &address, uint16_t port) const;
+
+	UdpSocket socket;
+	std::vector<UdpDelivery> channels;
+	std::size_t mtu;
+	std::size_t maxMessageSize = DefaultMaxMessageSize;
+	std::vector<std::unique_ptr<UdpConnection>> connections;
+	std::vector<uint8_t> receiveBuffer;
+
+	Simulation simulation;
+	std::deque<DelayedDatagram> delayed;
+	std::mt19937 random;
+
+	Delegate<void(UdpConnection &)> onConnect;
+	Delegate<void(UdpConnection &)> onDisconnect;
+};
+}
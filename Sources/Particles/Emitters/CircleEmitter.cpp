@@ -19,8 +19,9 @@ Vector3f CircleEmitter::GeneratePosition() const {
 	direction.Normalize();
 	direction *= radius;
 
-	auto a = Maths::Random(0.0f, 1.0f);
-	auto b = Maths::Random(0.0f, 1.0f);
+	auto &random = Random::Get();
+	auto a = random.Uniform();
+	auto b = random.Uniform();
 	if (a > b)
 		std::swap(a, b);
 
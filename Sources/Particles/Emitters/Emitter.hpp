@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Utils/StreamFactory.hpp"
-#include "Maths/Vector3.hpp"
+#include "Maths/Random.hpp"
 
 namespace acid {
 /**
@@ -18,12 +18,7 @@ public:
 	virtual Vector3f GeneratePosition() const = 0;
 
 	static Vector3f RandomUnitVector() {
-		auto theta = Maths::Random(0.0f, 1.0f) * 2.0f * Maths::PI<float>;
-		auto z = Maths::Random(0.0f, 1.0f) * 2.0f - 1.0f;
-		auto rootOneMinusZSquared = std::sqrt(1.0f - z * z);
-		auto x = rootOneMinusZSquared * std::cos(theta);
-		auto y = rootOneMinusZSquared * std::sin(theta);
-		return {x, y, z};
+		return Random::Get().UnitVector();
 	}
 };
 }
@@ -10,7 +10,7 @@ LineEmitter::LineEmitter(float length, const Vector3f &axis) :
 }
 
 Vector3f LineEmitter::GeneratePosition() const {
-	return axis * length * Maths::Random(-0.5f, 0.5f);
+	return axis * length * Random::Get().Uniform(-0.5f, 0.5f);
 }
 
 const Node &operator>>(const Node &node, LineEmitter &emitter) {
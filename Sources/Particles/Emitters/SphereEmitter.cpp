@@ -9,8 +9,9 @@ SphereEmitter::SphereEmitter(float radius) :
 }
 
 Vector3f SphereEmitter::GeneratePosition() const {
-	auto a = Maths::Random(0.0f, 1.0f);
-	auto b = Maths::Random(0.0f, 1.0f);
+	auto &random = Random::Get();
+	auto a = random.Uniform();
+	auto b = random.Uniform();
 	if (a > b)
 		std::swap(a, b);
 
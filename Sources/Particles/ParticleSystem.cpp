@@ -1,6 +1,7 @@
 #include "ParticleSystem.hpp"
 
 #include "Maths/Maths.hpp"
+#include "Maths/Random.hpp"
 #include "Maths/Transform.hpp"
 #include "Scenes/Entity.hpp"
 #include "Particles.hpp"
@@ -26,9 +27,19 @@ void ParticleSystem::Update() {
 	elapsedEmit.SetInterval(Time::Seconds(1.0f / pps));
 
 	if (auto elapsed = elapsedEmit.GetElapsed(); elapsed && !emitters.empty()) {
+		auto &random = Random::Get();
+
+		// The directions of every particle emitted this update are generated together.
+		directions.resize(elapsed);
+		if (direction != Vector3f::Zero) {
+			random.ConeDirections(direction.Normalize(), directionDeviation, directions.data(), directions.size());
+		} else {
+			random.UnitVectors(directions.data(), directions.size());
+		}
+
 		for (uint32_t i = 0; i < elapsed; i++) {
-			auto emitterIndex = static_cast<uint32_t>(Maths::Random(0.0f, static_cast<float>(emitters.size())));
-			Particles::Get()->AddParticle(EmitParticle(emitters[emitterIndex].get()));
+			auto emitter = emitters[random.Index(static_cast<uint32_t>(emitters.size()))].get();
+			Particles::Get()->AddParticle(EmitParticle(random, emitter, directions[i]));
 		}
 	}
 }
@@ -56,28 +67,7 @@ void ParticleSystem::AddEmitter(std::unique_ptr<Emitter> &&emitter) {
 }
 
 Vector3f ParticleSystem::RandomUnitVectorWithinCone(const Vector3f &coneDirection, float angle) const {
-	auto cosAngle = std::cos(angle);
-	auto theta = Maths::Random(0.0f, 1.0f) * 2.0f * Maths::PI<float>;
-	auto z = (cosAngle + Maths::Random(0.0f, 1.0f)) * (1.0f - cosAngle);
-	auto rootOneMinusZSquared = std::sqrt(1.0f - z * z);
-	auto x = rootOneMinusZSquared * std::cos(theta);
-	auto y = rootOneMinusZSquared * std::sin(theta);
-
-	Vector4f direction(x, y, z, 1.0f);
-
-	if (coneDirection.x != 0.0f || coneDirection.y != 0.0f || (coneDirection.z != 1.0f && coneDirection.z != -1.0f)) {
-		auto rotateAxis = coneDirection.Cross(Vector3f::Front);
-		rotateAxis.Normalize();
-		auto rotateAngle = std::acos(coneDirection.Dot(Vector3f::Front));
-
-		Matrix4 rotationMatrix;
-		rotationMatrix = rotationMatrix.Rotate(-rotateAngle, rotateAxis);
-		direction = rotationMatrix.Transform(direction);
-	} else if (coneDirection.z == -1.0f) {
-		direction.z *= -1.0f;
-	}
-
-	return {direction};
+	return Random::Get().ConeDirection(coneDirection.Normalize(), angle);
 }
 
 void ParticleSystem::SetPps(float pps) {
@@ -89,51 +79,33 @@ void ParticleSystem::SetDirection(const Vector3f &direction, float deviation) {
 	directionDeviation = deviation * Maths::PI<float>;
 }
 
-Particle ParticleSystem::EmitParticle(const Emitter *emitter) {
+Particle ParticleSystem::EmitParticle(Random &random, const Emitter *emitter, const Vector3f &direction) {
 	auto spawnPos = emitter->GeneratePosition();
 
 	if (auto transform = GetEntity()->GetComponent<Transform>())
 		spawnPos += transform->GetPosition();
 
-	Vector3f velocity;
+	auto velocity = direction * GenerateValue(random, averageSpeed, speedDeviation);
 
-	if (direction != Vector3f::Zero) {
-		velocity = RandomUnitVectorWithinCone(direction, directionDeviation);
-	} else {
-		velocity = GenerateRandomUnitVector();
-	}
-
-	velocity = velocity.Normalize();
-	velocity *= GenerateValue(averageSpeed, speedDeviation);
-
-	auto emitType = types.at(static_cast<uint32_t>(std::floor(Maths::Random(0.0f, static_cast<float>(types.size())))));
-	auto scale = GenerateValue(emitType->GetScale(), scaleDeviation);
-	auto lifeLength = GenerateValue(emitType->GetLifeLength(), lifeDeviation);
-	auto stageCycles = GenerateValue(emitType->GetStageCycles(), stageDeviation);
-	return {emitType, spawnPos, velocity, lifeLength, stageCycles, GenerateRotation(), scale, gravityEffect};
+	auto emitType = types.at(random.Index(static_cast<uint32_t>(types.size())));
+	auto scale = GenerateValue(random, emitType->GetScale(), scaleDeviation);
+	auto lifeLength = GenerateValue(random, emitType->GetLifeLength(), lifeDeviation);
+	auto stageCycles = GenerateValue(random, emitType->GetStageCycles(), stageDeviation);
+	return {emitType, spawnPos, velocity, lifeLength, stageCycles, GenerateRotation(random), scale, gravityEffect};
 }
 
-float ParticleSystem::GenerateValue(float average, float errorPercent) {
-	auto error = Maths::Random(-1.0f, 1.0f) * errorPercent;
+float ParticleSystem::GenerateValue(Random &random, float average, float errorPercent) {
+	auto error = random.Uniform(-1.0f, 1.0f) * errorPercent;
 	return average + (average * error);
 }
 
-float ParticleSystem::GenerateRotation() const {
+float ParticleSystem::GenerateRotation(Random &random) const {
 	if (randomRotation)
-		return Maths::Random(0.0f, Maths::PI<float>);
+		return random.Uniform(0.0f, Maths::PI<float>);
 
 	return 0.0f;
 }
 
-Vector3f ParticleSystem::GenerateRandomUnitVector() const {
-	auto theta = Maths::Random(0.0f, 1.0f) * 2.0f * Maths::PI<float>;
-	auto z = Maths::Random(0.0f, 1.0f) * 2.0f - 1.0f;
-	auto rootOneMinusZSquared = std::sqrt(1.0f - z * z);
-	auto x = rootOneMinusZSquared * std::cos(theta);
-	auto y = rootOneMinusZSquared * std::sin(theta);
-	return {x, y, z};
-}
-
 const Node &operator>>(const Node &node, ParticleSystem &particleSystem) {
 	node["types"].Get(particleSystem.types);
 	node["emitters"].Get(particleSystem.emitters);
@@ -66,10 +66,9 @@ public:
 	friend Node &operator<<(Node &node, const ParticleSystem &particleSystem);
 
 private:
-	Particle EmitParticle(const Emitter *emitter);
-	static float GenerateValue(float average, float errorPercent);
-	float GenerateRotation() const;
-	Vector3f GenerateRandomUnitVector() const;
+	Particle EmitParticle(Random &random, const Emitter *emitter, const Vector3f &direction);
+	static float GenerateValue(Random &random, float average, float errorPercent);
+	float GenerateRotation(Random &random) const;
 
 	std::vector<std::shared_ptr<ParticleType>> types;
 	std::vector<std::unique_ptr<Emitter>> emitters;
@@ -87,5 +86,6 @@ private:
 	float scaleDeviation = 0.0f;
 
 	ElapsedTime elapsedEmit;
+	std::vector<Vector3f> directions;
 };
 }
@@ -1,6 +1,7 @@
 #include "ParticleType.hpp"
 
 #include "Resources/Resources.hpp"
+#include "Maths/Batch.hpp"
 #include "Maths/Maths.hpp"
 #include "Models/Shapes/RectangleModel.hpp"
 #include "Scenes/Scenes.hpp"
@@ -52,18 +53,32 @@ void ParticleType::Update(const std::vector<Particle> &particles) {
 	if (particles.empty())
 		return;
 
+	// Culls every particle against the view frustum at once.
+	auto camera = Scenes::Get()->GetCamera();
+	positions.Clear();
+	radii.clear();
+
+	for (const auto &particle : particles) {
+		positions.Add(particle.GetPosition());
+		radii.emplace_back(FRUSTUM_BUFFER * particle.GetScale());
+	}
+
+	contained.resize(particles.size());
+	Batch::SpheresInFrustum(camera->GetViewFrustum(), positions, radii.data(), contained.data());
+
+	auto viewMatrix = camera->GetViewMatrix();
+
 	Instance *instances;
 	instanceBuffer.MapMemory(reinterpret_cast<void **>(&instances));
 
-	for (const auto &particle : particles) {
+	for (std::size_t i = 0; i < particles.size(); i++) {
 		if (this->instances >= maxInstances)
 			break;
 
-		if (!Scenes::Get()->GetCamera()->GetViewFrustum().SphereInFrustum(particle.GetPosition(), FRUSTUM_BUFFER * particle.GetScale())) {
+		if (!contained[i])
 			continue;
-		}
 
-		auto viewMatrix = Scenes::Get()->GetCamera()->GetViewMatrix();
+		const auto &particle = particles[i];
 		auto instance = &instances[this->instances];
 		instance->modelMatrix = Matrix4().Translate(particle.GetPosition());
 
@@ -80,7 +95,7 @@ void ParticleType::Update(const std::vector<Particle> &particles) {
 		instance->colourOffset = particle.GetParticleType()->colourOffset;
 		instance->offsets = {particle.imageOffset1, particle.imageOffset2};
 		instance->blend = {particle.imageBlendFactor, particle.transparency, static_cast<float>(particle.particleType->numberOfRows)};
-		instances++;
+		this->instances++;
 	}
 
 	instanceBuffer.UnmapMemory();
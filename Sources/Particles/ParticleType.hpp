@@ -4,6 +4,7 @@
 #include "Maths/Matrix4.hpp"
 #include "Maths/Vector4.hpp"
 #include "Maths/Vector3.hpp"
+#include "Maths/Vector3Soa.hpp"
 #include "Models/Model.hpp"
 #include "Graphics/Buffers/InstanceBuffer.hpp"
 #include "Graphics/Descriptors/DescriptorsHandler.hpp"
@@ -114,6 +115,11 @@ private:
 	uint32_t maxInstances = 0;
 	uint32_t instances = 0;
 
+	// Reused between updates to cull the particles.
+	Vector3Soa positions;
+	std::vector<float> radii;
+	std::vector<uint8_t> contained;
+
 	DescriptorsHandler descriptorSet;
 	InstanceBuffer instanceBuffer;
 };
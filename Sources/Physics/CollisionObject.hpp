@@ -35,6 +35,14 @@ public:
 	 */
 	virtual bool InFrustum(const Frustum &frustum) = 0;
 
+	/**
+	 * Gets the world space bounding box of the shape.
+	 * @param min The min point of the box.
+	 * @param max The max point of the box.
+	 * @return If the shape is created, the box is only set when it is.
+	 */
+	virtual bool GetBounds(Vector3f &min, Vector3f &max) = 0;
+
 	Collider *AddCollider(std::unique_ptr<Collider> &&collider);
 	void RemoveCollider(Collider *collider);
 
@@ -42,8 +42,14 @@ public:
 	 */
 	bool CubeInFrustum(const Vector3f &min, const Vector3f &max) const;
 
+	/**
+	 * Gets the planes of the frustum, the normal in XYZ points inside and W is the distance.
+	 * @return The right, left, bottom, top, back and front planes.
+	 */
+	const std::array<std::array<float, 4>, 6> &GetPlanes() const { return frustum; }
+
 private:
-	void NormalizePlane(int32_t side);
+	void SetPlane(uint32_t side, const Vector4f &plane);
 
 	std::array<std::array<float, 4>, 6> frustum = {};
 };
@@ -84,13 +84,24 @@ void KinematicCharacter::Update() {
 }
 
 bool KinematicCharacter::InFrustum(const Frustum &frustum) {
-	btVector3 min;
-	btVector3 max;
+	Vector3f min, max;
 
-	if (body && shape)
-		shape->getAabb(Collider::Convert(*GetEntity()->GetComponent<Transform>()), min, max);
+	if (!GetBounds(min, max))
+		return true;
 
-	return frustum.CubeInFrustum(Collider::Convert(min), Collider::Convert(max));
+	return frustum.CubeInFrustum(min, max);
+}
+
+bool KinematicCharacter::GetBounds(Vector3f &min, Vector3f &max) {
+	if (!body || !shape)
+		return false;
+
+	btVector3 aabbMin;
+	btVector3 aabbMax;
+	shape->getAabb(Collider::Convert(*GetEntity()->GetComponent<Transform>()), aabbMin, aabbMax);
+	min = Collider::Convert(aabbMin);
+	max = Collider::Convert(aabbMax);
+	return true;
 }
 
 void KinematicCharacter::ClearForces() {
@@ -28,6 +28,7 @@ public:
 	void Update() override;
 
 	bool InFrustum(const Frustum &frustum) override;
+	bool GetBounds(Vector3f &min, Vector3f &max) override;
 	void ClearForces() override;
 	void SetMass(float mass) override;
 	void SetGravity(const Vector3f &gravity) override;
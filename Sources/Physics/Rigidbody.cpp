@@ -91,13 +91,24 @@ void Rigidbody::Update() {
 }
 
 bool Rigidbody::InFrustum(const Frustum &frustum) {
-	btVector3 min;
-	btVector3 max;
+	Vector3f min, max;
 
-	if (body && shape)
-		rigidBody->getAabb(min, max);
+	if (!GetBounds(min, max))
+		return true;
 
-	return frustum.CubeInFrustum(Collider::Convert(min), Collider::Convert(max));
+	return frustum.CubeInFrustum(min, max);
+}
+
+bool Rigidbody::GetBounds(Vector3f &min, Vector3f &max) {
+	if (!body || !shape)
+		return false;
+
+	btVector3 aabbMin;
+	btVector3 aabbMax;
+	rigidBody->getAabb(aabbMin, aabbMax);
+	min = Collider::Convert(aabbMin);
+	max = Collider::Convert(aabbMax);
+	return true;
 }
 
 void Rigidbody::ClearForces() {
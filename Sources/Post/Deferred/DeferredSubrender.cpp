@@ -41,7 +41,8 @@ void DeferredSubrender::Render(const CommandBuffer &commandBuffer) {
 		}
 	}
 
-	if (this->skybox != skybox) {
+	// A new skybox is filtered once it has finished uploading, until then the old environment is kept.
+	if (this->skybox != skybox && (!skybox || skybox->IsResident())) {
 		this->skybox = skybox;
 		irradiance = Resources::Get()->GetThreadPool().Enqueue(ComputeIrradiance, skybox, 64);
 		prefiltered = Resources::Get()->GetThreadPool().Enqueue(ComputePrefiltered, skybox, 512);
@@ -0,0 +1,90 @@
+#include "HotReloader.hpp"
+
+#include "Files/Files.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Resources.hpp"
+
+namespace acid {
+HotReloader::HotReloader() {
+	for (const auto &searchPath : Files::Get()->GetSearchPaths()) {
+		if (std::filesystem::is_directory(searchPath))
+			Watch(searchPath);
+	}
+}
+
+void HotReloader::Watch(const std::filesystem::path &directory) {
+	auto &observer = observers.emplace_back(std::make_unique<FileObserver>(directory, 0.5s, FileObserver::Delivery::Update));
+	observer->OnChange().Add([this, directory](std::filesystem::path path, FileObserver::Status status) {
+		// Erased files are ignored, resources keep their contents until the file is written again.
+		if (status != FileObserver::Status::Erased)
+			changes.emplace(path.lexically_relative(directory));
+	});
+}
+
+void HotReloader::Update() {
+	for (auto &observer : observers)
+		observer->Update();
+
+	for (const auto &change : changes) {
+		for (const auto &resource : Resources::Get()->FindDependents(change))
+			Reload(resource);
+	}
+
+	changes.clear();
+
+	auto graphics = Graphics::Get();
+	auto frameCount = graphics ? graphics->GetFrameCount() : 0;
+	std::vector<std::shared_ptr<Resource>> changed;
+
+	for (auto it = pending.begin(); it != pending.end();) {
+		if (it->reloaded.wait_for(0s) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		// A resource that fails to reload keeps its old contents.
+		try {
+			if (auto reloaded = it->reloaded.get()) {
+				it->resource->Swap(*reloaded);
+				retired.emplace_back(RetiredResource{std::move(reloaded), frameCount});
+				onReload(it->resource);
+			}
+		} catch (const std::exception &e) {
+			Log::Error("Failed to reload resource: ", e.what(), '\n');
+		}
+
+		if (it->changed)
+			changed.emplace_back(std::move(it->resource));
+		it = pending.erase(it);
+	}
+
+	for (const auto &resource : changed)
+		Reload(resource);
+
+	// Frames submitted before the swap are finished once every swapchain image has been submitted again.
+	if (!graphics || !graphics->GetSwapchain()) {
+		retired.clear();
+		return;
+	}
+
+	auto imageCount = graphics->GetSwapchain()->GetImageCount();
+	retired.erase(std::remove_if(retired.begin(), retired.end(), [&](const RetiredResource &retiredResource) {
+		return frameCount > retiredResource.frame + imageCount;
+	}), retired.end());
+}
+
+void HotReloader::Reload(const std::shared_ptr<Resource> &resource) {
+	// A resource that changes while it is reloading is reloaded again after the running reload is swapped in.
+	if (auto it = std::find_if(pending.begin(), pending.end(), [&](const PendingReload &pendingReload) {
+		return pendingReload.resource == resource;
+	}); it != pending.end()) {
+		it->changed = true;
+		return;
+	}
+
+	auto reloaded = Resources::Get()->GetThreadPool().Enqueue([resource]() {
+		return resource->Reload();
+	});
+	pending.emplace_back(PendingReload{resource, std::move(reloaded)});
+}
+}
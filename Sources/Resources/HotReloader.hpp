@@ -0,0 +1,71 @@
+#pragma once
+
+#include <future>
+#include <set>
+
+#include "Files/FileObserver.hpp"
+#include "Resource.hpp"
+
+namespace acid {
+/**
+ * @brief Class that reloads resources when the files they are loaded from change.
+ *
+ * Changed files are mapped to the resources that depend on them, only those resources are reloaded on the resource thread pool.
+ * Finished reloads are swapped into the resources by Update between frames, the old contents are destroyed once the frames in flight
+ * that use them have finished, so nothing waits for the device to be idle.
+ */
+class ACID_EXPORT HotReloader : NonCopyable {
+public:
+	/**
+	 * Creates a new hot reloader, watching every directory in the file search paths.
+	 */
+	HotReloader();
+
+	/**
+	 * Watches a directory for changes, changed files are found in resources by their path relative to the directory.
+	 * @param directory The native path of the directory.
+	 */
+	void Watch(const std::filesystem::path &directory);
+
+	/**
+	 * Starts reloading resources with changed files and swaps in finished reloads, called from the main thread between frames.
+	 */
+	void Update();
+
+	/**
+	 * Called when a resource has been reloaded.
+	 * @return The delegate.
+	 */
+	Delegate<void(std::shared_ptr<Resource>)> &OnReload() { return onReload; }
+
+private:
+	/**
+	 * @brief A reload running on the resource thread pool.
+	 */
+	class PendingReload {
+	public:
+		std::shared_ptr<Resource> resource;
+		std::future<std::shared_ptr<Resource>> reloaded;
+		/// If the files changed again while reloading.
+		bool changed = false;
+	};
+
+	/**
+	 * @brief Old contents of a resource, held until the frames that used them have finished.
+	 */
+	class RetiredResource {
+	public:
+		std::shared_ptr<Resource> resource;
+		uint64_t frame;
+	};
+
+	void Reload(const std::shared_ptr<Resource> &resource);
+
+	std::vector<std::unique_ptr<FileObserver>> observers;
+	/// Changed files relative to the watched directories, found in resources on the next update.
+	std::set<std::filesystem::path> changes;
+	std::vector<PendingReload> pending;
+	std::vector<RetiredResource> retired;
+	Delegate<void(std::shared_ptr<Resource>)> onReload;
+};
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <filesystem>
+#include <memory>
 #include <typeindex>
+#include <vector>
 
 #include "Utils/NonCopyable.hpp"
 #include "Export.hpp"
@@ -15,6 +18,24 @@ public:
 	virtual ~Resource() = default;
 
 	virtual std::type_index GetTypeIndex() const = 0;
+
+	/**
+	 * Gets the files this resource is loaded from, a change to any of them reloads the resource.
+	 * @return The paths of the files, relative to the search paths.
+	 */
+	virtual std::vector<std::filesystem::path> GetDependencies() const { return {}; }
+
+	/**
+	 * Loads a new resource with the same values, called from a resource thread while this resource is still in use.
+	 * @return The reloaded resource, or nullptr if this resource cannot be reloaded.
+	 */
+	virtual std::shared_ptr<Resource> Reload() const { return nullptr; }
+
+	/**
+	 * Exchanges the loaded contents of this resource with a reloaded resource, called between frames.
+	 * @param reloaded The resource returned by Reload, left holding the old contents.
+	 */
+	virtual void Swap(Resource &/*reloaded*/) {}
 	
 	/*template<typename T>
 	friend std::enable_if_t<std::is_base_of_v<Resource, T>, const Node &> operator>>(const Node &node, std::shared_ptr<T> &object) {
@@ -28,13 +28,13 @@ void Resources::Update() {
 }
 
 std::shared_ptr<Resource> Resources::Find(const std::type_index &typeIndex, const Node &node) const {
-	if (resources.find(typeIndex) == resources.end())
+	auto it = resources.find(typeIndex);
+	if (it == resources.end())
 		return nullptr;
 
-	for (const auto &[key, resource] : resources.at(typeIndex)) {
-		if (key == node)
-			return resource;
-	}
+	// Nodes are ordered and compared equal by the same canonical form, so the keyed lookup finds the node a linear scan would.
+	if (auto it1 = it->second.find(node); it1 != it->second.end())
+		return it1->second;
 
 	return nullptr;
 }
@@ -55,4 +55,22 @@ void Resources::Remove(const std::shared_ptr<Resource> &resource) {
 	if (resources.empty())
 		this->resources.erase(resource->GetTypeIndex());
 }
+
+std::vector<std::shared_ptr<Resource>> Resources::FindDependents(const std::filesystem::path &filename) const {
+	auto name = filename.lexically_normal().generic_string();
+	std::vector<std::shared_ptr<Resource>> dependents;
+
+	for (const auto &[typeIndex, resources] : resources) {
+		for (const auto &[node, resource] : resources) {
+			for (const auto &dependency : resource->GetDependencies()) {
+				if (dependency.lexically_normal().generic_string() == name) {
+					dependents.emplace_back(resource);
+					break;
+				}
+			}
+		}
+	}
+
+	return dependents;
+}
 }
@@ -23,20 +23,19 @@ public:
 
 	template<typename T>
 	std::shared_ptr<T> Find(const Node &node) const {
-		if (resources.find(typeid(T)) == resources.end())
-			return nullptr;
-		
-		for (const auto &[key, resource] : resources.at(typeid(T))) {
-			if (key == node)
-				return std::dynamic_pointer_cast<T>(resource);
-		}
-		
-		return nullptr;
+		return std::dynamic_pointer_cast<T>(Find(typeid(T), node));
 	}
 	
 	void Add(const Node &node, const std::shared_ptr<Resource> &resource);
 	void Remove(const std::shared_ptr<Resource> &resource);
 
+	/**
+	 * Finds the resources that are loaded from a file.
+	 * @param filename The path of the file, relative to the search paths.
+	 * @return The resources with the file in their dependencies.
+	 */
+	std::vector<std::shared_ptr<Resource>> FindDependents(const std::filesystem::path &filename) const;
+
 	/**
 	 * Gets the resource loader thread pool.
 	 * @return The resource loader thread pool.
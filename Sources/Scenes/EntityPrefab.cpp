@@ -47,7 +47,7 @@ const EntityPrefab &operator>>(const EntityPrefab &entityPrefab, Entity &entity)
 			continue;
 		}
 
-		if (auto component = Component::Create(property.GetName())) {
+		if (auto component = Component::Create(std::string(property.GetName()))) {
 			property >> *component;
 			entity.AddComponent(std::move(component));
 		}
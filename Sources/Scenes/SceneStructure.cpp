@@ -1,5 +1,7 @@
 #include "SceneStructure.hpp"
 
+#include "Maths/Transform.hpp"
+#include "Meshes/Mesh.hpp"
 #include "Physics/Rigidbody.hpp"
 
 namespace acid {
@@ -16,22 +18,29 @@ Entity *SceneStructure::GetEntity(const std::string &name) const {
 }
 
 Entity *SceneStructure::CreateEntity() {
-	return objects.emplace_back(std::make_unique<Entity>()).get();
+	auto object = objects.emplace_back(std::make_unique<Entity>()).get();
+	UpdateProxy(object);
+	return object;
 }
 
 Entity *SceneStructure::CreateEntity(const std::string &filename) {
-	return objects.emplace_back(std::make_unique<Entity>(filename)).get();
+	auto object = objects.emplace_back(std::make_unique<Entity>(filename)).get();
+	UpdateProxy(object);
+	return object;
 }
 
 void SceneStructure::Add(Entity *object) {
 	objects.emplace_back(object);
+	UpdateProxy(object);
 }
 
 void SceneStructure::Add(std::unique_ptr<Entity> object) {
-	objects.emplace_back(std::move(object));
+	auto added = objects.emplace_back(std::move(object)).get();
+	UpdateProxy(added);
 }
 
 void SceneStructure::Remove(Entity *object) {
+	RemoveProxy(object);
 	objects.erase(std::remove_if(objects.begin(), objects.end(), [object](std::unique_ptr<Entity> &e) {
 		return e.get() == object;
 	}), objects.end());
@@ -42,23 +51,32 @@ void SceneStructure::Move(Entity *object, SceneStructure &structure) {
 		if ((*it).get() != object)
 			continue;
 
+		RemoveProxy(object);
 		structure.Add(std::move(*it));
 		objects.erase(it);
+		return;
 	}
 }
 
 void SceneStructure::Clear() {
 	objects.clear();
+	tree.Clear();
+	proxies.clear();
+	unbounded.clear();
 }
 
 void SceneStructure::Update() {
+	unbounded.clear();
+
 	for (auto it = objects.begin(); it != objects.end();) {
 		if ((*it)->IsRemoved()) {
+			RemoveProxy(it->get());
 			it = objects.erase(it);
 			continue;
 		}
 
 		(*it)->Update();
+		UpdateProxy(it->get());
 		++it;
 	}
 }
@@ -77,29 +95,31 @@ std::vector<Entity *> SceneStructure::QueryAll() {
 }
 
 std::vector<Entity *> SceneStructure::QueryFrustum(const Frustum &range) {
-	std::vector<Entity *> entities;
-
-	for (const auto &object : objects) {
-		if (object->IsRemoved())
-			continue;
-
-		auto rigidbody = object->GetComponent<Rigidbody>();
-
-		if (!rigidbody || rigidbody->InFrustum(range)) {
-			entities.emplace_back(object.get());
-		}
-	}
-
+	std::vector<Entity *> entities(unbounded);
+	tree.QueryFrustum(range, entities);
+	entities.erase(std::remove_if(entities.begin(), entities.end(), [](Entity *entity) {
+		return entity->IsRemoved();
+	}), entities.end());
 	return entities;
 }
 
-/*std::vector<Entity *> SceneStructure::QuerySphere(const Vector3 &centre, const Vector3 &radius) {
-	return {};
-}*/
+std::vector<Entity *> SceneStructure::QuerySphere(const Vector3f &centre, float radius) {
+	std::vector<Entity *> entities;
+	tree.QuerySphere(centre, radius, entities);
+	entities.erase(std::remove_if(entities.begin(), entities.end(), [](Entity *entity) {
+		return entity->IsRemoved();
+	}), entities.end());
+	return entities;
+}
 
-/*std::vector<Entity *> SceneStructure::QueryCube(const Vector3 &min, const Vector3 &max) {
-	return {};
-}*/
+std::vector<Entity *> SceneStructure::QueryCube(const Vector3f &min, const Vector3f &max) {
+	std::vector<Entity *> entities;
+	tree.QueryCube(min, max, entities);
+	entities.erase(std::remove_if(entities.begin(), entities.end(), [](Entity *entity) {
+		return entity->IsRemoved();
+	}), entities.end());
+	return entities;
+}
 
 bool SceneStructure::Contains(Entity *object) {
 	for (const auto &object2 : objects) {
@@ -109,4 +129,70 @@ bool SceneStructure::Contains(Entity *object) {
 
 	return false;
 }
+
+void SceneStructure::UpdateProxy(Entity *object) {
+	auto &proxy = proxies[object];
+	Vector3f min, max;
+
+	auto rigidbody = object->GetComponent<Rigidbody>();
+	auto mesh = object->GetComponent<Mesh>();
+	auto transform = object->GetComponent<Transform>();
+	auto model = mesh ? mesh->GetModel() : nullptr;
+
+	if (rigidbody && rigidbody->GetBounds(min, max)) {
+		proxy.modelBounds = false;
+	} else if (model && transform && model->GetMinExtents().x <= model->GetMaxExtents().x) {
+		// Static meshes keep their box until their model extents or transform change, a replaced or reloaded model is
+		// caught by its extents even if it has the address of the old one.
+		auto worldMatrix = transform->GetWorldMatrix();
+		if (proxy.node != SpatialTree::NullNode && proxy.modelBounds && proxy.minExtents == model->GetMinExtents() &&
+			proxy.maxExtents == model->GetMaxExtents() && proxy.worldMatrix == worldMatrix) {
+			return;
+		}
+
+		proxy.modelBounds = true;
+		proxy.minExtents = model->GetMinExtents();
+		proxy.maxExtents = model->GetMaxExtents();
+		proxy.worldMatrix = worldMatrix;
+
+		// The box around the transformed model box, each world axis takes the absolute projection of the model extents.
+		auto centre = (model->GetMinExtents() + model->GetMaxExtents()) / 2.0f;
+		auto extent = (model->GetMaxExtents() - model->GetMinExtents()) / 2.0f;
+		Vector3f worldCentre(worldMatrix.Transform(Vector4f(centre)));
+		Vector3f worldExtent;
+
+		for (uint32_t i = 0; i < 3; i++) {
+			worldExtent[i] = std::abs(worldMatrix.rows[0][i]) * extent.x + std::abs(worldMatrix.rows[1][i]) * extent.y +
+				std::abs(worldMatrix.rows[2][i]) * extent.z;
+		}
+
+		min = worldCentre - worldExtent;
+		max = worldCentre + worldExtent;
+	} else {
+		if (proxy.node != SpatialTree::NullNode) {
+			tree.Remove(proxy.node);
+			proxy.node = SpatialTree::NullNode;
+		}
+
+		proxy.modelBounds = false;
+		unbounded.emplace_back(object);
+		return;
+	}
+
+	if (proxy.node == SpatialTree::NullNode)
+		proxy.node = tree.Insert(object, min, max);
+	else
+		tree.Move(proxy.node, min, max);
+}
+
+void SceneStructure::RemoveProxy(Entity *object) {
+	unbounded.erase(std::remove(unbounded.begin(), unbounded.end(), object), unbounded.end());
+
+	if (auto it = proxies.find(object); it != proxies.end()) {
+		if (it->second.node != SpatialTree::NullNode)
+			tree.Remove(it->second.node);
+
+		proxies.erase(it);
+	}
+}
 }
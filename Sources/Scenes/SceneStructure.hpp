@@ -1,7 +1,10 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "Physics/Rigidbody.hpp"
 #include "Entity.hpp"
+#include "SpatialTree.hpp"
 
 namespace acid {
 /**
@@ -27,13 +30,13 @@ public:
 	Entity *CreateEntity(const std::string &filename);
 
 	/**
-	 * Adds a new object to the spatial structure.
+	 * Adds a new object to the spatial structure, it is found by spatial queries right away.
 	 * @param object The object to add.
 	 */
 	void Add(Entity *object);
 
 	/**
-	 * Adds a new object to the spatial structure.
+	 * Adds a new object to the spatial structure, it is found by spatial queries right away.
 	 * @param object The object to add.
 	 */
 	void Add(std::unique_ptr<Entity> object);
@@ -57,7 +60,8 @@ public:
 	void Clear();
 
 	/**
-	 * Updates all of the entity.
+	 * Updates all of the entity, then the bounding boxes the spatial queries are run with.
+	 * Boxes come from the entities rigidbody, else from its mesh model extents and world transform, which are only recalculated when either change.
 	 */
 	void Update();
 
@@ -75,14 +79,27 @@ public:
 
 	/**
 	 * Gets a set of all objects in a spatial objects contained in a frustum.
+	 * Objects without a bounding box are always contained.
 	 * @param range The frustum range of space being queried.
 	 * @return The list of all object in range.
 	 */
 	std::vector<Entity *> QueryFrustum(const Frustum &range);
 
-	//std::vector<Entity *> QuerySphere(const Vector3 &centre, const Vector3 &radius);
+	/**
+	 * Gets a set of all objects with a bounding box intersecting a sphere.
+	 * @param centre The spheres centre.
+	 * @param radius The spheres radius.
+	 * @return The list of all object in range.
+	 */
+	std::vector<Entity *> QuerySphere(const Vector3f &centre, float radius);
 
-	//std::vector<Entity *> QueryCube(const Vector3 &min, const Vector3 &max);
+	/**
+	 * Gets a set of all objects with a bounding box intersecting a cube.
+	 * @param min The min point of the cube.
+	 * @param max The max point of the cube.
+	 * @return The list of all object in range.
+	 */
+	std::vector<Entity *> QueryCube(const Vector3f &min, const Vector3f &max);
 
 	/**
 	 * Returns a set of all components of a type in the spatial structure.
@@ -132,6 +149,23 @@ public:
 	bool Contains(Entity *object);
 
 private:
+	class Proxy {
+	public:
+		int32_t node = SpatialTree::NullNode;
+		/// If the box was made from a model, the extents and world matrix it was made from are kept.
+		bool modelBounds = false;
+		Vector3f minExtents, maxExtents;
+		Matrix4 worldMatrix;
+	};
+
+	void UpdateProxy(Entity *object);
+	void RemoveProxy(Entity *object);
+
 	std::vector<std::unique_ptr<Entity>> objects;
+
+	SpatialTree tree;
+	std::unordered_map<Entity *, Proxy> proxies;
+	/// Objects without a bounding box, found by every frustum query.
+	std::vector<Entity *> unbounded;
 };
 }
@@ -0,0 +1,361 @@
+#include "SpatialTree.hpp"
+
+#include "Physics/Frustum.hpp"
+
+namespace acid {
+static float SurfaceArea(const Vector3f &min, const Vector3f &max) {
+	auto size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static bool Contains(const Vector3f &outerMin, const Vector3f &outerMax, const Vector3f &min, const Vector3f &max) {
+	return outerMin.x <= min.x && outerMin.y <= min.y && outerMin.z <= min.z && max.x <= outerMax.x && max.y <= outerMax.y && max.z <= outerMax.z;
+}
+
+static bool Overlaps(const Vector3f &minA, const Vector3f &maxA, const Vector3f &minB, const Vector3f &maxB) {
+	return minA.x <= maxB.x && minA.y <= maxB.y && minA.z <= maxB.z && minB.x <= maxA.x && minB.y <= maxA.y && minB.z <= maxA.z;
+}
+
+SpatialTree::SpatialTree(float margin) :
+	margin(margin) {
+}
+
+int32_t SpatialTree::Insert(Entity *object, const Vector3f &min, const Vector3f &max) {
+	auto proxy = AllocateNode();
+	nodes[proxy].min = min - margin;
+	nodes[proxy].max = max + margin;
+	leaves[proxy] = {min, max, object};
+	InsertLeaf(proxy);
+	size++;
+	return proxy;
+}
+
+void SpatialTree::Remove(int32_t proxy) {
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	size--;
+}
+
+bool SpatialTree::Move(int32_t proxy, const Vector3f &min, const Vector3f &max) {
+	leaves[proxy].min = min;
+	leaves[proxy].max = max;
+
+	if (Contains(nodes[proxy].min, nodes[proxy].max, min, max))
+		return false;
+
+	RemoveLeaf(proxy);
+	nodes[proxy].min = min - margin;
+	nodes[proxy].max = max + margin;
+	InsertLeaf(proxy);
+	return true;
+}
+
+void SpatialTree::Clear() {
+	nodes.clear();
+	leaves.clear();
+	root = NullNode;
+	freeList = NullNode;
+	size = 0;
+}
+
+void SpatialTree::QueryFrustum(const Frustum &frustum, std::vector<Entity *> &objects) const {
+	if (root == NullNode)
+		return;
+
+	const auto &planes = frustum.GetPlanes();
+
+	// Each entry holds a node and a bit for each plane it may still be outside of.
+	std::vector<std::pair<int32_t, uint32_t>> stack;
+	stack.reserve(64);
+	stack.emplace_back(root, (1u << planes.size()) - 1);
+
+	while (!stack.empty()) {
+		auto [index, mask] = stack.back();
+		stack.pop_back();
+
+		const auto &node = nodes[index];
+		const auto &min = node.IsLeaf() ? leaves[index].min : node.min;
+		const auto &max = node.IsLeaf() ? leaves[index].max : node.max;
+		auto outside = false;
+
+		for (uint32_t i = 0; i < planes.size() && !outside; i++) {
+			if (!(mask & 1u << i))
+				continue;
+
+			// The corners nearest and furthest along the planes normal take the smaller and larger product on each axis.
+			const auto &plane = planes[i];
+			auto x0 = plane[0] * min.x, x1 = plane[0] * max.x;
+			auto y0 = plane[1] * min.y, y1 = plane[1] * max.y;
+			auto z0 = plane[2] * min.z, z1 = plane[2] * max.z;
+			auto furthest = std::max(x0, x1) + std::max(y0, y1) + std::max(z0, z1) + plane[3];
+			auto nearest = std::min(x0, x1) + std::min(y0, y1) + std::min(z0, z1) + plane[3];
+
+			if (furthest <= 0.0f)
+				outside = true;
+			else if (nearest > 0.0f)
+				mask &= ~(1u << i);
+		}
+
+		if (outside)
+			continue;
+
+		if (node.IsLeaf()) {
+			objects.emplace_back(leaves[index].object);
+		} else if (mask == 0) {
+			AddObjects(index, objects);
+		} else {
+			stack.emplace_back(node.children[0], mask);
+			stack.emplace_back(node.children[1], mask);
+		}
+	}
+}
+
+void SpatialTree::QuerySphere(const Vector3f &centre, float radius, std::vector<Entity *> &objects) const {
+	if (root == NullNode)
+		return;
+
+	std::vector<int32_t> stack;
+	stack.reserve(64);
+	stack.emplace_back(root);
+
+	while (!stack.empty()) {
+		auto index = stack.back();
+		stack.pop_back();
+
+		const auto &node = nodes[index];
+		const auto &min = node.IsLeaf() ? leaves[index].min : node.min;
+		const auto &max = node.IsLeaf() ? leaves[index].max : node.max;
+		auto closest = centre.Max(min).Min(max);
+
+		if ((closest - centre).LengthSquared() > radius * radius)
+			continue;
+
+		if (node.IsLeaf()) {
+			objects.emplace_back(leaves[index].object);
+		} else {
+			stack.emplace_back(node.children[0]);
+			stack.emplace_back(node.children[1]);
+		}
+	}
+}
+
+void SpatialTree::QueryCube(const Vector3f &min, const Vector3f &max, std::vector<Entity *> &objects) const {
+	if (root == NullNode)
+		return;
+
+	std::vector<int32_t> stack;
+	stack.reserve(64);
+	stack.emplace_back(root);
+
+	while (!stack.empty()) {
+		auto index = stack.back();
+		stack.pop_back();
+
+		const auto &node = nodes[index];
+
+		if (node.IsLeaf()) {
+			const auto &leaf = leaves[index];
+
+			if (Overlaps(leaf.min, leaf.max, min, max))
+				objects.emplace_back(leaf.object);
+		} else if (Overlaps(node.min, node.max, min, max)) {
+			stack.emplace_back(node.children[0]);
+			stack.emplace_back(node.children[1]);
+		}
+	}
+}
+
+int32_t SpatialTree::GetHeight() const {
+	return root == NullNode ? 0 : nodes[root].height;
+}
+
+int32_t SpatialTree::AllocateNode() {
+	if (freeList == NullNode) {
+		nodes.emplace_back();
+		leaves.emplace_back();
+		return static_cast<int32_t>(nodes.size() - 1);
+	}
+
+	auto index = freeList;
+	freeList = nodes[index].parent;
+	nodes[index] = {};
+	return index;
+}
+
+void SpatialTree::FreeNode(int32_t index) {
+	leaves[index] = {};
+	nodes[index].parent = freeList;
+	nodes[index].height = -1;
+	freeList = index;
+}
+
+void SpatialTree::InsertLeaf(int32_t leaf) {
+	if (root == NullNode) {
+		root = leaf;
+		nodes[root].parent = NullNode;
+		return;
+	}
+
+	auto leafMin = nodes[leaf].min;
+	auto leafMax = nodes[leaf].max;
+
+	// Descends to the sibling that adds the least surface area, the cost of a branch includes the growth of every node above it.
+	auto index = root;
+
+	while (!nodes[index].IsLeaf()) {
+		const auto &node = nodes[index];
+		auto area = SurfaceArea(node.min, node.max);
+		auto combinedArea = SurfaceArea(node.min.Min(leafMin), node.max.Max(leafMax));
+
+		// The cost of making a new parent for this node and the leaf.
+		auto cost = 2.0f * combinedArea;
+		// The minimum cost of pushing the leaf further down the tree.
+		auto inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto childCost = [&](int32_t child) {
+			const auto &childNode = nodes[child];
+			auto childArea = SurfaceArea(childNode.min.Min(leafMin), childNode.max.Max(leafMax)) + inheritanceCost;
+
+			if (!childNode.IsLeaf())
+				childArea -= SurfaceArea(childNode.min, childNode.max);
+
+			return childArea;
+		};
+
+		auto cost0 = childCost(node.children[0]);
+		auto cost1 = childCost(node.children[1]);
+
+		if (cost < cost0 && cost < cost1)
+			break;
+
+		index = cost0 < cost1 ? node.children[0] : node.children[1];
+	}
+
+	auto sibling = index;
+	auto oldParent = nodes[sibling].parent;
+	auto newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].min = leafMin.Min(nodes[sibling].min);
+	nodes[newParent].max = leafMax.Max(nodes[sibling].max);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].children[0] = sibling;
+	nodes[newParent].children[1] = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == NullNode) {
+		root = newParent;
+	} else {
+		auto &children = nodes[oldParent].children;
+		children[children[0] == sibling ? 0 : 1] = newParent;
+	}
+
+	Refit(newParent);
+}
+
+void SpatialTree::RemoveLeaf(int32_t leaf) {
+	if (leaf == root) {
+		root = NullNode;
+		return;
+	}
+
+	auto parent = nodes[leaf].parent;
+	auto grandParent = nodes[parent].parent;
+	auto sibling = nodes[parent].children[nodes[parent].children[0] == leaf ? 1 : 0];
+
+	// The sibling takes the place of the parent.
+	nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NullNode) {
+		root = sibling;
+		return;
+	}
+
+	auto &children = nodes[grandParent].children;
+	children[children[0] == parent ? 0 : 1] = sibling;
+	Refit(grandParent);
+}
+
+void SpatialTree::Refit(int32_t index) {
+	while (index != NullNode) {
+		index = Balance(index);
+
+		auto &node = nodes[index];
+		const auto &child0 = nodes[node.children[0]];
+		const auto &child1 = nodes[node.children[1]];
+		node.min = child0.min.Min(child1.min);
+		node.max = child0.max.Max(child1.max);
+		node.height = 1 + std::max(child0.height, child1.height);
+		index = node.parent;
+	}
+}
+
+int32_t SpatialTree::Balance(int32_t index) {
+	auto &a = nodes[index];
+
+	if (a.IsLeaf() || a.height < 2)
+		return index;
+
+	auto balance = nodes[a.children[1]].height - nodes[a.children[0]].height;
+
+	if (balance >= -1 && balance <= 1)
+		return index;
+
+	// Rotates the taller child up to take this nodes place, this node keeps the shorter of the taller childs children.
+	auto taller = balance > 1 ? 1 : 0;
+	auto upIndex = a.children[taller];
+	auto &up = nodes[upIndex];
+	auto &shorter = nodes[a.children[1 - taller]];
+
+	up.parent = a.parent;
+	a.parent = upIndex;
+
+	if (up.parent == NullNode) {
+		root = upIndex;
+	} else {
+		auto &children = nodes[up.parent].children;
+		children[children[0] == index ? 0 : 1] = upIndex;
+	}
+
+	auto f = up.children[0];
+	auto g = up.children[1];
+
+	if (nodes[f].height < nodes[g].height)
+		std::swap(f, g);
+
+	// The taller grandchild stays under the rotated node, the other moves under this node.
+	up.children[0] = index;
+	up.children[1] = f;
+	a.children[taller] = g;
+	nodes[g].parent = index;
+
+	a.min = shorter.min.Min(nodes[g].min);
+	a.max = shorter.max.Max(nodes[g].max);
+	a.height = 1 + std::max(shorter.height, nodes[g].height);
+	up.min = a.min.Min(nodes[f].min);
+	up.max = a.max.Max(nodes[f].max);
+	up.height = 1 + std::max(a.height, nodes[f].height);
+	return upIndex;
+}
+
+void SpatialTree::AddObjects(int32_t branch, std::vector<Entity *> &objects) const {
+	std::vector<int32_t> stack;
+	stack.reserve(64);
+	stack.emplace_back(branch);
+
+	while (!stack.empty()) {
+		auto index = stack.back();
+		stack.pop_back();
+
+		const auto &node = nodes[index];
+
+		if (node.IsLeaf()) {
+			objects.emplace_back(leaves[index].object);
+		} else {
+			stack.emplace_back(node.children[0]);
+			stack.emplace_back(node.children[1]);
+		}
+	}
+}
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <vector>
+
+#include "Maths/Vector3.hpp"
+#include "Utils/NonCopyable.hpp"
+
+namespace acid {
+class Entity;
+class Frustum;
+
+/**
+ * @brief Class that indexes entities by bounding box in a dynamic AABB tree, so queries skip whole branches of space.
+ *
+ * Leaves hold the entities box and a box fattened by a margin, entities only move through the tree when they leave their fattened box.
+ * Inserts pick the sibling that adds the least surface area and rotations keep the tree balanced.
+ */
+class ACID_EXPORT SpatialTree : NonCopyable {
+public:
+	static constexpr int32_t NullNode = -1;
+
+	/**
+	 * Creates a new spatial tree.
+	 * @param margin The distance leaf boxes are fattened by on each side.
+	 */
+	explicit SpatialTree(float margin = 0.1f);
+
+	/**
+	 * Adds an entity to the tree.
+	 * @param object The entity.
+	 * @param min The min point of the entities bounding box.
+	 * @param max The max point of the entities bounding box.
+	 * @return The proxy that moves and removes the entity.
+	 */
+	int32_t Insert(Entity *object, const Vector3f &min, const Vector3f &max);
+
+	/**
+	 * Removes an entity from the tree.
+	 * @param proxy The proxy returned when the entity was inserted.
+	 */
+	void Remove(int32_t proxy);
+
+	/**
+	 * Updates the bounding box of an entity.
+	 * @param proxy The proxy returned when the entity was inserted.
+	 * @param min The min point of the entities bounding box.
+	 * @param max The max point of the entities bounding box.
+	 * @return If the entity left its fattened box and was moved through the tree.
+	 */
+	bool Move(int32_t proxy, const Vector3f &min, const Vector3f &max);
+
+	/**
+	 * Removes every entity from the tree.
+	 */
+	void Clear();
+
+	/**
+	 * Finds the entities with a bounding box partially in a frustum, as {@link Frustum#CubeInFrustum}.
+	 * Branches fully inside a plane stop being tested against it, branches inside every plane are added without tests.
+	 * @param frustum The frustum.
+	 * @param objects The list the entities are added to.
+	 */
+	void QueryFrustum(const Frustum &frustum, std::vector<Entity *> &objects) const;
+
+	/**
+	 * Finds the entities with a bounding box intersecting a sphere.
+	 * @param centre The spheres centre.
+	 * @param radius The spheres radius.
+	 * @param objects The list the entities are added to.
+	 */
+	void QuerySphere(const Vector3f &centre, float radius, std::vector<Entity *> &objects) const;
+
+	/**
+	 * Finds the entities with a bounding box intersecting a box.
+	 * @param min The min point of the box.
+	 * @param max The max point of the box.
+	 * @param objects The list the entities are added to.
+	 */
+	void QueryCube(const Vector3f &min, const Vector3f &max, std::vector<Entity *> &objects) const;
+
+	/**
+	 * Gets the number of entities in the tree.
+	 * @return The number of entities.
+	 */
+	uint32_t GetSize() const { return size; }
+
+	/**
+	 * Gets the height of the tree, a leaf has a height of zero.
+	 * @return The trees height.
+	 */
+	int32_t GetHeight() const;
+
+private:
+	class Node {
+	public:
+		bool IsLeaf() const { return children[0] == NullNode; }
+
+		/// The box around every child, or the fattened entity box for leaves.
+		Vector3f min, max;
+		/// The parent node, or the next free node when this node is free.
+		int32_t parent = NullNode;
+		int32_t children[2] = {NullNode, NullNode};
+		int32_t height = 0;
+	};
+
+	/// The entity in a leaf, kept apart from the nodes so traversals load less memory.
+	class Leaf {
+	public:
+		Vector3f min, max;
+		Entity *object = nullptr;
+	};
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t index);
+
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	void Refit(int32_t index);
+	int32_t Balance(int32_t index);
+
+	void AddObjects(int32_t branch, std::vector<Entity *> &objects) const;
+
+	float margin;
+	std::vector<Node> nodes;
+	/// The leaf data of each node, indexed the same as the nodes.
+	std::vector<Leaf> leaves;
+	int32_t root = NullNode;
+	int32_t freeList = NullNode;
+	uint32_t size = 0;
+};
+}
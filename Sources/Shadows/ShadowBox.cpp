@@ -2,6 +2,7 @@
 
 #include "Devices/Window.hpp"
 #include "Graphics/Graphics.hpp"
+#include "Maths/Batch.hpp"
 #include "Maths/Maths.hpp"
 
 namespace acid {
@@ -53,15 +54,8 @@ void ShadowBox::UpdateShadowBox(const Camera &camera) {
 	auto centreFar = toFar + camera.GetPosition();
 
 	auto points = CalculateFrustumVertices(rotation, forwardVector, centreNear, centreFar);
-
-	minExtents = Vector3f::Infinity;
-	maxExtents = -Vector3f::Infinity;
-
-	for (const auto &point : points) {
-		Vector3f extent(point);
-		minExtents = minExtents.Min(extent);
-		maxExtents = minExtents.Max(extent);
-	}
+	Batch::Transform(lightViewMatrix, points, points);
+	Batch::Extents(points, minExtents, maxExtents);
 
 	maxExtents.z += shadowOffset;
 }
@@ -73,7 +67,7 @@ void ShadowBox::UpdateSizes(const Camera &camera) {
 	nearHeight = nearWidth / Window::Get()->GetAspectRatio();
 }
 
-std::array<Vector4f, 8> ShadowBox::CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar) const {
+Vector3Soa ShadowBox::CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar) const {
 	Vector3f upVector(rotation.Transform(Vector4f(0.0f, 1.0f, 0.0f, 0.0f)));
 	auto rightVector = forwardVector.Cross(upVector);
 	auto downVector = -upVector;
@@ -84,24 +78,18 @@ std::array<Vector4f, 8> ShadowBox::CalculateFrustumVertices(const Matrix4 &rotat
 	auto nearTop = centreNear + (upVector * nearHeight);
 	auto nearBottom = centreNear + (downVector * nearHeight);
 
-	std::array<Vector4f, 8> points;
-	points[0] = CalculateLightSpaceFrustumCorner(farTop, rightVector, farWidth);
-	points[1] = CalculateLightSpaceFrustumCorner(farTop, leftVector, farWidth);
-	points[2] = CalculateLightSpaceFrustumCorner(farBottom, rightVector, farWidth);
-	points[3] = CalculateLightSpaceFrustumCorner(farBottom, leftVector, farWidth);
-	points[4] = CalculateLightSpaceFrustumCorner(nearTop, rightVector, nearWidth);
-	points[5] = CalculateLightSpaceFrustumCorner(nearTop, leftVector, nearWidth);
-	points[6] = CalculateLightSpaceFrustumCorner(nearBottom, rightVector, nearWidth);
-	points[7] = CalculateLightSpaceFrustumCorner(nearBottom, leftVector, nearWidth);
+	Vector3Soa points(8);
+	points.Set(0, farTop + (rightVector * farWidth));
+	points.Set(1, farTop + (leftVector * farWidth));
+	points.Set(2, farBottom + (rightVector * farWidth));
+	points.Set(3, farBottom + (leftVector * farWidth));
+	points.Set(4, nearTop + (rightVector * nearWidth));
+	points.Set(5, nearTop + (leftVector * nearWidth));
+	points.Set(6, nearBottom + (rightVector * nearWidth));
+	points.Set(7, nearBottom + (leftVector * nearWidth));
 	return points;
 }
 
-Vector4f ShadowBox::CalculateLightSpaceFrustumCorner(const Vector3f &startPoint, const Vector3f &direction, float width) const {
-	Vector4f point(startPoint + (direction * width));
-	point = lightViewMatrix.Transform(point);
-	return point;
-}
-
 void ShadowBox::UpdateOrthoProjectionMatrix() {
 	projectionMatrix = {};
 	projectionMatrix[0][0] = 2.0f / GetWidth();
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Maths/Matrix4.hpp"
+#include "Maths/Vector3Soa.hpp"
 #include "Maths/Vector4.hpp"
 #include "Scenes/Camera.hpp"
 
@@ -65,23 +66,14 @@ private:
 	void UpdateSizes(const Camera &camera);
 
 	/**
-	 * Calculates the vertex of each corner of the view frustum in light space.
+	 * Calculates the vertex of each corner of the view frustum in world space.
 	 * @param rotation The cameras rotation.
 	 * @param forwardVector The direction that the camera is aiming, and thus the direction of the frustum.
 	 * @param centreNear The centre point of the frustum's near plane.
 	 * @param centreFar The centre point of the frustum's far plane.
-	 * @return The vertices of the frustum in light space.
+	 * @return The vertices of the frustum in world space.
 	 */
-	std::array<Vector4f, 8> CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar) const;
-
-	/**
-	 * Calculates one of the corner vertices of the view frustum in world space and converts it to light space.
-	 * @param startPoint The starting centre point on the view frustum.
-	 * @param direction The direction of the corner from the start point.
-	 * @param width The distance of the corner from the start point.
-	 * @return The relevant corner vertex of the view frustum in light space.
-	 */
-	Vector4f CalculateLightSpaceFrustumCorner(const Vector3f &startPoint, const Vector3f &direction, float width) const;
+	Vector3Soa CalculateFrustumVertices(const Matrix4 &rotation, const Vector3f &forwardVector, const Vector3f &centreNear, const Vector3f &centreFar) const;
 
 	void UpdateOrthoProjectionMatrix();
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
 #include <string>
 #include <vector>
 #include <optional>
@@ -220,6 +223,79 @@ public:
 		}
 	}
 
+	/**
+	 * Parses whitespace separated numbers, like the contents of a COLLADA array, without splitting the string.
+	 * @tparam T The arithmetic type of the numbers.
+	 * @param str The string to parse.
+	 * @param numbers The vector the numbers are appended to.
+	 * @return If every value in the string was a number.
+	 */
+	template<typename T>
+	static bool ParseNumbers(std::string_view str, std::vector<T> &numbers) {
+		static_assert(std::is_arithmetic_v<T> && !std::is_same_v<bool, T>, "Numbers must be integers or floating point");
+		auto it = str.data();
+		auto end = it + str.size();
+
+		while (true) {
+			while (it != end && IsWhitespace(*it))
+				it++;
+			if (it == end)
+				return true;
+
+			// from_chars does not accept a leading plus sign.
+			if (*it == '+')
+				it++;
+
+			T value;
+			auto next = ParseNumber(it, end, value);
+			if (!next || (next != end && !IsWhitespace(*next)))
+				return false;
+
+			numbers.emplace_back(value);
+			it = next;
+		}
+	}
+
+	/**
+	 * Parses one number from the start of a string.
+	 * @tparam T The arithmetic type of the number.
+	 * @param it The start of the string.
+	 * @param end The end of the string.
+	 * @param value The parsed number.
+	 * @return The end of the number, or nullptr if the string does not start with a number.
+	 */
+	template<typename T>
+	static const char *ParseNumber(const char *it, const char *end, T &value) {
+#if !defined(__cpp_lib_to_chars)
+		if constexpr (std::is_floating_point_v<T>) {
+			// Floating point from_chars is not available, the number is read from a terminated copy.
+			auto numberEnd = it;
+			while (numberEnd != end && !IsWhitespace(*numberEnd))
+				numberEnd++;
+
+			std::string number(it, numberEnd);
+			char *parsedEnd;
+			errno = 0;
+			if constexpr (std::is_same_v<T, float>)
+				value = std::strtof(number.c_str(), &parsedEnd);
+			else if constexpr (std::is_same_v<T, double>)
+				value = std::strtod(number.c_str(), &parsedEnd);
+			else
+				value = std::strtold(number.c_str(), &parsedEnd);
+
+			if (number.empty() || errno != 0 || parsedEnd == number.c_str())
+				return nullptr;
+			return it + (parsedEnd - number.c_str());
+		} else
+#endif
+		{
+			auto result = std::from_chars(it, end, value);
+			if (result.ec != std::errc())
+				return nullptr;
+			return result.ptr;
+		}
+	}
+
 	// fnv1a 32 and 64 bit hash functions
 	// key is the data to hash, len is the size of the data (or how much of it to hash against)
 	// code license: public domain or equivalent
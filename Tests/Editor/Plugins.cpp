@@ -11,7 +11,7 @@
 namespace test {
 Plugins::Plugins() :
 	loadedPath(std::filesystem::current_path() / CR_PLUGIN("EditorTest")),
-	fileObserver(loadedPath, 0.5s),
+	fileObserver(loadedPath, 0.5s, FileObserver::Delivery::Update),
 	plugin(std::make_unique<cr_plugin>()),
 	buttonReload(Key::R) {
 	//panels.SetTransform({UiMargins::All});
@@ -21,7 +21,7 @@ Plugins::Plugins() :
 	std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
 	cr_plugin_load(*plugin, pathStr.c_str());
 
-	// Watches the plugin path.
+	// Watches the plugin path, changes are delivered on the main thread in Update.
 	fileObserver.OnChange().Add([this](std::filesystem::path path, FileObserver::Status status) {
 		update = true;
 	}, this);
@@ -38,6 +38,10 @@ Plugins::~Plugins() {
 }
 
 void Plugins::Update() {
+	fileObserver.Update();
+	// Shaders, images and models changed in the search paths are reloaded without restarting.
+	hotReloader.Update();
+
 	if (update) {
 		Log::Debug("[Host] Updating plugin\n");
 		//std::this_thread::sleep_for(std::chrono::milliseconds(150));
@@ -4,6 +4,8 @@
 #include <Files/FileObserver.hpp>
 #include <Files/Files.hpp>
 #include <Inputs/Buttons/KeyboardInputButton.hpp>
+#include <Resources/HotReloader.hpp>
+#include <Resources/Resources.hpp>
 #include "Uis/Panels.hpp"
 
 using namespace acid;
@@ -15,7 +17,7 @@ namespace test {
  * Module used for managing the world.
  */
 class Plugins : public Module::Registrar<Plugins>, public Observer {
-	inline static const bool Registered = Register(Stage::Always, Requires<Files>());
+	inline static const bool Registered = Register(Stage::Always, Requires<Files, Resources>());
 public:
 	Plugins();
 	~Plugins();
@@ -27,6 +29,7 @@ private:
 	FileObserver fileObserver;
 	std::unique_ptr<cr_plugin> plugin;
 	bool update = true;
+	HotReloader hotReloader;
 
 	//Panels panels;
 
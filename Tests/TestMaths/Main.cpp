@@ -1,17 +1,414 @@
+#include <numeric>
+#include <random>
+
 #include <Engine/Log.hpp>
 #include <Maths/Time.hpp>
+#include <Maths/Batch.hpp>
 #include <Maths/Colour.hpp>
 #include <Maths/Matrix2.hpp>
 #include <Maths/Matrix3.hpp>
 #include <Maths/Matrix4.hpp>
 #include <Maths/Quaternion.hpp>
+#include <Maths/Random.hpp>
 #include <Maths/Vector2.hpp>
 #include <Maths/Vector3.hpp>
 #include <Maths/Vector4.hpp>
 #include <Maths/Transform.hpp>
+#include <Physics/Frustum.hpp>
+#include <Scenes/Entity.hpp>
+#include <Scenes/SpatialTree.hpp>
 
 using namespace acid;
 
+// Scalar reference kernels, the kernels in the library are checked against them and timed next to them.
+Matrix4 ReferenceMultiply(const Matrix4 &left, const Matrix4 &right) {
+	Matrix4 result;
+	for (uint32_t row = 0; row < 4; row++) {
+		for (uint32_t col = 0; col < 4; col++)
+			result.rows[row][col] = left.rows[0][col] * right.rows[row][0] + left.rows[1][col] * right.rows[row][1] + left.rows[2][col] * right.rows[row][2] +
+				left.rows[3][col] * right.rows[row][3];
+	}
+	return result;
+}
+
+Vector4f ReferenceMultiply(const Matrix4 &left, const Vector4f &right) {
+	Vector4f result;
+	for (uint32_t row = 0; row < 4; row++)
+		result[row] = left.rows[0][row] * right.x + left.rows[1][row] * right.y + left.rows[2][row] * right.z + left.rows[3][row] * right.w;
+	return result;
+}
+
+Matrix4 ReferenceInverse(const Matrix4 &matrix) {
+	Matrix4 result;
+	auto det = matrix.Determinant();
+	for (uint32_t j = 0; j < 4; j++) {
+		for (uint32_t i = 0; i < 4; i++)
+			result.rows[i][j] = ((i + j) % 2 == 1 ? -1.0f : 1.0f) * matrix.GetSubmatrix(j, i).Determinant() / det;
+	}
+	return result;
+}
+
+Quaternion ReferenceMultiply(const Quaternion &left, const Quaternion &right) {
+	return {
+		left.x * right.w + left.w * right.x + left.y * right.z - left.z * right.y,
+		left.y * right.w + left.w * right.y + left.z * right.x - left.x * right.z,
+		left.z * right.w + left.w * right.z + left.x * right.y - left.y * right.x,
+		left.w * right.w - left.x * right.x - left.y * right.y - left.z * right.z
+	};
+}
+
+float Error(const Vector4f &a, const Vector4f &b) {
+	return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z), std::abs(a.w - b.w)});
+}
+
+float Error(const Matrix4 &a, const Matrix4 &b) {
+	return std::max({Error(a[0], b[0]), Error(a[1], b[1]), Error(a[2], b[2]), Error(a[3], b[3])});
+}
+
+float Error(const Quaternion &a, const Quaternion &b) {
+	return Error(Vector4f(a.x, a.y, a.z, a.w), Vector4f(b.x, b.y, b.z, b.w));
+}
+
+/**
+ * Times a kernel over every element, repeating it until enough time has passed to measure.
+ * @param count The number of elements.
+ * @param kernel The kernel, called with the index of each element.
+ * @return The time for each element, in nanoseconds.
+ */
+template<typename K>
+float Benchmark(std::size_t count, K &&kernel) {
+	std::size_t calls = 0;
+	auto start = Time::Now();
+	Time elapsed;
+	do {
+		for (std::size_t i = 0; i < count; i++)
+			kernel(i);
+		calls += count;
+		elapsed = Time::Now() - start;
+	} while (elapsed < 200ms);
+	return elapsed.AsMicroseconds<float>() * 1000.0f / static_cast<float>(calls);
+}
+
+/**
+ * Checks the maths kernels against the scalar references and compares their throughput.
+ * @return If every kernel matches its reference.
+ */
+bool BenchmarkKernels() {
+	static constexpr std::size_t Count = 4096;
+
+	std::mt19937 generator(5489);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+	auto random = [&]() { return distribution(generator); };
+
+	std::vector<Matrix4> matrices(Count);
+	std::vector<Vector4f> vectors(Count);
+	std::vector<Quaternion> quaternions(Count);
+	for (std::size_t i = 0; i < Count; i++) {
+		matrices[i] = Matrix4::TransformationMatrix({random(), random(), random()}, {random(), random(), random()}, Vector3f(0.5f) + Vector3f(std::abs(random())));
+		vectors[i] = {random(), random(), random(), 1.0f};
+		quaternions[i] = Quaternion(Vector3f(random(), random(), random()));
+	}
+
+	float multiplyError = 0.0f, transformError = 0.0f, inverseError = 0.0f, quaternionError = 0.0f;
+	for (std::size_t i = 0; i < Count; i++) {
+		auto &next = matrices[(i + 1) % Count];
+		multiplyError = std::max(multiplyError, Error(matrices[i].Multiply(next), ReferenceMultiply(matrices[i], next)) / (1.0f + Error(ReferenceMultiply(matrices[i], next), Matrix4(0.0f))));
+		transformError = std::max(transformError, Error(matrices[i].Multiply(vectors[i]), ReferenceMultiply(matrices[i], vectors[i])) / (1.0f + Error(ReferenceMultiply(matrices[i], vectors[i]), Vector4f())));
+		inverseError = std::max(inverseError, Error(matrices[i].Inverse().Multiply(matrices[i]), Matrix4()));
+		quaternionError = std::max(quaternionError, Error(quaternions[i] * quaternions[(i + 1) % Count], ReferenceMultiply(quaternions[i], quaternions[(i + 1) % Count])));
+	}
+
+	// The planes extracted from a projection must keep points in view and reject points behind the camera.
+	Frustum frustum;
+	auto view = Matrix4::ViewMatrix({}, {});
+	frustum.Update(view, Matrix4::PerspectiveMatrix(Maths::Radians(90.0f), 1.0f, 0.1f, 100.0f));
+	auto frustumCorrect = frustum.PointInFrustum({0.0f, 0.0f, -10.0f}) && !frustum.PointInFrustum({0.0f, 0.0f, 10.0f}) &&
+		!frustum.PointInFrustum({0.0f, 0.0f, -200.0f}) && !frustum.PointInFrustum({20.0f, 0.0f, -10.0f});
+
+	std::vector<Matrix4> matrixResults(Count);
+	std::vector<Vector4f> vectorResults(Count);
+	std::vector<Quaternion> quaternionResults(Count);
+
+	auto multiplyTime = Benchmark(Count, [&](std::size_t i) { matrixResults[i] = matrices[i].Multiply(matrices[(i + 1) % Count]); });
+	auto multiplyReferenceTime = Benchmark(Count, [&](std::size_t i) { matrixResults[i] = ReferenceMultiply(matrices[i], matrices[(i + 1) % Count]); });
+	auto transformTime = Benchmark(Count, [&](std::size_t i) { vectorResults[i] = matrices[i].Multiply(vectors[i]); });
+	auto transformReferenceTime = Benchmark(Count, [&](std::size_t i) { vectorResults[i] = ReferenceMultiply(matrices[i], vectors[i]); });
+	auto inverseTime = Benchmark(Count, [&](std::size_t i) { matrixResults[i] = matrices[i].Inverse(); });
+	auto inverseReferenceTime = Benchmark(Count, [&](std::size_t i) { matrixResults[i] = ReferenceInverse(matrices[i]); });
+	auto quaternionTime = Benchmark(Count, [&](std::size_t i) { quaternionResults[i] = quaternions[i] * quaternions[(i + 1) % Count]; });
+	auto quaternionReferenceTime = Benchmark(Count, [&](std::size_t i) { quaternionResults[i] = ReferenceMultiply(quaternions[i], quaternions[(i + 1) % Count]); });
+	auto frustumTime = Benchmark(Count, [&](std::size_t i) { frustum.Update(view, matrices[i]); });
+
+	Log::Out("Kernel times per element, reference scalar times in brackets:\n");
+	Log::Out("Matrix4 multiply: ", multiplyTime, "ns (", multiplyReferenceTime, "ns), relative error ", multiplyError, '\n');
+	Log::Out("Matrix4 vector multiply: ", transformTime, "ns (", transformReferenceTime, "ns), relative error ", transformError, '\n');
+	Log::Out("Matrix4 inverse: ", inverseTime, "ns (", inverseReferenceTime, "ns), identity error ", inverseError, '\n');
+	Log::Out("Quaternion multiply: ", quaternionTime, "ns (", quaternionReferenceTime, "ns), error ", quaternionError, '\n');
+	Log::Out("Frustum update: ", frustumTime, "ns, planes ", frustumCorrect ? "correct" : "incorrect", '\n');
+	Log::Out('\n');
+
+	return multiplyError < 1e-5f && transformError < 1e-5f && inverseError < 1e-3f && quaternionError < 1e-5f && frustumCorrect;
+}
+
+/**
+ * Checks the batch kernels against running the same maths one element at a time and compares their throughput.
+ * @return If every batch kernel matches its per element result.
+ */
+bool BenchmarkBatch() {
+	// Not a multiple of the register width, so the remainders are run too.
+	static constexpr std::size_t Count = 4099;
+
+	std::mt19937 generator(5489);
+	std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+	auto random = [&]() { return distribution(generator); };
+
+	auto matrix = Matrix4::TransformationMatrix({random(), random(), random()}, {random(), random(), random()}, Vector3f(2.0f));
+	std::vector<Matrix4> lefts(Count), rights(Count);
+	std::vector<Vector3f> points(Count);
+	Vector3Soa soaPoints(Count), soaMaxs(Count);
+	std::vector<float> radii(Count);
+	for (std::size_t i = 0; i < Count; i++) {
+		lefts[i] = Matrix4::TransformationMatrix({random(), random(), random()}, {random(), random(), random()}, Vector3f(1.0f));
+		rights[i] = Matrix4::TransformationMatrix({random(), random(), random()}, {random(), random(), random()}, Vector3f(1.0f));
+		points[i] = {random(), random(), random()};
+		soaPoints.Set(i, points[i]);
+		soaMaxs.Set(i, points[i] + Vector3f(std::abs(random()) / 10.0f));
+		radii[i] = std::abs(random()) / 10.0f;
+	}
+
+	Frustum frustum;
+	frustum.Update(Matrix4::ViewMatrix({}, {}), Matrix4::PerspectiveMatrix(Maths::Radians(60.0f), 1.0f, 0.1f, 150.0f));
+
+	Vector3Soa soaResults;
+	std::vector<Vector3f> results(Count);
+	std::vector<Matrix4> matrixResults(Count);
+	std::vector<uint8_t> contained(Count), containedResults(Count);
+	Vector3f min, max, soaMin, soaMax, strideMin, strideMax;
+
+	Batch::Transform(matrix, soaPoints, soaResults);
+	Batch::Multiply(lefts.data(), rights.data(), matrixResults.data(), Count);
+	Batch::Extents(soaPoints, soaMin, soaMax);
+	Batch::Extents(points.data(), Count, sizeof(Vector3f), strideMin, strideMax);
+
+	float transformError = 0.0f, multiplyError = 0.0f;
+	min = Vector3f::Infinity;
+	max = -Vector3f::Infinity;
+	for (std::size_t i = 0; i < Count; i++) {
+		transformError = std::max(transformError, Error(Vector4f(soaResults.Get(i)), matrix.Transform(Vector4f(points[i]))) / (1.0f + points[i].Length()));
+		multiplyError = std::max(multiplyError, Error(matrixResults[i], lefts[i].Multiply(rights[i])));
+		min = min.Min(points[i]);
+		max = max.Max(points[i]);
+	}
+
+	std::size_t sphereMismatches = 0, cubeMismatches = 0, spheresContained = 0;
+	Batch::SpheresInFrustum(frustum, soaPoints, radii.data(), contained.data());
+	for (std::size_t i = 0; i < Count; i++) {
+		sphereMismatches += (contained[i] != 0) != frustum.SphereInFrustum(points[i], radii[i]);
+		spheresContained += contained[i];
+	}
+
+	Batch::CubesInFrustum(frustum, soaPoints, soaMaxs, contained.data());
+	for (std::size_t i = 0; i < Count; i++)
+		cubeMismatches += (contained[i] != 0) != frustum.CubeInFrustum(points[i], soaMaxs.Get(i));
+
+	auto transformBatchTime = Benchmark(1, [&](std::size_t) { Batch::Transform(matrix, soaPoints, soaResults); }) / Count;
+	auto transformTime = Benchmark(Count, [&](std::size_t i) { results[i] = Vector3f(matrix.Transform(Vector4f(points[i]))); });
+	auto multiplyBatchTime = Benchmark(1, [&](std::size_t) { Batch::Multiply(lefts.data(), rights.data(), matrixResults.data(), Count); }) / Count;
+	auto multiplyTime = Benchmark(Count, [&](std::size_t i) { matrixResults[i] = lefts[i].Multiply(rights[i]); });
+	auto extentsBatchTime = Benchmark(1, [&](std::size_t) { Batch::Extents(soaPoints, soaMin, soaMax); }) / Count;
+	auto extentsStrideTime = Benchmark(1, [&](std::size_t) { Batch::Extents(points.data(), Count, sizeof(Vector3f), strideMin, strideMax); }) / Count;
+	auto extentsTime = Benchmark(1, [&](std::size_t) {
+		min = Vector3f::Infinity;
+		max = -Vector3f::Infinity;
+		for (const auto &point : points) {
+			min = min.Min(point);
+			max = max.Max(point);
+		}
+	}) / Count;
+	auto spheresBatchTime = Benchmark(1, [&](std::size_t) { Batch::SpheresInFrustum(frustum, soaPoints, radii.data(), contained.data()); }) / Count;
+	auto spheresTime = Benchmark(Count, [&](std::size_t i) { containedResults[i] = frustum.SphereInFrustum(points[i], radii[i]); });
+	auto cubesBatchTime = Benchmark(1, [&](std::size_t) { Batch::CubesInFrustum(frustum, soaPoints, soaMaxs, contained.data()); }) / Count;
+	auto cubesTime = Benchmark(Count, [&](std::size_t i) { containedResults[i] = frustum.CubeInFrustum(points[i], soaMaxs.Get(i)); });
+
+	auto extentsCorrect = soaMin == min && soaMax == max && strideMin == min && strideMax == max;
+
+	Log::Out("Batch times per element, one element at a time in brackets:\n");
+	Log::Out("Transform points: ", transformBatchTime, "ns (", transformTime, "ns), relative error ", transformError, '\n');
+	Log::Out("Matrix4 multiply: ", multiplyBatchTime, "ns (", multiplyTime, "ns), error ", multiplyError, '\n');
+	Log::Out("Extents: ", extentsBatchTime, "ns, strided ", extentsStrideTime, "ns (", extentsTime, "ns), ", extentsCorrect ? "correct" : "incorrect", '\n');
+	Log::Out("Spheres in frustum: ", spheresBatchTime, "ns (", spheresTime, "ns), ", spheresContained, " contained, ", sphereMismatches, " mismatches\n");
+	Log::Out("Cubes in frustum: ", cubesBatchTime, "ns (", cubesTime, "ns), ", cubeMismatches, " mismatches\n");
+	Log::Out('\n');
+
+	return transformError < 1e-5f && multiplyError < 1e-4f && extentsCorrect && sphereMismatches == 0 && cubeMismatches == 0;
+}
+
+/**
+ * Checks the random generator replays from its seed and its distributions, comparing its throughput with the standard library.
+ * @return If every check passes.
+ */
+bool BenchmarkRandom() {
+	static constexpr std::size_t Count = 4096;
+
+	Random a(42), b(42);
+	auto repeats = true;
+	for (std::size_t i = 0; i < Count; i++)
+		repeats &= a.Next() == b.Next();
+
+	std::vector<float> values(Count), replayed(Count);
+	Random::Reseed(7);
+	for (auto &value : values)
+		value = Maths::Random(-1.0f, 1.0f);
+	Random::Reseed(7);
+	for (auto &value : replayed)
+		value = Maths::Random(-1.0f, 1.0f);
+	repeats &= values == replayed;
+
+	auto &random = Random::Get();
+	random.Uniform(values.data(), Count, 2.0f, 4.0f);
+	auto uniformMean = std::accumulate(values.begin(), values.end(), 0.0f) / Count;
+	auto uniformCorrect = std::all_of(values.begin(), values.end(), [](float value) { return value >= 2.0f && value <= 4.0f; }) && std::abs(uniformMean - 3.0f) < 0.05f;
+
+	random.Normal(values.data(), Count, 2.0f, 5.0f);
+	auto normalMean = std::accumulate(values.begin(), values.end(), 0.0f) / Count;
+	auto normalVariance = std::accumulate(values.begin(), values.end(), 0.0f, [&](float sum, float value) { return sum + (value - normalMean) * (value - normalMean); }) / Count;
+	auto normalCorrect = std::abs(normalMean - 5.0f) < 0.15f && std::abs(std::sqrt(normalVariance) - 2.0f) < 0.15f;
+
+	std::vector<Vector3f> vectors(Count);
+	random.UnitVectors(vectors.data(), Count);
+	auto unitCorrect = std::all_of(vectors.begin(), vectors.end(), [](const Vector3f &vector) { return std::abs(vector.Length() - 1.0f) < 1e-4f; });
+
+	auto coneDirection = Vector3f(1.0f, 2.0f, -3.0f).Normalize();
+	random.ConeDirections(coneDirection, Maths::Radians(20.0f), vectors.data(), Count);
+	unitCorrect &= std::all_of(vectors.begin(), vectors.end(), [&](const Vector3f &vector) {
+		return std::abs(vector.Length() - 1.0f) < 1e-4f && vector.Dot(coneDirection) >= std::cos(Maths::Radians(20.0f)) - 1e-4f;
+	});
+
+	// The standard library path that Maths::Random used, one global generator and a distribution built for every value.
+	std::mt19937 generator(5489);
+	auto uniformTime = Benchmark(Count, [&](std::size_t i) { values[i] = random.Uniform(-1.0f, 1.0f); });
+	auto uniformBatchTime = Benchmark(1, [&](std::size_t) { random.Uniform(values.data(), Count, -1.0f, 1.0f); }) / Count;
+	auto uniformReferenceTime = Benchmark(Count, [&](std::size_t i) { values[i] = std::uniform_real_distribution<float>(-1.0f, 1.0f)(generator); });
+	auto normalBatchTime = Benchmark(1, [&](std::size_t) { random.Normal(values.data(), Count); }) / Count;
+	auto normalReferenceTime = Benchmark(Count, [&](std::size_t i) { values[i] = std::normal_distribution<float>(0.0f, 1.0f)(generator); });
+	auto unitBatchTime = Benchmark(1, [&](std::size_t) { random.UnitVectors(vectors.data(), Count); }) / Count;
+
+	Log::Out("Random times per value, standard library times in brackets:\n");
+	Log::Out("Uniform: ", uniformTime, "ns, batched ", uniformBatchTime, "ns (", uniformReferenceTime, "ns), mean ", uniformMean, '\n');
+	Log::Out("Normal batched: ", normalBatchTime, "ns (", normalReferenceTime, "ns), mean ", normalMean, ", deviation ", std::sqrt(normalVariance), '\n');
+	Log::Out("Unit vectors batched: ", unitBatchTime, "ns, ", unitCorrect ? "correct" : "incorrect", '\n');
+	Log::Out("Seeded sequences ", repeats ? "repeat" : "differ", '\n');
+	Log::Out('\n');
+
+	return repeats && uniformCorrect && normalCorrect && unitCorrect;
+}
+
+/**
+ * Checks the spatial tree queries against testing every box and compares their times over many static boxes.
+ * @return If every query matches testing every box.
+ */
+bool BenchmarkSpatialTree() {
+	static constexpr std::size_t Count = 100000;
+
+	std::mt19937 generator(5489);
+	std::uniform_real_distribution<float> positions(-1000.0f, 1000.0f);
+	std::uniform_real_distribution<float> sizes(0.5f, 5.0f);
+
+	std::vector<std::unique_ptr<Entity>> entities(Count);
+	std::vector<Vector3f> mins(Count), maxs(Count);
+	std::vector<int32_t> proxies(Count);
+	for (std::size_t i = 0; i < Count; i++) {
+		entities[i] = std::make_unique<Entity>();
+		mins[i] = {positions(generator), positions(generator), positions(generator)};
+		maxs[i] = mins[i] + Vector3f(sizes(generator), sizes(generator), sizes(generator));
+	}
+
+	SpatialTree tree;
+	auto buildStart = Time::Now();
+	for (std::size_t i = 0; i < Count; i++)
+		proxies[i] = tree.Insert(entities[i].get(), mins[i], maxs[i]);
+	auto buildTime = (Time::Now() - buildStart).AsMilliseconds<float>();
+
+	Frustum frustum;
+	frustum.Update(Matrix4::ViewMatrix({}, {0.3f, 0.5f, 0.0f}), Matrix4::PerspectiveMatrix(Maths::Radians(60.0f), 1.5f, 0.1f, 600.0f));
+	Vector3f centre(100.0f, -50.0f, 20.0f), cubeMin(-200.0f, -100.0f, -300.0f), cubeMax(100.0f, 200.0f, 0.0f);
+	auto radius = 150.0f;
+
+	auto sorted = [](std::vector<Entity *> objects) {
+		std::sort(objects.begin(), objects.end());
+		return objects;
+	};
+	auto bruteFrustum = [&]() {
+		std::vector<Entity *> objects;
+		for (std::size_t i = 0; i < Count; i++) {
+			if (frustum.CubeInFrustum(mins[i], maxs[i]))
+				objects.emplace_back(entities[i].get());
+		}
+		return objects;
+	};
+	auto bruteSphere = [&]() {
+		std::vector<Entity *> objects;
+		for (std::size_t i = 0; i < Count; i++) {
+			if ((centre.Max(mins[i]).Min(maxs[i]) - centre).LengthSquared() <= radius * radius)
+				objects.emplace_back(entities[i].get());
+		}
+		return objects;
+	};
+	auto bruteCube = [&]() {
+		std::vector<Entity *> objects;
+		for (std::size_t i = 0; i < Count; i++) {
+			if (mins[i].x <= cubeMax.x && mins[i].y <= cubeMax.y && mins[i].z <= cubeMax.z && cubeMin.x <= maxs[i].x && cubeMin.y <= maxs[i].y && cubeMin.z <= maxs[i].z)
+				objects.emplace_back(entities[i].get());
+		}
+		return objects;
+	};
+	auto queryFrustum = [&]() {
+		std::vector<Entity *> objects;
+		tree.QueryFrustum(frustum, objects);
+		return objects;
+	};
+	auto querySphere = [&]() {
+		std::vector<Entity *> objects;
+		tree.QuerySphere(centre, radius, objects);
+		return objects;
+	};
+	auto queryCube = [&]() {
+		std::vector<Entity *> objects;
+		tree.QueryCube(cubeMin, cubeMax, objects);
+		return objects;
+	};
+
+	auto frustumObjects = sorted(queryFrustum());
+	auto queriesCorrect = frustumObjects == bruteFrustum() && sorted(querySphere()) == bruteSphere() && sorted(queryCube()) == bruteCube();
+
+	// Moves a tenth of the boxes, some within their fattened box and some across the scene.
+	for (std::size_t i = 0; i < Count; i += 10) {
+		auto offset = i % 20 == 0 ? Vector3f(0.05f) : Vector3f(positions(generator), positions(generator), positions(generator)) / 4.0f;
+		mins[i] += offset;
+		maxs[i] += offset;
+		tree.Move(proxies[i], mins[i], maxs[i]);
+	}
+
+	queriesCorrect &= sorted(queryFrustum()) == bruteFrustum() && sorted(querySphere()) == bruteSphere() && sorted(queryCube()) == bruteCube();
+
+	std::size_t sink = 0;
+	auto frustumTime = Benchmark(1, [&](std::size_t) { sink += queryFrustum().size(); }) / 1000.0f;
+	auto frustumBruteTime = Benchmark(1, [&](std::size_t) { sink += bruteFrustum().size(); }) / 1000.0f;
+	auto sphereTime = Benchmark(1, [&](std::size_t) { sink += querySphere().size(); }) / 1000.0f;
+	auto sphereBruteTime = Benchmark(1, [&](std::size_t) { sink += bruteSphere().size(); }) / 1000.0f;
+	auto cubeTime = Benchmark(1, [&](std::size_t) { sink += queryCube().size(); }) / 1000.0f;
+	auto cubeBruteTime = Benchmark(1, [&](std::size_t) { sink += bruteCube().size(); }) / 1000.0f;
+
+	Log::Out("Spatial tree of ", tree.GetSize(), " boxes built in ", buildTime, "ms, height ", tree.GetHeight(), '\n');
+	Log::Out("Query times, testing every box in brackets:\n");
+	Log::Out("Frustum: ", frustumTime, "us (", frustumBruteTime, "us), ", frustumObjects.size(), " found\n");
+	Log::Out("Sphere: ", sphereTime, "us (", sphereBruteTime, "us)\n");
+	Log::Out("Cube: ", cubeTime, "us (", cubeBruteTime, "us), queries ", queriesCorrect ? "match" : "differ", ", ", sink % 2, '\n');
+	Log::Out('\n');
+
+	return queriesCorrect;
+}
+
 int main(int argc, char **argv) {
 	{
 		Log::Out("Time Size: ", sizeof(Time), '\n');
@@ -155,8 +552,13 @@ int main(int argc, char **argv) {
 		Log::Out('\n');
 	}
 
+	auto kernelsCorrect = BenchmarkKernels();
+	kernelsCorrect &= BenchmarkBatch();
+	kernelsCorrect &= BenchmarkRandom();
+	kernelsCorrect &= BenchmarkSpatialTree();
+
 	// Pauses the console.
 	std::cout << "Press enter to continue...";
 	std::cin.get();
-	return EXIT_SUCCESS;
+	return kernelsCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -1,12 +1,321 @@
 #include <thread>
+#include <unordered_map>
+#if !defined(ACID_BUILD_WINDOWS)
+#include <sys/resource.h>
+#endif
 #include <Engine/Log.hpp>
 #include <Network/Ftp/Ftp.hpp>
 #include <Network/Http/Http.hpp>
+#include <Network/Tcp/TcpListener.hpp>
+#include <Network/Tcp/TcpSocket.hpp>
 #include <Network/Udp/UdpSocket.hpp>
+#include <Network/Udp/UdpTransport.hpp>
 #include <Network/Packet.hpp>
+#include <Network/SocketPoller.hpp>
 
 using namespace acid;
 
+// Raises the soft limit of open file descriptors to a count if it is lower, within the hard limit.
+bool RaiseDescriptorLimit(std::size_t count) {
+#if defined(ACID_BUILD_WINDOWS)
+	return true;
+#else
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+		return false;
+	if (limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur >= count)
+		return true;
+	if (limit.rlim_max != RLIM_INFINITY && limit.rlim_max < count)
+		return false;
+
+	limit.rlim_cur = static_cast<rlim_t>(count);
+	return setrlimit(RLIMIT_NOFILE, &limit) == 0;
+#endif
+}
+
+// Measures how a poller scales with the number of loopback TCP connections, every client sends a ping each round
+// and the server side echoes back everything the poller reports as readable.
+void BenchmarkPoller(std::size_t connectionCount, uint32_t rounds) {
+	// Both ends of every connection are open in this process, with some room for the listener, poller and standard streams.
+	if (!RaiseDescriptorLimit(2 * connectionCount + 64)) {
+		Log::Warning("Poller benchmark skipped ", connectionCount, " connections, the file descriptor limit is too low\n");
+		return;
+	}
+
+	TcpListener listener;
+	if (listener.Listen(0, IpAddress::LocalHost) != Socket::Status::Done)
+		return;
+
+	std::vector<std::unique_ptr<TcpSocket>> clients;
+	std::vector<std::unique_ptr<TcpSocket>> servers;
+	// Bytes of a message each server socket has received so far, reads can end part way through a message.
+	std::unordered_map<Socket *, std::size_t> partial;
+	SocketPoller poller;
+
+	for (std::size_t i = 0; i < connectionCount; i++) {
+		auto &client = clients.emplace_back(std::make_unique<TcpSocket>());
+		auto &server = servers.emplace_back(std::make_unique<TcpSocket>());
+		if (client->Connect(IpAddress::LocalHost, listener.GetLocalPort()) != Socket::Status::Done ||
+			listener.Accept(*server) != Socket::Status::Done) {
+			Log::Error("Poller benchmark could only open ", i, " connections\n");
+			return;
+		}
+		poller.Add(*server);
+		partial[server.get()] = 0;
+	}
+
+	auto start = Time::Now();
+	Time worstRound;
+
+	for (uint32_t round = 0; round < rounds; round++) {
+		auto roundStart = Time::Now();
+		for (auto &client : clients)
+			client->Send(&round, sizeof(round));
+
+		std::size_t echoed = 0;
+		while (echoed < clients.size()) {
+			poller.Wait(1s);
+			for (const auto &ready : poller.GetReady()) {
+				if (!(ready.events & SocketEvent::Read))
+					continue;
+				// Edge-triggered, so drain until the socket would block. Only complete messages are counted.
+				auto socket = static_cast<TcpSocket *>(ready.socket);
+				auto &buffered = partial[ready.socket];
+				uint32_t value;
+				std::size_t received, sent;
+				while (socket->Receive(&value, sizeof(value), received) == Socket::Status::Done) {
+					socket->Send(&value, received, sent);
+					buffered += received;
+					echoed += buffered / sizeof(value);
+					buffered %= sizeof(value);
+				}
+			}
+		}
+
+		for (auto &client : clients) {
+			// The echo can arrive in more than one read.
+			uint32_t value;
+			for (std::size_t total = 0, received; total < sizeof(value); total += received) {
+				if (client->Receive(reinterpret_cast<uint8_t *>(&value) + total, sizeof(value) - total, received) != Socket::Status::Done)
+					break;
+			}
+		}
+
+		worstRound = std::max(worstRound, Time::Now() - roundStart);
+	}
+
+	auto elapsed = Time::Now() - start;
+	Log::Out("Poller ", connectionCount, " connections: ", elapsed.AsMilliseconds<float>() / rounds, "ms per round, ",
+		elapsed.AsMicroseconds<float>() / (rounds * connectionCount), "us per message, worst round ", worstRound.AsMilliseconds<float>(), "ms\n");
+}
+
+// Compares sending many small replication-sized packets one call at a time against a single gathered batch.
+void BenchmarkPacketSend(std::size_t packetCount, std::size_t batchSize) {
+	TcpListener listener;
+	if (listener.Listen(0, IpAddress::LocalHost) != Socket::Status::Done)
+		return;
+
+	TcpSocket client, server;
+	if (client.Connect(IpAddress::LocalHost, listener.GetLocalPort()) != Socket::Status::Done ||
+		listener.Accept(server) != Socket::Status::Done)
+		return;
+
+	std::vector<Packet> packets(batchSize);
+	std::vector<Packet *> packetPointers;
+	for (auto &packet : packets) {
+		packet << uint32_t(42) << 1.0f << 2.0f << 3.0f << std::string("transform");
+		packetPointers.emplace_back(&packet);
+	}
+
+	auto receiveAll = [&]() {
+		Packet received;
+		for (std::size_t i = 0; i < packetCount; i++)
+			server.Receive(received);
+	};
+
+	for (auto batched : {false, true}) {
+		auto start = Time::Now();
+		std::thread receiver(receiveAll);
+
+		for (std::size_t sent = 0; sent < packetCount; sent += batchSize) {
+			if (batched) {
+				client.Send(packetPointers.data(), packetPointers.size());
+			} else {
+				for (auto &packet : packets)
+					client.Send(packet);
+			}
+		}
+
+		receiver.join();
+		auto elapsed = Time::Now() - start;
+		Log::Out(batched ? "Batched" : "Single", " packet send: ", elapsed.AsMicroseconds<float>() * 1000.0f / packetCount, "ns per packet\n");
+	}
+}
+
+// Sends reliable messages, some larger than a datagram, between two loopback transports over a simulated lossy link
+// and checks every message arrives once and in order.
+void TestUdpTransport(uint32_t messageCount, const UdpTransport::Simulation &simulation) {
+	UdpTransport server, client;
+	if (server.Bind(0, IpAddress::LocalHost) != Socket::Status::Done)
+		return;
+	server.SetSimulation(simulation);
+	client.SetSimulation(simulation);
+
+	auto connection = client.Connect(IpAddress::LocalHost, server.GetLocalPort());
+	UdpConnection *accepted = nullptr;
+	server.OnConnect().Add([&](UdpConnection &c) {
+		accepted = &c;
+	});
+
+	auto start = Time::Now();
+	uint32_t sent = 0, received = 0, sequenced = 0;
+	bool ordered = true;
+
+	while (received < messageCount && Time::Now() - start < 30s) {
+		if (connection->GetState() == UdpConnection::State::Connected) {
+			for (uint32_t i = 0; i < 16 && sent < messageCount; i++, sent++) {
+				// Every 16th message is fragmented across several datagrams.
+				Packet packet;
+				packet << sent << std::string(sent % 16 == 0 ? 4000 : 16, 'x');
+				connection->Send(0, packet);
+			}
+
+			Packet state;
+			state << sent;
+			connection->Send(1, state);
+		}
+
+		client.Update();
+		server.Update();
+
+		uint8_t channel;
+		Packet packet;
+		while (accepted && accepted->Receive(channel, packet)) {
+			uint32_t index;
+			packet >> index;
+			if (channel == 0)
+				ordered &= index == received++;
+			else
+				sequenced++;
+		}
+
+		std::this_thread::sleep_for(1ms);
+	}
+
+	Log::Out("UdpTransport ", simulation.loss * 100.0f, "% loss, ", simulation.latency.AsMilliseconds(), "ms latency: ", received, '/', messageCount,
+		" reliable messages ", ordered ? "in order" : "OUT OF ORDER", ", ", sequenced, " sequenced, ", (Time::Now() - start).AsMilliseconds(),
+		"ms, rtt ", connection->GetRoundTripTime().AsMilliseconds(), "ms, loss ", connection->GetPacketLoss() * 100.0f, "%\n");
+}
+
+// Serves keep-alive HTTP/1.1 responses from a local listener, one connection at a time, until "/quit" is requested.
+void ServeHttp(TcpListener &listener) {
+	for (;;) {
+		TcpSocket client;
+		if (listener.Accept(client) != Socket::Status::Done)
+			return;
+
+		std::string buffer;
+		char data[4096];
+		std::size_t received;
+		bool open = true;
+
+		while (open && client.Receive(data, sizeof(data), received) == Socket::Status::Done) {
+			buffer.append(data, received);
+
+			for (std::size_t end; open && (end = buffer.find("\r\n\r\n")) != std::string::npos;) {
+				auto uriStart = buffer.find(' ') + 1;
+				auto uri = buffer.substr(uriStart, buffer.find(' ', uriStart) - uriStart);
+				buffer.erase(0, end + 4);
+
+				std::string response;
+				if (uri == "/chunked") {
+					response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+						"5\r\nHello\r\n7;ext=1\r\n, world\r\n0\r\nChecksum: 42\r\n\r\n";
+				} else if (uri == "/large") {
+					// Streamed in 64KB chunks, the client should never hold the whole body.
+					response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+					client.Send(response.c_str(), response.size());
+					std::string chunk = "10000\r\n" + std::string(0x10000, 'a') + "\r\n";
+					for (uint32_t i = 0; i < 128; i++)
+						client.Send(chunk.c_str(), chunk.size());
+					response = "0\r\n\r\n";
+				} else if (uri == "/truncated") {
+					// The connection closes before the length the header promised.
+					response = "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabc";
+					open = false;
+				} else if (uri == "/close" || uri == "/quit") {
+					response = "HTTP/1.1 200 OK\r\nContent-Length: 3\r\nConnection: close\r\n\r\nbye";
+				} else {
+					response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(uri.size()) + "\r\n\r\n" + uri;
+				}
+
+				client.Send(response.c_str(), response.size());
+
+				if (uri == "/quit")
+					return;
+				open = open && uri != "/close";
+			}
+		}
+	}
+}
+
+// Checks connection reuse, pipelining, chunked decoding and body streaming against a local stand-in HTTP server.
+void TestHttpKeepAlive(uint32_t requestCount) {
+	TcpListener listener;
+	if (listener.Listen(0, IpAddress::LocalHost) != Socket::Status::Done)
+		return;
+
+	std::thread server(ServeHttp, std::ref(listener));
+	Http http("http://127.0.0.1", listener.GetLocalPort());
+	bool passed = true;
+
+	auto start = Time::Now();
+	for (uint32_t i = 0; i < requestCount; i++)
+		passed &= http.SendRequest(HttpRequest("/poll")).GetBody() == "/poll";
+	auto keepAliveTime = (Time::Now() - start) / static_cast<int64_t>(requestCount);
+	passed &= http.GetConnectionCount() == 1;
+
+	auto chunked = http.SendRequest(HttpRequest("/chunked"));
+	passed &= chunked.GetBody() == "Hello, world" && chunked.GetField("Checksum") == "42";
+
+	std::vector<HttpRequest> requests;
+	for (uint32_t i = 0; i < 32; i++)
+		requests.emplace_back("/pipelined/" + std::to_string(i));
+	auto responses = http.SendRequests(requests);
+	for (uint32_t i = 0; i < responses.size(); i++)
+		passed &= responses[i].GetBody() == "/pipelined/" + std::to_string(i);
+
+	std::size_t streamed = 0;
+	auto large = http.SendRequest(HttpRequest("/large"), [&](const char *data, std::size_t size) {
+		streamed += size;
+		return true;
+	});
+	passed &= large.GetStatus() == HttpResponse::Status::Ok && large.GetBody().empty() && streamed == 128 * 0x10000;
+	passed &= http.GetConnectionCount() == 1;
+
+	// The server closes this connection, the next request has to open a new one.
+	passed &= http.SendRequest(HttpRequest("/close")).GetBody() == "bye";
+	start = Time::Now();
+	passed &= http.SendRequest(HttpRequest("/after-close")).GetBody() == "/after-close";
+	auto connectTime = Time::Now() - start;
+	passed &= http.GetConnectionCount() == 2;
+
+	// A body cut short by the server closing is an error, not a short success.
+	passed &= http.SendRequest(HttpRequest("/truncated")).GetStatus() == HttpResponse::Status::ConnectionFailed;
+
+	// Changing the host drops the pooled connection, even to the same address.
+	http.SendRequest(HttpRequest("/pooled"));
+	http.SetHost("http://127.0.0.1", listener.GetLocalPort());
+	passed &= http.SendRequest(HttpRequest("/after-set-host")).GetBody() == "/after-set-host";
+	passed &= http.GetConnectionCount() == 4;
+
+	http.SendRequest(HttpRequest("/quit"));
+	server.join();
+
+	Log::Out("Http keep-alive: ", passed ? "passed" : "FAILED", ", ", keepAliveTime.AsMicroseconds(), "us per reused request, ",
+		connectTime.AsMicroseconds(), "us with a new connection\n");
+}
+
 int main(int argc, char **argv) {
 	// TODO: Download a ZIP from Google Drive.
 	/*{
@@ -46,6 +355,19 @@ int main(int argc, char **argv) {
 		Log::Out("Content-Type header: ", response.GetField("Content-Type"), '\n');
 		Log::Out("Body: ", response.GetBody(), '\n');
 	}
+	{
+		for (auto connectionCount : {16, 256, 1024, 4096})
+			BenchmarkPoller(connectionCount, 100);
+		BenchmarkPacketSend(100000, 64);
+	}
+	{
+		TestHttpKeepAlive(1000);
+	}
+	{
+		TestUdpTransport(2000, {});
+		TestUdpTransport(2000, {0.1f, 50ms, 20ms});
+		TestUdpTransport(1000, {0.3f, 50ms, 20ms});
+	}
 	// TODO: json examples.
 	// https://www.sfml-dev.org/tutorials/2.5/network-ftp.php
 	/*{
@@ -1,5 +1,8 @@
 #include <Engine/Log.hpp>
+#include <Files/Pack/AssetPackWriter.hpp>
 #include <Files/Zip/ZipArchive.hpp>
+#include <Maths/Time.hpp>
+#include <Utils/ThreadPool.hpp>
 #include "Config.hpp"
 
 std::filesystem::path PATH = acid::ACID_RESOURCES_DEV;
@@ -14,9 +17,72 @@ std::unique_ptr<acid::ZipArchive> NewArchive(int index) {
 	return std::make_unique<acid::ZipArchive>(zipFilepath);
 }
 
+void BenchmarkLoad(const std::vector<std::filesystem::path> &zipFilepaths, const std::filesystem::path &packFilepath, acid::ThreadPool &threadPool) {
+	std::size_t zipBytes = 0;
+	auto start = acid::Time::Now();
+	for (const auto &zipFilepath : zipFilepaths) {
+		acid::ZipArchive archive(zipFilepath);
+		for (const auto &name : archive.GetEntryNames(false, true))
+			zipBytes += archive.GetEntry(name)->GetData().size();
+	}
+	auto zipTime = acid::Time::Now() - start;
+
+	std::string buffer;
+
+	auto loadPack = [&](acid::ThreadPool *pool) {
+		std::size_t bytes = 0;
+		acid::AssetPack pack(packFilepath);
+		for (const auto &entry : pack.GetEntries()) {
+			// Uncompressed entries are used straight from the mapped pack.
+			if (auto view = pack.GetView(entry)) {
+				bytes += view->size();
+				continue;
+			}
+			buffer.resize(static_cast<std::size_t>(entry.size));
+			pack.Read(entry, reinterpret_cast<uint8_t *>(buffer.data()), pool);
+			bytes += buffer.size();
+		}
+		return bytes;
+	};
+
+	start = acid::Time::Now();
+	auto packBytes = loadPack(nullptr);
+	auto packTime = acid::Time::Now() - start;
+
+	start = acid::Time::Now();
+	loadPack(&threadPool);
+	auto packParallelTime = acid::Time::Now() - start;
+
+	acid::Log::Out("Loaded ", zipBytes / 1000000, "MB from zip in ", zipTime.AsMilliseconds<float>(), "ms, ", packBytes / 1000000, "MB from asset pack in ",
+		packTime.AsMilliseconds<float>(), "ms, parallel decompression ", packParallelTime.AsMilliseconds<float>(), "ms\n");
+}
+
+void BenchmarkAppend(const std::filesystem::path &zipFilepath, acid::ThreadPool &threadPool) {
+	acid::ZipArchive archive(zipFilepath);
+	archive.AddEntry("Appended.txt", "Appended entry");
+	auto start = acid::Time::Now();
+	archive.Append(&threadPool);
+	auto appendTime = acid::Time::Now() - start;
+
+	archive.AddEntry("Appended.txt", "Rewritten entry");
+	start = acid::Time::Now();
+	archive.Write("", &threadPool);
+	auto writeTime = acid::Time::Now() - start;
+
+	acid::Log::Out("Added a entry to ", zipFilepath.filename(), " by appending in ", appendTime.AsMilliseconds<float>(), "ms, by rewriting in ",
+		writeTime.AsMilliseconds<float>(), "ms\n");
+}
+
 int main(int argc, char **argv) {
 	auto maxFraction = 16 * 1000000;
+	acid::ThreadPool threadPool;
+	auto start = acid::Time::Now();
+
+	auto packFilepath = std::filesystem::current_path() / "data.apak";
+	acid::Log::Out("New asset pack: ", packFilepath, '\n');
+	acid::AssetPackWriter pack(packFilepath);
 
+	std::vector<std::filesystem::path> zipFilepaths = {std::filesystem::current_path() / "data-0.zip"};
 	auto archive = NewArchive(0);
 	int index = 1;
 	int currentSizeBytes = 0;
@@ -25,21 +91,29 @@ int main(int argc, char **argv) {
 		if (!file.is_regular_file()) continue;
 
 		if (currentSizeBytes > maxFraction) {
-			archive->Write();
+			archive->Write("", &threadPool);
+			zipFilepaths.emplace_back(std::filesystem::current_path() / ("data-" + std::to_string(index) + ".zip"));
 			archive = NewArchive(index++);
 			currentSizeBytes = 0;
 		}
 		
 		acid::Log::Out(file.path(), '\n');
 		
-		std::ifstream t(file.path(), std::ios::in | std::ios::binary);
-		std::string str((std::istreambuf_iterator<char>(t)),
-			std::istreambuf_iterator<char>());
-		archive->AddEntry(file.path().string().substr(PATH.string().length() + 1), str);
+		// Zip entries are read from the file when the archive is written, the pack is written from a mapping.
+		auto name = file.path().string().substr(PATH.string().length() + 1);
+		archive->AddFile(name, file.path());
+		if (auto mapped = acid::MappedFile::Open(file.path()))
+			pack.AddEntry(name, mapped->GetString());
 		currentSizeBytes += file.file_size();
 	}
 	
-	archive->Write();
+	archive->Write("", &threadPool);
+	archive.reset();
+	pack.Finish();
+	acid::Log::Out("Packed ", PATH, " in ", (acid::Time::Now() - start).AsMilliseconds<float>(), "ms\n");
+
+	BenchmarkLoad(zipFilepaths, packFilepath, threadPool);
+	BenchmarkAppend(zipFilepaths.front(), threadPool);
 
 	// Pauses the console.
 	std::cout << "Press enter to continue...";
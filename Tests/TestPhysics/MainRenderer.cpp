@@ -54,7 +54,7 @@ MainRenderer::MainRenderer() {
 void MainRenderer::Start() {
 	//AddSubrender<RenderShadows>({0, 0});
 
-	AddSubrender<MeshesSubrender>({1, 0});
+	AddSubrender<MeshesSubrender>({1, 0}, MeshesSubrender::Sort::None, MeshesSubrender::Culling::Occlusion);
 
 	AddSubrender<DeferredSubrender>({1, 1});
 	AddSubrender<ParticlesSubrender>({1, 1});
@@ -1,9 +1,13 @@
+#include <random>
 #include <Files/File.hpp>
 #include <Files/Files.hpp>
 #include <Utils/EnumClass.hpp>
 #include <Maths/Matrix4.hpp>
 #include <Maths/Vector2.hpp>
+#include <Maths/Vector3.hpp>
 #include <Files/Node.hpp>
+#include <Files/NodeArena.hpp>
+#include <Files/Binary/Binary.hpp>
 #include <Files/Json/Json.hpp>
 #include <Files/Xml/Xml.hpp>
 //#include <Files/Yaml/Yaml.hpp>
@@ -11,6 +15,24 @@
 
 using namespace acid;
 
+// Counts heap allocations so benchmarks can report them.
+static std::size_t allocationCount = 0;
+
+void *operator new(std::size_t size) {
+	allocationCount++;
+	if (auto p = std::malloc(size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
 enum class ExampleType {
 	A = 1,
 	B = 2,
@@ -157,6 +179,138 @@ public:
 };
 }
 
+// Measures Json parsing throughput on a generated scene-like corpus of the given size.
+void BenchmarkJson(std::size_t targetSize) {
+	std::string corpus = "{\"entities\":[";
+	for (uint32_t i = 0; corpus.size() < targetSize; i++) {
+		if (i != 0) corpus += ',';
+		corpus += "\n  {\"name\": \"Entity " + std::to_string(i) + "\", \"enabled\": true, \"parent\": null, \"layer\": " + std::to_string(i % 32) +
+			",\n    \"transform\": {\"position\": [" + std::to_string(i * 0.5f) + ", -1.25, 3.0], \"rotation\": [0.0, 0.707, 0.0, 0.707], \"scale\": [1.0, 1.0, 1.0]},"
+			"\n    \"description\": \"A \\\"quoted\\\" line\\nwith\\tescapes\", \"weights\": [0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8]}";
+	}
+	corpus += "\n]}";
+
+	std::size_t entities = 0;
+	auto start = Time::Now();
+	{
+		Node node;
+		node.ParseString<Json>(corpus);
+		entities = node["entities"]->GetProperties().size();
+	}
+	auto elapsed = Time::Now() - start;
+	Log::Out("Json parse and free: ", corpus.size() / (1024.0 * 1024.0) / elapsed.AsSeconds<double>(), "MB/s, ", entities, " entities in ",
+		elapsed.AsMilliseconds(), "ms\n");
+}
+
+// Compares the size and load time of a generated scene written as Json and as binary nodes.
+void BenchmarkBinary(uint32_t entityCount, uint32_t vertexCount) {
+	std::mt19937 random(0);
+	Node scene;
+	auto &entities = scene.AddProperty("entities");
+	for (uint32_t i = 0; i < entityCount; i++) {
+		auto &entity = entities.AddProperty();
+		entity["name"] = "Entity " + std::to_string(i);
+		entity["enabled"] = i % 3 != 0;
+		entity["transform"]["position"] = Vector3f(i * 0.5f, -1.25f, 3.0f);
+		entity["transform"]["rotation"] = Vector3f(0.0f, i * 0.01f, 0.0f);
+		entity["transform"]["scale"] = Vector3f(1.0f);
+		std::vector<float> vertices(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			vertices[v] = std::uniform_real_distribution<float>(-100.0f, 100.0f)(random);
+		entity["mesh"]["vertices"] = vertices;
+		std::vector<uint32_t> indices(vertexCount / 3);
+		for (uint32_t v = 0; v < indices.size(); v++)
+			indices[v] = v;
+		entity["mesh"]["indices"] = indices;
+	}
+
+	auto json = scene.WriteString<Json>();
+	std::ostringstream binaryStream, deflatedStream;
+	Binary::WriteStream(scene, binaryStream, Binary::Compression::None);
+	Binary::WriteStream(scene, deflatedStream, Binary::Compression::Deflate);
+	auto binary = binaryStream.str();
+	auto deflated = deflatedStream.str();
+
+	auto load = [](const std::string &data, void (*parse)(Node &, std::string_view)) {
+		auto start = Time::Now();
+		Node node;
+		parse(node, data);
+		return Time::Now() - start;
+	};
+
+	Log::Out("Scene of ", entityCount, " entities: Json ", json.size() / 1024, "KB loads in ", load(json, &Json::ParseString).AsMilliseconds(), "ms, binary ",
+		binary.size() / 1024, "KB in ", load(binary, &Binary::ParseString).AsMilliseconds(), "ms, deflated ", deflated.size() / 1024, "KB in ",
+		load(deflated, &Binary::ParseString).AsMilliseconds(), "ms\n");
+}
+
+// Measures storing and reading large float arrays through nodes, and reading them back after a Json round trip.
+void BenchmarkNodeValues(uint32_t arrayCount, uint32_t arraySize) {
+	std::mt19937 random(0);
+	std::vector<std::vector<float>> arrays(arrayCount, std::vector<float>(arraySize));
+	for (auto &array : arrays)
+		for (auto &x : array)
+			x = std::uniform_real_distribution<float>(-100.0f, 100.0f)(random);
+
+	auto start = Time::Now();
+	Node node;
+	for (const auto &array : arrays)
+		node.AddProperty() << array;
+	auto setTime = Time::Now() - start;
+	node.SetType(Node::Type::Array);
+
+	start = Time::Now();
+	double sum = 0.0;
+	for (const auto &property : node.GetProperties())
+		sum += property.Get<std::vector<float>>()[arraySize / 2];
+	auto getTime = Time::Now() - start;
+
+	auto json = node.WriteString<Json>();
+	start = Time::Now();
+	Node parsed;
+	parsed.ParseString<Json>(json);
+	auto parseTime = Time::Now() - start;
+	start = Time::Now();
+	for (const auto &property : parsed.GetProperties())
+		sum += property.Get<std::vector<float>>()[arraySize / 2];
+	auto parsedGetTime = Time::Now() - start;
+
+	Log::Out(arrayCount, " float arrays of ", arraySize, ": set ", setTime.AsMilliseconds(), "ms, get ", getTime.AsMilliseconds(), "ms, Json parse ",
+		parseTime.AsMilliseconds(), "ms, get parsed ", parsedGetTime.AsMilliseconds(), "ms (", sum, ")\n");
+}
+
+// Compares parsing and freeing a COLLADA document as a heap node tree and in a node arena, like AnimatedMesh loads it.
+void BenchmarkCollada(const std::filesystem::path &filename, uint32_t iterations) {
+	auto fileLoaded = Files::Read(filename);
+
+	if (!fileLoaded) {
+		Log::Error("Collada file could not be loaded: ", filename, '\n');
+		return;
+	}
+
+	auto allocationsStart = allocationCount;
+	auto start = Time::Now();
+	for (uint32_t i = 0; i < iterations; i++) {
+		Node node;
+		node.ParseString<Xml>(*fileLoaded);
+	}
+	auto heapTime = (Time::Now() - start) / static_cast<int64_t>(iterations);
+	auto heapAllocations = (allocationCount - allocationsStart) / iterations;
+
+	std::size_t arenaBlocks = 0;
+	allocationsStart = allocationCount;
+	start = Time::Now();
+	for (uint32_t i = 0; i < iterations; i++) {
+		NodeArena arena;
+		arena.Parse<Xml>(*fileLoaded);
+		arenaBlocks = arena.GetAllocationCount();
+	}
+	auto arenaTime = (Time::Now() - start) / static_cast<int64_t>(iterations);
+	auto arenaAllocations = (allocationCount - allocationsStart) / iterations;
+
+	Log::Out("Collada ", fileLoaded->size() / 1024, "KB parse and free: heap ", heapTime.AsMicroseconds(), "us in ", heapAllocations, " allocations, arena ",
+		arenaTime.AsMicroseconds(), "us in ", arenaAllocations, " allocations (", arenaBlocks, " blocks)\n");
+}
+
 int main(int argc, char **argv) {
 	test::Example1 example1;
 	Node node;
@@ -226,6 +380,31 @@ int main(int argc, char **argv) {
 
 		Log::Out(json.WriteString<Json>(Node::Format::Minified), '\n');
 	}
+	{
+		// Nodes moved out of an arena own their strings, so they outlive the arena.
+		Node moved;
+		{
+			NodeArena arena;
+			moved = std::move(arena.Parse<Json>(R"({"message":"hello arena","values":[1,2,3]})"));
+		}
+
+		Log::Out(moved.WriteString<Json>(Node::Format::Minified), '\n');
+	}
+	{
+		// Test binary writer, the Json file type loads it by detecting the binary header.
+		File fileBinary1(File::Type::Binary, node);
+		fileBinary1.Write("Serial/Test1.bin");
+
+		File fileBinary2(File::Type::Json);
+		fileBinary2.Load("Serial/Test1.bin");
+		fileBinary2.Write("Serial/Test3.json", Node::Format::Beautified);
+	}
+	{
+		BenchmarkJson(50 * 1024 * 1024);
+		BenchmarkBinary(2000, 300);
+		BenchmarkNodeValues(100, 10000);
+		BenchmarkCollada("Resources/Objects/Animated/Model.dae", 20);
+	}
 	
 	/*ZipArchive zip0("Serial.zip");
 	zip0.AddEntry("hello.txt", "Hello World!");
@@ -0,0 +1,73 @@
+#include <Bitmaps/Bitmap.hpp>
+#include <Bitmaps/Compressed/CompressedBitmap.hpp>
+#include <Bitmaps/Compressed/TextureManifest.hpp>
+#include <Engine/Log.hpp>
+#include <Maths/Time.hpp>
+#include <Utils/String.hpp>
+#include <Utils/ThreadPool.hpp>
+#include "Config.hpp"
+
+std::filesystem::path PATH = acid::ACID_RESOURCES_DEV;
+
+bool IsNormalMap(const std::filesystem::path &filename) {
+	auto stem = acid::String::Lowercase(filename.stem().string());
+	return stem.find("normal") != std::string::npos || (stem.size() > 2 && stem.substr(stem.size() - 2) == "_n");
+}
+
+bool HasAlpha(const acid::CompressedBitmap &bitmap) {
+	for (std::size_t i = 3; i < bitmap.GetLength(); i += 4) {
+		if (bitmap.GetData()[i] != 255)
+			return true;
+	}
+	return false;
+}
+
+int main(int argc, char **argv) {
+	// Textures are read from the resources folder, or the folder given as the first argument, and cooked beside the manifest.
+	auto resourcesPath = argc > 1 ? std::filesystem::path(argv[1]) : PATH;
+	auto cookedPath = acid::TextureManifest::Path.parent_path();
+	acid::ThreadPool threadPool;
+	acid::TextureManifest manifest;
+	std::size_t sourceBytes = 0, cookedBytes = 0, decodedBytes = 0;
+	acid::Time decodeTime;
+	auto start = acid::Time::Now();
+
+	for (auto &file : std::filesystem::recursive_directory_iterator(resourcesPath)) {
+		auto extension = acid::String::Lowercase(file.path().extension().string());
+		if (!file.is_regular_file() || (extension != ".png" && extension != ".jpg" && extension != ".jpeg"))
+			continue;
+
+		auto textureStart = acid::Time::Now();
+		auto name = file.path().lexically_relative(resourcesPath);
+		acid::Bitmap bitmap(file.path());
+		if (!bitmap.GetData()) {
+			acid::Log::Error("Failed to decode ", file.path(), '\n');
+			continue;
+		}
+		decodeTime += acid::Time::Now() - textureStart;
+		decodedBytes += bitmap.GetLength();
+
+		// Normal maps keep two channels, colour is sRGB encoded and filtered in linear space.
+		acid::CompressedBitmap source(bitmap);
+		auto normalMap = IsNormalMap(name);
+		auto format = normalMap ? VK_FORMAT_BC5_UNORM_BLOCK : HasAlpha(source) ? VK_FORMAT_BC7_UNORM_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		auto mipmapped = source.GenerateMipmaps(!normalMap);
+		auto cooked = mipmapped.Compress(format, &threadPool);
+
+		auto cookedName = (cookedPath / name).replace_extension(".ktx2");
+		cooked.Write(resourcesPath / cookedName);
+		manifest.Add(name, cookedName);
+		sourceBytes += mipmapped.GetLength();
+		cookedBytes += cooked.GetLength();
+
+		auto formatName = normalMap ? "BC5" : format == VK_FORMAT_BC7_UNORM_BLOCK ? "BC7" : "BC1";
+		acid::Log::Out(name, " cooked to ", formatName, " with ", cooked.GetLevelCount(), " levels in ", (acid::Time::Now() - textureStart).AsMilliseconds<float>(), "ms\n");
+	}
+
+	manifest.Write(resourcesPath / acid::TextureManifest::Path);
+	acid::Log::Out("Cooked ", manifest.GetTextures().size(), " textures in ", (acid::Time::Now() - start).AsSeconds<float>(), "s, RGBA8 mip chains of ",
+		sourceBytes / 1000000, "MB stored in ", cookedBytes / 1000000, "MB\n");
+	acid::Log::Out("Decoded ", decodedBytes / 1000000, "MB of RGBA8 in ", decodeTime.AsMilliseconds<float>(), "ms, ",
+		decodedBytes / 1000000.0f / decodeTime.AsSeconds<float>(), "MB/s\n");
+	return 0;
+}